@@ -0,0 +1,65 @@
+#include "bench_common.h"
+
+/*
+ * Times hsd_sim_dot_f32 and hsd_sim_cosine_f32 in each precision mode on the same vectors. Run
+ * it with HSD_BENCH_FORCE_BACKEND=SCALAR to compare the modes against the scalar kernels.
+ */
+
+typedef hsd_status_t (*bench_fn_t)(const float *, const float *, size_t, float *);
+
+static double time_mode(bench_fn_t fn, const float *a, const float *b, float *result) {
+    if (fn(a, b, VECTOR_DIM, result) != HSD_SUCCESS) return -1.0;
+    double t0 = get_time_sec();
+    for (int i = 0; i < NUM_ITERATIONS; ++i) {
+        if (fn(a, b, VECTOR_DIM, result) != HSD_SUCCESS) return -1.0;
+    }
+    return get_time_sec() - t0;
+}
+
+int main(void) {
+    const char *fb = getenv("HSD_BENCH_FORCE_BACKEND");
+    hsd_set_manual_backend(parse_backend(fb));
+
+    initialize_random_seed();
+    printf("Benchmarking precision_modes_f32\n");
+    printf("Backend in use: %s\n", hsd_get_backend());
+    printf("Vector dim: %d, num iterations: %d\n", VECTOR_DIM, NUM_ITERATIONS);
+
+    float *a = malloc(VECTOR_DIM * sizeof(float)), *b = malloc(VECTOR_DIM * sizeof(float));
+    if (!a || !b) {
+        fprintf(stderr, "alloc failed\n");
+        return 1;
+    }
+    generate_random_f32(a, VECTOR_DIM);
+    generate_random_f32(b, VECTOR_DIM);
+
+    const struct {
+        HSD_Precision mode;
+        const char *name;
+    } modes[] = {{HSD_PRECISION_FAST, "fast"},
+                 {HSD_PRECISION_F64, "f64"},
+                 {HSD_PRECISION_DETERMINISTIC, "deterministic"}};
+    const struct {
+        bench_fn_t fn;
+        const char *name;
+    } fns[] = {{hsd_sim_dot_f32, "dot"}, {hsd_sim_cosine_f32, "cosine"}};
+
+    for (size_t f = 0; f < sizeof(fns) / sizeof(fns[0]); ++f) {
+        for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+            volatile float result;
+            hsd_set_precision(modes[m].mode);
+            double t = time_mode(fns[f].fn, a, b, (float *)&result);
+            if (t < 0.0) {
+                fprintf(stderr, "%s failed in %s mode\n", fns[f].name, modes[m].name);
+                continue;
+            }
+            printf("%s, %s: %.5f s (%.1f ns/call)\n", fns[f].name, modes[m].name, t,
+                   t / NUM_ITERATIONS * 1e9);
+        }
+    }
+    hsd_set_precision(HSD_PRECISION_FAST);
+
+    free(a);
+    free(b);
+    return 0;
+}
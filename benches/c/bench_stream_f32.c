@@ -0,0 +1,128 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bench_common.h"
+
+/*
+ * Streams a vector file through hsd_vecfile_stream_search() and compares its throughput with a
+ * plain sequential pread of the same file. The file size is set with HSD_BENCH_STREAM_MB and the
+ * path with HSD_BENCH_STREAM_PATH; the file is removed afterwards. HSD_BENCH_STREAM_DEPTHS is a
+ * comma-separated list of read-ahead depths (buffers in flight) to sweep, 2,4,8 by default.
+ */
+
+#define STREAM_DIM 256
+#define STREAM_K 10
+#define STREAM_READ_CHUNK (8u << 20)
+#define STREAM_MAX_DEPTHS 16
+
+/* Asks the kernel to drop the file's cached pages so both passes start cold where possible. */
+static void drop_cache(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+static double raw_read_seconds(const char *path, size_t *bytes) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1.0;
+    char *buf = malloc(STREAM_READ_CHUNK);
+    if (!buf) {
+        close(fd);
+        return -1.0;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    double t0 = get_time_sec();
+    ssize_t n;
+    *bytes = 0;
+    while ((n = read(fd, buf, STREAM_READ_CHUNK)) > 0) *bytes += (size_t)n;
+    double t1 = get_time_sec();
+    free(buf);
+    close(fd);
+    return t1 - t0;
+}
+
+static size_t parse_depths(const char *env, size_t *depths) {
+    size_t n = 0;
+    const char *p = env ? env : "2,4,8";
+    while (*p != '\0' && n < STREAM_MAX_DEPTHS) {
+        char *end;
+        unsigned long d = strtoul(p, &end, 10);
+        if (end == p) break;
+        if (d > 0) depths[n++] = (size_t)d;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return n;
+}
+
+int main(void) {
+    const char *fb = getenv("HSD_BENCH_FORCE_BACKEND");
+    hsd_set_manual_backend(parse_backend(fb));
+    const char *mb_env = getenv("HSD_BENCH_STREAM_MB");
+    const char *path = getenv("HSD_BENCH_STREAM_PATH");
+    size_t mb = mb_env ? (size_t)strtoul(mb_env, NULL, 10) : 256;
+    if (mb == 0) mb = 256;
+    if (!path) path = "hsd_bench_stream.bin";
+    size_t depths[STREAM_MAX_DEPTHS];
+    size_t num_depths = parse_depths(getenv("HSD_BENCH_STREAM_DEPTHS"), depths);
+    if (num_depths == 0) {
+        fprintf(stderr, "invalid HSD_BENCH_STREAM_DEPTHS\n");
+        return 1;
+    }
+
+    initialize_random_seed();
+    size_t count = mb * (1u << 20) / (STREAM_DIM * sizeof(float));
+    printf("Benchmarking vecfile_stream_search_f32\n");
+    printf("Backend in use: %s\n", hsd_get_backend());
+    printf("Vector dim: %d, rows: %zu, file: %s\n", STREAM_DIM, count, path);
+
+    float *data = malloc(count * STREAM_DIM * sizeof(float));
+    float query[STREAM_DIM];
+    if (!data) {
+        fprintf(stderr, "alloc failed\n");
+        return 1;
+    }
+    generate_random_f32(data, count * STREAM_DIM);
+    generate_random_f32(query, STREAM_DIM);
+    hsd_status_t st = hsd_vecfile_write(path, HSD_DTYPE_F32, STREAM_DIM, data, count, false);
+    free(data);
+    if (st != HSD_SUCCESS) {
+        fprintf(stderr, "write failed: %d\n", st);
+        return 1;
+    }
+
+    drop_cache(path);
+    size_t bytes = 0;
+    double raw = raw_read_seconds(path, &bytes);
+
+    if (raw <= 0.0) {
+        remove(path);
+        fprintf(stderr, "raw read failed\n");
+        return 1;
+    }
+    printf("Raw read: %.2f GB/s\n", (double)bytes / raw / 1e9);
+
+    uint64_t rows[STREAM_K];
+    float scores[STREAM_K];
+    size_t found = 0;
+    for (size_t i = 0; i < num_depths; ++i) {
+        hsd_stream_params_t params = {0, depths[i]};
+        drop_cache(path);
+        double t0 = get_time_sec();
+        st = hsd_vecfile_stream_search(path, query, HSD_METRIC_SQEUCLIDEAN, STREAM_K, &params,
+                                       rows, scores, &found);
+        double total = get_time_sec() - t0;
+        if (st != HSD_SUCCESS) {
+            remove(path);
+            fprintf(stderr, "stream search failed: %d\n", st);
+            return 1;
+        }
+        printf("Stream search, depth %zu: %.2f GB/s (%.5f s)\n", depths[i],
+               (double)bytes / total / 1e9, total);
+    }
+    remove(path);
+
+    if (found > 0) printf("Best hit: row %llu (%f)\n", (unsigned long long)rows[0], scores[0]);
+    return 0;
+}
@@ -30,6 +30,8 @@ _ERROR_MAP: Dict[int, str] = {
     ct.HSD_ERR_NULL_PTR: "Null pointer error encountered in C library",
     ct.HSD_ERR_UNSUPPORTED: "Unsupported operation/feature requested from C library",
     ct.HSD_ERR_INVALID_INPUT: "Invalid input data provided to C library (e.g., NaN, Inf, incompatible size)",
+    ct.HSD_ERR_CPU_NOT_SUPPORTED: "CPU does not support the instruction set required by the C library",
+    ct.HSD_ERR_OUT_OF_MEMORY: "Memory allocation failed in C library",
     ct.HSD_FAILURE: "General failure reported by C library",
 }
 
@@ -24,6 +24,8 @@ HSD_SUCCESS = 0
 HSD_ERR_NULL_PTR = -1
 HSD_ERR_UNSUPPORTED = -2
 HSD_ERR_INVALID_INPUT = -3
+HSD_ERR_CPU_NOT_SUPPORTED = -4
+HSD_ERR_OUT_OF_MEMORY = -5
 HSD_FAILURE = -99
 
 c_float_p = POINTER(c_float)
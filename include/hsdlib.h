@@ -25,8 +25,10 @@
 typedef enum {
     HSD_SUCCESS = 0,
     HSD_ERR_NULL_PTR = -1,
+    HSD_ERR_UNSUPPORTED = -2,
     HSD_ERR_INVALID_INPUT = -3,
     HSD_ERR_CPU_NOT_SUPPORTED = -4,
+    HSD_ERR_OUT_OF_MEMORY = -5,
     HSD_FAILURE = -99
 } HSD_Status;
 
@@ -50,17 +52,215 @@ typedef enum {
     HSD_BACKEND_SVE
 } HSD_Backend;
 
+typedef enum {
+    HSD_METRIC_SQEUCLIDEAN = 0,
+    HSD_METRIC_MANHATTAN,
+    HSD_METRIC_DOT,
+    HSD_METRIC_COSINE,
+    HSD_METRIC_HAMMING
+} HSD_Metric;
+
+typedef enum { HSD_DTYPE_F32 = 0, HSD_DTYPE_F16, HSD_DTYPE_U8 } HSD_DType;
+
+typedef enum {
+    HSD_PRECISION_FAST = 0,
+    HSD_PRECISION_F64,
+    HSD_PRECISION_DETERMINISTIC
+} HSD_Precision;
+
+typedef struct hsd_index_flat hsd_index_flat_t;
+
+typedef struct {
+    size_t m;
+    size_t ef_construction;
+    size_t ef_search;
+    uint64_t seed;
+} hsd_hnsw_params_t;
+
+typedef struct hsd_index_hnsw hsd_index_hnsw_t;
+
+typedef struct hsd_index_ivf hsd_index_ivf_t;
+
+typedef struct {
+    size_t max_iterations;
+    size_t batch_size;
+    uint64_t seed;
+} hsd_kmeans_params_t;
+
+typedef struct hsd_index_numa hsd_index_numa_t;
+
+typedef struct {
+    size_t cpu_count;
+    const int *cpu_nodes;
+} hsd_numa_topology_t;
+
+typedef struct hsd_vecfile hsd_vecfile_t;
+
+typedef enum {
+    HSD_ADVICE_NORMAL = 0,
+    HSD_ADVICE_SEQUENTIAL,
+    HSD_ADVICE_RANDOM,
+    HSD_ADVICE_WILLNEED
+} HSD_Advice;
+
+typedef struct {
+    size_t chunk_bytes;
+    size_t depth;
+} hsd_stream_params_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 hsd_status_t hsd_dist_sqeuclidean_f32(const float *a, const float *b, size_t n, float *result);
 hsd_status_t hsd_dist_manhattan_f32(const float *a, const float *b, size_t n, float *result);
+hsd_status_t hsd_dist_chebyshev_f32(const float *a, const float *b, size_t n, float *result);
+hsd_status_t hsd_dist_minkowski_f32(const float *a, const float *b, size_t n, float p,
+                                    float *result);
+hsd_status_t hsd_dist_kl_f32(const float *a, const float *b, size_t n, float *result);
+hsd_status_t hsd_dist_kl_eps_f32(const float *a, const float *b, size_t n, float eps,
+                                 float *result);
+hsd_status_t hsd_dist_jensen_shannon_f32(const float *a, const float *b, size_t n, float *result);
+hsd_status_t hsd_dist_canberra_f32(const float *a, const float *b, size_t n, float *result);
+hsd_status_t hsd_dist_braycurtis_f32(const float *a, const float *b, size_t n, float *result);
+hsd_status_t hsd_dist_sqeuclidean_f64(const double *a, const double *b, size_t n, double *result);
+hsd_status_t hsd_dist_manhattan_f64(const double *a, const double *b, size_t n, double *result);
 hsd_status_t hsd_dist_hamming_u8(const uint8_t *a, const uint8_t *b, size_t n, uint64_t *result);
+hsd_status_t hsd_dist_sqeuclidean_bounded_f32(const float *a, const float *b, size_t n,
+                                              float threshold, float *result);
+hsd_status_t hsd_dist_weighted_sqeuclidean_f32(const float *a, const float *b, const float *w,
+                                               size_t n, float *result);
+hsd_status_t hsd_mahalanobis_factor_f32(const float *cov, size_t n, float *factor);
+hsd_status_t hsd_whiten_rows_f32(const float *factor, size_t n, const float *rows, size_t count,
+                                 float *out);
+hsd_status_t hsd_dist_mahalanobis_f32(const float *a, const float *b, const float *factor,
+                                      size_t n, float *result);
+hsd_status_t hsd_dist_mahalanobis_batch_f32(const float *query, const float *whitened,
+                                            size_t count, const float *factor, size_t n,
+                                            float *out);
+hsd_status_t hsd_dist_manhattan_bounded_f32(const float *a, const float *b, size_t n,
+                                            float threshold, float *result);
+hsd_status_t hsd_dist_wasserstein1d_f32(const float *a, const float *b, size_t n,
+                                        float *result);
+hsd_status_t hsd_dist_wasserstein1d_sorted_f32(const float *x, size_t nx, const float *y,
+                                               size_t ny, float *result);
+hsd_status_t hsd_dist_hamming_bounded_u8(const uint8_t *a, const uint8_t *b, size_t n,
+                                         uint64_t threshold, uint64_t *result);
+hsd_status_t hsd_dist_levenshtein_u8(const uint8_t *a, size_t na, const uint8_t *b, size_t nb,
+                                     uint64_t *result);
+hsd_status_t hsd_dist_levenshtein_batch_u8(const uint8_t *pattern, size_t m,
+                                           const uint8_t *const *texts, const size_t *lengths,
+                                           size_t count, uint64_t *results);
+hsd_status_t hsd_dist_dtw_f32(const float *a, size_t na, const float *b, size_t nb, size_t band,
+                              float *result);
+hsd_status_t hsd_dist_dtw_bounded_f32(const float *a, size_t na, const float *b, size_t nb,
+                                      size_t band, float best_so_far, float *result);
+hsd_status_t hsd_dtw_envelope_f32(const float *x, size_t n, size_t band, float *upper,
+                                  float *lower);
+hsd_status_t hsd_dist_lb_keogh_f32(const float *q, const float *upper, const float *lower,
+                                   size_t n, float *result);
+hsd_status_t hsd_dist_haversine_batch_f32(const float *lat, const float *lon, size_t n,
+                                          float query_lat, float query_lon, float *result);
+hsd_status_t hsd_dist_haversine_batch_f64(const double *lat, const double *lon, size_t n,
+                                          double query_lat, double query_lon, double *result);
+hsd_status_t hsd_dist_znorm_euclidean_f32(const float *a, const float *b, size_t n,
+                                          float *result);
+hsd_status_t hsd_matrix_profile_f32(const float *t, size_t n, size_t m, float *profile,
+                                    size_t *index);
+hsd_status_t hsd_dist_sqeuclidean_sliding_f32(const float *query, size_t n, const float *signal,
+                                              size_t len, float *out);
 
 hsd_status_t hsd_sim_dot_f32(const float *a, const float *b, size_t n, float *result);
 hsd_status_t hsd_sim_cosine_f32(const float *a, const float *b, size_t n, float *result);
+hsd_status_t hsd_sim_pearson_f32(const float *a, const float *b, size_t n, float *result);
+hsd_status_t hsd_sim_pearson_centered_f32(const float *a, const float *b, size_t n,
+                                          float *result);
+hsd_status_t hsd_sim_dot_f64(const double *a, const double *b, size_t n, double *result);
+hsd_status_t hsd_sim_cosine_f64(const double *a, const double *b, size_t n, double *result);
+hsd_status_t hsd_sim_cosine_normed_f32(const float *a, const float *b, size_t n, float norm_a,
+                                       float norm_b, float *result);
+hsd_status_t hsd_sim_cosine_normed_batch_f32(const float *query, float query_norm,
+                                             const float *rows, const float *row_norms,
+                                             size_t count, size_t dim, float *out);
 hsd_status_t hsd_sim_jaccard_u16(const uint16_t *a, const uint16_t *b, size_t n, float *result);
+hsd_status_t hsd_sim_dot_sliding_f32(const float *query, size_t n, const float *signal,
+                                     size_t len, float *out);
+
+hsd_status_t hsd_norm_l2_f32(const float *v, size_t n, float *result);
+hsd_status_t hsd_norm_l1_f32(const float *v, size_t n, float *result);
+hsd_status_t hsd_normalize_f32(float *v, size_t n);
+hsd_status_t hsd_norms_l2_f32(const float *data, size_t count, size_t dim, float *norms);
+hsd_status_t hsd_norms_l1_f32(const float *data, size_t count, size_t dim, float *norms);
+hsd_status_t hsd_normalize_rows_f32(float *data, size_t count, size_t dim, float *norms);
+
+hsd_status_t hsd_cdist_f32(const float *a, size_t na, const float *b, size_t nb, size_t dim,
+                           HSD_Metric metric, float *out);
+
+hsd_status_t hsd_index_flat_create(size_t dim, HSD_DType dtype, HSD_Metric metric,
+                                   hsd_index_flat_t **index);
+void hsd_index_flat_free(hsd_index_flat_t *index);
+hsd_status_t hsd_index_flat_add(hsd_index_flat_t *index, const void *vectors, size_t count,
+                                uint64_t *first_id);
+hsd_status_t hsd_index_flat_remove(hsd_index_flat_t *index, uint64_t id);
+hsd_status_t hsd_index_flat_compact(hsd_index_flat_t *index);
+hsd_status_t hsd_index_flat_search(const hsd_index_flat_t *index, const void *query, size_t k,
+                                   uint64_t *ids, float *scores, size_t *found);
+size_t hsd_index_flat_size(const hsd_index_flat_t *index);
+
+hsd_status_t hsd_index_hnsw_create(size_t dim, HSD_Metric metric, size_t max_elements,
+                                   const hsd_hnsw_params_t *params, hsd_index_hnsw_t **index);
+void hsd_index_hnsw_free(hsd_index_hnsw_t *index);
+hsd_status_t hsd_index_hnsw_add(hsd_index_hnsw_t *index, const float *vector, uint64_t *id);
+hsd_status_t hsd_index_hnsw_set_ef_search(hsd_index_hnsw_t *index, size_t ef_search);
+hsd_status_t hsd_index_hnsw_search(const hsd_index_hnsw_t *index, const float *query, size_t k,
+                                   uint64_t *ids, float *scores, size_t *found);
+size_t hsd_index_hnsw_size(const hsd_index_hnsw_t *index);
+
+hsd_status_t hsd_index_ivf_create(size_t dim, HSD_Metric metric, size_t nlist,
+                                  hsd_index_ivf_t **index);
+void hsd_index_ivf_free(hsd_index_ivf_t *index);
+hsd_status_t hsd_index_ivf_train(hsd_index_ivf_t *index, const float *vectors, size_t count);
+hsd_status_t hsd_index_ivf_add(hsd_index_ivf_t *index, const float *vectors, size_t count,
+                               uint64_t *first_id);
+hsd_status_t hsd_index_ivf_set_nprobe(hsd_index_ivf_t *index, size_t nprobe);
+hsd_status_t hsd_index_ivf_search(const hsd_index_ivf_t *index, const float *query, size_t k,
+                                  uint64_t *ids, float *scores, size_t *found);
+size_t hsd_index_ivf_size(const hsd_index_ivf_t *index);
+hsd_status_t hsd_index_ivf_save(const hsd_index_ivf_t *index, const char *path);
+hsd_status_t hsd_index_ivf_load(const char *path, hsd_index_ivf_t **index);
+
+hsd_status_t hsd_index_numa_create(size_t dim, HSD_Metric metric,
+                                   const hsd_numa_topology_t *topology, hsd_index_numa_t **index);
+void hsd_index_numa_free(hsd_index_numa_t *index);
+hsd_status_t hsd_index_numa_add(hsd_index_numa_t *index, const float *vectors, size_t count,
+                                uint64_t *first_id);
+hsd_status_t hsd_index_numa_search(const hsd_index_numa_t *index, const float *query, size_t k,
+                                   uint64_t *ids, float *scores, size_t *found);
+size_t hsd_index_numa_size(const hsd_index_numa_t *index);
+size_t hsd_index_numa_shard_count(const hsd_index_numa_t *index);
+hsd_status_t hsd_index_numa_shard_info(const hsd_index_numa_t *index, size_t shard, int *node,
+                                       size_t *count);
+
+hsd_status_t hsd_vecfile_write(const char *path, HSD_DType dtype, size_t dim, const void *vectors,
+                               size_t count, bool with_norms);
+hsd_status_t hsd_vecfile_open(const char *path, hsd_vecfile_t **file);
+void hsd_vecfile_close(hsd_vecfile_t *file);
+size_t hsd_vecfile_count(const hsd_vecfile_t *file);
+size_t hsd_vecfile_dim(const hsd_vecfile_t *file);
+HSD_DType hsd_vecfile_dtype(const hsd_vecfile_t *file);
+size_t hsd_vecfile_row_stride(const hsd_vecfile_t *file);
+const void *hsd_vecfile_row(const hsd_vecfile_t *file, size_t row);
+const float *hsd_vecfile_norms(const hsd_vecfile_t *file);
+hsd_status_t hsd_vecfile_advise(const hsd_vecfile_t *file, HSD_Advice advice);
+hsd_status_t hsd_vecfile_search(const hsd_vecfile_t *file, const void *query, HSD_Metric metric,
+                                size_t k, uint64_t *rows, float *scores, size_t *found);
+hsd_status_t hsd_vecfile_stream_search(const char *path, const void *query, HSD_Metric metric,
+                                       size_t k, const hsd_stream_params_t *params,
+                                       uint64_t *rows, float *scores, size_t *found);
+
+hsd_status_t hsd_kmeans_f32(const float *data, size_t n, size_t dim, size_t k,
+                            const hsd_kmeans_params_t *params, float *centroids, uint32_t *labels,
+                            float *inertia);
 
 const char *hsd_get_backend(void);
 bool hsd_has_avx512(void);
@@ -69,6 +269,13 @@ hsd_fp_status_t hsd_get_fp_mode_status(void);
 hsd_status_t hsd_set_manual_backend(HSD_Backend backend);
 HSD_Backend hsd_get_current_backend_choice(void);
 
+hsd_status_t hsd_set_precision(HSD_Precision precision);
+HSD_Precision hsd_get_precision(void);
+
+hsd_status_t hsd_set_num_threads(size_t num_threads);
+size_t hsd_get_num_threads(void);
+hsd_status_t hsd_set_thread_affinity(const int *cpus, size_t count);
+
 #if defined(__x86_64__) || defined(_M_X64)
 bool hsd_cpu_has_avx(void);
 bool hsd_cpu_has_avx2(void);
@@ -108,6 +315,12 @@ static inline float hsd_internal_hsum_avx_f32(__m256 acc) {
     hsum_128 = _mm_hadd_ps(hsum_128, hsum_128);
     return _mm_cvtss_f32(hsum_128);
 }
+
+static inline double hsd_internal_hsum_avx_f64(__m256d acc) {
+    __m128d hsum_128 = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    hsum_128 = _mm_add_sd(hsum_128, _mm_unpackhi_pd(hsum_128, hsum_128));
+    return _mm_cvtsd_f64(hsum_128);
+}
 #endif
 
 #ifdef __cplusplus
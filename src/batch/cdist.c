@@ -0,0 +1,129 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#define HSD_CDIST_A_TILE 16
+#define HSD_CDIST_B_TILE 256
+
+typedef hsd_status_t (*hsd_cdist_kernel_t)(const float *, const float *, size_t, float *);
+
+/*
+ * The output matrix is cut into tiles of HSD_CDIST_A_TILE x HSD_CDIST_B_TILE pairs so that a
+ * tile's b rows stay in cache while every a row of the tile is scored against them, and so a
+ * single query against a large b set still spreads over the thread pool.
+ */
+typedef struct {
+    const float *a;
+    size_t na;
+    const float *b;
+    size_t nb;
+    size_t dim;
+    HSD_Metric metric;
+    hsd_cdist_kernel_t kernel;
+    const float *a_norms;
+    const float *b_norms;
+    float *out;
+    size_t b_tiles;
+} hsd_cdist_job_t;
+
+static hsd_status_t cdist_task(void *ctx, size_t tile, size_t slot) {
+    (void)slot;
+    hsd_cdist_job_t *job = (hsd_cdist_job_t *)ctx;
+    size_t i0 = tile / job->b_tiles * HSD_CDIST_A_TILE;
+    size_t j0 = tile % job->b_tiles * HSD_CDIST_B_TILE;
+    size_t ni = job->na - i0 < HSD_CDIST_A_TILE ? job->na - i0 : HSD_CDIST_A_TILE;
+    size_t nj = job->nb - j0 < HSD_CDIST_B_TILE ? job->nb - j0 : HSD_CDIST_B_TILE;
+    float *out = job->out + i0 * job->nb + j0;
+
+    if (job->kernel != NULL) {
+        for (size_t i = 0; i < ni; ++i) {
+            const float *x = job->a + (i0 + i) * job->dim;
+            for (size_t j = 0; j < nj; ++j) {
+                hsd_status_t status =
+                    job->kernel(x, job->b + (j0 + j) * job->dim, job->dim, out + i * job->nb + j);
+                if (status != HSD_SUCCESS) return status;
+            }
+        }
+        return HSD_SUCCESS;
+    }
+
+    hsd_internal_dot_block_f32(job->a + i0 * job->dim, ni, job->dim, job->b + j0 * job->dim, nj,
+                               job->dim, job->dim, out, job->nb);
+    if (job->metric == HSD_METRIC_COSINE) {
+        for (size_t i = 0; i < ni; ++i) {
+            float *row = out + i * job->nb;
+            float a_norm = job->a_norms[i0 + i];
+            for (size_t j = 0; j < nj; ++j)
+                row[j] = hsd_internal_cosine_from_dot(row[j], a_norm, job->b_norms[j0 + j]);
+        }
+    }
+    return HSD_SUCCESS;
+}
+
+/* L2 norms; going through hsd_sim_dot_f32 also rejects non-finite input. */
+static hsd_status_t cdist_norms(const float *rows, size_t n, size_t dim, float *norms) {
+    for (size_t i = 0; i < n; ++i) {
+        hsd_status_t status = hsd_sim_dot_f32(rows + i * dim, rows + i * dim, dim, &norms[i]);
+        if (status != HSD_SUCCESS) return status;
+        norms[i] = sqrtf(norms[i]);
+    }
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t cdist_run_blocked(hsd_cdist_job_t *job) {
+    float *norms = (float *)malloc((job->na + job->nb) * sizeof(float));
+    if (norms == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    job->a_norms = norms;
+    job->b_norms = norms + job->na;
+    hsd_status_t status = cdist_norms(job->a, job->na, job->dim, norms);
+    if (status == HSD_SUCCESS) status = cdist_norms(job->b, job->nb, job->dim, norms + job->na);
+    if (status == HSD_SUCCESS) {
+        size_t tiles = (job->na + HSD_CDIST_A_TILE - 1) / HSD_CDIST_A_TILE * job->b_tiles;
+        status = hsd_internal_parallel_for(tiles, hsd_get_num_threads(), cdist_task, job);
+    }
+    free(norms);
+    return status;
+}
+
+hsd_status_t hsd_cdist_f32(const float *a, size_t na, const float *b, size_t nb, size_t dim,
+                           HSD_Metric metric, float *out) {
+    if (a == NULL || b == NULL || out == NULL) return HSD_ERR_NULL_PTR;
+    if (na == 0 || nb == 0) return HSD_SUCCESS;
+
+    hsd_cdist_job_t job;
+    job.a = a;
+    job.na = na;
+    job.b = b;
+    job.nb = nb;
+    job.dim = dim;
+    job.metric = metric;
+    job.a_norms = NULL;
+    job.b_norms = NULL;
+    job.out = out;
+    job.b_tiles = (nb + HSD_CDIST_B_TILE - 1) / HSD_CDIST_B_TILE;
+    hsd_log("Cdist F32: na=%zu nb=%zu dim=%zu metric=%d", na, nb, dim, (int)metric);
+
+    switch (metric) {
+        case HSD_METRIC_SQEUCLIDEAN:
+            job.kernel = hsd_dist_sqeuclidean_f32;
+            break;
+        case HSD_METRIC_MANHATTAN:
+            job.kernel = hsd_dist_manhattan_f32;
+            break;
+        case HSD_METRIC_DOT:
+        case HSD_METRIC_COSINE:
+            /* The blocked kernel has its own summation order, so other modes score pair by pair. */
+            if (hsd_get_precision() != HSD_PRECISION_FAST) {
+                job.kernel = metric == HSD_METRIC_DOT ? hsd_sim_dot_f32 : hsd_sim_cosine_f32;
+                break;
+            }
+            job.kernel = NULL;
+            return cdist_run_blocked(&job);
+        default:
+            return HSD_ERR_INVALID_INPUT;
+    }
+    size_t tiles = (na + HSD_CDIST_A_TILE - 1) / HSD_CDIST_A_TILE * job.b_tiles;
+    return hsd_internal_parallel_for(tiles, hsd_get_num_threads(), cdist_task, &job);
+}
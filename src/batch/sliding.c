@@ -0,0 +1,887 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+/*
+ * Scores of a query of length n against every length-n window of a signal.
+ *
+ * Short queries use direct kernels in which every SIMD lane is a different window offset:
+ * each query element is broadcast once and multiplied with a contiguous, overlapping load of
+ * the signal, so nothing is gathered or reduced horizontally. From HSD_SLIDING_FFT_MIN on,
+ * the dot products come from an overlap-save cross-correlation in double precision, which
+ * costs O(log n) per window instead of O(n): the signal is cut into blocks of L samples that
+ * overlap by n - 1, two real blocks share one complex FFT, and the spectrum is multiplied by
+ * the conjugate spectrum of the query. The squared distance is then
+ * |q|^2 - 2 q.w + |w|^2 with the window norms |w|^2 rolled in double.
+ */
+#define HSD_SLIDING_FFT_MIN 320
+#define HSD_SLIDING_CHUNK 4096
+
+typedef struct {
+    /* out[i] = sum_k q[k] * t[i + k] (dot) or (t[i + k] - q[k])^2 (sqdiff), i < count. */
+    void (*dot)(const float *q, size_t n, const float *t, size_t count, float *out);
+    void (*sqdiff)(const float *q, size_t n, const float *t, size_t count, float *out);
+    /* In-place forward and inverse transforms of the FFT path (see sliding_fft_scalar). */
+    void (*fft)(double *re, double *im, size_t size, const double *tw_re, const double *tw_im);
+    void (*ifft)(double *re, double *im, size_t size, const double *tw_re, const double *tw_im);
+    const char *name;
+} hsd_sliding_kernels_t;
+
+static void sliding_dot_scalar(const float *q, size_t n, const float *t, size_t count,
+                               float *out) {
+    for (size_t i = 0; i < count; ++i) {
+        float sum = 0.0f;
+        for (size_t k = 0; k < n; ++k) sum += q[k] * t[i + k];
+        out[i] = sum;
+    }
+}
+
+static void sliding_sqdiff_scalar(const float *q, size_t n, const float *t, size_t count,
+                                  float *out) {
+    for (size_t i = 0; i < count; ++i) {
+        float sum = 0.0f;
+        for (size_t k = 0; k < n; ++k) {
+            float d = t[i + k] - q[k];
+            sum += d * d;
+        }
+        out[i] = sum;
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static void sliding_dot_avx(const float *q, size_t n,
+                                                           const float *t, size_t count,
+                                                           float *out) {
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+        for (size_t k = 0; k < n; ++k) {
+            const float *p = t + i + k;
+            __m256 qk = _mm256_set1_ps(q[k]);
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(qk, _mm256_loadu_ps(p)));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(qk, _mm256_loadu_ps(p + 8)));
+            acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(qk, _mm256_loadu_ps(p + 16)));
+            acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(qk, _mm256_loadu_ps(p + 24)));
+        }
+        _mm256_storeu_ps(out + i, acc0);
+        _mm256_storeu_ps(out + i + 8, acc1);
+        _mm256_storeu_ps(out + i + 16, acc2);
+        _mm256_storeu_ps(out + i + 24, acc3);
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (size_t k = 0; k < n; ++k)
+            acc = _mm256_add_ps(acc,
+                                _mm256_mul_ps(_mm256_set1_ps(q[k]), _mm256_loadu_ps(t + i + k)));
+        _mm256_storeu_ps(out + i, acc);
+    }
+    sliding_dot_scalar(q, n, t + i, count - i, out + i);
+}
+
+__attribute__((target("avx"))) static void sliding_sqdiff_avx(const float *q, size_t n,
+                                                              const float *t, size_t count,
+                                                              float *out) {
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+        for (size_t k = 0; k < n; ++k) {
+            const float *p = t + i + k;
+            __m256 qk = _mm256_set1_ps(q[k]);
+            __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(p), qk);
+            __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(p + 8), qk);
+            __m256 d2 = _mm256_sub_ps(_mm256_loadu_ps(p + 16), qk);
+            __m256 d3 = _mm256_sub_ps(_mm256_loadu_ps(p + 24), qk);
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(d0, d0));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(d1, d1));
+            acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(d2, d2));
+            acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(d3, d3));
+        }
+        _mm256_storeu_ps(out + i, acc0);
+        _mm256_storeu_ps(out + i + 8, acc1);
+        _mm256_storeu_ps(out + i + 16, acc2);
+        _mm256_storeu_ps(out + i + 24, acc3);
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (size_t k = 0; k < n; ++k) {
+            __m256 d = _mm256_sub_ps(_mm256_loadu_ps(t + i + k), _mm256_set1_ps(q[k]));
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(d, d));
+        }
+        _mm256_storeu_ps(out + i, acc);
+    }
+    sliding_sqdiff_scalar(q, n, t + i, count - i, out + i);
+}
+
+__attribute__((target("avx2,fma"))) static void sliding_dot_avx2(const float *q, size_t n,
+                                                                 const float *t, size_t count,
+                                                                 float *out) {
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+        for (size_t k = 0; k < n; ++k) {
+            const float *p = t + i + k;
+            __m256 qk = _mm256_set1_ps(q[k]);
+            acc0 = _mm256_fmadd_ps(qk, _mm256_loadu_ps(p), acc0);
+            acc1 = _mm256_fmadd_ps(qk, _mm256_loadu_ps(p + 8), acc1);
+            acc2 = _mm256_fmadd_ps(qk, _mm256_loadu_ps(p + 16), acc2);
+            acc3 = _mm256_fmadd_ps(qk, _mm256_loadu_ps(p + 24), acc3);
+        }
+        _mm256_storeu_ps(out + i, acc0);
+        _mm256_storeu_ps(out + i + 8, acc1);
+        _mm256_storeu_ps(out + i + 16, acc2);
+        _mm256_storeu_ps(out + i + 24, acc3);
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (size_t k = 0; k < n; ++k)
+            acc = _mm256_fmadd_ps(_mm256_set1_ps(q[k]), _mm256_loadu_ps(t + i + k), acc);
+        _mm256_storeu_ps(out + i, acc);
+    }
+    sliding_dot_scalar(q, n, t + i, count - i, out + i);
+}
+
+__attribute__((target("avx2,fma"))) static void sliding_sqdiff_avx2(const float *q, size_t n,
+                                                                    const float *t,
+                                                                    size_t count, float *out) {
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+        for (size_t k = 0; k < n; ++k) {
+            const float *p = t + i + k;
+            __m256 qk = _mm256_set1_ps(q[k]);
+            __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(p), qk);
+            __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(p + 8), qk);
+            __m256 d2 = _mm256_sub_ps(_mm256_loadu_ps(p + 16), qk);
+            __m256 d3 = _mm256_sub_ps(_mm256_loadu_ps(p + 24), qk);
+            acc0 = _mm256_fmadd_ps(d0, d0, acc0);
+            acc1 = _mm256_fmadd_ps(d1, d1, acc1);
+            acc2 = _mm256_fmadd_ps(d2, d2, acc2);
+            acc3 = _mm256_fmadd_ps(d3, d3, acc3);
+        }
+        _mm256_storeu_ps(out + i, acc0);
+        _mm256_storeu_ps(out + i + 8, acc1);
+        _mm256_storeu_ps(out + i + 16, acc2);
+        _mm256_storeu_ps(out + i + 24, acc3);
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (size_t k = 0; k < n; ++k) {
+            __m256 d = _mm256_sub_ps(_mm256_loadu_ps(t + i + k), _mm256_set1_ps(q[k]));
+            acc = _mm256_fmadd_ps(d, d, acc);
+        }
+        _mm256_storeu_ps(out + i, acc);
+    }
+    sliding_sqdiff_scalar(q, n, t + i, count - i, out + i);
+}
+
+__attribute__((target("avx512f"))) static void sliding_dot_avx512(const float *q, size_t n,
+                                                                  const float *t,
+                                                                  size_t count, float *out) {
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+        __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+        for (size_t k = 0; k < n; ++k) {
+            const float *p = t + i + k;
+            __m512 qk = _mm512_set1_ps(q[k]);
+            acc0 = _mm512_fmadd_ps(qk, _mm512_loadu_ps(p), acc0);
+            acc1 = _mm512_fmadd_ps(qk, _mm512_loadu_ps(p + 16), acc1);
+            acc2 = _mm512_fmadd_ps(qk, _mm512_loadu_ps(p + 32), acc2);
+            acc3 = _mm512_fmadd_ps(qk, _mm512_loadu_ps(p + 48), acc3);
+        }
+        _mm512_storeu_ps(out + i, acc0);
+        _mm512_storeu_ps(out + i + 16, acc1);
+        _mm512_storeu_ps(out + i + 32, acc2);
+        _mm512_storeu_ps(out + i + 48, acc3);
+    }
+    for (; i + 16 <= count; i += 16) {
+        __m512 acc = _mm512_setzero_ps();
+        for (size_t k = 0; k < n; ++k)
+            acc = _mm512_fmadd_ps(_mm512_set1_ps(q[k]), _mm512_loadu_ps(t + i + k), acc);
+        _mm512_storeu_ps(out + i, acc);
+    }
+    sliding_dot_scalar(q, n, t + i, count - i, out + i);
+}
+
+__attribute__((target("avx512f"))) static void sliding_sqdiff_avx512(const float *q, size_t n,
+                                                                     const float *t,
+                                                                     size_t count,
+                                                                     float *out) {
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+        __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+        for (size_t k = 0; k < n; ++k) {
+            const float *p = t + i + k;
+            __m512 qk = _mm512_set1_ps(q[k]);
+            __m512 d0 = _mm512_sub_ps(_mm512_loadu_ps(p), qk);
+            __m512 d1 = _mm512_sub_ps(_mm512_loadu_ps(p + 16), qk);
+            __m512 d2 = _mm512_sub_ps(_mm512_loadu_ps(p + 32), qk);
+            __m512 d3 = _mm512_sub_ps(_mm512_loadu_ps(p + 48), qk);
+            acc0 = _mm512_fmadd_ps(d0, d0, acc0);
+            acc1 = _mm512_fmadd_ps(d1, d1, acc1);
+            acc2 = _mm512_fmadd_ps(d2, d2, acc2);
+            acc3 = _mm512_fmadd_ps(d3, d3, acc3);
+        }
+        _mm512_storeu_ps(out + i, acc0);
+        _mm512_storeu_ps(out + i + 16, acc1);
+        _mm512_storeu_ps(out + i + 32, acc2);
+        _mm512_storeu_ps(out + i + 48, acc3);
+    }
+    for (; i + 16 <= count; i += 16) {
+        __m512 acc = _mm512_setzero_ps();
+        for (size_t k = 0; k < n; ++k) {
+            __m512 d = _mm512_sub_ps(_mm512_loadu_ps(t + i + k), _mm512_set1_ps(q[k]));
+            acc = _mm512_fmadd_ps(d, d, acc);
+        }
+        _mm512_storeu_ps(out + i, acc);
+    }
+    sliding_sqdiff_scalar(q, n, t + i, count - i, out + i);
+}
+#endif
+
+#if defined(__aarch64__)
+static void sliding_dot_neon(const float *q, size_t n, const float *t, size_t count,
+                             float *out) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+        float32x4_t acc2 = vdupq_n_f32(0.0f), acc3 = vdupq_n_f32(0.0f);
+        for (size_t k = 0; k < n; ++k) {
+            const float *p = t + i + k;
+            float32x4_t qk = vdupq_n_f32(q[k]);
+            acc0 = vfmaq_f32(acc0, qk, vld1q_f32(p));
+            acc1 = vfmaq_f32(acc1, qk, vld1q_f32(p + 4));
+            acc2 = vfmaq_f32(acc2, qk, vld1q_f32(p + 8));
+            acc3 = vfmaq_f32(acc3, qk, vld1q_f32(p + 12));
+        }
+        vst1q_f32(out + i, acc0);
+        vst1q_f32(out + i + 4, acc1);
+        vst1q_f32(out + i + 8, acc2);
+        vst1q_f32(out + i + 12, acc3);
+    }
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (size_t k = 0; k < n; ++k) acc = vfmaq_n_f32(acc, vld1q_f32(t + i + k), q[k]);
+        vst1q_f32(out + i, acc);
+    }
+    sliding_dot_scalar(q, n, t + i, count - i, out + i);
+}
+
+static void sliding_sqdiff_neon(const float *q, size_t n, const float *t, size_t count,
+                                float *out) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+        float32x4_t acc2 = vdupq_n_f32(0.0f), acc3 = vdupq_n_f32(0.0f);
+        for (size_t k = 0; k < n; ++k) {
+            const float *p = t + i + k;
+            float32x4_t qk = vdupq_n_f32(q[k]);
+            float32x4_t d0 = vsubq_f32(vld1q_f32(p), qk);
+            float32x4_t d1 = vsubq_f32(vld1q_f32(p + 4), qk);
+            float32x4_t d2 = vsubq_f32(vld1q_f32(p + 8), qk);
+            float32x4_t d3 = vsubq_f32(vld1q_f32(p + 12), qk);
+            acc0 = vfmaq_f32(acc0, d0, d0);
+            acc1 = vfmaq_f32(acc1, d1, d1);
+            acc2 = vfmaq_f32(acc2, d2, d2);
+            acc3 = vfmaq_f32(acc3, d3, d3);
+        }
+        vst1q_f32(out + i, acc0);
+        vst1q_f32(out + i + 4, acc1);
+        vst1q_f32(out + i + 8, acc2);
+        vst1q_f32(out + i + 12, acc3);
+    }
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (size_t k = 0; k < n; ++k) {
+            float32x4_t d = vsubq_f32(vld1q_f32(t + i + k), vdupq_n_f32(q[k]));
+            acc = vfmaq_f32(acc, d, d);
+        }
+        vst1q_f32(out + i, acc);
+    }
+    sliding_sqdiff_scalar(q, n, t + i, count - i, out + i);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static void sliding_dot_sve(const float *q, size_t n,
+                                                            const float *t, size_t count,
+                                                            float *out) {
+    const size_t width = svcntw();
+    for (size_t i = 0; i < count; i += width) {
+        svbool_t pg = svwhilelt_b32_u64(i, count);
+        svfloat32_t acc = svdup_n_f32(0.0f);
+        for (size_t k = 0; k < n; ++k) acc = svmla_n_f32_m(pg, acc, svld1_f32(pg, t + i + k), q[k]);
+        svst1_f32(pg, out + i, acc);
+    }
+}
+
+__attribute__((target("+sve"))) static void sliding_sqdiff_sve(const float *q, size_t n,
+                                                               const float *t, size_t count,
+                                                               float *out) {
+    const size_t width = svcntw();
+    for (size_t i = 0; i < count; i += width) {
+        svbool_t pg = svwhilelt_b32_u64(i, count);
+        svfloat32_t acc = svdup_n_f32(0.0f);
+        for (size_t k = 0; k < n; ++k) {
+            svfloat32_t d = svsub_n_f32_x(pg, svld1_f32(pg, t + i + k), q[k]);
+            acc = svmla_f32_m(pg, acc, d, d);
+        }
+        svst1_f32(pg, out + i, acc);
+    }
+}
+#endif
+#endif
+
+/*
+ * Radix-2 transforms of size L on split real and imaginary parts. The forward transform
+ * decimates in frequency and leaves the spectrum in bit-reversed order; the inverse decimates
+ * in time and takes that order back, so no permutation pass is needed because the spectra
+ * are only multiplied pointwise. tw_re/tw_im hold exp(-2 pi i k / 2h) at index h + k for
+ * every stage half-size h, so each stage reads its twiddles contiguously. The inverse is not
+ * scaled by 1 / L. The vector stages use separate multiplies and adds, in the scalar order,
+ * so the correlation is bit-identical on every backend.
+ */
+static void sliding_dif_stage_scalar(double *re, double *im, size_t size, size_t half,
+                                     const double *wr, const double *wi) {
+    for (size_t s = 0; s < size; s += 2 * half) {
+        double *ar = re + s, *ai = im + s, *br = re + s + half, *bi = im + s + half;
+        for (size_t k = 0; k < half; ++k) {
+            double dr = ar[k] - br[k], di = ai[k] - bi[k];
+            ar[k] += br[k];
+            ai[k] += bi[k];
+            br[k] = dr * wr[k] - di * wi[k];
+            bi[k] = dr * wi[k] + di * wr[k];
+        }
+    }
+}
+
+static void sliding_dit_stage_scalar(double *re, double *im, size_t size, size_t half,
+                                     const double *wr, const double *wi) {
+    for (size_t s = 0; s < size; s += 2 * half) {
+        double *ar = re + s, *ai = im + s, *br = re + s + half, *bi = im + s + half;
+        for (size_t k = 0; k < half; ++k) {
+            double xr = br[k] * wr[k] + bi[k] * wi[k];
+            double xi = bi[k] * wr[k] - br[k] * wi[k];
+            br[k] = ar[k] - xr;
+            bi[k] = ai[k] - xi;
+            ar[k] += xr;
+            ai[k] += xi;
+        }
+    }
+}
+
+static void sliding_fft_scalar(double *re, double *im, size_t size, const double *tw_re,
+                               const double *tw_im) {
+    for (size_t half = size >> 1; half > 0; half >>= 1)
+        sliding_dif_stage_scalar(re, im, size, half, tw_re + half, tw_im + half);
+}
+
+static void sliding_ifft_scalar(double *re, double *im, size_t size, const double *tw_re,
+                                const double *tw_im) {
+    for (size_t half = 1; half < size; half <<= 1)
+        sliding_dit_stage_scalar(re, im, size, half, tw_re + half, tw_im + half);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+/* Forward butterfly: (x, y) -> (x + y, (x - y) w). */
+__attribute__((target("avx"))) static inline void sliding_dif_avx(__m256d *xr, __m256d *xi,
+                                                                  __m256d *yr, __m256d *yi,
+                                                                  __m256d c, __m256d d) {
+    __m256d dr = _mm256_sub_pd(*xr, *yr), di = _mm256_sub_pd(*xi, *yi);
+    *xr = _mm256_add_pd(*xr, *yr);
+    *xi = _mm256_add_pd(*xi, *yi);
+    *yr = _mm256_sub_pd(_mm256_mul_pd(dr, c), _mm256_mul_pd(di, d));
+    *yi = _mm256_add_pd(_mm256_mul_pd(dr, d), _mm256_mul_pd(di, c));
+}
+
+/* Inverse butterfly: (x, y) -> (x + y conj(w), x - y conj(w)). */
+__attribute__((target("avx"))) static inline void sliding_dit_avx(__m256d *xr, __m256d *xi,
+                                                                  __m256d *yr, __m256d *yi,
+                                                                  __m256d c, __m256d d) {
+    __m256d tr = _mm256_add_pd(_mm256_mul_pd(*yr, c), _mm256_mul_pd(*yi, d));
+    __m256d ti = _mm256_sub_pd(_mm256_mul_pd(*yi, c), _mm256_mul_pd(*yr, d));
+    *yr = _mm256_sub_pd(*xr, tr);
+    *yi = _mm256_sub_pd(*xi, ti);
+    *xr = _mm256_add_pd(*xr, tr);
+    *xi = _mm256_add_pd(*xi, ti);
+}
+
+/*
+ * The stages are memory bound, so two consecutive stages (half-sizes h and h / 2) are fused
+ * into one pass over the data; stages with fewer than 4 butterflies per group stay scalar.
+ */
+__attribute__((target("avx"))) static void sliding_fft_avx(double *re, double *im, size_t size,
+                                                           const double *tw_re,
+                                                           const double *tw_im) {
+    size_t half = size >> 1;
+    for (; half >= 8; half >>= 2) {
+        const size_t q = half >> 1;
+        const double *wr = tw_re + half, *wi = tw_im + half;
+        const double *vr = tw_re + q, *vi = tw_im + q;
+        for (size_t s = 0; s < size; s += 2 * half) {
+            double *r = re + s, *i = im + s;
+            for (size_t k = 0; k < q; k += 4) {
+                __m256d ar = _mm256_loadu_pd(r + k), ai = _mm256_loadu_pd(i + k);
+                __m256d br = _mm256_loadu_pd(r + k + q), bi = _mm256_loadu_pd(i + k + q);
+                __m256d cr = _mm256_loadu_pd(r + k + half), ci = _mm256_loadu_pd(i + k + half);
+                __m256d dr = _mm256_loadu_pd(r + k + half + q);
+                __m256d di = _mm256_loadu_pd(i + k + half + q);
+                sliding_dif_avx(&ar, &ai, &cr, &ci, _mm256_loadu_pd(wr + k),
+                                _mm256_loadu_pd(wi + k));
+                sliding_dif_avx(&br, &bi, &dr, &di, _mm256_loadu_pd(wr + k + q),
+                                _mm256_loadu_pd(wi + k + q));
+                __m256d c = _mm256_loadu_pd(vr + k), d = _mm256_loadu_pd(vi + k);
+                sliding_dif_avx(&ar, &ai, &br, &bi, c, d);
+                sliding_dif_avx(&cr, &ci, &dr, &di, c, d);
+                _mm256_storeu_pd(r + k, ar);
+                _mm256_storeu_pd(i + k, ai);
+                _mm256_storeu_pd(r + k + q, br);
+                _mm256_storeu_pd(i + k + q, bi);
+                _mm256_storeu_pd(r + k + half, cr);
+                _mm256_storeu_pd(i + k + half, ci);
+                _mm256_storeu_pd(r + k + half + q, dr);
+                _mm256_storeu_pd(i + k + half + q, di);
+            }
+        }
+    }
+    for (; half > 0; half >>= 1) {
+        const double *wr = tw_re + half, *wi = tw_im + half;
+        if (half < 4) {
+            sliding_dif_stage_scalar(re, im, size, half, wr, wi);
+            continue;
+        }
+        for (size_t s = 0; s < size; s += 2 * half) {
+            double *r = re + s, *i = im + s;
+            for (size_t k = 0; k < half; k += 4) {
+                __m256d ar = _mm256_loadu_pd(r + k), ai = _mm256_loadu_pd(i + k);
+                __m256d br = _mm256_loadu_pd(r + k + half), bi = _mm256_loadu_pd(i + k + half);
+                sliding_dif_avx(&ar, &ai, &br, &bi, _mm256_loadu_pd(wr + k),
+                                _mm256_loadu_pd(wi + k));
+                _mm256_storeu_pd(r + k, ar);
+                _mm256_storeu_pd(i + k, ai);
+                _mm256_storeu_pd(r + k + half, br);
+                _mm256_storeu_pd(i + k + half, bi);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx"))) static void sliding_ifft_avx(double *re, double *im,
+                                                            size_t size, const double *tw_re,
+                                                            const double *tw_im) {
+    size_t half = 1;
+    for (; half < size && half < 4; half <<= 1)
+        sliding_dit_stage_scalar(re, im, size, half, tw_re + half, tw_im + half);
+    /* An odd number of vector stages leaves one unfused stage first. */
+    size_t vector_stages = 0;
+    for (size_t h = half; h < size; h <<= 1) ++vector_stages;
+    for (; vector_stages % 2 == 1; --vector_stages, half <<= 1) {
+        const double *wr = tw_re + half, *wi = tw_im + half;
+        for (size_t s = 0; s < size; s += 2 * half) {
+            double *r = re + s, *i = im + s;
+            for (size_t k = 0; k < half; k += 4) {
+                __m256d ar = _mm256_loadu_pd(r + k), ai = _mm256_loadu_pd(i + k);
+                __m256d br = _mm256_loadu_pd(r + k + half), bi = _mm256_loadu_pd(i + k + half);
+                sliding_dit_avx(&ar, &ai, &br, &bi, _mm256_loadu_pd(wr + k),
+                                _mm256_loadu_pd(wi + k));
+                _mm256_storeu_pd(r + k, ar);
+                _mm256_storeu_pd(i + k, ai);
+                _mm256_storeu_pd(r + k + half, br);
+                _mm256_storeu_pd(i + k + half, bi);
+            }
+        }
+    }
+    for (; half < size; half <<= 2) {
+        /* Stages q = half and 2 * half in one pass. */
+        const size_t q = half, h = half << 1;
+        const double *vr = tw_re + q, *vi = tw_im + q;
+        const double *wr = tw_re + h, *wi = tw_im + h;
+        for (size_t s = 0; s < size; s += 2 * h) {
+            double *r = re + s, *i = im + s;
+            for (size_t k = 0; k < q; k += 4) {
+                __m256d ar = _mm256_loadu_pd(r + k), ai = _mm256_loadu_pd(i + k);
+                __m256d br = _mm256_loadu_pd(r + k + q), bi = _mm256_loadu_pd(i + k + q);
+                __m256d cr = _mm256_loadu_pd(r + k + h), ci = _mm256_loadu_pd(i + k + h);
+                __m256d dr = _mm256_loadu_pd(r + k + h + q), di = _mm256_loadu_pd(i + k + h + q);
+                __m256d c = _mm256_loadu_pd(vr + k), d = _mm256_loadu_pd(vi + k);
+                sliding_dit_avx(&ar, &ai, &br, &bi, c, d);
+                sliding_dit_avx(&cr, &ci, &dr, &di, c, d);
+                sliding_dit_avx(&ar, &ai, &cr, &ci, _mm256_loadu_pd(wr + k),
+                                _mm256_loadu_pd(wi + k));
+                sliding_dit_avx(&br, &bi, &dr, &di, _mm256_loadu_pd(wr + k + q),
+                                _mm256_loadu_pd(wi + k + q));
+                _mm256_storeu_pd(r + k, ar);
+                _mm256_storeu_pd(i + k, ai);
+                _mm256_storeu_pd(r + k + q, br);
+                _mm256_storeu_pd(i + k + q, bi);
+                _mm256_storeu_pd(r + k + h, cr);
+                _mm256_storeu_pd(i + k + h, ci);
+                _mm256_storeu_pd(r + k + h + q, dr);
+                _mm256_storeu_pd(i + k + h + q, di);
+            }
+        }
+    }
+}
+#endif
+
+#if defined(__aarch64__)
+static void sliding_fft_neon(double *re, double *im, size_t size, const double *tw_re,
+                             const double *tw_im) {
+    for (size_t half = size >> 1; half > 0; half >>= 1) {
+        const double *wr = tw_re + half, *wi = tw_im + half;
+        if (half < 2) {
+            sliding_dif_stage_scalar(re, im, size, half, wr, wi);
+            continue;
+        }
+        for (size_t s = 0; s < size; s += 2 * half) {
+            double *ar = re + s, *ai = im + s, *br = re + s + half, *bi = im + s + half;
+            for (size_t k = 0; k < half; k += 2) {
+                float64x2_t xr = vld1q_f64(ar + k), xi = vld1q_f64(ai + k);
+                float64x2_t yr = vld1q_f64(br + k), yi = vld1q_f64(bi + k);
+                float64x2_t c = vld1q_f64(wr + k), d = vld1q_f64(wi + k);
+                float64x2_t dr = vsubq_f64(xr, yr), di = vsubq_f64(xi, yi);
+                vst1q_f64(ar + k, vaddq_f64(xr, yr));
+                vst1q_f64(ai + k, vaddq_f64(xi, yi));
+                vst1q_f64(br + k, vsubq_f64(vmulq_f64(dr, c), vmulq_f64(di, d)));
+                vst1q_f64(bi + k, vaddq_f64(vmulq_f64(dr, d), vmulq_f64(di, c)));
+            }
+        }
+    }
+}
+
+static void sliding_ifft_neon(double *re, double *im, size_t size, const double *tw_re,
+                              const double *tw_im) {
+    for (size_t half = 1; half < size; half <<= 1) {
+        const double *wr = tw_re + half, *wi = tw_im + half;
+        if (half < 2) {
+            sliding_dit_stage_scalar(re, im, size, half, wr, wi);
+            continue;
+        }
+        for (size_t s = 0; s < size; s += 2 * half) {
+            double *ar = re + s, *ai = im + s, *br = re + s + half, *bi = im + s + half;
+            for (size_t k = 0; k < half; k += 2) {
+                float64x2_t yr = vld1q_f64(br + k), yi = vld1q_f64(bi + k);
+                float64x2_t c = vld1q_f64(wr + k), d = vld1q_f64(wi + k);
+                float64x2_t xr = vaddq_f64(vmulq_f64(yr, c), vmulq_f64(yi, d));
+                float64x2_t xi = vsubq_f64(vmulq_f64(yi, c), vmulq_f64(yr, d));
+                float64x2_t zr = vld1q_f64(ar + k), zi = vld1q_f64(ai + k);
+                vst1q_f64(br + k, vsubq_f64(zr, xr));
+                vst1q_f64(bi + k, vsubq_f64(zi, xi));
+                vst1q_f64(ar + k, vaddq_f64(zr, xr));
+                vst1q_f64(ai + k, vaddq_f64(zi, xi));
+            }
+        }
+    }
+}
+#endif
+
+static const hsd_sliding_kernels_t sliding_kernels_scalar = {
+    sliding_dot_scalar, sliding_sqdiff_scalar, sliding_fft_scalar, sliding_ifft_scalar, "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_sliding_kernels_t sliding_kernels_avx = {
+    sliding_dot_avx, sliding_sqdiff_avx, sliding_fft_avx, sliding_ifft_avx, "AVX"};
+static const hsd_sliding_kernels_t sliding_kernels_avx2 = {
+    sliding_dot_avx2, sliding_sqdiff_avx2, sliding_fft_avx, sliding_ifft_avx, "AVX2"};
+static const hsd_sliding_kernels_t sliding_kernels_avx512 = {
+    sliding_dot_avx512, sliding_sqdiff_avx512, sliding_fft_avx, sliding_ifft_avx, "AVX512F"};
+#endif
+#if defined(__aarch64__)
+static const hsd_sliding_kernels_t sliding_kernels_neon = {
+    sliding_dot_neon, sliding_sqdiff_neon, sliding_fft_neon, sliding_ifft_neon, "NEON"};
+#if defined(__ARM_FEATURE_SVE)
+static const hsd_sliding_kernels_t sliding_kernels_sve = {
+    sliding_dot_sve, sliding_sqdiff_sve, sliding_fft_neon, sliding_ifft_neon, "SVE"};
+#endif
+#endif
+
+static const hsd_sliding_kernels_t *resolve_sliding_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_sliding_kernels_t *chosen = &sliding_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Sliding: Manual backend requested: %d", forced);
+        bool ok = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = &sliding_kernels_avx512;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2() && hsd_cpu_has_fma()) {
+                    chosen = &sliding_kernels_avx2;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen = &sliding_kernels_avx;
+                    ok = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = &sliding_kernels_sve;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = &sliding_kernels_neon;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                ok = true;
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            hsd_log("Forced backend %d not supported, fallback to scalar", forced);
+            chosen = &sliding_kernels_scalar;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &sliding_kernels_avx512;
+        else if (hsd_cpu_has_avx2() && hsd_cpu_has_fma())
+            chosen = &sliding_kernels_avx2;
+        else if (hsd_cpu_has_avx())
+            chosen = &sliding_kernels_avx;
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve())
+            chosen = &sliding_kernels_sve;
+        else if (hsd_cpu_has_neon())
+            chosen = &sliding_kernels_neon;
+#else
+        if (hsd_cpu_has_neon()) chosen = &sliding_kernels_neon;
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved sliding kernels to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_sliding_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_sliding_kernels_t *sliding_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_sliding_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_sliding_kernels_t *)cur;
+    const hsd_sliding_kernels_t *resolved = resolve_sliding_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_sliding_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+/* HSD_PRECISION_F64 for short queries: one vectorized f64 reduction per window. */
+static void sliding_direct_precise(const float *q, size_t n, const float *t, size_t count, int sq,
+                                   float *out) {
+    for (size_t i = 0; i < count; ++i)
+        out[i] = (float)(sq ? hsd_internal_precise_sq_diff_f32(t + i, q, n)
+                            : hsd_internal_precise_dot_f32(q, t + i, n));
+}
+
+/* HSD_PRECISION_DETERMINISTIC for short queries: sequential f64 sums in index order. */
+static void sliding_direct_sequential(const float *q, size_t n, const float *t, size_t count,
+                                      int sq, float *out) {
+    for (size_t i = 0; i < count; ++i) {
+        double sum = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            double x = sq ? (double)t[i + k] - (double)q[k] : (double)q[k] * (double)t[i + k];
+            sum += sq ? x * x : x;
+        }
+        out[i] = (float)sum;
+    }
+}
+
+typedef struct {
+    const hsd_sliding_kernels_t *kernels;
+    HSD_Precision precision; /* selects the direct kernel */
+    const float *q;
+    size_t n;
+    const float *t;
+    size_t len;
+    size_t count;
+    int sq;
+    float *out;
+    /* FFT path */
+    size_t size;
+    size_t step;
+    double q_norm;
+    const double *tw_re;
+    const double *tw_im;
+    const double *q_re; /* query spectrum */
+    const double *q_im;
+    double *scratch; /* 2 * size doubles per slot */
+} hsd_sliding_job_t;
+
+static hsd_status_t sliding_direct_task(void *ctx, size_t task, size_t slot) {
+    (void)slot;
+    hsd_sliding_job_t *job = (hsd_sliding_job_t *)ctx;
+    size_t start = task * HSD_SLIDING_CHUNK;
+    size_t count =
+        job->count - start < HSD_SLIDING_CHUNK ? job->count - start : HSD_SLIDING_CHUNK;
+    const float *t = job->t + start;
+    float *out = job->out + start;
+    if (job->precision == HSD_PRECISION_F64)
+        sliding_direct_precise(job->q, job->n, t, count, job->sq, out);
+    else if (job->precision == HSD_PRECISION_DETERMINISTIC)
+        sliding_direct_sequential(job->q, job->n, t, count, job->sq, out);
+    else if (job->sq)
+        job->kernels->sqdiff(job->q, job->n, t, count, out);
+    else
+        job->kernels->dot(job->q, job->n, t, count, out);
+    return HSD_SUCCESS;
+}
+
+/* Turns the dot products of outputs [start, start + count) into squared distances. */
+static void sliding_finish_sq(const hsd_sliding_job_t *job, size_t start, size_t count,
+                              const double *dots, double scale) {
+    const float *t = job->t + start;
+    double w = 0.0;
+    for (size_t k = 0; k < job->n; ++k) w += (double)t[k] * t[k];
+    for (size_t i = 0; i < count; ++i) {
+        double d = job->q_norm + w - 2.0 * dots[i] * scale;
+        job->out[start + i] = (float)(d > 0.0 ? d : 0.0);
+        if (i + 1 < count) w += (double)t[i + job->n] * t[i + job->n] - (double)t[i] * t[i];
+    }
+}
+
+/* One task correlates two consecutive blocks, packed as the real and imaginary input. */
+static hsd_status_t sliding_fft_task(void *ctx, size_t task, size_t slot) {
+    hsd_sliding_job_t *job = (hsd_sliding_job_t *)ctx;
+    const size_t size = job->size;
+    double *re = job->scratch + 2 * size * slot, *im = re + size;
+    size_t start[2], count[2];
+    for (int b = 0; b < 2; ++b) {
+        start[b] = (2 * task + b) * job->step;
+        count[b] = start[b] < job->count ? job->count - start[b] : 0;
+        if (count[b] > job->step) count[b] = job->step;
+    }
+    for (size_t l = 0; l < size; ++l) {
+        re[l] = start[0] + l < job->len ? job->t[start[0] + l] : 0.0;
+        im[l] = count[1] > 0 && start[1] + l < job->len ? job->t[start[1] + l] : 0.0;
+    }
+    job->kernels->fft(re, im, size, job->tw_re, job->tw_im);
+    /* Multiplying by conj(Q) turns the convolution into a correlation. */
+    for (size_t l = 0; l < size; ++l) {
+        double xr = re[l], xi = im[l];
+        re[l] = xr * job->q_re[l] + xi * job->q_im[l];
+        im[l] = xi * job->q_re[l] - xr * job->q_im[l];
+    }
+    job->kernels->ifft(re, im, size, job->tw_re, job->tw_im);
+    const double scale = 1.0 / (double)size;
+    if (job->sq) {
+        sliding_finish_sq(job, start[0], count[0], re, scale);
+        if (count[1] > 0) sliding_finish_sq(job, start[1], count[1], im, scale);
+        return HSD_SUCCESS;
+    }
+    for (size_t i = 0; i < count[0]; ++i) job->out[start[0] + i] = (float)(re[i] * scale);
+    for (size_t i = 0; i < count[1]; ++i) job->out[start[1] + i] = (float)(im[i] * scale);
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t sliding_run_fft(hsd_sliding_job_t *job) {
+    size_t size = 64;
+    while (size < 4 * job->n && size < job->len) size <<= 1;
+    job->size = size;
+    job->step = size - job->n + 1;
+    size_t blocks = (job->count + job->step - 1) / job->step;
+    size_t tasks = (blocks + 1) / 2;
+    size_t slots = hsd_get_num_threads();
+    if (slots > tasks) slots = tasks;
+
+    double *mem = (double *)malloc((4 + 2 * slots) * size * sizeof(double));
+    if (mem == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    double *tw_re = mem, *tw_im = mem + size, *q_re = tw_im + size, *q_im = q_re + size;
+    for (size_t half = 1; half < size; half <<= 1) {
+        for (size_t k = 0; k < half; ++k) {
+            double angle = -3.14159265358979323846 * (double)k / (double)half;
+            tw_re[half + k] = cos(angle);
+            tw_im[half + k] = sin(angle);
+        }
+    }
+    job->q_norm = 0.0;
+    for (size_t l = 0; l < size; ++l) {
+        q_re[l] = l < job->n ? job->q[l] : 0.0;
+        q_im[l] = 0.0;
+        job->q_norm += q_re[l] * q_re[l];
+    }
+    job->kernels->fft(q_re, q_im, size, tw_re, tw_im);
+    job->tw_re = tw_re;
+    job->tw_im = tw_im;
+    job->q_re = q_re;
+    job->q_im = q_im;
+    job->scratch = q_im + size;
+    hsd_status_t status = hsd_internal_parallel_for(tasks, slots, sliding_fft_task, job);
+    free(mem);
+    return status;
+}
+
+static hsd_status_t sliding_run(const float *q, size_t n, const float *t, size_t len, int sq,
+                                float *out) {
+    if (q == NULL || t == NULL || out == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0 || n > len) return HSD_ERR_INVALID_INPUT;
+#if HSD_ALLOW_FP_CHECKS
+    for (size_t k = 0; k < n; ++k) {
+        if (isnan(q[k]) || isinf(q[k])) return HSD_ERR_INVALID_INPUT;
+    }
+    for (size_t k = 0; k < len; ++k) {
+        if (isnan(t[k]) || isinf(t[k])) return HSD_ERR_INVALID_INPUT;
+    }
+#endif
+    hsd_sliding_job_t job;
+    job.q = q;
+    job.n = n;
+    job.t = t;
+    job.len = len;
+    job.count = len - n + 1;
+    job.sq = sq;
+    job.out = out;
+    hsd_log("Sliding F32: n=%zu len=%zu sq=%d", n, len, sq);
+
+    job.kernels = sliding_kernels();
+    job.precision = hsd_get_precision();
+    if (n >= HSD_SLIDING_FFT_MIN) return sliding_run_fft(&job);
+    size_t tasks = (job.count + HSD_SLIDING_CHUNK - 1) / HSD_SLIDING_CHUNK;
+    return hsd_internal_parallel_for(tasks, hsd_get_num_threads(), sliding_direct_task, &job);
+}
+
+hsd_status_t hsd_sim_dot_sliding_f32(const float *query, size_t n, const float *signal,
+                                     size_t len, float *out) {
+    return sliding_run(query, n, signal, len, 0, out);
+}
+
+hsd_status_t hsd_dist_sqeuclidean_sliding_f32(const float *query, size_t n, const float *signal,
+                                              size_t len, float *out) {
+    return sliding_run(query, n, signal, len, 1, out);
+}
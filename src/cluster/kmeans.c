@@ -0,0 +1,373 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#define HSD_KMEANS_DEFAULT_ITERATIONS 25
+#define HSD_KMEANS_DEFAULT_MINIBATCH_ITERATIONS 100
+#define HSD_KMEANS_SEED_SAMPLE_PER_CLUSTER 16
+#define HSD_KMEANS_POINT_BLOCK 64
+#define HSD_KMEANS_CENTROID_BLOCK_BYTES (128 * 1024)
+
+/*
+ * Shared state for one assignment pass. Points are handed out to the thread pool in blocks of
+ * HSD_KMEANS_POINT_BLOCK rows; each block is scored against the centroids a cache-sized
+ * slice at a time, so a slice stays resident while every row of the block uses it.
+ */
+typedef struct {
+    const float *points;
+    size_t n;
+    const float *point_norms;
+    const float *centroids;
+    size_t k;
+    const float *centroid_norms;
+    size_t dim;
+    bool inner_product;
+    uint32_t *assign;
+    float *best;
+    size_t centroid_block;
+    float *scratch;
+} hsd_kmeans_assign_job_t;
+
+static void kmeans_assign_rows(hsd_kmeans_assign_job_t *job, size_t begin, size_t end,
+                               float *dots) {
+    const size_t rows = end - begin;
+    const float *x = job->points + begin * job->dim;
+    /* Centroid 0 stands in until a finite score beats +inf, so all-NaN rows stay in range. */
+    for (size_t i = begin; i < end; ++i) {
+        job->best[i] = INFINITY;
+        job->assign[i] = 0;
+    }
+    for (size_t c0 = 0; c0 < job->k; c0 += job->centroid_block) {
+        size_t nc = job->k - c0 < job->centroid_block ? job->k - c0 : job->centroid_block;
+        hsd_internal_dot_block_f32(x, rows, job->dim, job->centroids + c0 * job->dim, nc,
+                                   job->dim, job->dim, dots, nc);
+        for (size_t r = 0; r < rows; ++r) {
+            const float *row = dots + r * nc;
+            float best = job->best[begin + r];
+            uint32_t arg = job->assign[begin + r];
+            for (size_t j = 0; j < nc; ++j) {
+                float score = job->inner_product ? -row[j]
+                                                 : job->point_norms[begin + r] - 2.0f * row[j] +
+                                                       job->centroid_norms[c0 + j];
+                if (score < best) {
+                    best = score;
+                    arg = (uint32_t)(c0 + j);
+                }
+            }
+            job->best[begin + r] = best;
+            job->assign[begin + r] = arg;
+        }
+    }
+    /* The expanded form can dip slightly below zero through cancellation. */
+    if (!job->inner_product) {
+        for (size_t i = begin; i < end; ++i) {
+            if (job->best[i] < 0.0f) job->best[i] = 0.0f;
+        }
+    }
+}
+
+static hsd_status_t kmeans_assign_task(void *ctx, size_t block, size_t slot) {
+    hsd_kmeans_assign_job_t *job = (hsd_kmeans_assign_job_t *)ctx;
+    float *dots = job->scratch + slot * HSD_KMEANS_POINT_BLOCK * job->centroid_block;
+    size_t begin = block * HSD_KMEANS_POINT_BLOCK;
+    size_t end = begin + HSD_KMEANS_POINT_BLOCK < job->n ? begin + HSD_KMEANS_POINT_BLOCK : job->n;
+    kmeans_assign_rows(job, begin, end, dots);
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_internal_kmeans_assign(const float *points, size_t n, const float *point_norms,
+                                        const float *centroids, size_t k,
+                                        const float *centroid_norms, size_t dim,
+                                        bool inner_product, uint32_t *assign, float *best) {
+    if (n == 0 || k == 0) return HSD_SUCCESS;
+    hsd_kmeans_assign_job_t job;
+    job.points = points;
+    job.n = n;
+    job.point_norms = point_norms;
+    job.centroids = centroids;
+    job.k = k;
+    job.centroid_norms = centroid_norms;
+    job.dim = dim;
+    job.inner_product = inner_product;
+    job.assign = assign;
+    job.best = best;
+    job.centroid_block = HSD_KMEANS_CENTROID_BLOCK_BYTES / (dim * sizeof(float));
+    job.centroid_block -= job.centroid_block % 4;
+    if (job.centroid_block < 4) job.centroid_block = 4;
+    if (job.centroid_block > k) job.centroid_block = k;
+
+    size_t blocks = (n + HSD_KMEANS_POINT_BLOCK - 1) / HSD_KMEANS_POINT_BLOCK;
+    size_t slots = hsd_get_num_threads();
+    if (slots > blocks) slots = blocks;
+    job.scratch =
+        (float *)malloc(slots * HSD_KMEANS_POINT_BLOCK * job.centroid_block * sizeof(float));
+    if (job.scratch == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    hsd_status_t status = hsd_internal_parallel_for(blocks, slots, kmeans_assign_task, &job);
+    free(job.scratch);
+    return status;
+}
+
+static uint64_t kmeans_splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static double kmeans_uniform(uint64_t *state) {
+    return (double)(kmeans_splitmix64(state) >> 11) * 0x1.0p-53;
+}
+
+/* Squared L2 norms of n contiguous rows; also rejects NaN and infinite input. */
+static hsd_status_t kmeans_norms(const float *rows, size_t n, size_t dim, float *norms) {
+    for (size_t i = 0; i < n; ++i) {
+        hsd_status_t status = hsd_sim_dot_f32(rows + i * dim, rows + i * dim, dim, &norms[i]);
+        if (status != HSD_SUCCESS) return status;
+    }
+    return HSD_SUCCESS;
+}
+
+/*
+ * Greedy k-means++ seeding over the given rows: each step draws a few candidates with
+ * probability proportional to their squared distance from the closest centroid chosen so far,
+ * and keeps the one that lowers the total potential the most. All candidates are scored in a
+ * single dot-block pass over the rows.
+ */
+static hsd_status_t kmeans_plusplus(const float *rows, const float *norms, size_t n, size_t dim,
+                                    size_t k, float *centroids, uint64_t *rng) {
+    const size_t trials = 2 + (size_t)log((double)k);
+    float *d2 = (float *)malloc(n * sizeof(float));
+    float *dots = (float *)malloc(n * trials * sizeof(float));
+    float *candidates = (float *)malloc(trials * dim * sizeof(float));
+    size_t *picks = (size_t *)malloc(trials * sizeof(size_t));
+    if (d2 == NULL || dots == NULL || candidates == NULL || picks == NULL) {
+        free(d2);
+        free(dots);
+        free(candidates);
+        free(picks);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+
+    size_t first = (size_t)(kmeans_splitmix64(rng) % n);
+    memcpy(centroids, rows + first * dim, dim * sizeof(float));
+    hsd_internal_dot_block_f32(rows, n, dim, rows + first * dim, 1, dim, dim, dots, 1);
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        float d = norms[i] - 2.0f * dots[i] + norms[first];
+        d2[i] = d > 0.0f ? d : 0.0f;
+        total += d2[i];
+    }
+
+    for (size_t c = 1; c < k; ++c) {
+        for (size_t t = 0; t < trials; ++t) {
+            size_t pick = (size_t)(kmeans_splitmix64(rng) % n);
+            if (total > 0.0) {
+                double target = kmeans_uniform(rng) * total, acc = 0.0;
+                for (size_t i = 0; i < n; ++i) {
+                    acc += d2[i];
+                    if (acc > target && d2[i] > 0.0f) {
+                        pick = i;
+                        break;
+                    }
+                }
+            }
+            picks[t] = pick;
+            memcpy(candidates + t * dim, rows + pick * dim, dim * sizeof(float));
+        }
+
+        hsd_internal_dot_block_f32(rows, n, dim, candidates, trials, dim, dim, dots, trials);
+        size_t best = 0;
+        double best_total = INFINITY;
+        for (size_t t = 0; t < trials; ++t) {
+            double potential = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                float d = norms[i] - 2.0f * dots[i * trials + t] + norms[picks[t]];
+                potential += d < d2[i] ? (d > 0.0f ? d : 0.0f) : d2[i];
+            }
+            if (potential < best_total) {
+                best_total = potential;
+                best = t;
+            }
+        }
+
+        memcpy(centroids + c * dim, candidates + best * dim, dim * sizeof(float));
+        total = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            float d = norms[i] - 2.0f * dots[i * trials + best] + norms[picks[best]];
+            if (d < d2[i]) d2[i] = d > 0.0f ? d : 0.0f;
+            total += d2[i];
+        }
+    }
+    free(d2);
+    free(dots);
+    free(candidates);
+    free(picks);
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t kmeans_seed(const float *data, const float *norms, size_t n, size_t dim,
+                                size_t k, size_t sample, float *centroids, uint64_t *rng) {
+    if (sample >= n) return kmeans_plusplus(data, norms, n, dim, k, centroids, rng);
+
+    /* Seed on a random subset so that mini-batch runs stay sublinear in n. */
+    float *rows = (float *)malloc(sample * dim * sizeof(float));
+    float *sample_norms = (float *)malloc(sample * sizeof(float));
+    hsd_status_t status = HSD_ERR_OUT_OF_MEMORY;
+    if (rows != NULL && sample_norms != NULL) {
+        for (size_t i = 0; i < sample; ++i) {
+            size_t src = (size_t)(kmeans_splitmix64(rng) % n);
+            memcpy(rows + i * dim, data + src * dim, dim * sizeof(float));
+            sample_norms[i] = norms[src];
+        }
+        status = kmeans_plusplus(rows, sample_norms, sample, dim, k, centroids, rng);
+    }
+    free(rows);
+    free(sample_norms);
+    return status;
+}
+
+static hsd_status_t kmeans_lloyd(const float *data, const float *norms, size_t n, size_t dim,
+                                 size_t k, size_t iterations, float *centroids,
+                                 float *centroid_norms, uint32_t *assign, float *best) {
+    uint32_t *previous = (uint32_t *)malloc(n * sizeof(uint32_t));
+    size_t *members = (size_t *)malloc(k * sizeof(size_t));
+    double *sums = (double *)malloc(k * dim * sizeof(double));
+    hsd_status_t status = HSD_ERR_OUT_OF_MEMORY;
+    if (previous == NULL || members == NULL || sums == NULL) iterations = 0;
+
+    for (size_t iter = 0; iter < iterations; ++iter) {
+        status = kmeans_norms(centroids, k, dim, centroid_norms);
+        if (status == HSD_SUCCESS)
+            status = hsd_internal_kmeans_assign(data, n, norms, centroids, k, centroid_norms, dim,
+                                                false, assign, best);
+        if (status != HSD_SUCCESS) break;
+        if (iter > 0 && memcmp(assign, previous, n * sizeof(uint32_t)) == 0) break;
+        memcpy(previous, assign, n * sizeof(uint32_t));
+
+        memset(members, 0, k * sizeof(size_t));
+        memset(sums, 0, k * dim * sizeof(double));
+        for (size_t i = 0; i < n; ++i) {
+            const float *p = data + i * dim;
+            double *sum = sums + (size_t)assign[i] * dim;
+            for (size_t d = 0; d < dim; ++d) sum[d] += p[d];
+            members[assign[i]]++;
+        }
+        for (size_t c = 0; c < k; ++c) {
+            float *centroid = centroids + c * dim;
+            if (members[c] == 0) {
+                /* Reseed an empty cluster with the point that is currently worst served. */
+                size_t far = 0;
+                for (size_t i = 1; i < n; ++i) {
+                    if (best[i] > best[far]) far = i;
+                }
+                memcpy(centroid, data + far * dim, dim * sizeof(float));
+                best[far] = 0.0f;
+                continue;
+            }
+            for (size_t d = 0; d < dim; ++d)
+                centroid[d] = (float)(sums[c * dim + d] / (double)members[c]);
+        }
+    }
+    free(previous);
+    free(members);
+    free(sums);
+    return status;
+}
+
+/* Mini-batch k-means (Sculley 2010): per-centroid learning rate 1 / (points seen so far). */
+static hsd_status_t kmeans_minibatch(const float *data, const float *norms, size_t n, size_t dim,
+                                     size_t k, size_t batch, size_t iterations, float *centroids,
+                                     float *centroid_norms, uint64_t *rng) {
+    float *rows = (float *)malloc(batch * dim * sizeof(float));
+    float *batch_norms = (float *)malloc(batch * sizeof(float));
+    uint32_t *assign = (uint32_t *)malloc(batch * sizeof(uint32_t));
+    float *best = (float *)malloc(batch * sizeof(float));
+    size_t *seen = (size_t *)calloc(k, sizeof(size_t));
+    hsd_status_t status = HSD_ERR_OUT_OF_MEMORY;
+    if (rows != NULL && batch_norms != NULL && assign != NULL && best != NULL && seen != NULL)
+        status = HSD_SUCCESS;
+
+    for (size_t iter = 0; status == HSD_SUCCESS && iter < iterations; ++iter) {
+        for (size_t i = 0; i < batch; ++i) {
+            size_t src = (size_t)(kmeans_splitmix64(rng) % n);
+            memcpy(rows + i * dim, data + src * dim, dim * sizeof(float));
+            batch_norms[i] = norms[src];
+        }
+        status = kmeans_norms(centroids, k, dim, centroid_norms);
+        if (status == HSD_SUCCESS)
+            status = hsd_internal_kmeans_assign(rows, batch, batch_norms, centroids, k,
+                                                centroid_norms, dim, false, assign, best);
+        for (size_t i = 0; status == HSD_SUCCESS && i < batch; ++i) {
+            float *centroid = centroids + (size_t)assign[i] * dim;
+            const float *p = rows + i * dim;
+            float eta = 1.0f / (float)(++seen[assign[i]]);
+            for (size_t d = 0; d < dim; ++d) centroid[d] += eta * (p[d] - centroid[d]);
+        }
+    }
+    free(rows);
+    free(batch_norms);
+    free(assign);
+    free(best);
+    free(seen);
+    return status;
+}
+
+hsd_status_t hsd_kmeans_f32(const float *data, size_t n, size_t dim, size_t k,
+                            const hsd_kmeans_params_t *params, float *centroids, uint32_t *labels,
+                            float *inertia) {
+    if (data == NULL || centroids == NULL) return HSD_ERR_NULL_PTR;
+    if (dim == 0 || k == 0 || k > n || k > UINT32_MAX) return HSD_ERR_INVALID_INPUT;
+
+    size_t batch = params != NULL ? params->batch_size : 0;
+    if (batch >= n) batch = 0;
+    size_t iterations = params != NULL ? params->max_iterations : 0;
+    if (iterations == 0)
+        iterations =
+            batch ? HSD_KMEANS_DEFAULT_MINIBATCH_ITERATIONS : HSD_KMEANS_DEFAULT_ITERATIONS;
+    uint64_t rng = params != NULL ? params->seed : 0;
+    hsd_log("KMeans F32: n=%zu dim=%zu k=%zu batch=%zu iterations=%zu", n, dim, k, batch,
+            iterations);
+
+    float *norms = (float *)malloc(n * sizeof(float));
+    float *centroid_norms = (float *)malloc(k * sizeof(float));
+    uint32_t *assign = labels != NULL ? labels : (uint32_t *)malloc(n * sizeof(uint32_t));
+    float *best = (float *)malloc(n * sizeof(float));
+    hsd_status_t status = HSD_ERR_OUT_OF_MEMORY;
+    if (norms != NULL && centroid_norms != NULL && assign != NULL && best != NULL)
+        status = kmeans_norms(data, n, dim, norms);
+
+    if (status == HSD_SUCCESS) {
+        size_t sample = batch ? HSD_KMEANS_SEED_SAMPLE_PER_CLUSTER * k : n;
+        if (batch > sample) sample = batch;
+        status = kmeans_seed(data, norms, n, dim, k, sample, centroids, &rng);
+    }
+    if (status == HSD_SUCCESS) {
+        if (batch)
+            status = kmeans_minibatch(data, norms, n, dim, k, batch, iterations, centroids,
+                                      centroid_norms, &rng);
+        else
+            status = kmeans_lloyd(data, norms, n, dim, k, iterations, centroids, centroid_norms,
+                                  assign, best);
+    }
+    /* Final labels and inertia always refer to the returned centroids. */
+    if (status == HSD_SUCCESS && (labels != NULL || inertia != NULL)) {
+        status = kmeans_norms(centroids, k, dim, centroid_norms);
+        if (status == HSD_SUCCESS)
+            status = hsd_internal_kmeans_assign(data, n, norms, centroids, k, centroid_norms, dim,
+                                                false, assign, best);
+        if (status == HSD_SUCCESS && inertia != NULL) {
+            double total = 0.0;
+            for (size_t i = 0; i < n; ++i) total += best[i];
+            *inertia = (float)total;
+        }
+    }
+
+    free(norms);
+    free(centroid_norms);
+    if (assign != labels) free(assign);
+    free(best);
+    return status;
+}
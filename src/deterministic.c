@@ -0,0 +1,405 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/*
+ * Kernels behind HSD_PRECISION_DETERMINISTIC. Every backend emulates the same HSD_DET_LANES
+ * virtual f32 lanes: element i is always added to lane i % HSD_DET_LANES, products and
+ * differences are rounded before they are added (no FMA), the tail is added lane by lane in
+ * scalar code, and the lanes are folded by the same halving tree. IEEE-754 then gives the same
+ * bits on every CPU, whatever its native vector width.
+ */
+#define HSD_DET_LANES 16
+
+/* Contracting a multiply and an add into an FMA would change the rounding on some CPUs only. */
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+typedef struct {
+    void (*dot)(const float *a, const float *b, size_t n, float *lanes);
+    void (*sq_diff)(const float *a, const float *b, size_t n, float *lanes);
+    void (*abs_diff)(const float *a, const float *b, size_t n, float *lanes);
+    void (*sum_abs)(const float *v, size_t n, float *lanes);
+    /* lanes holds the a.b, a.a and b.b lanes one after another. */
+    void (*cosine)(const float *a, const float *b, size_t n, float *lanes);
+    const char *name;
+} hsd_det_kernels_t;
+
+/*
+ * Scalar reference. Each kernel adds elements [start, n) into the lanes; SIMD kernels handle
+ * the whole blocks and then call these for the tail, so tails are identical everywhere.
+ */
+static void det_dot_scalar(const float *a, const float *b, size_t n, float *lanes) {
+    for (size_t i = 0; i < n; ++i) {
+        float p = a[i] * b[i];
+        lanes[i % HSD_DET_LANES] += p;
+    }
+}
+
+static void det_sq_diff_scalar(const float *a, const float *b, size_t n, float *lanes) {
+    for (size_t i = 0; i < n; ++i) {
+        float d = a[i] - b[i];
+        float p = d * d;
+        lanes[i % HSD_DET_LANES] += p;
+    }
+}
+
+static void det_abs_diff_scalar(const float *a, const float *b, size_t n, float *lanes) {
+    for (size_t i = 0; i < n; ++i) lanes[i % HSD_DET_LANES] += fabsf(a[i] - b[i]);
+}
+
+static void det_sum_abs_scalar(const float *v, size_t n, float *lanes) {
+    for (size_t i = 0; i < n; ++i) lanes[i % HSD_DET_LANES] += fabsf(v[i]);
+}
+
+static void det_cosine_scalar(const float *a, const float *b, size_t n, float *lanes) {
+    for (size_t i = 0; i < n; ++i) {
+        float ab = a[i] * b[i], aa = a[i] * a[i], bb = b[i] * b[i];
+        size_t l = i % HSD_DET_LANES;
+        lanes[l] += ab;
+        lanes[HSD_DET_LANES + l] += aa;
+        lanes[2 * HSD_DET_LANES + l] += bb;
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+/* Two 8-lane registers hold lanes 0-7 and 8-15. */
+__attribute__((target("avx"))) static void det_dot_avx(const float *a, const float *b, size_t n,
+                                                       float *lanes) {
+    __m256 lo = _mm256_setzero_ps(), hi = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        lo = _mm256_add_ps(lo, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        hi = _mm256_add_ps(hi,
+                           _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    _mm256_storeu_ps(lanes, lo);
+    _mm256_storeu_ps(lanes + 8, hi);
+    det_dot_scalar(a + i, b + i, n - i, lanes);
+}
+
+__attribute__((target("avx"))) static void det_sq_diff_avx(const float *a, const float *b,
+                                                           size_t n, float *lanes) {
+    __m256 lo = _mm256_setzero_ps(), hi = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        lo = _mm256_add_ps(lo, _mm256_mul_ps(d0, d0));
+        hi = _mm256_add_ps(hi, _mm256_mul_ps(d1, d1));
+    }
+    _mm256_storeu_ps(lanes, lo);
+    _mm256_storeu_ps(lanes + 8, hi);
+    det_sq_diff_scalar(a + i, b + i, n - i, lanes);
+}
+
+__attribute__((target("avx"))) static void det_abs_diff_avx(const float *a, const float *b,
+                                                            size_t n, float *lanes) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 lo = _mm256_setzero_ps(), hi = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        lo = _mm256_add_ps(lo, _mm256_andnot_ps(sign, d0));
+        hi = _mm256_add_ps(hi, _mm256_andnot_ps(sign, d1));
+    }
+    _mm256_storeu_ps(lanes, lo);
+    _mm256_storeu_ps(lanes + 8, hi);
+    det_abs_diff_scalar(a + i, b + i, n - i, lanes);
+}
+
+__attribute__((target("avx"))) static void det_sum_abs_avx(const float *v, size_t n,
+                                                           float *lanes) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 lo = _mm256_setzero_ps(), hi = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        lo = _mm256_add_ps(lo, _mm256_andnot_ps(sign, _mm256_loadu_ps(v + i)));
+        hi = _mm256_add_ps(hi, _mm256_andnot_ps(sign, _mm256_loadu_ps(v + i + 8)));
+    }
+    _mm256_storeu_ps(lanes, lo);
+    _mm256_storeu_ps(lanes + 8, hi);
+    det_sum_abs_scalar(v + i, n - i, lanes);
+}
+
+__attribute__((target("avx"))) static void det_cosine_avx(const float *a, const float *b,
+                                                          size_t n, float *lanes) {
+    __m256 ab_lo = _mm256_setzero_ps(), ab_hi = _mm256_setzero_ps();
+    __m256 aa_lo = _mm256_setzero_ps(), aa_hi = _mm256_setzero_ps();
+    __m256 bb_lo = _mm256_setzero_ps(), bb_hi = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        __m256 x0 = _mm256_loadu_ps(a + i), y0 = _mm256_loadu_ps(b + i);
+        __m256 x1 = _mm256_loadu_ps(a + i + 8), y1 = _mm256_loadu_ps(b + i + 8);
+        ab_lo = _mm256_add_ps(ab_lo, _mm256_mul_ps(x0, y0));
+        ab_hi = _mm256_add_ps(ab_hi, _mm256_mul_ps(x1, y1));
+        aa_lo = _mm256_add_ps(aa_lo, _mm256_mul_ps(x0, x0));
+        aa_hi = _mm256_add_ps(aa_hi, _mm256_mul_ps(x1, x1));
+        bb_lo = _mm256_add_ps(bb_lo, _mm256_mul_ps(y0, y0));
+        bb_hi = _mm256_add_ps(bb_hi, _mm256_mul_ps(y1, y1));
+    }
+    _mm256_storeu_ps(lanes, ab_lo);
+    _mm256_storeu_ps(lanes + 8, ab_hi);
+    _mm256_storeu_ps(lanes + HSD_DET_LANES, aa_lo);
+    _mm256_storeu_ps(lanes + HSD_DET_LANES + 8, aa_hi);
+    _mm256_storeu_ps(lanes + 2 * HSD_DET_LANES, bb_lo);
+    _mm256_storeu_ps(lanes + 2 * HSD_DET_LANES + 8, bb_hi);
+    det_cosine_scalar(a + i, b + i, n - i, lanes);
+}
+
+/* One 16-lane register; the separate multiply and add are never fused. */
+__attribute__((target("avx512f"))) static void det_dot_avx512(const float *a, const float *b,
+                                                              size_t n, float *lanes) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES)
+        acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    _mm512_storeu_ps(lanes, acc);
+    det_dot_scalar(a + i, b + i, n - i, lanes);
+}
+
+__attribute__((target("avx512f"))) static void det_sq_diff_avx512(const float *a, const float *b,
+                                                                  size_t n, float *lanes) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        acc = _mm512_add_ps(acc, _mm512_mul_ps(d, d));
+    }
+    _mm512_storeu_ps(lanes, acc);
+    det_sq_diff_scalar(a + i, b + i, n - i, lanes);
+}
+
+__attribute__((target("avx512f"))) static void det_abs_diff_avx512(const float *a,
+                                                                   const float *b, size_t n,
+                                                                   float *lanes) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES)
+        acc = _mm512_add_ps(
+            acc, _mm512_abs_ps(_mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i))));
+    _mm512_storeu_ps(lanes, acc);
+    det_abs_diff_scalar(a + i, b + i, n - i, lanes);
+}
+
+__attribute__((target("avx512f"))) static void det_sum_abs_avx512(const float *v, size_t n,
+                                                                  float *lanes) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES)
+        acc = _mm512_add_ps(acc, _mm512_abs_ps(_mm512_loadu_ps(v + i)));
+    _mm512_storeu_ps(lanes, acc);
+    det_sum_abs_scalar(v + i, n - i, lanes);
+}
+
+__attribute__((target("avx512f"))) static void det_cosine_avx512(const float *a, const float *b,
+                                                                 size_t n, float *lanes) {
+    __m512 ab = _mm512_setzero_ps(), aa = _mm512_setzero_ps(), bb = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        __m512 x = _mm512_loadu_ps(a + i), y = _mm512_loadu_ps(b + i);
+        ab = _mm512_add_ps(ab, _mm512_mul_ps(x, y));
+        aa = _mm512_add_ps(aa, _mm512_mul_ps(x, x));
+        bb = _mm512_add_ps(bb, _mm512_mul_ps(y, y));
+    }
+    _mm512_storeu_ps(lanes, ab);
+    _mm512_storeu_ps(lanes + HSD_DET_LANES, aa);
+    _mm512_storeu_ps(lanes + 2 * HSD_DET_LANES, bb);
+    det_cosine_scalar(a + i, b + i, n - i, lanes);
+}
+#endif
+
+#if defined(__aarch64__)
+/* Four 4-lane registers; vmulq/vaddq keep the product rounded, unlike vfmaq. */
+static void det_dot_neon(const float *a, const float *b, size_t n, float *lanes) {
+    float32x4_t acc[4] = {vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f),
+                          vdupq_n_f32(0.0f)};
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        for (size_t r = 0; r < 4; ++r) {
+            float32x4_t p = vmulq_f32(vld1q_f32(a + i + 4 * r), vld1q_f32(b + i + 4 * r));
+            acc[r] = vaddq_f32(acc[r], p);
+        }
+    }
+    for (size_t r = 0; r < 4; ++r) vst1q_f32(lanes + 4 * r, acc[r]);
+    det_dot_scalar(a + i, b + i, n - i, lanes);
+}
+
+static void det_sq_diff_neon(const float *a, const float *b, size_t n, float *lanes) {
+    float32x4_t acc[4] = {vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f),
+                          vdupq_n_f32(0.0f)};
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        for (size_t r = 0; r < 4; ++r) {
+            float32x4_t d = vsubq_f32(vld1q_f32(a + i + 4 * r), vld1q_f32(b + i + 4 * r));
+            acc[r] = vaddq_f32(acc[r], vmulq_f32(d, d));
+        }
+    }
+    for (size_t r = 0; r < 4; ++r) vst1q_f32(lanes + 4 * r, acc[r]);
+    det_sq_diff_scalar(a + i, b + i, n - i, lanes);
+}
+
+static void det_abs_diff_neon(const float *a, const float *b, size_t n, float *lanes) {
+    float32x4_t acc[4] = {vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f),
+                          vdupq_n_f32(0.0f)};
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        for (size_t r = 0; r < 4; ++r) {
+            float32x4_t d = vabdq_f32(vld1q_f32(a + i + 4 * r), vld1q_f32(b + i + 4 * r));
+            acc[r] = vaddq_f32(acc[r], d);
+        }
+    }
+    for (size_t r = 0; r < 4; ++r) vst1q_f32(lanes + 4 * r, acc[r]);
+    det_abs_diff_scalar(a + i, b + i, n - i, lanes);
+}
+
+static void det_sum_abs_neon(const float *v, size_t n, float *lanes) {
+    float32x4_t acc[4] = {vdupq_n_f32(0.0f), vdupq_n_f32(0.0f), vdupq_n_f32(0.0f),
+                          vdupq_n_f32(0.0f)};
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        for (size_t r = 0; r < 4; ++r)
+            acc[r] = vaddq_f32(acc[r], vabsq_f32(vld1q_f32(v + i + 4 * r)));
+    }
+    for (size_t r = 0; r < 4; ++r) vst1q_f32(lanes + 4 * r, acc[r]);
+    det_sum_abs_scalar(v + i, n - i, lanes);
+}
+
+static void det_cosine_neon(const float *a, const float *b, size_t n, float *lanes) {
+    float32x4_t ab[4], aa[4], bb[4];
+    for (size_t r = 0; r < 4; ++r) ab[r] = aa[r] = bb[r] = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + HSD_DET_LANES <= n; i += HSD_DET_LANES) {
+        for (size_t r = 0; r < 4; ++r) {
+            float32x4_t x = vld1q_f32(a + i + 4 * r), y = vld1q_f32(b + i + 4 * r);
+            ab[r] = vaddq_f32(ab[r], vmulq_f32(x, y));
+            aa[r] = vaddq_f32(aa[r], vmulq_f32(x, x));
+            bb[r] = vaddq_f32(bb[r], vmulq_f32(y, y));
+        }
+    }
+    for (size_t r = 0; r < 4; ++r) {
+        vst1q_f32(lanes + 4 * r, ab[r]);
+        vst1q_f32(lanes + HSD_DET_LANES + 4 * r, aa[r]);
+        vst1q_f32(lanes + 2 * HSD_DET_LANES + 4 * r, bb[r]);
+    }
+    det_cosine_scalar(a + i, b + i, n - i, lanes);
+}
+#endif
+
+static const hsd_det_kernels_t det_kernels_scalar = {det_dot_scalar,      det_sq_diff_scalar,
+                                                     det_abs_diff_scalar, det_sum_abs_scalar,
+                                                     det_cosine_scalar,   "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_det_kernels_t det_kernels_avx = {det_dot_avx,      det_sq_diff_avx,
+                                                  det_abs_diff_avx, det_sum_abs_avx,
+                                                  det_cosine_avx,   "AVX"};
+static const hsd_det_kernels_t det_kernels_avx512 = {det_dot_avx512,      det_sq_diff_avx512,
+                                                     det_abs_diff_avx512, det_sum_abs_avx512,
+                                                     det_cosine_avx512,   "AVX512F"};
+#elif defined(__aarch64__)
+static const hsd_det_kernels_t det_kernels_neon = {det_dot_neon,     det_sq_diff_neon,
+                                                   det_abs_diff_neon, det_sum_abs_neon,
+                                                   det_cosine_neon,  "NEON"};
+#endif
+
+/* Same choice as the f64 kernels: AVX serves AVX2 and NEON serves SVE. */
+static const hsd_det_kernels_t *resolve_det_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_det_kernels_t *chosen = &det_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Deterministic F32: Manual backend requested: %d", forced);
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) chosen = &det_kernels_avx512;
+                break;
+            case HSD_BACKEND_AVX2:
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) chosen = &det_kernels_avx;
+                break;
+#elif defined(__aarch64__)
+            case HSD_BACKEND_SVE:
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) chosen = &det_kernels_neon;
+                break;
+#endif
+            default:
+                break;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &det_kernels_avx512;
+        else if (hsd_cpu_has_avx())
+            chosen = &det_kernels_avx;
+#elif defined(__aarch64__)
+        if (hsd_cpu_has_neon()) chosen = &det_kernels_neon;
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Deterministic F32 to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_det_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_det_kernels_t *det_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_det_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_det_kernels_t *)cur;
+    const hsd_det_kernels_t *resolved = resolve_det_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_det_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+/* Folds lanes [w, 2w) onto [0, w) for w = 8, 4, 2, 1. */
+static float det_reduce(float *lanes) {
+    for (size_t w = HSD_DET_LANES / 2; w > 0; w /= 2)
+        for (size_t j = 0; j < w; ++j) lanes[j] += lanes[j + w];
+    return lanes[0];
+}
+
+float hsd_internal_det_dot_f32(const float *a, const float *b, size_t n) {
+    float lanes[HSD_DET_LANES] = {0.0f};
+    det_kernels()->dot(a, b, n, lanes);
+    return det_reduce(lanes);
+}
+
+float hsd_internal_det_sq_diff_f32(const float *a, const float *b, size_t n) {
+    float lanes[HSD_DET_LANES] = {0.0f};
+    det_kernels()->sq_diff(a, b, n, lanes);
+    return det_reduce(lanes);
+}
+
+float hsd_internal_det_abs_diff_f32(const float *a, const float *b, size_t n) {
+    float lanes[HSD_DET_LANES] = {0.0f};
+    det_kernels()->abs_diff(a, b, n, lanes);
+    return det_reduce(lanes);
+}
+
+float hsd_internal_det_sum_abs_f32(const float *v, size_t n) {
+    float lanes[HSD_DET_LANES] = {0.0f};
+    det_kernels()->sum_abs(v, n, lanes);
+    return det_reduce(lanes);
+}
+
+void hsd_internal_det_cosine_f32(const float *a, const float *b, size_t n, float sums[3]) {
+    float lanes[3 * HSD_DET_LANES] = {0.0f};
+    det_kernels()->cosine(a, b, n, lanes);
+    for (size_t k = 0; k < 3; ++k) sums[k] = det_reduce(lanes + k * HSD_DET_LANES);
+}
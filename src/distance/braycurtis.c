@@ -0,0 +1,273 @@
+/*
+ * If HSDLIB_NO_CHECKS is defined, all isnan/isinf tests
+ * get compiled out for maximum speed.
+ */
+#ifdef HSDLIB_NO_CHECKS
+#define HSD_ALLOW_FP_CHECKS 0
+#else
+#define HSD_ALLOW_FP_CHECKS 1
+#endif
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+typedef hsd_status_t (*hsd_braycurtis_f32_func_t)(const float *, const float *, size_t, float *);
+
+/*
+ * Bray-Curtis distance: sum of |a - b| divided by sum of |a + b|. Two all-zero vectors are at
+ * distance 0. For non-negative data the result lies in [0, 1]. The kernels only add and take
+ * absolute values, so AVX2 hosts use the AVX kernel.
+ */
+static hsd_status_t braycurtis_store(float num, float den, float *result) {
+    float d = (num == 0.0f && den == 0.0f) ? 0.0f : num / den;
+    *result = d;
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(d) || isinf(d)) return HSD_ERR_INVALID_INPUT;
+#endif
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t braycurtis_scalar_internal(const float *a, const float *b, size_t n,
+                                               float *result) {
+    hsd_log("Enter braycurtis_scalar_internal (n=%zu)", n);
+    float num = 0.0f, den = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        num += fabsf(a[i] - b[i]);
+        den += fabsf(a[i] + b[i]);
+    }
+    return braycurtis_store(num, den, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static hsd_status_t braycurtis_avx_internal(const float *a,
+                                                                           const float *b, size_t n,
+                                                                           float *result) {
+    hsd_log("Enter braycurtis_avx_internal (n=%zu)", n);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 num_acc = _mm256_setzero_ps();
+    __m256 den_acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        num_acc = _mm256_add_ps(num_acc, _mm256_andnot_ps(sign, _mm256_sub_ps(va, vb)));
+        den_acc = _mm256_add_ps(den_acc, _mm256_andnot_ps(sign, _mm256_add_ps(va, vb)));
+    }
+    float num = hsd_internal_hsum_avx_f32(num_acc);
+    float den = hsd_internal_hsum_avx_f32(den_acc);
+    for (; i < n; ++i) {
+        num += fabsf(a[i] - b[i]);
+        den += fabsf(a[i] + b[i]);
+    }
+    return braycurtis_store(num, den, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t braycurtis_avx512_internal(const float *a,
+                                                                                  const float *b,
+                                                                                  size_t n,
+                                                                                  float *result) {
+    hsd_log("Enter braycurtis_avx512_internal (n=%zu)", n);
+    __m512 num_acc = _mm512_setzero_ps();
+    __m512 den_acc = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 in = n - i >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1u);
+        __m512 va = _mm512_maskz_loadu_ps(in, a + i);
+        __m512 vb = _mm512_maskz_loadu_ps(in, b + i);
+        num_acc = _mm512_add_ps(num_acc, _mm512_abs_ps(_mm512_sub_ps(va, vb)));
+        den_acc = _mm512_add_ps(den_acc, _mm512_abs_ps(_mm512_add_ps(va, vb)));
+    }
+    float num = _mm512_reduce_add_ps(num_acc);
+    float den = _mm512_reduce_add_ps(den_acc);
+    return braycurtis_store(num, den, result);
+}
+#endif
+
+#if defined(__aarch64__)
+static hsd_status_t braycurtis_neon_internal(const float *a, const float *b, size_t n,
+                                             float *result) {
+    hsd_log("Enter braycurtis_neon_internal (n=%zu)", n);
+    float32x4_t num_acc = vdupq_n_f32(0.0f);
+    float32x4_t den_acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t va = vld1q_f32(a + i);
+        float32x4_t vb = vld1q_f32(b + i);
+        num_acc = vaddq_f32(num_acc, vabdq_f32(va, vb));
+        den_acc = vaddq_f32(den_acc, vabsq_f32(vaddq_f32(va, vb)));
+    }
+    float num = vaddvq_f32(num_acc);
+    float den = vaddvq_f32(den_acc);
+    for (; i < n; ++i) {
+        num += fabsf(a[i] - b[i]);
+        den += fabsf(a[i] + b[i]);
+    }
+    return braycurtis_store(num, den, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t braycurtis_sve_internal(const float *a,
+                                                                            const float *b,
+                                                                            size_t n,
+                                                                            float *result) {
+    hsd_log("Enter braycurtis_sve_internal (n=%zu)", n);
+    svfloat32_t num_acc = svdup_n_f32(0.0f);
+    svfloat32_t den_acc = svdup_n_f32(0.0f);
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t va = svld1_f32(pg, a + i);
+        svfloat32_t vb = svld1_f32(pg, b + i);
+        num_acc = svadd_f32_m(pg, num_acc, svabd_f32_x(pg, va, vb));
+        den_acc = svadd_f32_m(pg, den_acc, svabs_f32_x(pg, svadd_f32_x(pg, va, vb)));
+    }
+    float num = svaddv_f32(svptrue_b32(), num_acc);
+    float den = svaddv_f32(svptrue_b32(), den_acc);
+    return braycurtis_store(num, den, result);
+}
+#endif
+#endif
+
+static hsd_braycurtis_f32_func_t resolve_braycurtis_f32_internal(void);
+static hsd_status_t braycurtis_f32_resolver_trampoline(const float *a, const float *b, size_t n,
+                                                       float *result);
+
+static atomic_uintptr_t hsd_braycurtis_f32_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)braycurtis_f32_resolver_trampoline);
+
+hsd_status_t hsd_dist_braycurtis_f32(const float *a, const float *b, size_t n, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    hsd_braycurtis_f32_func_t func = (hsd_braycurtis_f32_func_t)atomic_load_explicit(
+        &hsd_braycurtis_f32_ptr, memory_order_acquire);
+    return func(a, b, n, result);
+}
+
+static hsd_status_t braycurtis_f32_resolver_trampoline(const float *a, const float *b, size_t n,
+                                                       float *result) {
+    hsd_log("BrayCurtis F32: resolving backend");
+    hsd_braycurtis_f32_func_t resolved_func = resolve_braycurtis_f32_internal();
+    uintptr_t expected = (uintptr_t)braycurtis_f32_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_braycurtis_f32_ptr, &expected,
+                                            (uintptr_t)resolved_func, memory_order_release,
+                                            memory_order_relaxed);
+    hsd_braycurtis_f32_func_t current_func = (hsd_braycurtis_f32_func_t)atomic_load_explicit(
+        &hsd_braycurtis_f32_ptr, memory_order_acquire);
+    return current_func(a, b, n, result);
+}
+
+static hsd_braycurtis_f32_func_t resolve_braycurtis_f32_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_braycurtis_f32_func_t chosen_func = braycurtis_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("BrayCurtis F32: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen_func = braycurtis_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx()) {
+                    chosen_func = braycurtis_avx_internal;
+                    reason = "AVX (Forced AVX2, no separate AVX2 kernel)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen_func = braycurtis_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen_func = braycurtis_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen_func = braycurtis_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                chosen_func = braycurtis_scalar_internal;
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen_func = braycurtis_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen_func = braycurtis_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen_func = braycurtis_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen_func = braycurtis_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen_func = braycurtis_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen_func = braycurtis_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved BrayCurtis F32 to: %s", reason);
+    return chosen_func;
+}
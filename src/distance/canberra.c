@@ -0,0 +1,273 @@
+/*
+ * If HSDLIB_NO_CHECKS is defined, all isnan/isinf tests
+ * get compiled out for maximum speed.
+ */
+#ifdef HSDLIB_NO_CHECKS
+#define HSD_ALLOW_FP_CHECKS 0
+#else
+#define HSD_ALLOW_FP_CHECKS 1
+#endif
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+typedef hsd_status_t (*hsd_canberra_f32_func_t)(const float *, const float *, size_t, float *);
+
+/*
+ * Canberra distance: sum of |a - b| / (|a| + |b|). A term whose denominator is zero (both
+ * entries zero) contributes 0, as in SciPy. The vector kernels divide every lane and then mask
+ * those lanes out. The mask compares "not equal" in the unordered sense, so a NaN term is kept
+ * and shows up in the final check. The kernel is division-bound and uses no FMA, so AVX2 hosts
+ * use the AVX kernel. NEON needs AArch64 for vdivq_f32.
+ */
+static hsd_status_t canberra_store(float sum, float *result) {
+    *result = sum;
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(sum) || isinf(sum)) return HSD_ERR_INVALID_INPUT;
+#endif
+    return HSD_SUCCESS;
+}
+
+static float canberra_tail(const float *a, const float *b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float den = fabsf(a[i]) + fabsf(b[i]);
+        if (den != 0.0f) sum += fabsf(a[i] - b[i]) / den;
+    }
+    return sum;
+}
+
+static hsd_status_t canberra_scalar_internal(const float *a, const float *b, size_t n,
+                                             float *result) {
+    hsd_log("Enter canberra_scalar_internal (n=%zu)", n);
+    float sum = canberra_tail(a, b, n);
+    return canberra_store(sum, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static hsd_status_t canberra_avx_internal(const float *a,
+                                                                         const float *b, size_t n,
+                                                                         float *result) {
+    hsd_log("Enter canberra_avx_internal (n=%zu)", n);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 acc = zero;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        __m256 vb = _mm256_loadu_ps(b + i);
+        __m256 num = _mm256_andnot_ps(sign, _mm256_sub_ps(va, vb));
+        __m256 den = _mm256_add_ps(_mm256_andnot_ps(sign, va), _mm256_andnot_ps(sign, vb));
+        __m256 live = _mm256_cmp_ps(den, zero, _CMP_NEQ_UQ);
+        acc = _mm256_add_ps(acc, _mm256_and_ps(live, _mm256_div_ps(num, den)));
+    }
+    float sum = hsd_internal_hsum_avx_f32(acc) + canberra_tail(a + i, b + i, n - i);
+    return canberra_store(sum, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t canberra_avx512_internal(const float *a,
+                                                                                const float *b,
+                                                                                size_t n,
+                                                                                float *result) {
+    hsd_log("Enter canberra_avx512_internal (n=%zu)", n);
+    const __m512 zero = _mm512_setzero_ps();
+    __m512 acc = zero;
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 in = n - i >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1u);
+        __m512 va = _mm512_maskz_loadu_ps(in, a + i);
+        __m512 vb = _mm512_maskz_loadu_ps(in, b + i);
+        __m512 num = _mm512_abs_ps(_mm512_sub_ps(va, vb));
+        __m512 den = _mm512_add_ps(_mm512_abs_ps(va), _mm512_abs_ps(vb));
+        __mmask16 live = _mm512_mask_cmp_ps_mask(in, den, zero, _CMP_NEQ_UQ);
+        acc = _mm512_add_ps(acc, _mm512_maskz_div_ps(live, num, den));
+    }
+    float sum = _mm512_reduce_add_ps(acc);
+    return canberra_store(sum, result);
+}
+#endif
+
+#if defined(__aarch64__)
+static hsd_status_t canberra_neon_internal(const float *a, const float *b, size_t n,
+                                           float *result) {
+    hsd_log("Enter canberra_neon_internal (n=%zu)", n);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t acc = zero;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t va = vld1q_f32(a + i);
+        float32x4_t vb = vld1q_f32(b + i);
+        float32x4_t num = vabdq_f32(va, vb);
+        float32x4_t den = vaddq_f32(vabsq_f32(va), vabsq_f32(vb));
+        uint32x4_t empty = vceqq_f32(den, zero);
+        acc = vaddq_f32(acc, vbslq_f32(empty, zero, vdivq_f32(num, den)));
+    }
+    float sum = vaddvq_f32(acc) + canberra_tail(a + i, b + i, n - i);
+    return canberra_store(sum, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t canberra_sve_internal(const float *a,
+                                                                          const float *b, size_t n,
+                                                                          float *result) {
+    hsd_log("Enter canberra_sve_internal (n=%zu)", n);
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t va = svld1_f32(pg, a + i);
+        svfloat32_t vb = svld1_f32(pg, b + i);
+        svfloat32_t num = svabd_f32_x(pg, va, vb);
+        svfloat32_t den = svadd_f32_x(pg, svabs_f32_x(pg, va), svabs_f32_x(pg, vb));
+        svbool_t live = svbic_b_z(pg, pg, svcmpeq_n_f32(pg, den, 0.0f));
+        acc = svadd_f32_m(live, acc, svdiv_f32_x(live, num, den));
+    }
+    float sum = svaddv_f32(svptrue_b32(), acc);
+    return canberra_store(sum, result);
+}
+#endif
+#endif
+
+static hsd_canberra_f32_func_t resolve_canberra_f32_internal(void);
+static hsd_status_t canberra_f32_resolver_trampoline(const float *a, const float *b, size_t n,
+                                                     float *result);
+
+static atomic_uintptr_t hsd_canberra_f32_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)canberra_f32_resolver_trampoline);
+
+hsd_status_t hsd_dist_canberra_f32(const float *a, const float *b, size_t n, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    hsd_canberra_f32_func_t func = (hsd_canberra_f32_func_t)atomic_load_explicit(
+        &hsd_canberra_f32_ptr, memory_order_acquire);
+    return func(a, b, n, result);
+}
+
+static hsd_status_t canberra_f32_resolver_trampoline(const float *a, const float *b, size_t n,
+                                                     float *result) {
+    hsd_log("Canberra F32: resolving backend");
+    hsd_canberra_f32_func_t resolved_func = resolve_canberra_f32_internal();
+    uintptr_t expected = (uintptr_t)canberra_f32_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_canberra_f32_ptr, &expected,
+                                            (uintptr_t)resolved_func, memory_order_release,
+                                            memory_order_relaxed);
+    hsd_canberra_f32_func_t current_func = (hsd_canberra_f32_func_t)atomic_load_explicit(
+        &hsd_canberra_f32_ptr, memory_order_acquire);
+    return current_func(a, b, n, result);
+}
+
+static hsd_canberra_f32_func_t resolve_canberra_f32_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_canberra_f32_func_t chosen_func = canberra_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Canberra F32: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen_func = canberra_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx()) {
+                    chosen_func = canberra_avx_internal;
+                    reason = "AVX (Forced AVX2, no separate AVX2 kernel)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen_func = canberra_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen_func = canberra_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen_func = canberra_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                chosen_func = canberra_scalar_internal;
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen_func = canberra_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen_func = canberra_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen_func = canberra_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen_func = canberra_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen_func = canberra_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen_func = canberra_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Canberra F32 to: %s", reason);
+    return chosen_func;
+}
@@ -0,0 +1,418 @@
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+/*
+ * KL and Jensen-Shannon divergence. The SIMD kernels use the vector logf approximation from
+ * hsd_internal.h, with a relative error of about 1e-7; the scalar kernels use logf.
+ *
+ * A kernel returns NaN if any entry is negative, NaN or infinite, and +inf if some a[i] > 0
+ * meets b[i] == 0 (the divergence is unbounded). Zero entries of a contribute nothing.
+ */
+typedef struct {
+    float (*kl)(const float *a, const float *b, size_t n, float eps);
+    float (*js)(const float *a, const float *b, size_t n);
+    const char *name;
+} hsd_divergence_kernels_t;
+
+static inline bool div_entry_invalid(float x) { return !(x >= 0.0f && x <= FLT_MAX); }
+
+static float kl_scalar(const float *a, const float *b, size_t n, float eps) {
+    float sum = 0.0f;
+    bool unbounded = false;
+    for (size_t i = 0; i < n; ++i) {
+        if (div_entry_invalid(a[i]) || div_entry_invalid(b[i])) return NAN;
+        float p = fmaxf(a[i], eps);
+        float q = fmaxf(b[i], eps);
+        if (p == 0.0f) continue;
+        if (q == 0.0f) {
+            unbounded = true;
+            continue;
+        }
+        sum += p * (logf(p) - logf(q));
+    }
+    return unbounded ? INFINITY : sum;
+}
+
+static float js_scalar(const float *a, const float *b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float p = a[i], q = b[i];
+        if (div_entry_invalid(p) || div_entry_invalid(q)) return NAN;
+        float log_m = logf(0.5f * p + 0.5f * q);
+        if (p > 0.0f) sum += p * (logf(p) - log_m);
+        if (q > 0.0f) sum += q * (logf(q) - log_m);
+    }
+    return 0.5f * sum;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx2,fma"))) static inline __m256 div_invalid_avx2(__m256 x) {
+    return _mm256_or_ps(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_NGE_UQ),
+                        _mm256_cmp_ps(x, _mm256_set1_ps(FLT_MAX), _CMP_GT_OQ));
+}
+
+__attribute__((target("avx2,fma"))) static float kl_avx2(const float *a, const float *b, size_t n,
+                                                         float eps) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 veps = _mm256_set1_ps(eps);
+    __m256 acc = zero, bad = zero, unbounded = zero;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 p = _mm256_loadu_ps(a + i);
+        __m256 q = _mm256_loadu_ps(b + i);
+        bad = _mm256_or_ps(bad, _mm256_or_ps(div_invalid_avx2(p), div_invalid_avx2(q)));
+        p = _mm256_max_ps(p, veps);
+        q = _mm256_max_ps(q, veps);
+        __m256 live = _mm256_cmp_ps(p, zero, _CMP_GT_OQ);
+        unbounded = _mm256_or_ps(unbounded,
+                                 _mm256_and_ps(live, _mm256_cmp_ps(q, zero, _CMP_EQ_OQ)));
+        __m256 term =
+            _mm256_mul_ps(p, _mm256_sub_ps(hsd_internal_log_avx2(p), hsd_internal_log_avx2(q)));
+        acc = _mm256_add_ps(acc, _mm256_and_ps(live, term));
+    }
+    if (_mm256_movemask_ps(bad) != 0) return NAN;
+    float tail = kl_scalar(a + i, b + i, n - i, eps);
+    if (_mm256_movemask_ps(unbounded) != 0 && !isnan(tail)) return INFINITY;
+    return hsd_internal_hsum_avx_f32(acc) + tail;
+}
+
+__attribute__((target("avx2,fma"))) static float js_avx2(const float *a, const float *b,
+                                                         size_t n) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 half = _mm256_set1_ps(0.5f);
+    __m256 acc = zero, bad = zero;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 p = _mm256_loadu_ps(a + i);
+        __m256 q = _mm256_loadu_ps(b + i);
+        bad = _mm256_or_ps(bad, _mm256_or_ps(div_invalid_avx2(p), div_invalid_avx2(q)));
+        __m256 log_m = hsd_internal_log_avx2(_mm256_fmadd_ps(p, half, _mm256_mul_ps(q, half)));
+        __m256 tp = _mm256_mul_ps(p, _mm256_sub_ps(hsd_internal_log_avx2(p), log_m));
+        __m256 tq = _mm256_mul_ps(q, _mm256_sub_ps(hsd_internal_log_avx2(q), log_m));
+        acc = _mm256_add_ps(acc, _mm256_and_ps(_mm256_cmp_ps(p, zero, _CMP_GT_OQ), tp));
+        acc = _mm256_add_ps(acc, _mm256_and_ps(_mm256_cmp_ps(q, zero, _CMP_GT_OQ), tq));
+    }
+    if (_mm256_movemask_ps(bad) != 0) return NAN;
+    return 0.5f * hsd_internal_hsum_avx_f32(acc) + js_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static inline __mmask16 div_invalid_avx512(__m512 x) {
+    return _mm512_cmp_ps_mask(x, _mm512_setzero_ps(), _CMP_NGE_UQ) |
+           _mm512_cmp_ps_mask(x, _mm512_set1_ps(FLT_MAX), _CMP_GT_OQ);
+}
+
+__attribute__((target("avx512f"))) static float kl_avx512(const float *a, const float *b,
+                                                          size_t n, float eps) {
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 veps = _mm512_set1_ps(eps);
+    __m512 acc = zero;
+    __mmask16 bad = 0, unbounded = 0;
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 in = n - i >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1u);
+        __m512 p = _mm512_maskz_loadu_ps(in, a + i);
+        __m512 q = _mm512_maskz_loadu_ps(in, b + i);
+        bad |= div_invalid_avx512(p) | div_invalid_avx512(q);
+        p = _mm512_max_ps(p, veps);
+        q = _mm512_max_ps(q, veps);
+        __mmask16 live = _mm512_cmp_ps_mask(p, zero, _CMP_GT_OQ) & in;
+        unbounded |= _mm512_mask_cmp_ps_mask(live, q, zero, _CMP_EQ_OQ);
+        __m512 term = _mm512_mul_ps(
+            p, _mm512_sub_ps(hsd_internal_log_avx512(p), hsd_internal_log_avx512(q)));
+        acc = _mm512_mask_add_ps(acc, live, acc, term);
+    }
+    if (bad != 0) return NAN;
+    if (unbounded != 0) return INFINITY;
+    return _mm512_reduce_add_ps(acc);
+}
+
+__attribute__((target("avx512f"))) static float js_avx512(const float *a, const float *b,
+                                                          size_t n) {
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512 half = _mm512_set1_ps(0.5f);
+    __m512 acc = zero;
+    __mmask16 bad = 0;
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 in = n - i >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1u);
+        __m512 p = _mm512_maskz_loadu_ps(in, a + i);
+        __m512 q = _mm512_maskz_loadu_ps(in, b + i);
+        bad |= div_invalid_avx512(p) | div_invalid_avx512(q);
+        __m512 log_m = hsd_internal_log_avx512(_mm512_fmadd_ps(p, half, _mm512_mul_ps(q, half)));
+        __m512 tp = _mm512_mul_ps(p, _mm512_sub_ps(hsd_internal_log_avx512(p), log_m));
+        __m512 tq = _mm512_mul_ps(q, _mm512_sub_ps(hsd_internal_log_avx512(q), log_m));
+        acc = _mm512_mask_add_ps(acc, _mm512_cmp_ps_mask(p, zero, _CMP_GT_OQ), acc, tp);
+        acc = _mm512_mask_add_ps(acc, _mm512_cmp_ps_mask(q, zero, _CMP_GT_OQ), acc, tq);
+    }
+    if (bad != 0) return NAN;
+    return 0.5f * _mm512_reduce_add_ps(acc);
+}
+#endif
+
+#if defined(__aarch64__)
+static inline uint32x4_t div_invalid_neon(float32x4_t x) {
+    uint32x4_t ok = vandq_u32(vcgeq_f32(x, vdupq_n_f32(0.0f)), vcleq_f32(x, vdupq_n_f32(FLT_MAX)));
+    return vmvnq_u32(ok);
+}
+
+static float kl_neon(const float *a, const float *b, size_t n, float eps) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t veps = vdupq_n_f32(eps);
+    float32x4_t acc = zero;
+    uint32x4_t bad = vdupq_n_u32(0), unbounded = vdupq_n_u32(0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t p = vld1q_f32(a + i);
+        float32x4_t q = vld1q_f32(b + i);
+        bad = vorrq_u32(bad, vorrq_u32(div_invalid_neon(p), div_invalid_neon(q)));
+        p = vmaxq_f32(p, veps);
+        q = vmaxq_f32(q, veps);
+        uint32x4_t live = vcgtq_f32(p, zero);
+        unbounded = vorrq_u32(unbounded, vandq_u32(live, vceqq_f32(q, zero)));
+        float32x4_t term =
+            vmulq_f32(p, vsubq_f32(hsd_internal_log_neon(p), hsd_internal_log_neon(q)));
+        acc = vaddq_f32(acc, vbslq_f32(live, term, zero));
+    }
+    if (vmaxvq_u32(bad) != 0) return NAN;
+    float tail = kl_scalar(a + i, b + i, n - i, eps);
+    if (vmaxvq_u32(unbounded) != 0 && !isnan(tail)) return INFINITY;
+    return vaddvq_f32(acc) + tail;
+}
+
+static float js_neon(const float *a, const float *b, size_t n) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t acc = zero;
+    uint32x4_t bad = vdupq_n_u32(0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t p = vld1q_f32(a + i);
+        float32x4_t q = vld1q_f32(b + i);
+        bad = vorrq_u32(bad, vorrq_u32(div_invalid_neon(p), div_invalid_neon(q)));
+        float32x4_t log_m = hsd_internal_log_neon(vfmaq_n_f32(vmulq_n_f32(q, 0.5f), p, 0.5f));
+        float32x4_t tp = vmulq_f32(p, vsubq_f32(hsd_internal_log_neon(p), log_m));
+        float32x4_t tq = vmulq_f32(q, vsubq_f32(hsd_internal_log_neon(q), log_m));
+        acc = vaddq_f32(acc, vbslq_f32(vcgtq_f32(p, zero), tp, zero));
+        acc = vaddq_f32(acc, vbslq_f32(vcgtq_f32(q, zero), tq, zero));
+    }
+    if (vmaxvq_u32(bad) != 0) return NAN;
+    return 0.5f * vaddvq_f32(acc) + js_scalar(a + i, b + i, n - i);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static inline svbool_t div_invalid_sve(svbool_t pg,
+                                                                      svfloat32_t x) {
+    svbool_t ok = svand_b_z(pg, svcmpge_n_f32(pg, x, 0.0f), svcmple_n_f32(pg, x, FLT_MAX));
+    return svnot_b_z(pg, ok);
+}
+
+__attribute__((target("+sve"))) static float kl_sve(const float *a, const float *b, size_t n,
+                                                    float eps) {
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    svbool_t bad = svpfalse_b(), unbounded = svpfalse_b();
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t p = svld1_f32(pg, a + i);
+        svfloat32_t q = svld1_f32(pg, b + i);
+        bad = svorr_b_z(svptrue_b32(), bad,
+                        svorr_b_z(pg, div_invalid_sve(pg, p), div_invalid_sve(pg, q)));
+        p = svmax_n_f32_x(pg, p, eps);
+        q = svmax_n_f32_x(pg, q, eps);
+        svbool_t live = svcmpgt_n_f32(pg, p, 0.0f);
+        unbounded = svorr_b_z(svptrue_b32(), unbounded, svcmpeq_n_f32(live, q, 0.0f));
+        svfloat32_t log_pq =
+            svsub_f32_x(live, hsd_internal_log_sve(live, p), hsd_internal_log_sve(live, q));
+        svfloat32_t term = svmul_f32_x(live, p, log_pq);
+        acc = svadd_f32_m(live, acc, term);
+    }
+    if (svptest_any(svptrue_b32(), bad)) return NAN;
+    if (svptest_any(svptrue_b32(), unbounded)) return INFINITY;
+    return svaddv_f32(svptrue_b32(), acc);
+}
+
+__attribute__((target("+sve"))) static float js_sve(const float *a, const float *b, size_t n) {
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    svbool_t bad = svpfalse_b();
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t p = svld1_f32(pg, a + i);
+        svfloat32_t q = svld1_f32(pg, b + i);
+        bad = svorr_b_z(svptrue_b32(), bad,
+                        svorr_b_z(pg, div_invalid_sve(pg, p), div_invalid_sve(pg, q)));
+        svfloat32_t log_m =
+            hsd_internal_log_sve(pg, svmla_n_f32_x(pg, svmul_n_f32_x(pg, q, 0.5f), p, 0.5f));
+        svbool_t live_p = svcmpgt_n_f32(pg, p, 0.0f);
+        svbool_t live_q = svcmpgt_n_f32(pg, q, 0.0f);
+        svfloat32_t tp =
+            svmul_f32_x(pg, p, svsub_f32_x(pg, hsd_internal_log_sve(live_p, p), log_m));
+        svfloat32_t tq =
+            svmul_f32_x(pg, q, svsub_f32_x(pg, hsd_internal_log_sve(live_q, q), log_m));
+        acc = svadd_f32_m(live_p, acc, tp);
+        acc = svadd_f32_m(live_q, acc, tq);
+    }
+    if (svptest_any(svptrue_b32(), bad)) return NAN;
+    return 0.5f * svaddv_f32(svptrue_b32(), acc);
+}
+#endif
+#endif
+
+static const hsd_divergence_kernels_t divergence_kernels_scalar = {kl_scalar, js_scalar,
+                                                                   "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_divergence_kernels_t divergence_kernels_avx2 = {kl_avx2, js_avx2, "AVX2"};
+static const hsd_divergence_kernels_t divergence_kernels_avx512 = {kl_avx512, js_avx512,
+                                                                   "AVX512F"};
+#endif
+#if defined(__aarch64__)
+static const hsd_divergence_kernels_t divergence_kernels_neon = {kl_neon, js_neon, "NEON"};
+#if defined(__ARM_FEATURE_SVE)
+static const hsd_divergence_kernels_t divergence_kernels_sve = {kl_sve, js_sve, "SVE"};
+#endif
+#endif
+
+/* The log approximation needs 256-bit integer ops, so AVX-only hosts use the scalar kernels. */
+static const hsd_divergence_kernels_t *resolve_divergence_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_divergence_kernels_t *chosen = &divergence_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Divergence F32: Manual backend requested: %d", forced);
+        bool ok = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = &divergence_kernels_avx512;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2() && hsd_cpu_has_fma()) {
+                    chosen = &divergence_kernels_avx2;
+                    ok = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = &divergence_kernels_sve;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = &divergence_kernels_neon;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                ok = true;
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            hsd_log("Forced backend %d not supported, fallback to scalar", forced);
+            chosen = &divergence_kernels_scalar;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &divergence_kernels_avx512;
+        else if (hsd_cpu_has_avx2() && hsd_cpu_has_fma())
+            chosen = &divergence_kernels_avx2;
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve())
+            chosen = &divergence_kernels_sve;
+        else if (hsd_cpu_has_neon())
+            chosen = &divergence_kernels_neon;
+#else
+        if (hsd_cpu_has_neon()) chosen = &divergence_kernels_neon;
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Divergence F32 to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_divergence_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_divergence_kernels_t *divergence_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_divergence_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_divergence_kernels_t *)cur;
+    const hsd_divergence_kernels_t *resolved = resolve_divergence_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_divergence_kernels_ptr, &cur,
+                                            (uintptr_t)resolved, memory_order_release,
+                                            memory_order_relaxed);
+    return resolved;
+}
+
+/* Handles NULL pointers and empty vectors; true means the call is over and *status is final. */
+static bool divergence_early_exit(const float *a, const float *b, size_t n, float *result,
+                                  hsd_status_t *status) {
+    if (result == NULL) {
+        *status = HSD_ERR_NULL_PTR;
+        return true;
+    }
+    if (n == 0) {
+        *result = 0.0f;
+        *status = HSD_SUCCESS;
+        return true;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        *status = HSD_ERR_NULL_PTR;
+        return true;
+    }
+    return false;
+}
+
+static hsd_status_t divergence_result(float value, float *result) {
+    *result = value;
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(value) || isinf(value)) return HSD_ERR_INVALID_INPUT;
+#endif
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_dist_kl_f32(const float *a, const float *b, size_t n, float *result) {
+    hsd_status_t status;
+    if (divergence_early_exit(a, b, n, result, &status)) return status;
+    return divergence_result(divergence_kernels()->kl(a, b, n, 0.0f), result);
+}
+
+hsd_status_t hsd_dist_kl_eps_f32(const float *a, const float *b, size_t n, float eps,
+                                 float *result) {
+    if (result != NULL && !(eps > 0.0f && eps <= FLT_MAX)) {
+        *result = NAN;
+        return HSD_ERR_INVALID_INPUT;
+    }
+    hsd_status_t status;
+    if (divergence_early_exit(a, b, n, result, &status)) return status;
+    return divergence_result(divergence_kernels()->kl(a, b, n, eps), result);
+}
+
+hsd_status_t hsd_dist_jensen_shannon_f32(const float *a, const float *b, size_t n,
+                                         float *result) {
+    hsd_status_t status;
+    if (divergence_early_exit(a, b, n, result, &status)) return status;
+    return divergence_result(divergence_kernels()->js(a, b, n), result);
+}
@@ -0,0 +1,454 @@
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+/*
+ * Dynamic time warping with squared local cost and a Sakoe-Chiba band |i - j| <= w, where
+ * w = max(band, |na - nb|) so that the end cell is always reachable.
+ *
+ * The DP walks anti-diagonals k = i + j. Every cell on a diagonal depends only on the two
+ * previous diagonals:
+ *
+ *   D[i][j] = (a[i] - b[j])^2 + min(D[i - 1][j], D[i][j - 1], D[i - 1][j - 1])
+ *
+ * so a whole diagonal is one SIMD pass. The diagonals are stored by i, with slot p = i + 1
+ * (slot 0 is the border i = -1), and b is reversed once so that b[k - i] is a contiguous,
+ * ascending load as well. Each pass writes +inf just outside its band so the next two passes
+ * never read stale cells.
+ *
+ * The cell arithmetic is the same on every backend, so DTW results are bit-identical across
+ * backends. A warping path visits at least one of any two consecutive diagonals, so the bounded
+ * variant stops as soon as two consecutive diagonals are entirely above the threshold.
+ */
+typedef struct {
+    /* cur[t] = (a[t] - br[t])^2 + min(p1[t], p1[t + 1], p2[t]); returns min over cur. */
+    float (*diag)(const float *a, const float *br, const float *p1, const float *p2, float *cur,
+                  size_t count);
+    /* Sum over t of the squared distance from q[t] to the interval [lower[t], upper[t]]. */
+    float (*lb_keogh)(const float *q, const float *upper, const float *lower, size_t n);
+    const char *name;
+} hsd_dtw_kernels_t;
+
+static inline float dtw_min3(float x, float y, float z) {
+    float m = x < y ? x : y;
+    return m < z ? m : z;
+}
+
+static float dtw_diag_scalar(const float *a, const float *br, const float *p1, const float *p2,
+                             float *cur, size_t count) {
+    float best = INFINITY;
+    for (size_t t = 0; t < count; ++t) {
+        float d = a[t] - br[t];
+        float v = d * d + dtw_min3(p1[t], p1[t + 1], p2[t]);
+        cur[t] = v;
+        best = v < best ? v : best;
+    }
+    return best;
+}
+
+static float lb_keogh_scalar(const float *q, const float *upper, const float *lower, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float e = q[i] > upper[i] ? q[i] - upper[i] : (q[i] < lower[i] ? lower[i] - q[i] : 0.0f);
+        sum += e * e;
+    }
+    return sum;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static inline float dtw_hmin_avx(__m256 v) {
+    __m128 m = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    m = _mm_min_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_min_ss(m, _mm_shuffle_ps(m, m, 1));
+    return _mm_cvtss_f32(m);
+}
+
+__attribute__((target("avx"))) static float dtw_diag_avx(const float *a, const float *br,
+                                                         const float *p1, const float *p2,
+                                                         float *cur, size_t count) {
+    __m256 vmin = _mm256_set1_ps(INFINITY);
+    size_t t = 0;
+    for (; t + 8 <= count; t += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + t), _mm256_loadu_ps(br + t));
+        __m256 m = _mm256_min_ps(_mm256_loadu_ps(p1 + t), _mm256_loadu_ps(p1 + t + 1));
+        m = _mm256_min_ps(m, _mm256_loadu_ps(p2 + t));
+        __m256 v = _mm256_add_ps(_mm256_mul_ps(d, d), m);
+        _mm256_storeu_ps(cur + t, v);
+        vmin = _mm256_min_ps(vmin, v);
+    }
+    float best = dtw_hmin_avx(vmin);
+    float rest = dtw_diag_scalar(a + t, br + t, p1 + t, p2 + t, cur + t, count - t);
+    return rest < best ? rest : best;
+}
+
+__attribute__((target("avx"))) static float lb_keogh_avx(const float *q, const float *upper,
+                                                         const float *lower, size_t n) {
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 acc = zero;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(q + i);
+        __m256 e = _mm256_add_ps(_mm256_max_ps(_mm256_sub_ps(x, _mm256_loadu_ps(upper + i)), zero),
+                                 _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(lower + i), x), zero));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(e, e));
+    }
+    return hsd_internal_hsum_avx_f32(acc) + lb_keogh_scalar(q + i, upper + i, lower + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static float dtw_diag_avx512(const float *a, const float *br,
+                                                                const float *p1, const float *p2,
+                                                                float *cur, size_t count) {
+    __m512 vmin = _mm512_set1_ps(INFINITY);
+    for (size_t t = 0; t < count; t += 16) {
+        __mmask16 in = count - t >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (count - t)) - 1u);
+        __m512 d =
+            _mm512_sub_ps(_mm512_maskz_loadu_ps(in, a + t), _mm512_maskz_loadu_ps(in, br + t));
+        __m512 m = _mm512_min_ps(_mm512_maskz_loadu_ps(in, p1 + t),
+                                 _mm512_maskz_loadu_ps(in, p1 + t + 1));
+        m = _mm512_min_ps(m, _mm512_maskz_loadu_ps(in, p2 + t));
+        __m512 v = _mm512_add_ps(_mm512_mul_ps(d, d), m);
+        _mm512_mask_storeu_ps(cur + t, in, v);
+        vmin = _mm512_mask_min_ps(vmin, in, vmin, v);
+    }
+    return _mm512_reduce_min_ps(vmin);
+}
+
+__attribute__((target("avx512f"))) static float lb_keogh_avx512(const float *q, const float *upper,
+                                                                const float *lower, size_t n) {
+    const __m512 zero = _mm512_setzero_ps();
+    __m512 acc = zero;
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 in = n - i >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1u);
+        __m512 x = _mm512_maskz_loadu_ps(in, q + i);
+        __m512 e = _mm512_add_ps(
+            _mm512_max_ps(_mm512_sub_ps(x, _mm512_maskz_loadu_ps(in, upper + i)), zero),
+            _mm512_max_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(in, lower + i), x), zero));
+        acc = _mm512_fmadd_ps(e, e, acc);
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+#endif
+
+#if defined(__aarch64__)
+static float dtw_diag_neon(const float *a, const float *br, const float *p1, const float *p2,
+                           float *cur, size_t count) {
+    float32x4_t vmin = vdupq_n_f32(INFINITY);
+    size_t t = 0;
+    for (; t + 4 <= count; t += 4) {
+        float32x4_t d = vsubq_f32(vld1q_f32(a + t), vld1q_f32(br + t));
+        float32x4_t m = vminq_f32(vminq_f32(vld1q_f32(p1 + t), vld1q_f32(p1 + t + 1)),
+                                  vld1q_f32(p2 + t));
+        float32x4_t v = vaddq_f32(vmulq_f32(d, d), m);
+        vst1q_f32(cur + t, v);
+        vmin = vminq_f32(vmin, v);
+    }
+    float best = vminvq_f32(vmin);
+    float rest = dtw_diag_scalar(a + t, br + t, p1 + t, p2 + t, cur + t, count - t);
+    return rest < best ? rest : best;
+}
+
+static float lb_keogh_neon(const float *q, const float *upper, const float *lower, size_t n) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t acc = zero;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(q + i);
+        float32x4_t e = vaddq_f32(vmaxq_f32(vsubq_f32(x, vld1q_f32(upper + i)), zero),
+                                  vmaxq_f32(vsubq_f32(vld1q_f32(lower + i), x), zero));
+        acc = vfmaq_f32(acc, e, e);
+    }
+    return vaddvq_f32(acc) + lb_keogh_scalar(q + i, upper + i, lower + i, n - i);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static float dtw_diag_sve(const float *a, const float *br,
+                                                          const float *p1, const float *p2,
+                                                          float *cur, size_t count) {
+    svfloat32_t vmin = svdup_n_f32(INFINITY);
+    for (uint64_t t = 0; t < count; t += svcntw()) {
+        svbool_t pg = svwhilelt_b32(t, (uint64_t)count);
+        svfloat32_t d = svsub_f32_x(pg, svld1_f32(pg, a + t), svld1_f32(pg, br + t));
+        svfloat32_t m = svmin_f32_x(pg, svld1_f32(pg, p1 + t), svld1_f32(pg, p1 + t + 1));
+        m = svmin_f32_x(pg, m, svld1_f32(pg, p2 + t));
+        svfloat32_t v = svadd_f32_x(pg, svmul_f32_x(pg, d, d), m);
+        svst1_f32(pg, cur + t, v);
+        vmin = svmin_f32_m(pg, vmin, v);
+    }
+    return svminv_f32(svptrue_b32(), vmin);
+}
+
+__attribute__((target("+sve"))) static float lb_keogh_sve(const float *q, const float *upper,
+                                                          const float *lower, size_t n) {
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t x = svld1_f32(pg, q + i);
+        svfloat32_t e = svadd_f32_x(
+            pg, svmax_n_f32_x(pg, svsub_f32_x(pg, x, svld1_f32(pg, upper + i)), 0.0f),
+            svmax_n_f32_x(pg, svsub_f32_x(pg, svld1_f32(pg, lower + i), x), 0.0f));
+        acc = svmla_f32_m(pg, acc, e, e);
+    }
+    return svaddv_f32(svptrue_b32(), acc);
+}
+#endif
+#endif
+
+static const hsd_dtw_kernels_t dtw_kernels_scalar = {dtw_diag_scalar, lb_keogh_scalar, "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_dtw_kernels_t dtw_kernels_avx = {dtw_diag_avx, lb_keogh_avx, "AVX"};
+static const hsd_dtw_kernels_t dtw_kernels_avx512 = {dtw_diag_avx512, lb_keogh_avx512, "AVX512F"};
+#endif
+#if defined(__aarch64__)
+static const hsd_dtw_kernels_t dtw_kernels_neon = {dtw_diag_neon, lb_keogh_neon, "NEON"};
+#if defined(__ARM_FEATURE_SVE)
+static const hsd_dtw_kernels_t dtw_kernels_sve = {dtw_diag_sve, lb_keogh_sve, "SVE"};
+#endif
+#endif
+
+/* The kernels only subtract, multiply and take minima, so AVX2 hosts use the AVX kernels. */
+static const hsd_dtw_kernels_t *resolve_dtw_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_dtw_kernels_t *chosen = &dtw_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("DTW: Manual backend requested: %d", forced);
+        bool ok = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = &dtw_kernels_avx512;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen = &dtw_kernels_avx;
+                    ok = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = &dtw_kernels_sve;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = &dtw_kernels_neon;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                ok = true;
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            hsd_log("Forced backend %d not supported, fallback to scalar", forced);
+            chosen = &dtw_kernels_scalar;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &dtw_kernels_avx512;
+        else if (hsd_cpu_has_avx())
+            chosen = &dtw_kernels_avx;
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve())
+            chosen = &dtw_kernels_sve;
+        else if (hsd_cpu_has_neon())
+            chosen = &dtw_kernels_neon;
+#else
+        if (hsd_cpu_has_neon()) chosen = &dtw_kernels_neon;
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved DTW to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_dtw_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_dtw_kernels_t *dtw_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_dtw_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_dtw_kernels_t *)cur;
+    const hsd_dtw_kernels_t *resolved = resolve_dtw_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_dtw_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+#if HSD_ALLOW_FP_CHECKS
+static bool dtw_has_non_finite(const float *v, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (isnan(v[i]) || isinf(v[i])) return true;
+    }
+    return false;
+}
+#endif
+
+static size_t dtw_max(size_t x, size_t y) { return x > y ? x : y; }
+static size_t dtw_min(size_t x, size_t y) { return x < y ? x : y; }
+
+static hsd_status_t dtw_run(const float *a, size_t na, const float *b, size_t nb, size_t band,
+                            float threshold, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (na == 0 && nb == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    *result = NAN;
+    if (a == NULL || b == NULL) return HSD_ERR_NULL_PTR;
+    if (na == 0 || nb == 0 || isnan(threshold)) return HSD_ERR_INVALID_INPUT;
+#if HSD_ALLOW_FP_CHECKS
+    if (dtw_has_non_finite(a, na) || dtw_has_non_finite(b, nb)) return HSD_ERR_INVALID_INPUT;
+#endif
+    /* DTW is symmetric; index the diagonals by the shorter series to keep them small. */
+    if (na > nb) {
+        const float *tp = a;
+        a = b;
+        b = tp;
+        size_t tn = na;
+        na = nb;
+        nb = tn;
+    }
+    /* No cell lies further than nb from the diagonal, so clamping keeps (k + w) / 2 in range. */
+    size_t w = dtw_max(dtw_min(band, nb), nb - na);
+
+    float *mem = (float *)malloc((3 * (na + 2) + nb) * sizeof(float));
+    if (mem == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    float *prev2 = mem, *prev1 = mem + (na + 2), *cur = mem + 2 * (na + 2);
+    float *br = mem + 3 * (na + 2);
+    for (size_t t = 0; t < nb; ++t) br[t] = b[nb - 1 - t];
+    for (size_t p = 0; p < 3 * (na + 2); ++p) mem[p] = INFINITY;
+    prev2[0] = 0.0f; /* D[-1][-1] */
+
+    const hsd_dtw_kernels_t *kernels = dtw_kernels();
+    float last_min = INFINITY;
+    bool abandoned = false;
+    for (size_t k = 0; k + 2 <= na + nb; ++k) {
+        /* Cells (i, k - i) with 0 <= i < na, 0 <= k - i < nb and |2i - k| <= w. */
+        size_t lo = dtw_max(k >= nb ? k - (nb - 1) : 0, k > w ? (k - w + 1) / 2 : 0);
+        size_t hi = dtw_min(dtw_min(na - 1, k), (k + w) / 2);
+        /* Border cells for the next two diagonals: slots lo and hi + 2 hold i = lo - 1, hi + 1. */
+        cur[lo] = INFINITY;
+        cur[hi + 2] = INFINITY;
+        float diag_min = INFINITY;
+        if (lo <= hi) {
+            diag_min = kernels->diag(a + lo, br + (nb - 1 - k + lo), prev1 + lo, prev2 + lo,
+                                     cur + lo + 1, hi - lo + 1);
+        } else {
+            /* An empty diagonal (w = 0 and odd k, for example) must read as +inf. */
+            for (size_t p = hi + 1; p <= lo + 1 && p <= na + 1; ++p) cur[p] = INFINITY;
+        }
+        if (diag_min > threshold && last_min > threshold) {
+            abandoned = true;
+            break;
+        }
+        last_min = diag_min;
+        float *tp = prev2;
+        prev2 = prev1;
+        prev1 = cur;
+        cur = tp;
+    }
+    float d = prev1[na];
+    free(mem);
+    if (abandoned || d > threshold) {
+        *result = INFINITY;
+        return HSD_SUCCESS;
+    }
+    *result = d;
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(d) || isinf(d)) return HSD_ERR_INVALID_INPUT;
+#endif
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_dist_dtw_f32(const float *a, size_t na, const float *b, size_t nb, size_t band,
+                              float *result) {
+    return dtw_run(a, na, b, nb, band, INFINITY, result);
+}
+
+hsd_status_t hsd_dist_dtw_bounded_f32(const float *a, size_t na, const float *b, size_t nb,
+                                      size_t band, float best_so_far, float *result) {
+    return dtw_run(a, na, b, nb, band, best_so_far, result);
+}
+
+/* Lemire's streaming min/max: each index enters and leaves each deque at most once. */
+hsd_status_t hsd_dtw_envelope_f32(const float *x, size_t n, size_t band, float *upper,
+                                  float *lower) {
+    if (upper == NULL || lower == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) return HSD_SUCCESS;
+    if (x == NULL) return HSD_ERR_NULL_PTR;
+    size_t *dq = (size_t *)malloc(2 * n * sizeof(size_t));
+    if (dq == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    size_t *maxq = dq, *minq = dq + n;
+    size_t max_head = 0, max_tail = 0, min_head = 0, min_tail = 0;
+    size_t w = dtw_min(band, n);
+    for (size_t j = 0; j < n + w; ++j) {
+        if (j < n) {
+            while (max_tail > max_head && x[maxq[max_tail - 1]] <= x[j]) --max_tail;
+            maxq[max_tail++] = j;
+            while (min_tail > min_head && x[minq[min_tail - 1]] >= x[j]) --min_tail;
+            minq[min_tail++] = j;
+        }
+        if (j < w) continue;
+        /* The window of output i = j - w is [i - w, i + w]. */
+        size_t i = j - w;
+        while (maxq[max_head] + w < i) ++max_head;
+        while (minq[min_head] + w < i) ++min_head;
+        upper[i] = x[maxq[max_head]];
+        lower[i] = x[minq[min_head]];
+    }
+    free(dq);
+#if HSD_ALLOW_FP_CHECKS
+    if (dtw_has_non_finite(x, n)) return HSD_ERR_INVALID_INPUT;
+#endif
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_dist_lb_keogh_f32(const float *q, const float *upper, const float *lower,
+                                   size_t n, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (q == NULL || upper == NULL || lower == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    const hsd_dtw_kernels_t *kernels =
+        hsd_get_precision() != HSD_PRECISION_FAST ? &dtw_kernels_scalar : dtw_kernels();
+    float sum = kernels->lb_keogh(q, upper, lower, n);
+    *result = sum;
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(sum) || isinf(sum)) return HSD_ERR_INVALID_INPUT;
+#endif
+    return HSD_SUCCESS;
+}
@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include <stdio.h>
 
+#include "hsd_internal.h"
 #include "hsdlib.h"
 
 #if defined(__x86_64__) || defined(_M_X64)
@@ -247,6 +248,11 @@ hsd_status_t hsd_dist_sqeuclidean_f32(const float *a, const float *b, size_t n,
         *result = NAN;
         return HSD_ERR_NULL_PTR;
     }
+    HSD_Precision precision = hsd_get_precision();
+    if (precision == HSD_PRECISION_F64)
+        return hsd_internal_round_result(hsd_internal_precise_sq_diff_f32(a, b, n), result);
+    if (precision == HSD_PRECISION_DETERMINISTIC)
+        return hsd_internal_round_result(hsd_internal_det_sq_diff_f32(a, b, n), result);
     hsd_sqeuclidean_f32_func_t func = (hsd_sqeuclidean_f32_func_t)atomic_load_explicit(
         &hsd_sqeuclidean_f32_ptr, memory_order_acquire);
     return func(a, b, n, result);
@@ -365,3 +371,919 @@ static hsd_sqeuclidean_f32_func_t resolve_sqeuclidean_f32_internal(void) {
     hsd_log("Dispatch: Resolved SqEuclidean F32 to: %s", reason);
     return chosen_func;
 }
+
+/*
+ * Early-abandoning variant for k-NN scans. Each kernel accumulates exactly like its unbounded
+ * counterpart above, but every SQEUCLID_BOUND_STRIDE elements it reduces the accumulator and
+ * gives up once the partial sum exceeds the threshold. The terms are non-negative, so the
+ * partial sums never decrease, and a distance that is not abandoned is bit-identical to
+ * hsd_dist_sqeuclidean_f32.
+ */
+#define SQEUCLID_BOUND_STRIDE 128
+
+typedef hsd_status_t (*hsd_sqeuclidean_bounded_f32_func_t)(const float *, const float *, size_t,
+                                                           float, float *);
+
+static inline bool sqeuclid_bound_exceeded(float partial, float threshold) {
+#if HSD_ALLOW_FP_CHECKS
+    /* An overflowing sum is left to the final check so it reports the same error. */
+    return partial > threshold && partial <= FLT_MAX;
+#else
+    return partial > threshold;
+#endif
+}
+
+static hsd_status_t sqeuclid_bounded_result(float sum, float threshold, float *result) {
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(sum) || isinf(sum)) {
+        *result = sum;
+        return HSD_ERR_INVALID_INPUT;
+    }
+#endif
+    *result = sum > threshold ? INFINITY : sum;
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t sqeuclid_bounded_scalar_internal(const float *a, const float *b, size_t n,
+                                                     float threshold, float *result) {
+    hsd_log("Enter sqeuclid_bounded_scalar_internal (n=%zu)", n);
+    float sum_sq_diff = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        float d = a[i] - b[i];
+        sum_sq_diff += d * d;
+        if ((i + 1) % SQEUCLID_BOUND_STRIDE == 0 &&
+            sqeuclid_bound_exceeded(sum_sq_diff, threshold)) {
+            *result = INFINITY;
+            return HSD_SUCCESS;
+        }
+    }
+    return sqeuclid_bounded_result(sum_sq_diff, threshold, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static hsd_status_t sqeuclid_bounded_avx_internal(
+    const float *a, const float *b, size_t n, float threshold, float *result) {
+    hsd_log("Enter sqeuclid_bounded_avx_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256 acc = _mm256_setzero_ps();
+    while (i + 8 <= n) {
+        size_t block_end = n - i > SQEUCLID_BOUND_STRIDE ? i + SQEUCLID_BOUND_STRIDE : n;
+        for (; i + 8 <= block_end; i += 8) {
+            __m256 va = _mm256_loadu_ps(a + i);
+            __m256 vb = _mm256_loadu_ps(b + i);
+            __m256 d = _mm256_sub_ps(va, vb);
+#if defined(__FMA__)
+            acc = _mm256_fmadd_ps(d, d, acc);
+#else
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(d, d));
+#endif
+        }
+        if (i + 8 <= n && sqeuclid_bound_exceeded(hsd_internal_hsum_avx_f32(acc), threshold)) {
+            *result = INFINITY;
+            return HSD_SUCCESS;
+        }
+    }
+    float sum_sq_diff = hsd_internal_hsum_avx_f32(acc);
+    for (; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        float d = a[i] - b[i];
+        sum_sq_diff += d * d;
+    }
+    return sqeuclid_bounded_result(sum_sq_diff, threshold, result);
+}
+
+__attribute__((target("avx2,fma"))) static hsd_status_t sqeuclid_bounded_avx2_internal(
+    const float *a, const float *b, size_t n, float threshold, float *result) {
+    hsd_log("Enter sqeuclid_bounded_avx2_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256 acc = _mm256_setzero_ps();
+    while (i + 8 <= n) {
+        size_t block_end = n - i > SQEUCLID_BOUND_STRIDE ? i + SQEUCLID_BOUND_STRIDE : n;
+        for (; i + 8 <= block_end; i += 8) {
+            __m256 va = _mm256_loadu_ps(a + i);
+            __m256 vb = _mm256_loadu_ps(b + i);
+            __m256 d = _mm256_sub_ps(va, vb);
+            acc = _mm256_fmadd_ps(d, d, acc);
+        }
+        if (i + 8 <= n && sqeuclid_bound_exceeded(hsd_internal_hsum_avx_f32(acc), threshold)) {
+            *result = INFINITY;
+            return HSD_SUCCESS;
+        }
+    }
+    float sum_sq_diff = hsd_internal_hsum_avx_f32(acc);
+    for (; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        float d = a[i] - b[i];
+        sum_sq_diff += d * d;
+    }
+    return sqeuclid_bounded_result(sum_sq_diff, threshold, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t sqeuclid_bounded_avx512_internal(
+    const float *a, const float *b, size_t n, float threshold, float *result) {
+    hsd_log("Enter sqeuclid_bounded_avx512_internal (n=%zu)", n);
+    size_t i = 0;
+    __m512 acc = _mm512_setzero_ps();
+    while (i + 16 <= n) {
+        size_t block_end = n - i > SQEUCLID_BOUND_STRIDE ? i + SQEUCLID_BOUND_STRIDE : n;
+        for (; i + 16 <= block_end; i += 16) {
+            __m512 va = _mm512_loadu_ps(a + i);
+            __m512 vb = _mm512_loadu_ps(b + i);
+            __m512 d = _mm512_sub_ps(va, vb);
+            acc = _mm512_fmadd_ps(d, d, acc);
+        }
+        if (i + 16 <= n && sqeuclid_bound_exceeded(_mm512_reduce_add_ps(acc), threshold)) {
+            *result = INFINITY;
+            return HSD_SUCCESS;
+        }
+    }
+    float sum_sq_diff = _mm512_reduce_add_ps(acc);
+    for (; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        float d = a[i] - b[i];
+        sum_sq_diff += d * d;
+    }
+    return sqeuclid_bounded_result(sum_sq_diff, threshold, result);
+}
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+static inline float sqeuclid_bounded_hsum_neon(float32x4_t acc) {
+#if defined(__aarch64__)
+    return vaddvq_f32(acc);
+#else
+    float32x2_t tmp = vpadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    tmp = vpadd_f32(tmp, tmp);
+    return vget_lane_f32(tmp, 0);
+#endif
+}
+
+static hsd_status_t sqeuclid_bounded_neon_internal(const float *a, const float *b, size_t n,
+                                                   float threshold, float *result) {
+    hsd_log("Enter sqeuclid_bounded_neon_internal (n=%zu)", n);
+    size_t i = 0;
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    while (i + 4 <= n) {
+        size_t block_end = n - i > SQEUCLID_BOUND_STRIDE ? i + SQEUCLID_BOUND_STRIDE : n;
+        for (; i + 4 <= block_end; i += 4) {
+            float32x4_t va = vld1q_f32(a + i);
+            float32x4_t vb = vld1q_f32(b + i);
+            float32x4_t d = vsubq_f32(va, vb);
+            acc = vfmaq_f32(acc, d, d);
+        }
+        if (i + 4 <= n && sqeuclid_bound_exceeded(sqeuclid_bounded_hsum_neon(acc), threshold)) {
+            *result = INFINITY;
+            return HSD_SUCCESS;
+        }
+    }
+    float sum_sq_diff = sqeuclid_bounded_hsum_neon(acc);
+    for (; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        float d = a[i] - b[i];
+        sum_sq_diff += d * d;
+    }
+    return sqeuclid_bounded_result(sum_sq_diff, threshold, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t sqeuclid_bounded_sve_internal(
+    const float *a, const float *b, size_t n, float threshold, float *result) {
+    hsd_log("Enter sqeuclid_bounded_sve_internal (n=%zu)", n);
+    uint64_t i = 0;
+    uint64_t next_check = SQEUCLID_BOUND_STRIDE;
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    while (i < n) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t va = svld1_f32(pg, a + i);
+        svfloat32_t vb = svld1_f32(pg, b + i);
+        svfloat32_t d = svsub_f32_z(pg, va, vb);
+        acc = svmla_f32_m(pg, acc, d, d);
+        i += svcntw();
+        /* The vector length need not divide the stride, so check on crossing it. */
+        if (i >= next_check && i < n) {
+            if (sqeuclid_bound_exceeded(svaddv_f32(svptrue_b32(), acc), threshold)) {
+                *result = INFINITY;
+                return HSD_SUCCESS;
+            }
+            next_check = i + SQEUCLID_BOUND_STRIDE;
+        }
+    }
+    return sqeuclid_bounded_result(svaddv_f32(svptrue_b32(), acc), threshold, result);
+}
+#endif
+#endif
+static hsd_sqeuclidean_bounded_f32_func_t resolve_sqeuclidean_bounded_f32_internal(void);
+static hsd_status_t sqeuclidean_bounded_f32_resolver_trampoline(const float *a, const float *b,
+                                                                size_t n, float threshold,
+                                                                float *result);
+
+static atomic_uintptr_t hsd_sqeuclidean_bounded_f32_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)sqeuclidean_bounded_f32_resolver_trampoline);
+
+hsd_status_t hsd_dist_sqeuclidean_bounded_f32(const float *a, const float *b, size_t n,
+                                              float threshold, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (isnan(threshold)) {
+        *result = NAN;
+        return HSD_ERR_INVALID_INPUT;
+    }
+    if (n == 0) {
+        *result = 0.0f > threshold ? INFINITY : 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    if (hsd_get_precision() != HSD_PRECISION_FAST) {
+        hsd_status_t status = hsd_dist_sqeuclidean_f32(a, b, n, result);
+        if (status == HSD_SUCCESS && *result > threshold) *result = INFINITY;
+        return status;
+    }
+    hsd_sqeuclidean_bounded_f32_func_t func =
+        (hsd_sqeuclidean_bounded_f32_func_t)atomic_load_explicit(&hsd_sqeuclidean_bounded_f32_ptr,
+                                                                 memory_order_acquire);
+    return func(a, b, n, threshold, result);
+}
+
+static hsd_status_t sqeuclidean_bounded_f32_resolver_trampoline(const float *a, const float *b,
+                                                                size_t n, float threshold,
+                                                                float *result) {
+    hsd_sqeuclidean_bounded_f32_func_t resolved = resolve_sqeuclidean_bounded_f32_internal();
+    uintptr_t expected = (uintptr_t)sqeuclidean_bounded_f32_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_sqeuclidean_bounded_f32_ptr, &expected,
+                                            (uintptr_t)resolved, memory_order_release,
+                                            memory_order_relaxed);
+    return resolved(a, b, n, threshold, result);
+}
+
+/* Mirrors resolve_sqeuclidean_f32_internal so both entry points pick matching kernels. */
+static hsd_sqeuclidean_bounded_f32_func_t resolve_sqeuclidean_bounded_f32_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_sqeuclidean_bounded_f32_func_t chosen = sqeuclid_bounded_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("SqEuclidean Bounded F32: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = sqeuclid_bounded_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2()) {
+                    chosen = sqeuclid_bounded_avx2_internal;
+                    reason = "AVX2 (Forced)";
+                    supported = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen = sqeuclid_bounded_avx_internal;
+                    reason = "AVX (fallback from forced AVX2)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen = sqeuclid_bounded_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = sqeuclid_bounded_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = sqeuclid_bounded_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen = sqeuclid_bounded_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen = sqeuclid_bounded_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx2()) {
+            chosen = sqeuclid_bounded_avx2_internal;
+            reason = "AVX2 (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen = sqeuclid_bounded_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen = sqeuclid_bounded_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen = sqeuclid_bounded_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen = sqeuclid_bounded_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved SqEuclidean Bounded F32 to: %s", reason);
+    return chosen;
+}
+
+/*
+ * Diagonal-weighted squared distance sum(w[i] * (a[i] - b[i])^2). The weight is folded into
+ * the multiply that feeds the accumulator, (w * d) * d, so each element costs one extra
+ * multiply over hsd_dist_sqeuclidean_f32 and the weights are streamed alongside the inputs.
+ */
+typedef hsd_status_t (*hsd_weighted_sqeuclidean_f32_func_t)(const float *, const float *,
+                                                            const float *, size_t, float *);
+
+static hsd_status_t weighted_sqeuclid_tail(const float *a, const float *b, const float *w,
+                                           size_t i, size_t n, float sum, float *result) {
+    for (; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i]) || isnan(w[i]) ||
+            isinf(w[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        float d = a[i] - b[i];
+        sum += w[i] * d * d;
+    }
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(sum) || isinf(sum)) {
+        *result = sum;
+        return HSD_ERR_INVALID_INPUT;
+    }
+#endif
+    *result = sum;
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t weighted_sqeuclid_scalar_internal(const float *a, const float *b,
+                                                      const float *w, size_t n, float *result) {
+    hsd_log("Enter weighted_sqeuclid_scalar_internal (n=%zu)", n);
+    return weighted_sqeuclid_tail(a, b, w, 0, n, 0.0f, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static hsd_status_t weighted_sqeuclid_avx_internal(
+    const float *a, const float *b, const float *w, size_t n, float *result) {
+    hsd_log("Enter weighted_sqeuclid_avx_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 wd = _mm256_mul_ps(_mm256_loadu_ps(w + i), d);
+#if defined(__FMA__)
+        acc = _mm256_fmadd_ps(wd, d, acc);
+#else
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(wd, d));
+#endif
+    }
+    return weighted_sqeuclid_tail(a, b, w, i, n, hsd_internal_hsum_avx_f32(acc), result);
+}
+
+__attribute__((target("avx2,fma"))) static hsd_status_t weighted_sqeuclid_avx2_internal(
+    const float *a, const float *b, const float *w, size_t n, float *result) {
+    hsd_log("Enter weighted_sqeuclid_avx2_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        acc0 = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_loadu_ps(w + i), d0), d0, acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_loadu_ps(w + i + 8), d1), d1, acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        acc0 = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_loadu_ps(w + i), d), d, acc0);
+    }
+    float sum = hsd_internal_hsum_avx_f32(_mm256_add_ps(acc0, acc1));
+    return weighted_sqeuclid_tail(a, b, w, i, n, sum, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t weighted_sqeuclid_avx512_internal(
+    const float *a, const float *b, const float *w, size_t n, float *result) {
+    hsd_log("Enter weighted_sqeuclid_avx512_internal (n=%zu)", n);
+    size_t i = 0;
+    __m512 acc = _mm512_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        acc = _mm512_fmadd_ps(_mm512_mul_ps(_mm512_loadu_ps(w + i), d), d, acc);
+    }
+    return weighted_sqeuclid_tail(a, b, w, i, n, _mm512_reduce_add_ps(acc), result);
+}
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+static hsd_status_t weighted_sqeuclid_neon_internal(const float *a, const float *b,
+                                                    const float *w, size_t n, float *result) {
+    hsd_log("Enter weighted_sqeuclid_neon_internal (n=%zu)", n);
+    size_t i = 0;
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t d = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        acc = vfmaq_f32(acc, vmulq_f32(vld1q_f32(w + i), d), d);
+    }
+#if defined(__aarch64__)
+    float sum = vaddvq_f32(acc);
+#else
+    float32x2_t tmp = vpadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    tmp = vpadd_f32(tmp, tmp);
+    float sum = vget_lane_f32(tmp, 0);
+#endif
+    return weighted_sqeuclid_tail(a, b, w, i, n, sum, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t weighted_sqeuclid_sve_internal(
+    const float *a, const float *b, const float *w, size_t n, float *result) {
+    hsd_log("Enter weighted_sqeuclid_sve_internal (n=%zu)", n);
+    int64_t i = 0;
+    int64_t n_sve = (int64_t)n;
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    while (i < n_sve) {
+        svbool_t pg = svwhilelt_b32((uint64_t)i, (uint64_t)n_sve);
+        svfloat32_t d = svsub_f32_z(pg, svld1_f32(pg, a + i), svld1_f32(pg, b + i));
+        acc = svmla_f32_m(pg, acc, svmul_f32_z(pg, svld1_f32(pg, w + i), d), d);
+        i += svcntw();
+    }
+    return weighted_sqeuclid_tail(a, b, w, n, n, svaddv_f32(svptrue_b32(), acc), result);
+}
+#endif
+#endif
+
+/* Sequential f64 sum for HSD_PRECISION_DETERMINISTIC; its order does not depend on the backend. */
+static double weighted_sqeuclid_sequential(const float *a, const float *b, const float *w,
+                                           size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double d = (double)a[i] - (double)b[i];
+        sum += (double)w[i] * d * d;
+    }
+    return sum;
+}
+
+static hsd_weighted_sqeuclidean_f32_func_t resolve_weighted_sqeuclidean_f32_internal(void);
+static hsd_status_t weighted_sqeuclidean_f32_resolver_trampoline(const float *a, const float *b,
+                                                                 const float *w, size_t n,
+                                                                 float *result);
+
+static atomic_uintptr_t hsd_weighted_sqeuclidean_f32_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)weighted_sqeuclidean_f32_resolver_trampoline);
+
+hsd_status_t hsd_dist_weighted_sqeuclidean_f32(const float *a, const float *b, const float *w,
+                                               size_t n, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL || w == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    HSD_Precision precision = hsd_get_precision();
+    if (precision == HSD_PRECISION_F64)
+        return hsd_internal_round_result(hsd_internal_precise_weighted_sq_diff_f32(a, b, w, n),
+                                         result);
+    if (precision == HSD_PRECISION_DETERMINISTIC)
+        return hsd_internal_round_result(weighted_sqeuclid_sequential(a, b, w, n), result);
+    hsd_weighted_sqeuclidean_f32_func_t func =
+        (hsd_weighted_sqeuclidean_f32_func_t)atomic_load_explicit(
+            &hsd_weighted_sqeuclidean_f32_ptr, memory_order_acquire);
+    return func(a, b, w, n, result);
+}
+
+static hsd_status_t weighted_sqeuclidean_f32_resolver_trampoline(const float *a, const float *b,
+                                                                 const float *w, size_t n,
+                                                                 float *result) {
+    hsd_weighted_sqeuclidean_f32_func_t resolved = resolve_weighted_sqeuclidean_f32_internal();
+    uintptr_t expected = (uintptr_t)weighted_sqeuclidean_f32_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_weighted_sqeuclidean_f32_ptr, &expected,
+                                            (uintptr_t)resolved, memory_order_release,
+                                            memory_order_relaxed);
+    return resolved(a, b, w, n, result);
+}
+
+static hsd_weighted_sqeuclidean_f32_func_t resolve_weighted_sqeuclidean_f32_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_weighted_sqeuclidean_f32_func_t chosen = weighted_sqeuclid_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Weighted SqEuclidean F32: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = weighted_sqeuclid_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2()) {
+                    chosen = weighted_sqeuclid_avx2_internal;
+                    reason = "AVX2 (Forced)";
+                    supported = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen = weighted_sqeuclid_avx_internal;
+                    reason = "AVX (fallback from forced AVX2)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen = weighted_sqeuclid_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = weighted_sqeuclid_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = weighted_sqeuclid_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen = weighted_sqeuclid_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen = weighted_sqeuclid_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx2()) {
+            chosen = weighted_sqeuclid_avx2_internal;
+            reason = "AVX2 (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen = weighted_sqeuclid_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen = weighted_sqeuclid_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen = weighted_sqeuclid_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen = weighted_sqeuclid_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Weighted SqEuclidean F32 to: %s", reason);
+    return chosen;
+}
+
+typedef hsd_status_t (*hsd_sqeuclidean_f64_func_t)(const double *, const double *, size_t,
+                                                   double *);
+
+static hsd_status_t sqeuclid_f64_scalar_internal(const double *a, const double *b, size_t n,
+                                                 double *result) {
+    hsd_log("Enter sqeuclid_f64_scalar_internal (n=%zu)", n);
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static hsd_status_t sqeuclid_f64_avx_internal(const double *a,
+                                                                             const double *b,
+                                                                             size_t n,
+                                                                             double *result) {
+    hsd_log("Enter sqeuclid_f64_avx_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256d acc = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        __m256d vb = _mm256_loadu_pd(b + i);
+        __m256d d = _mm256_sub_pd(va, vb);
+#if defined(__FMA__)
+        acc = _mm256_fmadd_pd(d, d, acc);
+#else
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(d, d));
+#endif
+    }
+    double sum = hsd_internal_hsum_avx_f64(acc);
+    for (; i < n; ++i) {
+        double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+__attribute__((target("avx2,fma"))) static hsd_status_t sqeuclid_f64_avx2_internal(
+    const double *a, const double *b, size_t n, double *result) {
+    hsd_log("Enter sqeuclid_f64_avx2_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256d acc = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        __m256d vb = _mm256_loadu_pd(b + i);
+        __m256d d = _mm256_sub_pd(va, vb);
+        acc = _mm256_fmadd_pd(d, d, acc);
+    }
+    double sum = hsd_internal_hsum_avx_f64(acc);
+    for (; i < n; ++i) {
+        double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t sqeuclid_f64_avx512_internal(
+    const double *a, const double *b, size_t n, double *result) {
+    hsd_log("Enter sqeuclid_f64_avx512_internal (n=%zu)", n);
+    size_t i = 0;
+    __m512d acc = _mm512_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        __m512d va = _mm512_loadu_pd(a + i);
+        __m512d vb = _mm512_loadu_pd(b + i);
+        __m512d d = _mm512_sub_pd(va, vb);
+        acc = _mm512_fmadd_pd(d, d, acc);
+    }
+    double sum = _mm512_reduce_add_pd(acc);
+    for (; i < n; ++i) {
+        double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+#endif
+
+#if defined(__aarch64__)
+static hsd_status_t sqeuclid_f64_neon_internal(const double *a, const double *b, size_t n,
+                                               double *result) {
+    hsd_log("Enter sqeuclid_f64_neon_internal (n=%zu)", n);
+    size_t i = 0;
+    float64x2_t acc = vdupq_n_f64(0.0);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t va = vld1q_f64(a + i);
+        float64x2_t vb = vld1q_f64(b + i);
+        float64x2_t d = vsubq_f64(va, vb);
+        acc = vfmaq_f64(acc, d, d);
+    }
+    double sum = vaddvq_f64(acc);
+    for (; i < n; ++i) {
+        double d = a[i] - b[i];
+        sum += d * d;
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t sqeuclid_f64_sve_internal(const double *a,
+                                                                              const double *b,
+                                                                              size_t n,
+                                                                              double *result) {
+    hsd_log("Enter sqeuclid_f64_sve_internal (n=%zu)", n);
+    int64_t i = 0;
+    svfloat64_t acc = svdup_n_f64(0.0);
+    while (i < (int64_t)n) {
+        svbool_t pg = svwhilelt_b64((uint64_t)i, (uint64_t)n);
+        svfloat64_t va = svld1_f64(pg, a + i);
+        svfloat64_t vb = svld1_f64(pg, b + i);
+        svfloat64_t d = svsub_f64_z(pg, va, vb);
+        acc = svmla_f64_m(pg, acc, d, d);
+        i += svcntd();
+    }
+    double sum = svaddv_f64(svptrue_b64(), acc);
+    return hsd_internal_f64_result(sum, result);
+}
+
+#endif
+#endif
+
+static hsd_sqeuclidean_f64_func_t resolve_sqeuclidean_f64_internal(void);
+static hsd_status_t sqeuclidean_f64_resolver_trampoline(const double *a, const double *b, size_t n,
+                                                        double *result);
+
+static atomic_uintptr_t hsd_sqeuclidean_f64_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)sqeuclidean_f64_resolver_trampoline);
+
+hsd_status_t hsd_dist_sqeuclidean_f64(const double *a, const double *b, size_t n, double *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    hsd_sqeuclidean_f64_func_t func = (hsd_sqeuclidean_f64_func_t)atomic_load_explicit(
+        &hsd_sqeuclidean_f64_ptr, memory_order_acquire);
+    return func(a, b, n, result);
+}
+
+static hsd_status_t sqeuclidean_f64_resolver_trampoline(const double *a, const double *b, size_t n,
+                                                        double *result) {
+    hsd_log("SqEuclidean F64: resolving backend");
+    hsd_sqeuclidean_f64_func_t resolved_func = resolve_sqeuclidean_f64_internal();
+    uintptr_t expected = (uintptr_t)sqeuclidean_f64_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_sqeuclidean_f64_ptr, &expected,
+                                            (uintptr_t)resolved_func, memory_order_release,
+                                            memory_order_relaxed);
+    hsd_sqeuclidean_f64_func_t current_func = (hsd_sqeuclidean_f64_func_t)atomic_load_explicit(
+        &hsd_sqeuclidean_f64_ptr, memory_order_acquire);
+    return current_func(a, b, n, result);
+}
+
+static hsd_sqeuclidean_f64_func_t resolve_sqeuclidean_f64_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_sqeuclidean_f64_func_t chosen_func = sqeuclid_f64_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("SqEuclidean F64: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen_func = sqeuclid_f64_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2()) {
+                    chosen_func = sqeuclid_f64_avx2_internal;
+                    reason = "AVX2 (Forced)";
+                    supported = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen_func = sqeuclid_f64_avx_internal;
+                    reason = "AVX (fallback from forced AVX2)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen_func = sqeuclid_f64_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen_func = sqeuclid_f64_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen_func = sqeuclid_f64_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                chosen_func = sqeuclid_f64_scalar_internal;
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen_func = sqeuclid_f64_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen_func = sqeuclid_f64_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx2()) {
+            chosen_func = sqeuclid_f64_avx2_internal;
+            reason = "AVX2 (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen_func = sqeuclid_f64_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen_func = sqeuclid_f64_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen_func = sqeuclid_f64_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen_func = sqeuclid_f64_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved SqEuclidean F64 to: %s", reason);
+    return chosen_func;
+}
@@ -293,3 +293,276 @@ static hsd_hamming_u8_func_t resolve_hamming_u8_internal(void) {
     hsd_log("Dispatch: Resolved Hamming U8 to: %s", reason);
     return chosen_func;
 }
+
+/*
+ * Early-abandoning variant: the running count is checked every HAMMING_BOUND_STRIDE bytes and
+ * the scan stops once it exceeds the threshold, reporting UINT64_MAX.
+ */
+#define HAMMING_BOUND_STRIDE 256
+
+typedef hsd_status_t (*hsd_hamming_bounded_u8_func_t)(const uint8_t *, const uint8_t *, size_t,
+                                                      uint64_t, uint64_t *);
+
+static hsd_status_t hamming_bounded_scalar_internal(const uint8_t *a, const uint8_t *b, size_t n,
+                                                    uint64_t threshold, uint64_t *result) {
+    hsd_log("Enter hamming_bounded_scalar_internal (n=%zu)", n);
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += (uint64_t)hsd_internal_popcount8(a[i] ^ b[i]);
+        if ((i + 1) % HAMMING_BOUND_STRIDE == 0 && total > threshold) {
+            *result = UINT64_MAX;
+            return HSD_SUCCESS;
+        }
+    }
+    *result = total > threshold ? UINT64_MAX : total;
+    return HSD_SUCCESS;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx512f,avx512vpopcntdq"))) static hsd_status_t
+hamming_bounded_avx512_vpopcntdq_internal(const uint8_t *a, const uint8_t *b, size_t n,
+                                          uint64_t threshold, uint64_t *result) {
+    hsd_log("Enter hamming_bounded_avx512_vpopcntdq_internal (n=%zu)", n);
+    size_t i = 0;
+    __m512i acc = _mm512_setzero_si512();
+    while (i + 64 <= n) {
+        size_t block_end = n - i > HAMMING_BOUND_STRIDE ? i + HAMMING_BOUND_STRIDE : n;
+        for (; i + 64 <= block_end; i += 64) {
+            __m512i va = _mm512_loadu_si512((const __m512i *)(a + i));
+            __m512i vb = _mm512_loadu_si512((const __m512i *)(b + i));
+            acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_xor_si512(va, vb)));
+        }
+        if (i + 64 <= n && (uint64_t)_mm512_reduce_add_epi64(acc) > threshold) {
+            *result = UINT64_MAX;
+            return HSD_SUCCESS;
+        }
+    }
+    uint64_t total = (uint64_t)_mm512_reduce_add_epi64(acc);
+    for (; i < n; ++i) total += (uint64_t)hsd_internal_popcount8(a[i] ^ b[i]);
+    *result = total > threshold ? UINT64_MAX : total;
+    return HSD_SUCCESS;
+}
+
+__attribute__((target("avx2"))) static inline uint64_t hamming_bounded_hsum_avx2(__m256i acc) {
+    uint64_t sums[4];
+    _mm256_storeu_si256((__m256i *)sums, acc);
+    return sums[0] + sums[1] + sums[2] + sums[3];
+}
+
+__attribute__((target("avx2"))) static hsd_status_t hamming_bounded_avx2_pshufb_internal(
+    const uint8_t *a, const uint8_t *b, size_t n, uint64_t threshold, uint64_t *result) {
+    hsd_log("Enter hamming_bounded_avx2_pshufb_internal (n=%zu)", n);
+
+    static const uint8_t popcount_table[32] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+    const __m256i lookup = _mm256_loadu_si256((const __m256i *)popcount_table);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    __m256i acc = _mm256_setzero_si256();
+
+    while (i + 32 <= n) {
+        size_t block_end = n - i > HAMMING_BOUND_STRIDE ? i + HAMMING_BOUND_STRIDE : n;
+        for (; i + 32 <= block_end; i += 32) {
+            __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+            __m256i x = _mm256_xor_si256(va, vb);
+            __m256i lo = _mm256_and_si256(x, low_mask);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask);
+            __m256i pc =
+                _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(pc, _mm256_setzero_si256()));
+        }
+        if (i + 32 <= n && hamming_bounded_hsum_avx2(acc) > threshold) {
+            *result = UINT64_MAX;
+            return HSD_SUCCESS;
+        }
+    }
+
+    uint64_t total = hamming_bounded_hsum_avx2(acc);
+    for (; i < n; ++i) total += hsd_internal_popcount8(a[i] ^ b[i]);
+    *result = total > threshold ? UINT64_MAX : total;
+    return HSD_SUCCESS;
+}
+
+#endif
+
+#if defined(__aarch64__) || defined(__arm__)
+static inline uint64_t hamming_bounded_hsum_neon(uint64x2_t acc) {
+#if defined(__aarch64__)
+    return vaddvq_u64(acc);
+#else
+    return vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+#endif
+}
+
+static hsd_status_t hamming_bounded_neon_internal(const uint8_t *a, const uint8_t *b, size_t n,
+                                                  uint64_t threshold, uint64_t *result) {
+    hsd_log("Enter hamming_bounded_neon_internal (n=%zu)", n);
+    size_t i = 0;
+    uint64x2_t acc = vdupq_n_u64(0);
+    while (i + 16 <= n) {
+        size_t block_end = n - i > HAMMING_BOUND_STRIDE ? i + HAMMING_BOUND_STRIDE : n;
+        for (; i + 16 <= block_end; i += 16) {
+            uint8x16_t pc = vcntq_u8(veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+            acc = vpadalq_u32(acc, vpaddlq_u16(vpaddlq_u8(pc)));
+        }
+        if (i + 16 <= n && hamming_bounded_hsum_neon(acc) > threshold) {
+            *result = UINT64_MAX;
+            return HSD_SUCCESS;
+        }
+    }
+    uint64_t total = hamming_bounded_hsum_neon(acc);
+    for (; i < n; ++i) total += (uint64_t)hsd_internal_popcount8(a[i] ^ b[i]);
+    *result = total > threshold ? UINT64_MAX : total;
+    return HSD_SUCCESS;
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t hamming_bounded_sve_internal(
+    const uint8_t *a, const uint8_t *b, size_t n, uint64_t threshold, uint64_t *result) {
+    hsd_log("Enter hamming_bounded_sve_internal (n=%zu)", n);
+    uint64_t i = 0;
+    uint64_t next_check = HAMMING_BOUND_STRIDE;
+    uint64_t total = 0;
+    while (i < n) {
+        svbool_t pg_b8 = svwhilelt_b8(i, (uint64_t)n);
+        svuint8_t x = sveor_z(pg_b8, svld1_u8(pg_b8, a + i), svld1_u8(pg_b8, b + i));
+        svuint8_t pc8 = svcnt_u8_z(pg_b8, x);
+        svbool_t pg_b16 = svwhilelt_b16(i, (uint64_t)n);
+        total += svaddv_u16(pg_b16, svunpklo_u16(pc8)) + svaddv_u16(pg_b16, svunpkhi_u16(pc8));
+        i += svcntb();
+        if (i >= next_check && i < n) {
+            if (total > threshold) {
+                *result = UINT64_MAX;
+                return HSD_SUCCESS;
+            }
+            next_check = i + HAMMING_BOUND_STRIDE;
+        }
+    }
+    *result = total > threshold ? UINT64_MAX : total;
+    return HSD_SUCCESS;
+}
+#endif
+#endif
+
+static hsd_hamming_bounded_u8_func_t resolve_hamming_bounded_u8_internal(void);
+static hsd_status_t hamming_bounded_u8_resolver_trampoline(const uint8_t *, const uint8_t *, size_t,
+                                                           uint64_t, uint64_t *);
+
+static atomic_uintptr_t hsd_hamming_bounded_u8_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)hamming_bounded_u8_resolver_trampoline);
+
+hsd_status_t hsd_dist_hamming_bounded_u8(const uint8_t *a, const uint8_t *b, size_t n,
+                                         uint64_t threshold, uint64_t *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = UINT64_MAX;
+        return HSD_ERR_NULL_PTR;
+    }
+    hsd_hamming_bounded_u8_func_t func = (hsd_hamming_bounded_u8_func_t)atomic_load_explicit(
+        &hsd_hamming_bounded_u8_ptr, memory_order_acquire);
+    return func(a, b, n, threshold, result);
+}
+
+static hsd_status_t hamming_bounded_u8_resolver_trampoline(const uint8_t *a, const uint8_t *b,
+                                                           size_t n, uint64_t threshold,
+                                                           uint64_t *result) {
+    hsd_hamming_bounded_u8_func_t resolved = resolve_hamming_bounded_u8_internal();
+    uintptr_t exp = (uintptr_t)hamming_bounded_u8_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_hamming_bounded_u8_ptr, &exp, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved(a, b, n, threshold, result);
+}
+
+static hsd_hamming_bounded_u8_func_t resolve_hamming_bounded_u8_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_hamming_bounded_u8_func_t chosen_func = hamming_bounded_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Hamming Bounded U8: Forced backend %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512VPOPCNTDQ:
+                if (hsd_cpu_has_avx512f() && hsd_cpu_has_avx512vpopcntdq()) {
+                    chosen_func = hamming_bounded_avx512_vpopcntdq_internal;
+                    reason = "AVX512VPOPCNTDQ (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2()) {
+                    chosen_func = hamming_bounded_avx2_pshufb_internal;
+                    reason = "AVX2 (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen_func = hamming_bounded_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen_func = hamming_bounded_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#endif
+            case HSD_BACKEND_SCALAR:
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Forced backend %d not supported; falling back to Scalar.", forced);
+            chosen_func = hamming_bounded_scalar_internal;
+            reason = "Scalar (Fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f() && hsd_cpu_has_avx512vpopcntdq()) {
+            chosen_func = hamming_bounded_avx512_vpopcntdq_internal;
+            reason = "AVX512VPOPCNTDQ (Auto)";
+        } else if (hsd_cpu_has_avx2()) {
+            chosen_func = hamming_bounded_avx2_pshufb_internal;
+            reason = "AVX2 (Auto)";
+        }
+#elif defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen_func = hamming_bounded_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen_func = hamming_bounded_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen_func = hamming_bounded_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Hamming Bounded U8 to: %s", reason);
+    return chosen_func;
+}
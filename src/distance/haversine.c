@@ -0,0 +1,853 @@
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+/*
+ * Batched haversine distance from one query point to n points stored as separate latitude and
+ * longitude arrays, all in degrees. The result is the central angle in radians, i.e. the
+ * great-circle distance on the unit sphere; multiply by the sphere radius to get a length.
+ *
+ *   h = sin^2(dlat / 2) + cos(lat) * cos(query_lat) * sin^2(dlon / 2)
+ *   d = 2 * asin(sqrt(min(h, 1)))
+ *
+ * The SIMD kernels evaluate sin and cos with Cody-Waite reduction to [-pi/4, pi/4] and the
+ * Cephes minimax polynomials; cos(x) is sin(x) shifted by one quadrant after the reduction, so
+ * it costs no extra rounding. asin(sqrt(h)) uses the Cephes asin approximation. For h > 1/4
+ * the reduced argument is taken as (1 - h) / (2 * (1 + sqrt(h))) instead of (1 - sqrt(h)) / 2,
+ * which avoids cancelling in 1 - sqrt(h). Each step is within about 4e-7 relative error in
+ * f32 and a few ulp in f64. Near antipodal points the formula itself is ill-conditioned: an
+ * error e in h moves d by about e / cos(d / 2). The scalar kernels call libm in double.
+ *
+ * A kernel returns true if any output is NaN (a NaN or infinite input coordinate).
+ */
+#define HSD_HAV_HALF_DEG_TO_RAD 0.00872664625997164788461845384244306
+#define HSD_HAV_DEG_TO_RAD 0.0174532925199432957692369076848861
+#define HSD_HAV_2_OVER_PI 0.636619772367581343075535053490057
+#define HSD_HAV_PI_2 1.57079632679489661923132169163975
+
+#define HSD_HAV_PIO2_HI_F32 1.5703125f
+#define HSD_HAV_PIO2_MID_F32 4.837512969970703125e-4f
+#define HSD_HAV_PIO2_LO_F32 7.54978995489188216e-8f
+
+#define HSD_HAV_PIO2_HI_F64 1.57079625129699707031
+#define HSD_HAV_PIO2_MID_F64 7.54978941586159635336e-8
+#define HSD_HAV_PIO2_LO_F64 5.39030285815811905290e-15
+
+#define HSD_HAV_PIO4_F64 7.85398163397448309616e-1
+#define HSD_HAV_MOREBITS_F64 6.123233995736765886130e-17
+
+/* sin(r) = r + r^3 * S(r^2) and cos(r) = 1 - r^2 / 2 + r^4 * C(r^2) on [-pi/4, pi/4]. */
+static const float hav_sin_f32[3] = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+static const float hav_cos_f32[3] = {2.443315711809948e-5f, -1.388731625493765e-3f,
+                                     4.166664568298827e-2f};
+/* asin(x) = x + x^3 * A(x^2) on [0, 1/2]. */
+static const float hav_asin_f32[5] = {4.2163199048e-2f, 2.4181311049e-2f, 4.5470025998e-2f,
+                                      7.4953002686e-2f, 1.6666752422e-1f};
+
+static const double hav_sin_f64[6] = {1.58962301576546568060e-10, -2.50507477628578072866e-8,
+                                      2.75573136213857245213e-6,  -1.98412698295895385996e-4,
+                                      8.33333333332211858878e-3,  -1.66666666666666307295e-1};
+static const double hav_cos_f64[6] = {-1.13585365213876817300e-11, 2.08757008419747316778e-9,
+                                      -2.75573141792967388112e-7,  2.48015872888517045348e-5,
+                                      -1.38888888888730564116e-3,  4.16666666666665929218e-2};
+/* asin(x) = x + x^3 * P(x^2) / Q(x^2) for x <= 0.625, and a rational R / S in 1 - x above. */
+static const double hav_asin_p_f64[6] = {4.253011369004428248960e-3, -6.019598008014123785661e-1,
+                                         5.444622390564711410273e0,  -1.626247967210700244449e1,
+                                         1.956261983317594739197e1,  -8.198089802484824371615e0};
+static const double hav_asin_q_f64[6] = {1.0,
+                                         -1.474091372988853791896e1, 7.049610280856842141659e1,
+                                         -1.471791292232726029859e2, 1.395105614657485689735e2,
+                                         -4.918853881490881290097e1};
+static const double hav_asin_r_f64[5] = {2.967721961301243206100e-3, -5.634242780008963776856e-1,
+                                         6.968710824104713396794e0,  -2.556901049652824852289e1,
+                                         2.853665548261061424989e1};
+static const double hav_asin_s_f64[5] = {1.0, -2.194779531642920639778e1,
+                                         1.470656354026814941758e2, -3.838770957603691357202e2,
+                                         3.424398657913078477438e2};
+
+typedef struct {
+    bool (*batch_f32)(const float *lat, const float *lon, size_t n, float qlat, float qlon,
+                      float cos_qlat, float *out);
+    bool (*batch_f64)(const double *lat, const double *lon, size_t n, double qlat, double qlon,
+                      double cos_qlat, double *out);
+    const char *name;
+} hsd_haversine_kernels_t;
+
+static inline double hav_point_scalar(double lat, double lon, double qlat, double qlon,
+                                      double cos_qlat) {
+    double s_lat = sin((lat - qlat) * HSD_HAV_HALF_DEG_TO_RAD);
+    double s_lon = sin((lon - qlon) * HSD_HAV_HALF_DEG_TO_RAD);
+    double h = s_lat * s_lat + cos(lat * HSD_HAV_DEG_TO_RAD) * cos_qlat * s_lon * s_lon;
+    return 2.0 * asin(sqrt(h > 1.0 ? 1.0 : h));
+}
+
+static bool haversine_f32_scalar(const float *lat, const float *lon, size_t n, float qlat,
+                                 float qlon, float cos_qlat, float *out) {
+    (void)cos_qlat;
+    double cq = cos((double)qlat * HSD_HAV_DEG_TO_RAD);
+    bool bad = false;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = (float)hav_point_scalar(lat[i], lon[i], qlat, qlon, cq);
+        bad |= isnan(out[i]);
+    }
+    return bad;
+}
+
+static bool haversine_f64_scalar(const double *lat, const double *lon, size_t n, double qlat,
+                                 double qlon, double cos_qlat, double *out) {
+    bool bad = false;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = hav_point_scalar(lat[i], lon[i], qlat, qlon, cos_qlat);
+        bad |= isnan(out[i]);
+    }
+    return bad;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+/* sin(x + offset * pi / 2); offset 1 gives cos(x). */
+__attribute__((target("avx2,fma"))) static inline __m256 hav_sin_avx2(__m256 x, int offset) {
+    __m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps((float)HSD_HAV_2_OVER_PI)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(j, _mm256_set1_ps(HSD_HAV_PIO2_HI_F32), x);
+    r = _mm256_fnmadd_ps(j, _mm256_set1_ps(HSD_HAV_PIO2_MID_F32), r);
+    r = _mm256_fnmadd_ps(j, _mm256_set1_ps(HSD_HAV_PIO2_LO_F32), r);
+    __m256 z = _mm256_mul_ps(r, r);
+    __m256 s = _mm256_set1_ps(hav_sin_f32[0]);
+    for (int k = 1; k < 3; ++k) s = _mm256_fmadd_ps(s, z, _mm256_set1_ps(hav_sin_f32[k]));
+    s = _mm256_fmadd_ps(_mm256_mul_ps(s, z), r, r);
+    __m256 c = _mm256_set1_ps(hav_cos_f32[0]);
+    for (int k = 1; k < 3; ++k) c = _mm256_fmadd_ps(c, z, _mm256_set1_ps(hav_cos_f32[k]));
+    c = _mm256_fmadd_ps(_mm256_mul_ps(c, z), z,
+                        _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.0f)));
+    __m256i q = _mm256_add_epi32(_mm256_cvtps_epi32(j), _mm256_set1_epi32(offset));
+    __m256i one = _mm256_set1_epi32(1);
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+    __m256 sign = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+    return _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sign);
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256 hav_point_avx2(__m256 lat, __m256 lon,
+                                                                        float qlat, float qlon,
+                                                                        float cos_qlat) {
+    const __m256 half_deg = _mm256_set1_ps((float)HSD_HAV_HALF_DEG_TO_RAD);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 s_lat = hav_sin_avx2(_mm256_mul_ps(_mm256_sub_ps(lat, _mm256_set1_ps(qlat)), half_deg),
+                                0);
+    __m256 s_lon = hav_sin_avx2(_mm256_mul_ps(_mm256_sub_ps(lon, _mm256_set1_ps(qlon)), half_deg),
+                                0);
+    __m256 c_lat = hav_sin_avx2(_mm256_mul_ps(lat, _mm256_set1_ps((float)HSD_HAV_DEG_TO_RAD)), 1);
+    __m256 h = _mm256_mul_ps(_mm256_mul_ps(c_lat, _mm256_set1_ps(cos_qlat)),
+                             _mm256_mul_ps(s_lon, s_lon));
+    h = _mm256_min_ps(one, _mm256_fmadd_ps(s_lat, s_lat, h));
+    /* asin(sqrt(h)); above sqrt(h) = 1/2 use asin(s) = pi/2 - 2 * asin(sqrt((1 - s) / 2)). */
+    __m256 s = _mm256_sqrt_ps(h);
+    __m256 big = _mm256_cmp_ps(s, _mm256_set1_ps(0.5f), _CMP_GT_OQ);
+    __m256 z_big = _mm256_div_ps(_mm256_mul_ps(_mm256_sub_ps(one, h), _mm256_set1_ps(0.5f)),
+                                 _mm256_add_ps(one, s));
+    __m256 z = _mm256_blendv_ps(h, z_big, big);
+    __m256 x = _mm256_blendv_ps(s, _mm256_sqrt_ps(z_big), big);
+    __m256 p = _mm256_set1_ps(hav_asin_f32[0]);
+    for (int k = 1; k < 5; ++k) p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(hav_asin_f32[k]));
+    __m256 y = _mm256_fmadd_ps(_mm256_mul_ps(x, z), p, x);
+    y = _mm256_blendv_ps(y, _mm256_fnmadd_ps(_mm256_set1_ps(2.0f), y,
+                                             _mm256_set1_ps((float)HSD_HAV_PI_2)),
+                         big);
+    return _mm256_add_ps(y, y);
+}
+
+__attribute__((target("avx2,fma"))) static bool haversine_f32_avx2(const float *lat,
+                                                                   const float *lon, size_t n,
+                                                                   float qlat, float qlon,
+                                                                   float cos_qlat, float *out) {
+    __m256 bad = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = hav_point_avx2(_mm256_loadu_ps(lat + i), _mm256_loadu_ps(lon + i), qlat, qlon,
+                                  cos_qlat);
+        bad = _mm256_or_ps(bad, _mm256_cmp_ps(d, d, _CMP_UNORD_Q));
+        _mm256_storeu_ps(out + i, d);
+    }
+    if (i < n) {
+        /* Run the tail through the same polynomials so results do not depend on position. */
+        float tl[8] = {0.0f}, tn[8] = {0.0f}, td[8];
+        memcpy(tl, lat + i, (n - i) * sizeof(float));
+        memcpy(tn, lon + i, (n - i) * sizeof(float));
+        __m256 d = hav_point_avx2(_mm256_loadu_ps(tl), _mm256_loadu_ps(tn), qlat, qlon, cos_qlat);
+        bad = _mm256_or_ps(bad, _mm256_cmp_ps(d, d, _CMP_UNORD_Q));
+        _mm256_storeu_ps(td, d);
+        memcpy(out + i, td, (n - i) * sizeof(float));
+    }
+    return _mm256_movemask_ps(bad) != 0;
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256d hav_sin_f64_avx2(__m256d x,
+                                                                           int offset) {
+    __m256d j = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(HSD_HAV_2_OVER_PI)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_fnmadd_pd(j, _mm256_set1_pd(HSD_HAV_PIO2_HI_F64), x);
+    r = _mm256_fnmadd_pd(j, _mm256_set1_pd(HSD_HAV_PIO2_MID_F64), r);
+    r = _mm256_fnmadd_pd(j, _mm256_set1_pd(HSD_HAV_PIO2_LO_F64), r);
+    __m256d z = _mm256_mul_pd(r, r);
+    __m256d s = _mm256_set1_pd(hav_sin_f64[0]);
+    for (int k = 1; k < 6; ++k) s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(hav_sin_f64[k]));
+    s = _mm256_fmadd_pd(_mm256_mul_pd(s, z), r, r);
+    __m256d c = _mm256_set1_pd(hav_cos_f64[0]);
+    for (int k = 1; k < 6; ++k) c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(hav_cos_f64[k]));
+    c = _mm256_fmadd_pd(_mm256_mul_pd(c, z), z,
+                        _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, _mm256_set1_pd(1.0)));
+    __m128i q32 = _mm_add_epi32(_mm256_cvtpd_epi32(j), _mm_set1_epi32(offset));
+    __m128i one = _mm_set1_epi32(1);
+    __m256d swap = _mm256_castsi256_pd(
+        _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(_mm_and_si128(q32, one), one)));
+    __m256d sign = _mm256_castsi256_pd(_mm256_slli_epi64(
+        _mm256_cvtepi32_epi64(_mm_and_si128(q32, _mm_set1_epi32(2))), 62));
+    return _mm256_xor_pd(_mm256_blendv_pd(s, c, swap), sign);
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256d hav_poly_f64_avx2(const double *c,
+                                                                            int count,
+                                                                            __m256d z) {
+    __m256d p = _mm256_set1_pd(c[0]);
+    for (int k = 1; k < count; ++k) p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(c[k]));
+    return p;
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256d hav_point_f64_avx2(__m256d lat,
+                                                                             __m256d lon,
+                                                                             double qlat,
+                                                                             double qlon,
+                                                                             double cos_qlat) {
+    const __m256d half_deg = _mm256_set1_pd(HSD_HAV_HALF_DEG_TO_RAD);
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256d s_lat =
+        hav_sin_f64_avx2(_mm256_mul_pd(_mm256_sub_pd(lat, _mm256_set1_pd(qlat)), half_deg), 0);
+    __m256d s_lon =
+        hav_sin_f64_avx2(_mm256_mul_pd(_mm256_sub_pd(lon, _mm256_set1_pd(qlon)), half_deg), 0);
+    __m256d c_lat = hav_sin_f64_avx2(_mm256_mul_pd(lat, _mm256_set1_pd(HSD_HAV_DEG_TO_RAD)), 1);
+    __m256d h = _mm256_mul_pd(_mm256_mul_pd(c_lat, _mm256_set1_pd(cos_qlat)),
+                              _mm256_mul_pd(s_lon, s_lon));
+    h = _mm256_min_pd(one, _mm256_fmadd_pd(s_lat, s_lat, h));
+    __m256d a = _mm256_sqrt_pd(h);
+    /* Small branch: a + a * h * P(h) / Q(h). */
+    __m256d ps = _mm256_div_pd(_mm256_mul_pd(h, hav_poly_f64_avx2(hav_asin_p_f64, 6, h)),
+                               hav_poly_f64_avx2(hav_asin_q_f64, 6, h));
+    __m256d small = _mm256_fmadd_pd(a, ps, a);
+    /* Large branch in zz = 1 - a, computed from h without cancellation. */
+    __m256d zz = _mm256_div_pd(_mm256_sub_pd(one, h), _mm256_add_pd(one, a));
+    __m256d pr = _mm256_div_pd(_mm256_mul_pd(zz, hav_poly_f64_avx2(hav_asin_r_f64, 5, zz)),
+                               hav_poly_f64_avx2(hav_asin_s_f64, 5, zz));
+    __m256d t = _mm256_sqrt_pd(_mm256_add_pd(zz, zz));
+    __m256d large = _mm256_sub_pd(_mm256_set1_pd(HSD_HAV_PIO4_F64), t);
+    large = _mm256_sub_pd(large, _mm256_fmsub_pd(t, pr, _mm256_set1_pd(HSD_HAV_MOREBITS_F64)));
+    large = _mm256_add_pd(large, _mm256_set1_pd(HSD_HAV_PIO4_F64));
+    __m256d y = _mm256_blendv_pd(small, large, _mm256_cmp_pd(a, _mm256_set1_pd(0.625), _CMP_GT_OQ));
+    return _mm256_add_pd(y, y);
+}
+
+__attribute__((target("avx2,fma"))) static bool haversine_f64_avx2(const double *lat,
+                                                                   const double *lon, size_t n,
+                                                                   double qlat, double qlon,
+                                                                   double cos_qlat, double *out) {
+    __m256d bad = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d d = hav_point_f64_avx2(_mm256_loadu_pd(lat + i), _mm256_loadu_pd(lon + i), qlat,
+                                       qlon, cos_qlat);
+        bad = _mm256_or_pd(bad, _mm256_cmp_pd(d, d, _CMP_UNORD_Q));
+        _mm256_storeu_pd(out + i, d);
+    }
+    if (i < n) {
+        double tl[4] = {0.0}, tn[4] = {0.0}, td[4];
+        memcpy(tl, lat + i, (n - i) * sizeof(double));
+        memcpy(tn, lon + i, (n - i) * sizeof(double));
+        __m256d d = hav_point_f64_avx2(_mm256_loadu_pd(tl), _mm256_loadu_pd(tn), qlat, qlon,
+                                       cos_qlat);
+        bad = _mm256_or_pd(bad, _mm256_cmp_pd(d, d, _CMP_UNORD_Q));
+        _mm256_storeu_pd(td, d);
+        memcpy(out + i, td, (n - i) * sizeof(double));
+    }
+    return _mm256_movemask_pd(bad) != 0;
+}
+
+__attribute__((target("avx512f"))) static inline __m512 hav_sin_avx512(__m512 x, int offset) {
+    __m512 j = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps((float)HSD_HAV_2_OVER_PI)),
+                                    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 r = _mm512_fnmadd_ps(j, _mm512_set1_ps(HSD_HAV_PIO2_HI_F32), x);
+    r = _mm512_fnmadd_ps(j, _mm512_set1_ps(HSD_HAV_PIO2_MID_F32), r);
+    r = _mm512_fnmadd_ps(j, _mm512_set1_ps(HSD_HAV_PIO2_LO_F32), r);
+    __m512 z = _mm512_mul_ps(r, r);
+    __m512 s = _mm512_set1_ps(hav_sin_f32[0]);
+    for (int k = 1; k < 3; ++k) s = _mm512_fmadd_ps(s, z, _mm512_set1_ps(hav_sin_f32[k]));
+    s = _mm512_fmadd_ps(_mm512_mul_ps(s, z), r, r);
+    __m512 c = _mm512_set1_ps(hav_cos_f32[0]);
+    for (int k = 1; k < 3; ++k) c = _mm512_fmadd_ps(c, z, _mm512_set1_ps(hav_cos_f32[k]));
+    c = _mm512_fmadd_ps(_mm512_mul_ps(c, z), z,
+                        _mm512_fnmadd_ps(_mm512_set1_ps(0.5f), z, _mm512_set1_ps(1.0f)));
+    __m512i q = _mm512_add_epi32(_mm512_cvtps_epi32(j), _mm512_set1_epi32(offset));
+    __mmask16 swap = _mm512_test_epi32_mask(q, _mm512_set1_epi32(1));
+    __m512i sign = _mm512_slli_epi32(_mm512_and_si512(q, _mm512_set1_epi32(2)), 30);
+    __m512 v = _mm512_mask_blend_ps(swap, s, c);
+    return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(v), sign));
+}
+
+__attribute__((target("avx512f"))) static inline __m512 hav_point_avx512(__m512 lat, __m512 lon,
+                                                                         float qlat, float qlon,
+                                                                         float cos_qlat) {
+    const __m512 half_deg = _mm512_set1_ps((float)HSD_HAV_HALF_DEG_TO_RAD);
+    const __m512 one = _mm512_set1_ps(1.0f);
+    __m512 s_lat =
+        hav_sin_avx512(_mm512_mul_ps(_mm512_sub_ps(lat, _mm512_set1_ps(qlat)), half_deg), 0);
+    __m512 s_lon =
+        hav_sin_avx512(_mm512_mul_ps(_mm512_sub_ps(lon, _mm512_set1_ps(qlon)), half_deg), 0);
+    __m512 c_lat = hav_sin_avx512(_mm512_mul_ps(lat, _mm512_set1_ps((float)HSD_HAV_DEG_TO_RAD)),
+                                  1);
+    __m512 h = _mm512_mul_ps(_mm512_mul_ps(c_lat, _mm512_set1_ps(cos_qlat)),
+                             _mm512_mul_ps(s_lon, s_lon));
+    h = _mm512_min_ps(one, _mm512_fmadd_ps(s_lat, s_lat, h));
+    __m512 s = _mm512_sqrt_ps(h);
+    __mmask16 big = _mm512_cmp_ps_mask(s, _mm512_set1_ps(0.5f), _CMP_GT_OQ);
+    __m512 z_big = _mm512_div_ps(_mm512_mul_ps(_mm512_sub_ps(one, h), _mm512_set1_ps(0.5f)),
+                                 _mm512_add_ps(one, s));
+    __m512 z = _mm512_mask_blend_ps(big, h, z_big);
+    __m512 x = _mm512_mask_blend_ps(big, s, _mm512_sqrt_ps(z_big));
+    __m512 p = _mm512_set1_ps(hav_asin_f32[0]);
+    for (int k = 1; k < 5; ++k) p = _mm512_fmadd_ps(p, z, _mm512_set1_ps(hav_asin_f32[k]));
+    __m512 y = _mm512_fmadd_ps(_mm512_mul_ps(x, z), p, x);
+    y = _mm512_mask_blend_ps(big, y, _mm512_fnmadd_ps(_mm512_set1_ps(2.0f), y,
+                                                      _mm512_set1_ps((float)HSD_HAV_PI_2)));
+    return _mm512_add_ps(y, y);
+}
+
+__attribute__((target("avx512f"))) static bool haversine_f32_avx512(const float *lat,
+                                                                    const float *lon, size_t n,
+                                                                    float qlat, float qlon,
+                                                                    float cos_qlat, float *out) {
+    __mmask16 bad = 0;
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 in = n - i >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1u);
+        __m512 d = hav_point_avx512(_mm512_maskz_loadu_ps(in, lat + i),
+                                    _mm512_maskz_loadu_ps(in, lon + i), qlat, qlon, cos_qlat);
+        bad |= _mm512_mask_cmp_ps_mask(in, d, d, _CMP_UNORD_Q);
+        _mm512_mask_storeu_ps(out + i, in, d);
+    }
+    return bad != 0;
+}
+
+__attribute__((target("avx512f"))) static inline __m512d hav_sin_f64_avx512(__m512d x,
+                                                                            int offset) {
+    __m512d j = _mm512_roundscale_pd(_mm512_mul_pd(x, _mm512_set1_pd(HSD_HAV_2_OVER_PI)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_fnmadd_pd(j, _mm512_set1_pd(HSD_HAV_PIO2_HI_F64), x);
+    r = _mm512_fnmadd_pd(j, _mm512_set1_pd(HSD_HAV_PIO2_MID_F64), r);
+    r = _mm512_fnmadd_pd(j, _mm512_set1_pd(HSD_HAV_PIO2_LO_F64), r);
+    __m512d z = _mm512_mul_pd(r, r);
+    __m512d s = _mm512_set1_pd(hav_sin_f64[0]);
+    for (int k = 1; k < 6; ++k) s = _mm512_fmadd_pd(s, z, _mm512_set1_pd(hav_sin_f64[k]));
+    s = _mm512_fmadd_pd(_mm512_mul_pd(s, z), r, r);
+    __m512d c = _mm512_set1_pd(hav_cos_f64[0]);
+    for (int k = 1; k < 6; ++k) c = _mm512_fmadd_pd(c, z, _mm512_set1_pd(hav_cos_f64[k]));
+    c = _mm512_fmadd_pd(_mm512_mul_pd(c, z), z,
+                        _mm512_fnmadd_pd(_mm512_set1_pd(0.5), z, _mm512_set1_pd(1.0)));
+    __m512i q = _mm512_cvtepi32_epi64(
+        _mm256_add_epi32(_mm512_cvtpd_epi32(j), _mm256_set1_epi32(offset)));
+    __mmask8 swap = _mm512_test_epi64_mask(q, _mm512_set1_epi64(1));
+    __m512i sign = _mm512_slli_epi64(_mm512_and_si512(q, _mm512_set1_epi64(2)), 62);
+    __m512d v = _mm512_mask_blend_pd(swap, s, c);
+    return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(v), sign));
+}
+
+__attribute__((target("avx512f"))) static inline __m512d hav_poly_f64_avx512(const double *c,
+                                                                             int count,
+                                                                             __m512d z) {
+    __m512d p = _mm512_set1_pd(c[0]);
+    for (int k = 1; k < count; ++k) p = _mm512_fmadd_pd(p, z, _mm512_set1_pd(c[k]));
+    return p;
+}
+
+__attribute__((target("avx512f"))) static inline __m512d hav_point_f64_avx512(__m512d lat,
+                                                                              __m512d lon,
+                                                                              double qlat,
+                                                                              double qlon,
+                                                                              double cos_qlat) {
+    const __m512d half_deg = _mm512_set1_pd(HSD_HAV_HALF_DEG_TO_RAD);
+    const __m512d one = _mm512_set1_pd(1.0);
+    __m512d s_lat =
+        hav_sin_f64_avx512(_mm512_mul_pd(_mm512_sub_pd(lat, _mm512_set1_pd(qlat)), half_deg), 0);
+    __m512d s_lon =
+        hav_sin_f64_avx512(_mm512_mul_pd(_mm512_sub_pd(lon, _mm512_set1_pd(qlon)), half_deg), 0);
+    __m512d c_lat =
+        hav_sin_f64_avx512(_mm512_mul_pd(lat, _mm512_set1_pd(HSD_HAV_DEG_TO_RAD)), 1);
+    __m512d h = _mm512_mul_pd(_mm512_mul_pd(c_lat, _mm512_set1_pd(cos_qlat)),
+                              _mm512_mul_pd(s_lon, s_lon));
+    h = _mm512_min_pd(one, _mm512_fmadd_pd(s_lat, s_lat, h));
+    __m512d a = _mm512_sqrt_pd(h);
+    __m512d ps = _mm512_div_pd(_mm512_mul_pd(h, hav_poly_f64_avx512(hav_asin_p_f64, 6, h)),
+                               hav_poly_f64_avx512(hav_asin_q_f64, 6, h));
+    __m512d small = _mm512_fmadd_pd(a, ps, a);
+    __m512d zz = _mm512_div_pd(_mm512_sub_pd(one, h), _mm512_add_pd(one, a));
+    __m512d pr = _mm512_div_pd(_mm512_mul_pd(zz, hav_poly_f64_avx512(hav_asin_r_f64, 5, zz)),
+                               hav_poly_f64_avx512(hav_asin_s_f64, 5, zz));
+    __m512d t = _mm512_sqrt_pd(_mm512_add_pd(zz, zz));
+    __m512d large = _mm512_sub_pd(_mm512_set1_pd(HSD_HAV_PIO4_F64), t);
+    large = _mm512_sub_pd(large, _mm512_fmsub_pd(t, pr, _mm512_set1_pd(HSD_HAV_MOREBITS_F64)));
+    large = _mm512_add_pd(large, _mm512_set1_pd(HSD_HAV_PIO4_F64));
+    __mmask8 big = _mm512_cmp_pd_mask(a, _mm512_set1_pd(0.625), _CMP_GT_OQ);
+    __m512d y = _mm512_mask_blend_pd(big, small, large);
+    return _mm512_add_pd(y, y);
+}
+
+__attribute__((target("avx512f"))) static bool haversine_f64_avx512(const double *lat,
+                                                                    const double *lon, size_t n,
+                                                                    double qlat, double qlon,
+                                                                    double cos_qlat,
+                                                                    double *out) {
+    __mmask8 bad = 0;
+    for (size_t i = 0; i < n; i += 8) {
+        __mmask8 in = n - i >= 8 ? (__mmask8)0xFF : (__mmask8)((1u << (n - i)) - 1u);
+        __m512d d = hav_point_f64_avx512(_mm512_maskz_loadu_pd(in, lat + i),
+                                         _mm512_maskz_loadu_pd(in, lon + i), qlat, qlon,
+                                         cos_qlat);
+        bad |= _mm512_mask_cmp_pd_mask(in, d, d, _CMP_UNORD_Q);
+        _mm512_mask_storeu_pd(out + i, in, d);
+    }
+    return bad != 0;
+}
+#endif
+
+#if defined(__aarch64__)
+static inline float32x4_t hav_sin_neon(float32x4_t x, int32_t offset) {
+    float32x4_t j = vrndnq_f32(vmulq_n_f32(x, (float)HSD_HAV_2_OVER_PI));
+    float32x4_t r = vfmsq_f32(x, j, vdupq_n_f32(HSD_HAV_PIO2_HI_F32));
+    r = vfmsq_f32(r, j, vdupq_n_f32(HSD_HAV_PIO2_MID_F32));
+    r = vfmsq_f32(r, j, vdupq_n_f32(HSD_HAV_PIO2_LO_F32));
+    float32x4_t z = vmulq_f32(r, r);
+    float32x4_t s = vdupq_n_f32(hav_sin_f32[0]);
+    for (int k = 1; k < 3; ++k) s = vfmaq_f32(vdupq_n_f32(hav_sin_f32[k]), s, z);
+    s = vfmaq_f32(r, vmulq_f32(s, z), r);
+    float32x4_t c = vdupq_n_f32(hav_cos_f32[0]);
+    for (int k = 1; k < 3; ++k) c = vfmaq_f32(vdupq_n_f32(hav_cos_f32[k]), c, z);
+    c = vfmaq_f32(vfmsq_f32(vdupq_n_f32(1.0f), z, vdupq_n_f32(0.5f)), vmulq_f32(c, z), z);
+    int32x4_t q = vaddq_s32(vcvtq_s32_f32(j), vdupq_n_s32(offset));
+    uint32x4_t swap = vtstq_s32(q, vdupq_n_s32(1));
+    uint32x4_t sign = vreinterpretq_u32_s32(vshlq_n_s32(vandq_s32(q, vdupq_n_s32(2)), 30));
+    float32x4_t v = vbslq_f32(swap, c, s);
+    return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(v), sign));
+}
+
+static inline float32x4_t hav_point_neon(float32x4_t lat, float32x4_t lon, float qlat,
+                                         float qlon, float cos_qlat) {
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float half_deg = (float)HSD_HAV_HALF_DEG_TO_RAD;
+    float32x4_t s_lat = hav_sin_neon(vmulq_n_f32(vsubq_f32(lat, vdupq_n_f32(qlat)), half_deg), 0);
+    float32x4_t s_lon = hav_sin_neon(vmulq_n_f32(vsubq_f32(lon, vdupq_n_f32(qlon)), half_deg), 0);
+    float32x4_t c_lat = hav_sin_neon(vmulq_n_f32(lat, (float)HSD_HAV_DEG_TO_RAD), 1);
+    float32x4_t h = vmulq_f32(vmulq_n_f32(c_lat, cos_qlat), vmulq_f32(s_lon, s_lon));
+    h = vminq_f32(one, vfmaq_f32(h, s_lat, s_lat));
+    float32x4_t s = vsqrtq_f32(h);
+    uint32x4_t big = vcgtq_f32(s, vdupq_n_f32(0.5f));
+    float32x4_t z_big = vdivq_f32(vmulq_n_f32(vsubq_f32(one, h), 0.5f), vaddq_f32(one, s));
+    float32x4_t z = vbslq_f32(big, z_big, h);
+    float32x4_t x = vbslq_f32(big, vsqrtq_f32(z_big), s);
+    float32x4_t p = vdupq_n_f32(hav_asin_f32[0]);
+    for (int k = 1; k < 5; ++k) p = vfmaq_f32(vdupq_n_f32(hav_asin_f32[k]), p, z);
+    float32x4_t y = vfmaq_f32(x, vmulq_f32(x, z), p);
+    y = vbslq_f32(big, vfmsq_f32(vdupq_n_f32((float)HSD_HAV_PI_2), y, vdupq_n_f32(2.0f)), y);
+    return vaddq_f32(y, y);
+}
+
+static bool haversine_f32_neon(const float *lat, const float *lon, size_t n, float qlat,
+                               float qlon, float cos_qlat, float *out) {
+    uint32x4_t ok = vdupq_n_u32(0xFFFFFFFFu);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t d = hav_point_neon(vld1q_f32(lat + i), vld1q_f32(lon + i), qlat, qlon,
+                                       cos_qlat);
+        ok = vandq_u32(ok, vceqq_f32(d, d));
+        vst1q_f32(out + i, d);
+    }
+    if (i < n) {
+        float tl[4] = {0.0f}, tn[4] = {0.0f}, td[4];
+        memcpy(tl, lat + i, (n - i) * sizeof(float));
+        memcpy(tn, lon + i, (n - i) * sizeof(float));
+        float32x4_t d = hav_point_neon(vld1q_f32(tl), vld1q_f32(tn), qlat, qlon, cos_qlat);
+        ok = vandq_u32(ok, vceqq_f32(d, d));
+        vst1q_f32(td, d);
+        memcpy(out + i, td, (n - i) * sizeof(float));
+    }
+    return vminvq_u32(ok) == 0;
+}
+
+static inline float64x2_t hav_sin_f64_neon(float64x2_t x, int64_t offset) {
+    float64x2_t j = vrndnq_f64(vmulq_n_f64(x, HSD_HAV_2_OVER_PI));
+    float64x2_t r = vfmsq_f64(x, j, vdupq_n_f64(HSD_HAV_PIO2_HI_F64));
+    r = vfmsq_f64(r, j, vdupq_n_f64(HSD_HAV_PIO2_MID_F64));
+    r = vfmsq_f64(r, j, vdupq_n_f64(HSD_HAV_PIO2_LO_F64));
+    float64x2_t z = vmulq_f64(r, r);
+    float64x2_t s = vdupq_n_f64(hav_sin_f64[0]);
+    for (int k = 1; k < 6; ++k) s = vfmaq_f64(vdupq_n_f64(hav_sin_f64[k]), s, z);
+    s = vfmaq_f64(r, vmulq_f64(s, z), r);
+    float64x2_t c = vdupq_n_f64(hav_cos_f64[0]);
+    for (int k = 1; k < 6; ++k) c = vfmaq_f64(vdupq_n_f64(hav_cos_f64[k]), c, z);
+    c = vfmaq_f64(vfmsq_f64(vdupq_n_f64(1.0), z, vdupq_n_f64(0.5)), vmulq_f64(c, z), z);
+    int64x2_t q = vaddq_s64(vcvtq_s64_f64(j), vdupq_n_s64(offset));
+    uint64x2_t swap = vtstq_s64(q, vdupq_n_s64(1));
+    uint64x2_t sign = vreinterpretq_u64_s64(vshlq_n_s64(vandq_s64(q, vdupq_n_s64(2)), 62));
+    float64x2_t v = vbslq_f64(swap, c, s);
+    return vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(v), sign));
+}
+
+static inline float64x2_t hav_poly_f64_neon(const double *c, int count, float64x2_t z) {
+    float64x2_t p = vdupq_n_f64(c[0]);
+    for (int k = 1; k < count; ++k) p = vfmaq_f64(vdupq_n_f64(c[k]), p, z);
+    return p;
+}
+
+static inline float64x2_t hav_point_f64_neon(float64x2_t lat, float64x2_t lon, double qlat,
+                                             double qlon, double cos_qlat) {
+    const float64x2_t one = vdupq_n_f64(1.0);
+    const double half_deg = HSD_HAV_HALF_DEG_TO_RAD;
+    float64x2_t s_lat =
+        hav_sin_f64_neon(vmulq_n_f64(vsubq_f64(lat, vdupq_n_f64(qlat)), half_deg), 0);
+    float64x2_t s_lon =
+        hav_sin_f64_neon(vmulq_n_f64(vsubq_f64(lon, vdupq_n_f64(qlon)), half_deg), 0);
+    float64x2_t c_lat = hav_sin_f64_neon(vmulq_n_f64(lat, HSD_HAV_DEG_TO_RAD), 1);
+    float64x2_t h = vmulq_f64(vmulq_n_f64(c_lat, cos_qlat), vmulq_f64(s_lon, s_lon));
+    h = vminq_f64(one, vfmaq_f64(h, s_lat, s_lat));
+    float64x2_t a = vsqrtq_f64(h);
+    float64x2_t ps = vdivq_f64(vmulq_f64(h, hav_poly_f64_neon(hav_asin_p_f64, 6, h)),
+                               hav_poly_f64_neon(hav_asin_q_f64, 6, h));
+    float64x2_t small = vfmaq_f64(a, a, ps);
+    float64x2_t zz = vdivq_f64(vsubq_f64(one, h), vaddq_f64(one, a));
+    float64x2_t pr = vdivq_f64(vmulq_f64(zz, hav_poly_f64_neon(hav_asin_r_f64, 5, zz)),
+                               hav_poly_f64_neon(hav_asin_s_f64, 5, zz));
+    float64x2_t t = vsqrtq_f64(vaddq_f64(zz, zz));
+    float64x2_t large = vsubq_f64(vdupq_n_f64(HSD_HAV_PIO4_F64), t);
+    large = vsubq_f64(large, vsubq_f64(vmulq_f64(t, pr), vdupq_n_f64(HSD_HAV_MOREBITS_F64)));
+    large = vaddq_f64(large, vdupq_n_f64(HSD_HAV_PIO4_F64));
+    float64x2_t y = vbslq_f64(vcgtq_f64(a, vdupq_n_f64(0.625)), large, small);
+    return vaddq_f64(y, y);
+}
+
+static bool haversine_f64_neon(const double *lat, const double *lon, size_t n, double qlat,
+                               double qlon, double cos_qlat, double *out) {
+    uint64x2_t ok = vdupq_n_u64(~0ull);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t d = hav_point_f64_neon(vld1q_f64(lat + i), vld1q_f64(lon + i), qlat, qlon,
+                                           cos_qlat);
+        ok = vandq_u64(ok, vceqq_f64(d, d));
+        vst1q_f64(out + i, d);
+    }
+    if (i < n) {
+        out[i] = hav_point_scalar(lat[i], lon[i], qlat, qlon, cos_qlat);
+        if (isnan(out[i])) ok = vdupq_n_u64(0);
+    }
+    return (vgetq_lane_u64(ok, 0) & vgetq_lane_u64(ok, 1)) == 0;
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static inline svfloat32_t hav_sin_sve(svbool_t pg, svfloat32_t x,
+                                                                      int32_t offset) {
+    svfloat32_t j = svrintn_f32_x(pg, svmul_n_f32_x(pg, x, (float)HSD_HAV_2_OVER_PI));
+    svfloat32_t r = svmls_n_f32_x(pg, x, j, HSD_HAV_PIO2_HI_F32);
+    r = svmls_n_f32_x(pg, r, j, HSD_HAV_PIO2_MID_F32);
+    r = svmls_n_f32_x(pg, r, j, HSD_HAV_PIO2_LO_F32);
+    svfloat32_t z = svmul_f32_x(pg, r, r);
+    svfloat32_t s = svdup_n_f32(hav_sin_f32[0]);
+    for (int k = 1; k < 3; ++k) s = svmad_n_f32_x(pg, s, z, hav_sin_f32[k]);
+    s = svmla_f32_x(pg, r, svmul_f32_x(pg, s, z), r);
+    svfloat32_t c = svdup_n_f32(hav_cos_f32[0]);
+    for (int k = 1; k < 3; ++k) c = svmad_n_f32_x(pg, c, z, hav_cos_f32[k]);
+    c = svmla_f32_x(pg, svmls_n_f32_x(pg, svdup_n_f32(1.0f), z, 0.5f), svmul_f32_x(pg, c, z), z);
+    svint32_t q = svadd_n_s32_x(pg, svcvt_s32_f32_x(pg, j), offset);
+    svbool_t swap = svcmpne_n_s32(pg, svand_n_s32_x(pg, q, 1), 0);
+    svuint32_t sign = svreinterpret_u32_s32(svlsl_n_s32_x(pg, svand_n_s32_x(pg, q, 2), 30));
+    svfloat32_t v = svsel_f32(swap, c, s);
+    return svreinterpret_f32_u32(sveor_u32_x(pg, svreinterpret_u32_f32(v), sign));
+}
+
+__attribute__((target("+sve"))) static inline svfloat32_t hav_point_sve(svbool_t pg,
+                                                                        svfloat32_t lat,
+                                                                        svfloat32_t lon,
+                                                                        float qlat, float qlon,
+                                                                        float cos_qlat) {
+    const float half_deg = (float)HSD_HAV_HALF_DEG_TO_RAD;
+    svfloat32_t s_lat =
+        hav_sin_sve(pg, svmul_n_f32_x(pg, svsub_n_f32_x(pg, lat, qlat), half_deg), 0);
+    svfloat32_t s_lon =
+        hav_sin_sve(pg, svmul_n_f32_x(pg, svsub_n_f32_x(pg, lon, qlon), half_deg), 0);
+    svfloat32_t c_lat = hav_sin_sve(pg, svmul_n_f32_x(pg, lat, (float)HSD_HAV_DEG_TO_RAD), 1);
+    svfloat32_t h =
+        svmul_f32_x(pg, svmul_n_f32_x(pg, c_lat, cos_qlat), svmul_f32_x(pg, s_lon, s_lon));
+    h = svmin_f32_x(pg, svdup_n_f32(1.0f), svmla_f32_x(pg, h, s_lat, s_lat));
+    svfloat32_t s = svsqrt_f32_x(pg, h);
+    svbool_t big = svcmpgt_n_f32(pg, s, 0.5f);
+    svfloat32_t z_big = svdiv_f32_x(pg, svmul_n_f32_x(pg, svsubr_n_f32_x(pg, h, 1.0f), 0.5f),
+                                    svadd_n_f32_x(pg, s, 1.0f));
+    svfloat32_t z = svsel_f32(big, z_big, h);
+    svfloat32_t x = svsel_f32(big, svsqrt_f32_x(pg, z_big), s);
+    svfloat32_t p = svdup_n_f32(hav_asin_f32[0]);
+    for (int k = 1; k < 5; ++k) p = svmad_n_f32_x(pg, p, z, hav_asin_f32[k]);
+    svfloat32_t y = svmla_f32_x(pg, x, svmul_f32_x(pg, x, z), p);
+    y = svsel_f32(big, svmls_n_f32_x(pg, svdup_n_f32((float)HSD_HAV_PI_2), y, 2.0f), y);
+    return svadd_f32_x(pg, y, y);
+}
+
+__attribute__((target("+sve"))) static bool haversine_f32_sve(const float *lat, const float *lon,
+                                                              size_t n, float qlat, float qlon,
+                                                              float cos_qlat, float *out) {
+    svbool_t bad = svpfalse_b();
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t d = hav_point_sve(pg, svld1_f32(pg, lat + i), svld1_f32(pg, lon + i), qlat,
+                                      qlon, cos_qlat);
+        bad = svorr_b_z(svptrue_b32(), bad, svcmpuo_f32(pg, d, d));
+        svst1_f32(pg, out + i, d);
+    }
+    return svptest_any(svptrue_b32(), bad);
+}
+
+__attribute__((target("+sve"))) static inline svfloat64_t hav_sin_f64_sve(svbool_t pg,
+                                                                          svfloat64_t x,
+                                                                          int64_t offset) {
+    svfloat64_t j = svrintn_f64_x(pg, svmul_n_f64_x(pg, x, HSD_HAV_2_OVER_PI));
+    svfloat64_t r = svmls_n_f64_x(pg, x, j, HSD_HAV_PIO2_HI_F64);
+    r = svmls_n_f64_x(pg, r, j, HSD_HAV_PIO2_MID_F64);
+    r = svmls_n_f64_x(pg, r, j, HSD_HAV_PIO2_LO_F64);
+    svfloat64_t z = svmul_f64_x(pg, r, r);
+    svfloat64_t s = svdup_n_f64(hav_sin_f64[0]);
+    for (int k = 1; k < 6; ++k) s = svmad_n_f64_x(pg, s, z, hav_sin_f64[k]);
+    s = svmla_f64_x(pg, r, svmul_f64_x(pg, s, z), r);
+    svfloat64_t c = svdup_n_f64(hav_cos_f64[0]);
+    for (int k = 1; k < 6; ++k) c = svmad_n_f64_x(pg, c, z, hav_cos_f64[k]);
+    c = svmla_f64_x(pg, svmls_n_f64_x(pg, svdup_n_f64(1.0), z, 0.5), svmul_f64_x(pg, c, z), z);
+    svint64_t q = svadd_n_s64_x(pg, svcvt_s64_f64_x(pg, j), offset);
+    svbool_t swap = svcmpne_n_s64(pg, svand_n_s64_x(pg, q, 1), 0);
+    svuint64_t sign = svreinterpret_u64_s64(svlsl_n_s64_x(pg, svand_n_s64_x(pg, q, 2), 62));
+    svfloat64_t v = svsel_f64(swap, c, s);
+    return svreinterpret_f64_u64(sveor_u64_x(pg, svreinterpret_u64_f64(v), sign));
+}
+
+__attribute__((target("+sve"))) static inline svfloat64_t hav_poly_f64_sve(svbool_t pg,
+                                                                           const double *c,
+                                                                           int count,
+                                                                           svfloat64_t z) {
+    svfloat64_t p = svdup_n_f64(c[0]);
+    for (int k = 1; k < count; ++k) p = svmad_n_f64_x(pg, p, z, c[k]);
+    return p;
+}
+
+__attribute__((target("+sve"))) static inline svfloat64_t hav_point_f64_sve(svbool_t pg,
+                                                                            svfloat64_t lat,
+                                                                            svfloat64_t lon,
+                                                                            double qlat,
+                                                                            double qlon,
+                                                                            double cos_qlat) {
+    svfloat64_t s_lat = hav_sin_f64_sve(
+        pg, svmul_n_f64_x(pg, svsub_n_f64_x(pg, lat, qlat), HSD_HAV_HALF_DEG_TO_RAD), 0);
+    svfloat64_t s_lon = hav_sin_f64_sve(
+        pg, svmul_n_f64_x(pg, svsub_n_f64_x(pg, lon, qlon), HSD_HAV_HALF_DEG_TO_RAD), 0);
+    svfloat64_t c_lat = hav_sin_f64_sve(pg, svmul_n_f64_x(pg, lat, HSD_HAV_DEG_TO_RAD), 1);
+    svfloat64_t h =
+        svmul_f64_x(pg, svmul_n_f64_x(pg, c_lat, cos_qlat), svmul_f64_x(pg, s_lon, s_lon));
+    h = svmin_f64_x(pg, svdup_n_f64(1.0), svmla_f64_x(pg, h, s_lat, s_lat));
+    svfloat64_t a = svsqrt_f64_x(pg, h);
+    svfloat64_t ps =
+        svdiv_f64_x(pg, svmul_f64_x(pg, h, hav_poly_f64_sve(pg, hav_asin_p_f64, 6, h)),
+                    hav_poly_f64_sve(pg, hav_asin_q_f64, 6, h));
+    svfloat64_t small = svmla_f64_x(pg, a, a, ps);
+    svfloat64_t zz = svdiv_f64_x(pg, svsubr_n_f64_x(pg, h, 1.0), svadd_n_f64_x(pg, a, 1.0));
+    svfloat64_t pr =
+        svdiv_f64_x(pg, svmul_f64_x(pg, zz, hav_poly_f64_sve(pg, hav_asin_r_f64, 5, zz)),
+                    hav_poly_f64_sve(pg, hav_asin_s_f64, 5, zz));
+    svfloat64_t t = svsqrt_f64_x(pg, svadd_f64_x(pg, zz, zz));
+    svfloat64_t large = svsubr_n_f64_x(pg, t, HSD_HAV_PIO4_F64);
+    large = svsub_f64_x(pg, large,
+                        svsub_n_f64_x(pg, svmul_f64_x(pg, t, pr), HSD_HAV_MOREBITS_F64));
+    large = svadd_n_f64_x(pg, large, HSD_HAV_PIO4_F64);
+    svfloat64_t y = svsel_f64(svcmpgt_n_f64(pg, a, 0.625), large, small);
+    return svadd_f64_x(pg, y, y);
+}
+
+__attribute__((target("+sve"))) static bool haversine_f64_sve(const double *lat,
+                                                              const double *lon, size_t n,
+                                                              double qlat, double qlon,
+                                                              double cos_qlat, double *out) {
+    svbool_t bad = svpfalse_b();
+    for (uint64_t i = 0; i < n; i += svcntd()) {
+        svbool_t pg = svwhilelt_b64(i, (uint64_t)n);
+        svfloat64_t d = hav_point_f64_sve(pg, svld1_f64(pg, lat + i), svld1_f64(pg, lon + i),
+                                          qlat, qlon, cos_qlat);
+        bad = svorr_b_z(svptrue_b64(), bad, svcmpuo_f64(pg, d, d));
+        svst1_f64(pg, out + i, d);
+    }
+    return svptest_any(svptrue_b64(), bad);
+}
+#endif
+#endif
+
+static const hsd_haversine_kernels_t haversine_kernels_scalar = {
+    haversine_f32_scalar, haversine_f64_scalar, "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_haversine_kernels_t haversine_kernels_avx2 = {haversine_f32_avx2,
+                                                               haversine_f64_avx2, "AVX2"};
+static const hsd_haversine_kernels_t haversine_kernels_avx512 = {haversine_f32_avx512,
+                                                                 haversine_f64_avx512, "AVX512F"};
+#endif
+#if defined(__aarch64__)
+static const hsd_haversine_kernels_t haversine_kernels_neon = {haversine_f32_neon,
+                                                               haversine_f64_neon, "NEON"};
+#if defined(__ARM_FEATURE_SVE)
+static const hsd_haversine_kernels_t haversine_kernels_sve = {haversine_f32_sve,
+                                                              haversine_f64_sve, "SVE"};
+#endif
+#endif
+
+/* AVX-only CPUs use the scalar kernels; the polynomials need FMA to stay accurate. */
+static const hsd_haversine_kernels_t *resolve_haversine_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_haversine_kernels_t *chosen = &haversine_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Haversine: Manual backend requested: %d", forced);
+        bool ok = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = &haversine_kernels_avx512;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2() && hsd_cpu_has_fma()) {
+                    chosen = &haversine_kernels_avx2;
+                    ok = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = &haversine_kernels_sve;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = &haversine_kernels_neon;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                ok = true;
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            hsd_log("Forced backend %d not supported, fallback to scalar", forced);
+            chosen = &haversine_kernels_scalar;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &haversine_kernels_avx512;
+        else if (hsd_cpu_has_avx2() && hsd_cpu_has_fma())
+            chosen = &haversine_kernels_avx2;
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve())
+            chosen = &haversine_kernels_sve;
+        else if (hsd_cpu_has_neon())
+            chosen = &haversine_kernels_neon;
+#else
+        if (hsd_cpu_has_neon()) chosen = &haversine_kernels_neon;
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Haversine to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_haversine_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+/*
+ * The non-fast precision modes use the scalar libm kernels, which do not depend on the CPU. They
+ * are deliberately not vectorized: the SIMD polynomials are what the fast mode trades accuracy
+ * for, and libm in double is the reference the precise modes promise.
+ */
+static const hsd_haversine_kernels_t *haversine_kernels(void) {
+    if (hsd_get_precision() != HSD_PRECISION_FAST) return &haversine_kernels_scalar;
+    uintptr_t cur = atomic_load_explicit(&hsd_haversine_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_haversine_kernels_t *)cur;
+    const hsd_haversine_kernels_t *resolved = resolve_haversine_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_haversine_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+/* Handles NULL pointers, empty input and a non-finite query; true means *status is final. */
+static bool haversine_early_exit(const void *lat, const void *lon, size_t n, double query_lat,
+                                 double query_lon, const void *result, hsd_status_t *status) {
+    if (result == NULL || (n > 0 && (lat == NULL || lon == NULL))) {
+        *status = HSD_ERR_NULL_PTR;
+        return true;
+    }
+    if (n == 0) {
+        *status = HSD_SUCCESS;
+        return true;
+    }
+    if (isnan(query_lat) || isinf(query_lat) || isnan(query_lon) || isinf(query_lon)) {
+        *status = HSD_ERR_INVALID_INPUT;
+        return true;
+    }
+    return false;
+}
+
+static hsd_status_t haversine_result(bool bad) {
+#if HSD_ALLOW_FP_CHECKS
+    if (bad) return HSD_ERR_INVALID_INPUT;
+#else
+    (void)bad;
+#endif
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_dist_haversine_batch_f32(const float *lat, const float *lon, size_t n,
+                                          float query_lat, float query_lon, float *result) {
+    hsd_status_t status;
+    if (haversine_early_exit(lat, lon, n, query_lat, query_lon, result, &status)) return status;
+    float cos_qlat = (float)cos((double)query_lat * HSD_HAV_DEG_TO_RAD);
+    return haversine_result(
+        haversine_kernels()->batch_f32(lat, lon, n, query_lat, query_lon, cos_qlat, result));
+}
+
+hsd_status_t hsd_dist_haversine_batch_f64(const double *lat, const double *lon, size_t n,
+                                          double query_lat, double query_lon, double *result) {
+    hsd_status_t status;
+    if (haversine_early_exit(lat, lon, n, query_lat, query_lon, result, &status)) return status;
+    double cos_qlat = cos(query_lat * HSD_HAV_DEG_TO_RAD);
+    return haversine_result(
+        haversine_kernels()->batch_f64(lat, lon, n, query_lat, query_lon, cos_qlat, result));
+}
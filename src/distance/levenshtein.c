@@ -0,0 +1,460 @@
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+/*
+ * Levenshtein distance with the bit-parallel algorithm of Myers (1999) in the formulation of
+ * Hyyrö (2003). One column of the DP matrix is kept as two bit vectors of vertical +1/-1
+ * deltas over the pattern, and each text byte updates the whole column with a handful of word
+ * operations, so a pattern of up to 64 bytes costs O(n) word operations. Longer patterns are
+ * split into 64-bit blocks that pass the horizontal deltas of the block boundary upwards.
+ *
+ * peq holds, for every byte value, the bit mask of its positions in the pattern. The batch
+ * mode builds it once and runs one text per 64-bit SIMD lane.
+ */
+#define HSD_LEV_WORD_BITS 64
+#define HSD_LEV_BATCH_CHUNK 512
+
+typedef struct {
+    /* Distances from a pattern of 1..64 bytes, described by peq, to each of the texts. */
+    void (*batch64)(const uint64_t *peq, size_t m, const uint8_t *const *texts,
+                    const size_t *lengths, size_t count, uint64_t *results);
+    const char *name;
+} hsd_lev_kernels_t;
+
+static uint64_t lev_myers64(const uint64_t *peq, size_t m, const uint8_t *t, size_t n) {
+    const uint64_t last = UINT64_C(1) << (m - 1);
+    uint64_t vp = ~UINT64_C(0), vn = 0, score = m;
+    for (size_t j = 0; j < n; ++j) {
+        uint64_t x = peq[t[j]] | vn;
+        uint64_t d0 = (((x & vp) + vp) ^ vp) | x;
+        uint64_t hp = vn | ~(d0 | vp);
+        uint64_t hn = vp & d0;
+        score += (hp & last) != 0;
+        score -= (hn & last) != 0;
+        hp = (hp << 1) | 1;
+        hn <<= 1;
+        vp = hn | ~(d0 | hp);
+        vn = hp & d0;
+    }
+    return score;
+}
+
+/* peq is laid out as peq[byte * words + word]; vp and vn are scratch of `words` entries. */
+static uint64_t lev_myers_blocks(const uint64_t *peq, size_t m, const uint8_t *t, size_t n,
+                                 uint64_t *vp, uint64_t *vn) {
+    const size_t words = (m + HSD_LEV_WORD_BITS - 1) / HSD_LEV_WORD_BITS;
+    const uint64_t last = UINT64_C(1) << ((m - 1) % HSD_LEV_WORD_BITS);
+    for (size_t w = 0; w < words; ++w) {
+        vp[w] = ~UINT64_C(0);
+        vn[w] = 0;
+    }
+    uint64_t score = m;
+    for (size_t j = 0; j < n; ++j) {
+        const uint64_t *row = peq + (size_t)t[j] * words;
+        /* The top row of the DP matrix grows by one per column. */
+        uint64_t hp_carry = 1, hn_carry = 0;
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t x = row[w] | hn_carry;
+            uint64_t d0 = (((x & vp[w]) + vp[w]) ^ vp[w]) | x | vn[w];
+            uint64_t hp = vn[w] | ~(d0 | vp[w]);
+            uint64_t hn = d0 & vp[w];
+            uint64_t hp_out = w + 1 < words ? hp >> 63 : (hp & last) != 0;
+            uint64_t hn_out = w + 1 < words ? hn >> 63 : (hn & last) != 0;
+            hp = (hp << 1) | hp_carry;
+            hn = (hn << 1) | hn_carry;
+            vp[w] = hn | ~(d0 | hp);
+            vn[w] = hp & d0;
+            hp_carry = hp_out;
+            hn_carry = hn_out;
+        }
+        score += hp_carry;
+        score -= hn_carry;
+    }
+    return score;
+}
+
+static void lev_build_peq(const uint8_t *p, size_t m, size_t words, uint64_t *peq) {
+    memset(peq, 0, 256 * words * sizeof(uint64_t));
+    for (size_t i = 0; i < m; ++i)
+        peq[(size_t)p[i] * words + i / HSD_LEV_WORD_BITS] |= UINT64_C(1)
+                                                            << (i % HSD_LEV_WORD_BITS);
+}
+
+static void lev_batch64_scalar(const uint64_t *peq, size_t m, const uint8_t *const *texts,
+                               const size_t *lengths, size_t count, uint64_t *results) {
+    for (size_t i = 0; i < count; ++i) results[i] = lev_myers64(peq, m, texts[i], lengths[i]);
+}
+
+/* Gathers the peq masks of position j of every lane; finished lanes get 0. */
+static inline void lev_gather(const uint64_t *peq, const uint8_t *const *texts,
+                              const size_t *lengths, size_t width, size_t j, uint64_t *pm) {
+    for (size_t l = 0; l < width; ++l) pm[l] = j < lengths[l] ? peq[texts[l][j]] : 0;
+}
+
+static inline size_t lev_max_length(const size_t *lengths, size_t width) {
+    size_t max = 0;
+    for (size_t l = 0; l < width; ++l) max = lengths[l] > max ? lengths[l] : max;
+    return max;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx2"))) static void lev_batch64_avx2(const uint64_t *peq, size_t m,
+                                                             const uint8_t *const *texts,
+                                                             const size_t *lengths,
+                                                             size_t count, uint64_t *results) {
+    const __m256i ones = _mm256_set1_epi64x(-1), one = _mm256_set1_epi64x(1);
+    const __m256i last = _mm256_set1_epi64x((long long)(UINT64_C(1) << (m - 1)));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const size_t *len = lengths + i;
+        const __m256i vlen = _mm256_loadu_si256((const __m256i *)len);
+        __m256i vp = ones, vn = _mm256_setzero_si256(), score = _mm256_set1_epi64x((long long)m);
+        size_t max = lev_max_length(len, 4);
+        uint64_t pm[4];
+        for (size_t j = 0; j < max; ++j) {
+            /* Lengths stay below 2^63, so the signed compare is safe. */
+            __m256i active = _mm256_cmpgt_epi64(vlen, _mm256_set1_epi64x((long long)j));
+            lev_gather(peq, texts + i, len, 4, j, pm);
+            __m256i x = _mm256_or_si256(_mm256_loadu_si256((const __m256i *)pm), vn);
+            __m256i d0 = _mm256_or_si256(
+                _mm256_xor_si256(_mm256_add_epi64(_mm256_and_si256(x, vp), vp), vp), x);
+            __m256i hp = _mm256_or_si256(vn, _mm256_andnot_si256(_mm256_or_si256(d0, vp), ones));
+            __m256i hn = _mm256_and_si256(vp, d0);
+            __m256i up = _mm256_cmpeq_epi64(_mm256_and_si256(hp, last), last);
+            __m256i down = _mm256_cmpeq_epi64(_mm256_and_si256(hn, last), last);
+            score = _mm256_sub_epi64(score, _mm256_and_si256(up, active));
+            score = _mm256_add_epi64(score, _mm256_and_si256(down, active));
+            hp = _mm256_or_si256(_mm256_slli_epi64(hp, 1), one);
+            hn = _mm256_slli_epi64(hn, 1);
+            vp = _mm256_or_si256(hn, _mm256_andnot_si256(_mm256_or_si256(d0, hp), ones));
+            vn = _mm256_and_si256(hp, d0);
+        }
+        _mm256_storeu_si256((__m256i *)(results + i), score);
+    }
+    lev_batch64_scalar(peq, m, texts + i, lengths + i, count - i, results + i);
+}
+
+__attribute__((target("avx512f"))) static void lev_batch64_avx512(const uint64_t *peq,
+                                                                  size_t m,
+                                                                  const uint8_t *const *texts,
+                                                                  const size_t *lengths,
+                                                                  size_t count,
+                                                                  uint64_t *results) {
+    const __m512i ones = _mm512_set1_epi64(-1), one = _mm512_set1_epi64(1);
+    const __m512i last = _mm512_set1_epi64((long long)(UINT64_C(1) << (m - 1)));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const size_t *len = lengths + i;
+        const __m512i vlen = _mm512_loadu_si512(len);
+        __m512i vp = ones, vn = _mm512_setzero_si512(), score = _mm512_set1_epi64((long long)m);
+        size_t max = lev_max_length(len, 8);
+        uint64_t pm[8];
+        for (size_t j = 0; j < max; ++j) {
+            __mmask8 active = _mm512_cmpgt_epu64_mask(vlen, _mm512_set1_epi64((long long)j));
+            lev_gather(peq, texts + i, len, 8, j, pm);
+            __m512i x = _mm512_or_si512(_mm512_loadu_si512(pm), vn);
+            __m512i d0 = _mm512_or_si512(
+                _mm512_xor_si512(_mm512_add_epi64(_mm512_and_si512(x, vp), vp), vp), x);
+            __m512i hp = _mm512_or_si512(vn, _mm512_andnot_si512(_mm512_or_si512(d0, vp), ones));
+            __m512i hn = _mm512_and_si512(vp, d0);
+            score = _mm512_mask_add_epi64(score, active & _mm512_test_epi64_mask(hp, last), score,
+                                          one);
+            score = _mm512_mask_sub_epi64(score, active & _mm512_test_epi64_mask(hn, last), score,
+                                          one);
+            hp = _mm512_or_si512(_mm512_slli_epi64(hp, 1), one);
+            hn = _mm512_slli_epi64(hn, 1);
+            vp = _mm512_or_si512(hn, _mm512_andnot_si512(_mm512_or_si512(d0, hp), ones));
+            vn = _mm512_and_si512(hp, d0);
+        }
+        _mm512_storeu_si512(results + i, score);
+    }
+    lev_batch64_scalar(peq, m, texts + i, lengths + i, count - i, results + i);
+}
+#endif
+
+#if defined(__aarch64__)
+static void lev_batch64_neon(const uint64_t *peq, size_t m, const uint8_t *const *texts,
+                             const size_t *lengths, size_t count, uint64_t *results) {
+    const uint64x2_t ones = vdupq_n_u64(~UINT64_C(0)), one = vdupq_n_u64(1);
+    const uint64x2_t last = vdupq_n_u64(UINT64_C(1) << (m - 1));
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const size_t *len = lengths + i;
+        const uint64x2_t vlen = vld1q_u64((const uint64_t *)len);
+        uint64x2_t vp = ones, vn = vdupq_n_u64(0), score = vdupq_n_u64(m);
+        size_t max = lev_max_length(len, 2);
+        uint64_t pm[2];
+        for (size_t j = 0; j < max; ++j) {
+            uint64x2_t active = vcgtq_u64(vlen, vdupq_n_u64(j));
+            lev_gather(peq, texts + i, len, 2, j, pm);
+            uint64x2_t x = vorrq_u64(vld1q_u64(pm), vn);
+            uint64x2_t d0 = vorrq_u64(veorq_u64(vaddq_u64(vandq_u64(x, vp), vp), vp), x);
+            uint64x2_t hp = vorrq_u64(vn, veorq_u64(vorrq_u64(d0, vp), ones));
+            uint64x2_t hn = vandq_u64(vp, d0);
+            score = vsubq_u64(score, vandq_u64(vtstq_u64(hp, last), active));
+            score = vaddq_u64(score, vandq_u64(vtstq_u64(hn, last), active));
+            hp = vorrq_u64(vshlq_n_u64(hp, 1), one);
+            hn = vshlq_n_u64(hn, 1);
+            vp = vorrq_u64(hn, veorq_u64(vorrq_u64(d0, hp), ones));
+            vn = vandq_u64(hp, d0);
+        }
+        vst1q_u64(results + i, score);
+    }
+    lev_batch64_scalar(peq, m, texts + i, lengths + i, count - i, results + i);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static void lev_batch64_sve(const uint64_t *peq, size_t m,
+                                                            const uint8_t *const *texts,
+                                                            const size_t *lengths,
+                                                            size_t count, uint64_t *results) {
+    const size_t width = svcntd();
+    const svbool_t all = svptrue_b64();
+    const svuint64_t last = svdup_n_u64(UINT64_C(1) << (m - 1));
+    size_t i = 0;
+    for (; i + width <= count; i += width) {
+        const size_t *len = lengths + i;
+        const svuint64_t vlen = svld1_u64(all, (const uint64_t *)len);
+        svuint64_t vp = svdup_n_u64(~UINT64_C(0)), vn = svdup_n_u64(0);
+        svuint64_t score = svdup_n_u64(m);
+        size_t max = lev_max_length(len, width);
+        uint64_t pm[32];
+        for (size_t j = 0; j < max; ++j) {
+            svbool_t active = svcmpgt_n_u64(all, vlen, j);
+            lev_gather(peq, texts + i, len, width, j, pm);
+            svuint64_t x = svorr_u64_x(all, svld1_u64(all, pm), vn);
+            svuint64_t d0 = svorr_u64_x(
+                all, sveor_u64_x(all, svadd_u64_x(all, svand_u64_x(all, x, vp), vp), vp), x);
+            svuint64_t hp = svorr_u64_x(all, vn, svnot_u64_x(all, svorr_u64_x(all, d0, vp)));
+            svuint64_t hn = svand_u64_x(all, vp, d0);
+            svbool_t up = svcmpne_n_u64(active, svand_u64_x(all, hp, last), 0);
+            svbool_t down = svcmpne_n_u64(active, svand_u64_x(all, hn, last), 0);
+            score = svadd_n_u64_m(up, score, 1);
+            score = svsub_n_u64_m(down, score, 1);
+            hp = svorr_n_u64_x(all, svlsl_n_u64_x(all, hp, 1), 1);
+            hn = svlsl_n_u64_x(all, hn, 1);
+            vp = svorr_u64_x(all, hn, svnot_u64_x(all, svorr_u64_x(all, d0, hp)));
+            vn = svand_u64_x(all, hp, d0);
+        }
+        svst1_u64(all, results + i, score);
+    }
+    lev_batch64_scalar(peq, m, texts + i, lengths + i, count - i, results + i);
+}
+#endif
+#endif
+
+static const hsd_lev_kernels_t lev_kernels_scalar = {lev_batch64_scalar, "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_lev_kernels_t lev_kernels_avx2 = {lev_batch64_avx2, "AVX2"};
+static const hsd_lev_kernels_t lev_kernels_avx512 = {lev_batch64_avx512, "AVX512F"};
+#endif
+#if defined(__aarch64__)
+static const hsd_lev_kernels_t lev_kernels_neon = {lev_batch64_neon, "NEON"};
+#if defined(__ARM_FEATURE_SVE)
+static const hsd_lev_kernels_t lev_kernels_sve = {lev_batch64_sve, "SVE"};
+#endif
+#endif
+
+static const hsd_lev_kernels_t *resolve_lev_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_lev_kernels_t *chosen = &lev_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Levenshtein: Manual backend requested: %d", forced);
+        bool ok = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = &lev_kernels_avx512;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2()) {
+                    chosen = &lev_kernels_avx2;
+                    ok = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = &lev_kernels_sve;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = &lev_kernels_neon;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                ok = true;
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            hsd_log("Forced backend %d not supported, fallback to scalar", forced);
+            chosen = &lev_kernels_scalar;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &lev_kernels_avx512;
+        else if (hsd_cpu_has_avx2())
+            chosen = &lev_kernels_avx2;
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve())
+            chosen = &lev_kernels_sve;
+        else if (hsd_cpu_has_neon())
+            chosen = &lev_kernels_neon;
+#else
+        if (hsd_cpu_has_neon()) chosen = &lev_kernels_neon;
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Levenshtein batch to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_lev_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_lev_kernels_t *lev_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_lev_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_lev_kernels_t *)cur;
+    const hsd_lev_kernels_t *resolved = resolve_lev_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_lev_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+hsd_status_t hsd_dist_levenshtein_u8(const uint8_t *a, size_t na, const uint8_t *b, size_t nb,
+                                     uint64_t *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if ((a == NULL && na > 0) || (b == NULL && nb > 0)) {
+        *result = UINT64_MAX;
+        return HSD_ERR_NULL_PTR;
+    }
+    /* A common prefix or suffix never changes the distance. */
+    while (na > 0 && nb > 0 && *a == *b) ++a, ++b, --na, --nb;
+    while (na > 0 && nb > 0 && a[na - 1] == b[nb - 1]) --na, --nb;
+    if (na == 0 || nb == 0) {
+        *result = na + nb;
+        return HSD_SUCCESS;
+    }
+    /* The shorter string is the pattern, so it needs fewer words. */
+    if (na > nb) {
+        const uint8_t *s = a;
+        a = b, b = s;
+        size_t n = na;
+        na = nb, nb = n;
+    }
+    if (na <= HSD_LEV_WORD_BITS) {
+        uint64_t peq[256];
+        lev_build_peq(a, na, 1, peq);
+        *result = lev_myers64(peq, na, b, nb);
+        return HSD_SUCCESS;
+    }
+    size_t words = (na + HSD_LEV_WORD_BITS - 1) / HSD_LEV_WORD_BITS;
+    uint64_t *peq = (uint64_t *)malloc((256 + 2) * words * sizeof(uint64_t));
+    if (peq == NULL) {
+        *result = UINT64_MAX;
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    lev_build_peq(a, na, words, peq);
+    *result = lev_myers_blocks(peq, na, b, nb, peq + 256 * words, peq + 257 * words);
+    free(peq);
+    return HSD_SUCCESS;
+}
+
+typedef struct {
+    const hsd_lev_kernels_t *kernels;
+    const uint64_t *peq;
+    size_t m;
+    size_t words;
+    const uint8_t *const *texts;
+    const size_t *lengths;
+    size_t count;
+    uint64_t *results;
+    uint64_t *scratch; /* 2 * words entries per slot for the block path */
+} hsd_lev_batch_job_t;
+
+static hsd_status_t lev_batch_task(void *ctx, size_t task, size_t slot) {
+    hsd_lev_batch_job_t *job = (hsd_lev_batch_job_t *)ctx;
+    size_t start = task * HSD_LEV_BATCH_CHUNK;
+    size_t count = job->count - start < HSD_LEV_BATCH_CHUNK ? job->count - start
+                                                            : HSD_LEV_BATCH_CHUNK;
+    if (job->words == 1) {
+        job->kernels->batch64(job->peq, job->m, job->texts + start, job->lengths + start, count,
+                              job->results + start);
+        return HSD_SUCCESS;
+    }
+    uint64_t *vp = job->scratch + 2 * job->words * slot, *vn = vp + job->words;
+    for (size_t i = start; i < start + count; ++i)
+        job->results[i] =
+            lev_myers_blocks(job->peq, job->m, job->texts[i], job->lengths[i], vp, vn);
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_dist_levenshtein_batch_u8(const uint8_t *pattern, size_t m,
+                                           const uint8_t *const *texts, const size_t *lengths,
+                                           size_t count, uint64_t *results) {
+    if (count == 0) return HSD_SUCCESS;
+    if (texts == NULL || lengths == NULL || results == NULL || (pattern == NULL && m > 0))
+        return HSD_ERR_NULL_PTR;
+    for (size_t i = 0; i < count; ++i) {
+        if (texts[i] == NULL && lengths[i] > 0) return HSD_ERR_NULL_PTR;
+    }
+    if (m == 0) {
+        for (size_t i = 0; i < count; ++i) results[i] = lengths[i];
+        return HSD_SUCCESS;
+    }
+
+    size_t words = (m + HSD_LEV_WORD_BITS - 1) / HSD_LEV_WORD_BITS;
+    size_t tasks = (count + HSD_LEV_BATCH_CHUNK - 1) / HSD_LEV_BATCH_CHUNK;
+    size_t slots = tasks > 1 ? hsd_get_num_threads() : 1;
+    if (slots > tasks) slots = tasks;
+    uint64_t *peq = (uint64_t *)malloc((256 + 2 * slots) * words * sizeof(uint64_t));
+    if (peq == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    lev_build_peq(pattern, m, words, peq);
+
+    hsd_lev_batch_job_t job;
+    job.kernels = lev_kernels();
+    job.peq = peq;
+    job.m = m;
+    job.words = words;
+    job.texts = texts;
+    job.lengths = lengths;
+    job.count = count;
+    job.results = results;
+    job.scratch = peq + 256 * words;
+    hsd_status_t status = tasks > 1
+                              ? hsd_internal_parallel_for(tasks, slots, lev_batch_task, &job)
+                              : lev_batch_task(&job, 0, 0);
+    free(peq);
+    return status;
+}
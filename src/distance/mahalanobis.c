@@ -0,0 +1,138 @@
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+/*
+ * Mahalanobis distance through a whitening factor.
+ *
+ * For a covariance C = L L^T (Cholesky), the distance is d(a, b)^2 = (a - b)^T C^-1 (a - b) =
+ * |W (a - b)|^2 with W = L^-1. hsd_mahalanobis_factor_f32 computes W once, in double, as a
+ * lower-triangular n x n row-major matrix. A single distance then costs one triangular
+ * matrix-vector product, n^2 / 2 multiply-adds, instead of a solve against C. For scans, rows
+ * are whitened once with hsd_whiten_rows_f32 and the distance becomes plain L2 between the
+ * whitened query and the whitened rows, which is what the batch function hands to cdist.
+ */
+
+/* Vectors up to this length are whitened into a stack buffer. */
+#define HSD_MAHALANOBIS_STACK_N 256
+
+hsd_status_t hsd_mahalanobis_factor_f32(const float *cov, size_t n, float *factor) {
+    if (n == 0) return HSD_SUCCESS;
+    if (cov == NULL || factor == NULL) return HSD_ERR_NULL_PTR;
+    if (n >= SIZE_MAX / sizeof(double) / (n + 1)) return HSD_ERR_INVALID_INPUT;
+
+    double *l = (double *)malloc((n * n + n) * sizeof(double));
+    if (l == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    double *x = l + n * n;
+
+    /* Cholesky factor from the lower triangle of cov, row by row. */
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            double s = (double)cov[i * n + j];
+            for (size_t k = 0; k < j; ++k) s -= l[i * n + k] * l[j * n + k];
+            if (i == j) {
+                if (!(s > 0.0) || isinf(s)) {
+                    hsd_log("Mahalanobis factor: covariance is not positive definite at %zu", i);
+                    free(l);
+                    return HSD_ERR_INVALID_INPUT;
+                }
+                l[i * n + i] = sqrt(s);
+            } else {
+                l[i * n + j] = s / l[j * n + j];
+            }
+        }
+    }
+
+    /* Column j of L^-1 by forward substitution of L x = e_j; x[i] = 0 for i < j. */
+    for (size_t j = 0; j < n; ++j) {
+        x[j] = 1.0 / l[j * n + j];
+        factor[j * n + j] = (float)x[j];
+        for (size_t i = j + 1; i < n; ++i) {
+            double s = 0.0;
+            for (size_t k = j; k < i; ++k) s -= l[i * n + k] * x[k];
+            x[i] = s / l[i * n + i];
+            factor[i * n + j] = (float)x[i];
+        }
+        for (size_t i = 0; i < j; ++i) factor[i * n + j] = 0.0f;
+    }
+    free(l);
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_whiten_rows_f32(const float *factor, size_t n, const float *rows, size_t count,
+                                 float *out) {
+    if (n == 0 || count == 0) return HSD_SUCCESS;
+    if (factor == NULL || rows == NULL || out == NULL) return HSD_ERR_NULL_PTR;
+    /* out[r * n + j] = rows_r . W_j, i.e. every row times W^T. */
+    return hsd_cdist_f32(rows, count, factor, n, n, HSD_METRIC_DOT, out);
+}
+
+hsd_status_t hsd_dist_mahalanobis_f32(const float *a, const float *b, const float *factor,
+                                      size_t n, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL || factor == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+
+    float stack[HSD_MAHALANOBIS_STACK_N];
+    float *diff = stack;
+    if (n > HSD_MAHALANOBIS_STACK_N) {
+        diff = (float *)malloc(n * sizeof(float));
+        if (diff == NULL) {
+            *result = NAN;
+            return HSD_ERR_OUT_OF_MEMORY;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) diff[i] = a[i] - b[i];
+
+    /* Row j of W has j + 1 nonzero entries. */
+    hsd_status_t status = HSD_SUCCESS;
+    double sum = 0.0;
+    for (size_t j = 0; j < n && status == HSD_SUCCESS; ++j) {
+        float y;
+        status = hsd_sim_dot_f32(factor + j * n, diff, j + 1, &y);
+        sum += (double)y * y;
+    }
+    if (diff != stack) free(diff);
+    if (status != HSD_SUCCESS) {
+        *result = NAN;
+        return status;
+    }
+    return hsd_internal_round_result(sqrt(sum), result);
+}
+
+hsd_status_t hsd_dist_mahalanobis_batch_f32(const float *query, const float *whitened,
+                                            size_t count, const float *factor, size_t n,
+                                            float *out) {
+    if (count == 0) return HSD_SUCCESS;
+    if (query == NULL || whitened == NULL || factor == NULL || out == NULL)
+        return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        for (size_t i = 0; i < count; ++i) out[i] = 0.0f;
+        return HSD_SUCCESS;
+    }
+
+    float stack[HSD_MAHALANOBIS_STACK_N];
+    float *y = stack;
+    if (n > HSD_MAHALANOBIS_STACK_N) {
+        y = (float *)malloc(n * sizeof(float));
+        if (y == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    }
+    /* Same path as the rows, so a row whitened from the query itself is at distance 0. */
+    hsd_status_t status = hsd_whiten_rows_f32(factor, n, query, 1, y);
+    if (status == HSD_SUCCESS)
+        status = hsd_cdist_f32(y, 1, whitened, count, n, HSD_METRIC_SQEUCLIDEAN, out);
+    if (y != stack) free(y);
+    if (status != HSD_SUCCESS) return status;
+    for (size_t i = 0; i < count; ++i) out[i] = sqrtf(out[i]);
+    return HSD_SUCCESS;
+}
@@ -15,6 +15,7 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include "hsd_internal.h"
 #include "hsdlib.h"
 
 #if defined(__x86_64__) || defined(_M_X64)
@@ -243,6 +244,11 @@ hsd_status_t hsd_dist_manhattan_f32(const float *a, const float *b, size_t n, fl
         *result = NAN;
         return HSD_ERR_NULL_PTR;
     }
+    HSD_Precision precision = hsd_get_precision();
+    if (precision == HSD_PRECISION_F64)
+        return hsd_internal_round_result(hsd_internal_precise_abs_diff_f32(a, b, n), result);
+    if (precision == HSD_PRECISION_DETERMINISTIC)
+        return hsd_internal_round_result(hsd_internal_det_abs_diff_f32(a, b, n), result);
     hsd_manhattan_f32_func_t func = (hsd_manhattan_f32_func_t)atomic_load_explicit(
         &hsd_manhattan_f32_ptr, memory_order_acquire);
     return func(a, b, n, result);
@@ -329,3 +335,939 @@ static hsd_manhattan_f32_func_t resolve_manhattan_f32_internal(void) {
     hsd_log("Dispatch: Resolved Manhattan F32 to: %s", reason);
     return chosen;
 }
+
+/*
+ * Early-abandoning variant, see the bounded squared Euclidean kernels. The partial sum is
+ * reduced every MANHATTAN_BOUND_STRIDE elements; distances that are not abandoned match
+ * hsd_dist_manhattan_f32 bit for bit.
+ */
+#define MANHATTAN_BOUND_STRIDE 128
+
+typedef hsd_status_t (*hsd_manhattan_bounded_f32_func_t)(const float *, const float *, size_t,
+                                                         float, float *);
+
+static inline bool manhattan_bound_exceeded(float partial, float threshold) {
+#if HSD_ALLOW_FP_CHECKS
+    return partial > threshold && partial <= FLT_MAX;
+#else
+    return partial > threshold;
+#endif
+}
+
+static hsd_status_t manhattan_bounded_result(float sum, float threshold, float *result) {
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(sum) || isinf(sum)) {
+        *result = sum;
+        return HSD_ERR_INVALID_INPUT;
+    }
+#endif
+    *result = sum > threshold ? INFINITY : sum;
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t manhattan_bounded_scalar_internal(const float *a, const float *b, size_t n,
+                                                      float threshold, float *result) {
+    hsd_log("Enter manhattan_bounded_scalar_internal (n=%zu)", n);
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        sum += fabsf(a[i] - b[i]);
+        if ((i + 1) % MANHATTAN_BOUND_STRIDE == 0 && manhattan_bound_exceeded(sum, threshold)) {
+            *result = INFINITY;
+            return HSD_SUCCESS;
+        }
+    }
+    return manhattan_bounded_result(sum, threshold, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+/* The unbounded AVX and AVX2 kernels are the same code, so one bounded kernel serves both. */
+__attribute__((target("avx"))) static hsd_status_t manhattan_bounded_avx_internal(
+    const float *a, const float *b, size_t n, float threshold, float *result) {
+    hsd_log("Enter manhattan_bounded_avx_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256 acc = _mm256_setzero_ps();
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    while (i + 8 <= n) {
+        size_t block_end = n - i > MANHATTAN_BOUND_STRIDE ? i + MANHATTAN_BOUND_STRIDE : n;
+        for (; i + 8 <= block_end; i += 8) {
+            __m256 va = _mm256_loadu_ps(a + i);
+            __m256 vb = _mm256_loadu_ps(b + i);
+            __m256 diff = _mm256_sub_ps(va, vb);
+            acc = _mm256_add_ps(acc, _mm256_and_ps(diff, abs_mask));
+        }
+        if (i + 8 <= n && manhattan_bound_exceeded(hsd_internal_hsum_avx_f32(acc), threshold)) {
+            *result = INFINITY;
+            return HSD_SUCCESS;
+        }
+    }
+    float sum = hsd_internal_hsum_avx_f32(acc);
+    for (; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        sum += fabsf(a[i] - b[i]);
+    }
+    return manhattan_bounded_result(sum, threshold, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t manhattan_bounded_avx512_internal(
+    const float *a, const float *b, size_t n, float threshold, float *result) {
+    hsd_log("Enter manhattan_bounded_avx512_internal (n=%zu)", n);
+    size_t i = 0;
+    __m512 acc = _mm512_setzero_ps();
+    while (i + 16 <= n) {
+        size_t block_end = n - i > MANHATTAN_BOUND_STRIDE ? i + MANHATTAN_BOUND_STRIDE : n;
+        for (; i + 16 <= block_end; i += 16) {
+            __m512 va = _mm512_loadu_ps(a + i);
+            __m512 vb = _mm512_loadu_ps(b + i);
+            acc = _mm512_add_ps(acc, _mm512_abs_ps(_mm512_sub_ps(va, vb)));
+        }
+        if (i + 16 <= n && manhattan_bound_exceeded(_mm512_reduce_add_ps(acc), threshold)) {
+            *result = INFINITY;
+            return HSD_SUCCESS;
+        }
+    }
+    float sum = _mm512_reduce_add_ps(acc);
+    for (; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        sum += fabsf(a[i] - b[i]);
+    }
+    return manhattan_bounded_result(sum, threshold, result);
+}
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+static inline float manhattan_bounded_hsum_neon(float32x4_t acc) {
+#if defined(__aarch64__)
+    return vaddvq_f32(acc);
+#else
+    float32x2_t p = vpadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    p = vpadd_f32(p, p);
+    return vget_lane_f32(p, 0);
+#endif
+}
+
+static hsd_status_t manhattan_bounded_neon_internal(const float *a, const float *b, size_t n,
+                                                    float threshold, float *result) {
+    hsd_log("Enter manhattan_bounded_neon_internal (n=%zu)", n);
+    size_t i = 0;
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    while (i + 4 <= n) {
+        size_t block_end = n - i > MANHATTAN_BOUND_STRIDE ? i + MANHATTAN_BOUND_STRIDE : n;
+        for (; i + 4 <= block_end; i += 4) {
+            float32x4_t va = vld1q_f32(a + i);
+            float32x4_t vb = vld1q_f32(b + i);
+            acc = vaddq_f32(acc, vabsq_f32(vsubq_f32(va, vb)));
+        }
+        if (i + 4 <= n && manhattan_bound_exceeded(manhattan_bounded_hsum_neon(acc), threshold)) {
+            *result = INFINITY;
+            return HSD_SUCCESS;
+        }
+    }
+    float sum = manhattan_bounded_hsum_neon(acc);
+    for (; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        sum += fabsf(a[i] - b[i]);
+    }
+    return manhattan_bounded_result(sum, threshold, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t manhattan_bounded_sve_internal(
+    const float *a, const float *b, size_t n, float threshold, float *result) {
+    hsd_log("Enter manhattan_bounded_sve_internal (n=%zu)", n);
+    uint64_t i = 0;
+    uint64_t next_check = MANHATTAN_BOUND_STRIDE;
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    while (i < n) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t va = svld1_f32(pg, a + i);
+        svfloat32_t vb = svld1_f32(pg, b + i);
+        svfloat32_t ad = svabs_f32_z(pg, svsub_f32_z(pg, va, vb));
+        acc = svadd_f32_m(pg, acc, ad);
+        i += svcntw();
+        if (i >= next_check && i < n) {
+            if (manhattan_bound_exceeded(svaddv_f32(svptrue_b32(), acc), threshold)) {
+                *result = INFINITY;
+                return HSD_SUCCESS;
+            }
+            next_check = i + MANHATTAN_BOUND_STRIDE;
+        }
+    }
+    return manhattan_bounded_result(svaddv_f32(svptrue_b32(), acc), threshold, result);
+}
+#endif
+#endif
+static hsd_manhattan_bounded_f32_func_t resolve_manhattan_bounded_f32_internal(void);
+static hsd_status_t manhattan_bounded_f32_resolver_trampoline(const float *a, const float *b,
+                                                              size_t n, float threshold,
+                                                              float *result);
+
+static atomic_uintptr_t hsd_manhattan_bounded_f32_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)manhattan_bounded_f32_resolver_trampoline);
+
+hsd_status_t hsd_dist_manhattan_bounded_f32(const float *a, const float *b, size_t n,
+                                            float threshold, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (isnan(threshold)) {
+        *result = NAN;
+        return HSD_ERR_INVALID_INPUT;
+    }
+    if (n == 0) {
+        *result = 0.0f > threshold ? INFINITY : 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    if (hsd_get_precision() != HSD_PRECISION_FAST) {
+        hsd_status_t status = hsd_dist_manhattan_f32(a, b, n, result);
+        if (status == HSD_SUCCESS && *result > threshold) *result = INFINITY;
+        return status;
+    }
+    hsd_manhattan_bounded_f32_func_t func = (hsd_manhattan_bounded_f32_func_t)atomic_load_explicit(
+        &hsd_manhattan_bounded_f32_ptr, memory_order_acquire);
+    return func(a, b, n, threshold, result);
+}
+
+static hsd_status_t manhattan_bounded_f32_resolver_trampoline(const float *a, const float *b,
+                                                              size_t n, float threshold,
+                                                              float *result) {
+    hsd_manhattan_bounded_f32_func_t resolved = resolve_manhattan_bounded_f32_internal();
+    uintptr_t exp = (uintptr_t)manhattan_bounded_f32_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_manhattan_bounded_f32_ptr, &exp,
+                                            (uintptr_t)resolved, memory_order_release,
+                                            memory_order_relaxed);
+    return resolved(a, b, n, threshold, result);
+}
+
+static hsd_manhattan_bounded_f32_func_t resolve_manhattan_bounded_f32_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_manhattan_bounded_f32_func_t chosen = manhattan_bounded_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Manhattan Bounded F32: Forced backend %d", forced);
+        bool supported = false;
+#if defined(__x86_64__) || defined(_M_X64)
+        if (forced == HSD_BACKEND_AVX512F && hsd_cpu_has_avx512f()) {
+            chosen = manhattan_bounded_avx512_internal;
+            reason = "AVX512F (Forced)";
+            supported = true;
+        } else if (forced == HSD_BACKEND_AVX2 && hsd_cpu_has_avx2()) {
+            chosen = manhattan_bounded_avx_internal;
+            reason = "AVX (Forced AVX2, same kernel)";
+            supported = true;
+        } else if (forced == HSD_BACKEND_AVX && hsd_cpu_has_avx()) {
+            chosen = manhattan_bounded_avx_internal;
+            reason = "AVX (Forced)";
+            supported = true;
+        }
+#elif defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+        if (forced == HSD_BACKEND_SVE && hsd_cpu_has_sve()) {
+            chosen = manhattan_bounded_sve_internal;
+            reason = "SVE (Forced)";
+            supported = true;
+        } else
+#endif
+            if (forced == HSD_BACKEND_NEON && hsd_cpu_has_neon()) {
+            chosen = manhattan_bounded_neon_internal;
+            reason = "NEON (Forced)";
+            supported = true;
+        }
+#endif
+        else if (forced == HSD_BACKEND_SCALAR) {
+            reason = "Scalar (Forced)";
+            supported = true;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Forced backend %d not supported; falling back", forced);
+            chosen = manhattan_bounded_scalar_internal;
+            reason = "Scalar (Fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen = manhattan_bounded_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen = manhattan_bounded_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen = manhattan_bounded_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen = manhattan_bounded_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen = manhattan_bounded_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Manhattan Bounded F32 to: %s", reason);
+    return chosen;
+}
+
+/*
+ * 1-D Wasserstein distance between two histograms on the same unit-width bins: the L1 norm of
+ * the difference of their cumulative sums, sum_i |sum_{k <= i} (a[k] - b[k])|. The kernels take
+ * an in-register prefix sum of each block of differences (log2(width) shift-and-add steps), add
+ * the running total carried over from the previous blocks as a broadcast vector, and then
+ * accumulate absolute values like the Manhattan kernels above. The carry is advanced by the
+ * block's own total, which does not depend on the carry, so the loop-carried chain is one add.
+ */
+typedef hsd_status_t (*hsd_wasserstein1d_f32_func_t)(const float *, const float *, size_t,
+                                                     float *);
+
+static hsd_status_t wasserstein1d_tail(const float *a, const float *b, size_t i, size_t n,
+                                       float carry, float sum, float *result) {
+    for (; i < n; ++i) {
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(a[i]) || isnan(b[i]) || isinf(a[i]) || isinf(b[i])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        carry += a[i] - b[i];
+        sum += fabsf(carry);
+    }
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(sum) || isinf(sum)) {
+        *result = sum;
+        return HSD_ERR_INVALID_INPUT;
+    }
+#endif
+    *result = sum;
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t wasserstein1d_scalar_internal(const float *a, const float *b, size_t n,
+                                                  float *result) {
+    hsd_log("Enter wasserstein1d_scalar_internal (n=%zu)", n);
+    return wasserstein1d_tail(a, b, 0, n, 0.0f, 0.0f, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static hsd_status_t wasserstein1d_avx_internal(const float *a,
+                                                                              const float *b,
+                                                                              size_t n,
+                                                                              float *result) {
+    hsd_log("Enter wasserstein1d_avx_internal (n=%zu)", n);
+    size_t i = 0;
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 acc = zero, carry = zero;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        /* Shift by one and two elements within each 128-bit half, then carry the low half. */
+        x = _mm256_add_ps(x, _mm256_blend_ps(_mm256_permute_ps(x, 0x90), zero, 0x11));
+        x = _mm256_add_ps(x, _mm256_blend_ps(_mm256_permute_ps(x, 0x40), zero, 0x33));
+        __m256 top = _mm256_permute_ps(x, 0xFF);
+        x = _mm256_add_ps(x, _mm256_permute2f128_ps(top, top, 0x08));
+        top = _mm256_permute_ps(x, 0xFF);
+        x = _mm256_add_ps(x, carry);
+        carry = _mm256_add_ps(carry, _mm256_permute2f128_ps(top, top, 0x11));
+        acc = _mm256_add_ps(acc, _mm256_and_ps(x, abs_mask));
+    }
+    float sum = hsd_internal_hsum_avx_f32(acc);
+    return wasserstein1d_tail(a, b, i, n, _mm256_cvtss_f32(carry), sum, result);
+}
+
+__attribute__((target("avx2"))) static hsd_status_t wasserstein1d_avx2_internal(const float *a,
+                                                                                const float *b,
+                                                                                size_t n,
+                                                                                float *result) {
+    hsd_log("Enter wasserstein1d_avx2_internal (n=%zu)", n);
+    size_t i = 0;
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256i last = _mm256_set1_epi32(7);
+    __m256 acc = _mm256_setzero_ps(), carry = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256i xi = _mm256_castps_si256(x);
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(xi, 4)));
+        xi = _mm256_castps_si256(x);
+        x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(xi, 8)));
+        __m256 top = _mm256_permute_ps(x, 0xFF);
+        x = _mm256_add_ps(x, _mm256_permute2f128_ps(top, top, 0x08));
+        __m256 total = _mm256_permutevar8x32_ps(x, last);
+        x = _mm256_add_ps(x, carry);
+        carry = _mm256_add_ps(carry, total);
+        acc = _mm256_add_ps(acc, _mm256_and_ps(x, abs_mask));
+    }
+    float sum = hsd_internal_hsum_avx_f32(acc);
+    return wasserstein1d_tail(a, b, i, n, _mm256_cvtss_f32(carry), sum, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t wasserstein1d_avx512_internal(
+    const float *a, const float *b, size_t n, float *result) {
+    hsd_log("Enter wasserstein1d_avx512_internal (n=%zu)", n);
+    size_t i = 0;
+    const __m512i iota = _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m512i last = _mm512_set1_epi32(15);
+    __m512 acc = _mm512_setzero_ps(), carry = _mm512_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        __m512 x = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        /* Lane j adds lane j - k for k = 1, 2, 4, 8; the lanes below k add zero. */
+        for (int k = 1; k < 16; k <<= 1) {
+            __m512i idx = _mm512_sub_epi32(iota, _mm512_set1_epi32(k));
+            x = _mm512_add_ps(x, _mm512_maskz_permutexvar_ps((__mmask16)(0xFFFFu << k), idx, x));
+        }
+        __m512 total = _mm512_permutexvar_ps(last, x);
+        x = _mm512_add_ps(x, carry);
+        carry = _mm512_add_ps(carry, total);
+        acc = _mm512_add_ps(acc, _mm512_abs_ps(x));
+    }
+    float sum = _mm512_reduce_add_ps(acc);
+    return wasserstein1d_tail(a, b, i, n, _mm512_cvtss_f32(carry), sum, result);
+}
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+static hsd_status_t wasserstein1d_neon_internal(const float *a, const float *b, size_t n,
+                                                float *result) {
+    hsd_log("Enter wasserstein1d_neon_internal (n=%zu)", n);
+    size_t i = 0;
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t acc = zero, carry = zero;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        x = vaddq_f32(x, vextq_f32(zero, x, 3));
+        x = vaddq_f32(x, vextq_f32(zero, x, 2));
+        float32x4_t total = vdupq_n_f32(vgetq_lane_f32(x, 3));
+        x = vaddq_f32(x, carry);
+        carry = vaddq_f32(carry, total);
+        acc = vaddq_f32(acc, vabsq_f32(x));
+    }
+#if defined(__aarch64__)
+    float sum = vaddvq_f32(acc);
+#else
+    float32x2_t tmp = vpadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    tmp = vpadd_f32(tmp, tmp);
+    float sum = vget_lane_f32(tmp, 0);
+#endif
+    return wasserstein1d_tail(a, b, i, n, vgetq_lane_f32(carry, 0), sum, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+/*
+ * The vector length is only known at run time, so the shifts go through svtbl, which returns
+ * zero for the out-of-range indices of the lanes below k. Lanes past n hold the carried total
+ * and are left out of the accumulator by the predicate.
+ */
+__attribute__((target("+sve"))) static hsd_status_t wasserstein1d_sve_internal(const float *a,
+                                                                               const float *b,
+                                                                               size_t n,
+                                                                               float *result) {
+    hsd_log("Enter wasserstein1d_sve_internal (n=%zu)", n);
+    int64_t i = 0;
+    int64_t n_sve = (int64_t)n;
+    const svbool_t all = svptrue_b32();
+    const svuint32_t iota = svindex_u32(0, 1);
+    const uint32_t lanes = (uint32_t)svcntw();
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    float carry = 0.0f;
+    while (i < n_sve) {
+        svbool_t pg = svwhilelt_b32((uint64_t)i, (uint64_t)n_sve);
+        svfloat32_t x = svsub_f32_z(pg, svld1_f32(pg, a + i), svld1_f32(pg, b + i));
+        for (uint32_t k = 1; k < lanes; k <<= 1)
+            x = svadd_f32_x(all, x, svtbl_f32(x, svsub_n_u32_x(all, iota, k)));
+        float total = svlastb_f32(pg, x);
+        x = svadd_n_f32_x(all, x, carry);
+        carry += total;
+        acc = svadd_f32_m(pg, acc, svabs_f32_x(pg, x));
+        i += svcntw();
+    }
+    return wasserstein1d_tail(a, b, n, n, carry, svaddv_f32(all, acc), result);
+}
+#endif
+#endif
+
+/*
+ * Sequential f64 prefix sum used outside fast mode; its order does not depend on the backend.
+ * It is kept scalar because the blocked prefix sum of the SIMD kernels reassociates the running
+ * total, which is the rounding the precise modes avoid.
+ */
+static double wasserstein1d_f64(const float *a, const float *b, size_t n) {
+    double carry = 0.0, sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        carry += (double)a[i] - (double)b[i];
+        sum += fabs(carry);
+    }
+    return sum;
+}
+
+static hsd_wasserstein1d_f32_func_t resolve_wasserstein1d_f32_internal(void);
+static hsd_status_t wasserstein1d_f32_resolver_trampoline(const float *a, const float *b,
+                                                          size_t n, float *result);
+
+static atomic_uintptr_t hsd_wasserstein1d_f32_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)wasserstein1d_f32_resolver_trampoline);
+
+hsd_status_t hsd_dist_wasserstein1d_f32(const float *a, const float *b, size_t n,
+                                        float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    if (hsd_get_precision() != HSD_PRECISION_FAST)
+        return hsd_internal_round_result(wasserstein1d_f64(a, b, n), result);
+    hsd_wasserstein1d_f32_func_t func = (hsd_wasserstein1d_f32_func_t)atomic_load_explicit(
+        &hsd_wasserstein1d_f32_ptr, memory_order_acquire);
+    return func(a, b, n, result);
+}
+
+static hsd_status_t wasserstein1d_f32_resolver_trampoline(const float *a, const float *b,
+                                                          size_t n, float *result) {
+    hsd_wasserstein1d_f32_func_t resolved = resolve_wasserstein1d_f32_internal();
+    uintptr_t expected = (uintptr_t)wasserstein1d_f32_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_wasserstein1d_f32_ptr, &expected,
+                                            (uintptr_t)resolved, memory_order_release,
+                                            memory_order_relaxed);
+    return resolved(a, b, n, result);
+}
+
+static hsd_wasserstein1d_f32_func_t resolve_wasserstein1d_f32_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_wasserstein1d_f32_func_t chosen = wasserstein1d_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Wasserstein1D F32: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = wasserstein1d_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2()) {
+                    chosen = wasserstein1d_avx2_internal;
+                    reason = "AVX2 (Forced)";
+                    supported = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen = wasserstein1d_avx_internal;
+                    reason = "AVX (fallback from forced AVX2)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen = wasserstein1d_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = wasserstein1d_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = wasserstein1d_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen = wasserstein1d_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen = wasserstein1d_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx2()) {
+            chosen = wasserstein1d_avx2_internal;
+            reason = "AVX2 (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen = wasserstein1d_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen = wasserstein1d_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen = wasserstein1d_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen = wasserstein1d_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Wasserstein1D F32 to: %s", reason);
+    return chosen;
+}
+
+/*
+ * Wasserstein distance between two empirical distributions given as sorted samples: the area
+ * between their step CDFs. Equal sample counts pair the i-th smallest values, which is the
+ * Manhattan distance divided by n. Otherwise the two arrays are merged and each gap between
+ * consecutive values is weighted by |F_x - F_y|, kept exact as |i * ny - j * nx| / (nx * ny).
+ * A decreasing pair in either array is reported as invalid input: in the merge it shows up as a
+ * value below the previous one, and the equal-count path checks it in a separate O(n) pass.
+ */
+hsd_status_t hsd_dist_wasserstein1d_sorted_f32(const float *x, size_t nx, const float *y,
+                                               size_t ny, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (nx == 0 || ny == 0) {
+        *result = NAN;
+        return HSD_ERR_INVALID_INPUT;
+    }
+    if (x == NULL || y == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    if (nx == ny) {
+#if HSD_ALLOW_FP_CHECKS
+        for (size_t k = 1; k < nx; ++k) {
+            if (x[k] < x[k - 1] || y[k] < y[k - 1]) {
+                hsd_log("Wasserstein1D sorted: samples not ascending at %zu", k);
+                *result = NAN;
+                return HSD_ERR_INVALID_INPUT;
+            }
+        }
+#endif
+        hsd_status_t status = hsd_dist_manhattan_f32(x, y, nx, result);
+        if (status == HSD_SUCCESS) *result /= (float)nx;
+        return status;
+    }
+
+    size_t i = 0, j = 0;
+    double prev = x[0] < y[0] ? x[0] : y[0];
+    double area = 0.0;
+    while (i < nx || j < ny) {
+        bool take_x = j == ny || (i < nx && x[i] <= y[j]);
+        double v = take_x ? x[i] : y[j];
+#if HSD_ALLOW_FP_CHECKS
+        if (isnan(v) || isinf(v) || v < prev) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+#endif
+        area += fabs((double)i * (double)ny - (double)j * (double)nx) * (v - prev);
+        prev = v;
+        if (take_x)
+            ++i;
+        else
+            ++j;
+    }
+    return hsd_internal_round_result(area / ((double)nx * (double)ny), result);
+}
+
+typedef hsd_status_t (*hsd_manhattan_f64_func_t)(const double *, const double *, size_t, double *);
+
+static hsd_status_t manhattan_f64_scalar_internal(const double *a, const double *b, size_t n,
+                                                  double *result) {
+    hsd_log("Enter manhattan_f64_scalar_internal (n=%zu)", n);
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += fabs(a[i] - b[i]);
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static hsd_status_t manhattan_f64_avx_internal(const double *a,
+                                                                              const double *b,
+                                                                              size_t n,
+                                                                              double *result) {
+    hsd_log("Enter manhattan_f64_avx_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256d acc = _mm256_setzero_pd();
+    const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    for (; i + 4 <= n; i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        __m256d vb = _mm256_loadu_pd(b + i);
+        __m256d diff = _mm256_sub_pd(va, vb);
+        acc = _mm256_add_pd(acc, _mm256_and_pd(diff, abs_mask));
+    }
+    double sum = hsd_internal_hsum_avx_f64(acc);
+    for (; i < n; ++i) {
+        sum += fabs(a[i] - b[i]);
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+__attribute__((target("avx2,fma"))) static hsd_status_t manhattan_f64_avx2_internal(
+    const double *a, const double *b, size_t n, double *result) {
+    hsd_log("Enter manhattan_f64_avx2_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256d acc = _mm256_setzero_pd();
+    const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    for (; i + 4 <= n; i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        __m256d vb = _mm256_loadu_pd(b + i);
+        __m256d diff = _mm256_sub_pd(va, vb);
+        acc = _mm256_add_pd(acc, _mm256_and_pd(diff, abs_mask));
+    }
+    double sum = hsd_internal_hsum_avx_f64(acc);
+    for (; i < n; ++i) {
+        sum += fabs(a[i] - b[i]);
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t manhattan_f64_avx512_internal(
+    const double *a, const double *b, size_t n, double *result) {
+    hsd_log("Enter manhattan_f64_avx512_internal (n=%zu)", n);
+    size_t i = 0;
+    __m512d acc = _mm512_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        __m512d va = _mm512_loadu_pd(a + i);
+        __m512d vb = _mm512_loadu_pd(b + i);
+        acc = _mm512_add_pd(acc, _mm512_abs_pd(_mm512_sub_pd(va, vb)));
+    }
+    double sum = _mm512_reduce_add_pd(acc);
+    for (; i < n; ++i) {
+        sum += fabs(a[i] - b[i]);
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+#endif
+
+#if defined(__aarch64__)
+static hsd_status_t manhattan_f64_neon_internal(const double *a, const double *b, size_t n,
+                                                double *result) {
+    hsd_log("Enter manhattan_f64_neon_internal (n=%zu)", n);
+    size_t i = 0;
+    float64x2_t acc = vdupq_n_f64(0.0);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t va = vld1q_f64(a + i);
+        float64x2_t vb = vld1q_f64(b + i);
+        acc = vaddq_f64(acc, vabdq_f64(va, vb));
+    }
+    double sum = vaddvq_f64(acc);
+    for (; i < n; ++i) {
+        sum += fabs(a[i] - b[i]);
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t manhattan_f64_sve_internal(const double *a,
+                                                                               const double *b,
+                                                                               size_t n,
+                                                                               double *result) {
+    hsd_log("Enter manhattan_f64_sve_internal (n=%zu)", n);
+    int64_t i = 0;
+    svfloat64_t acc = svdup_n_f64(0.0);
+    while (i < (int64_t)n) {
+        svbool_t pg = svwhilelt_b64((uint64_t)i, (uint64_t)n);
+        svfloat64_t va = svld1_f64(pg, a + i);
+        svfloat64_t vb = svld1_f64(pg, b + i);
+        svfloat64_t ad = svabd_f64_z(pg, va, vb);
+        acc = svadd_f64_m(pg, acc, ad);
+        i += svcntd();
+    }
+    double sum = svaddv_f64(svptrue_b64(), acc);
+    return hsd_internal_f64_result(sum, result);
+}
+
+#endif
+#endif
+
+static hsd_manhattan_f64_func_t resolve_manhattan_f64_internal(void);
+static hsd_status_t manhattan_f64_resolver_trampoline(const double *a, const double *b, size_t n,
+                                                      double *result);
+
+static atomic_uintptr_t hsd_manhattan_f64_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)manhattan_f64_resolver_trampoline);
+
+hsd_status_t hsd_dist_manhattan_f64(const double *a, const double *b, size_t n, double *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    hsd_manhattan_f64_func_t func = (hsd_manhattan_f64_func_t)atomic_load_explicit(
+        &hsd_manhattan_f64_ptr, memory_order_acquire);
+    return func(a, b, n, result);
+}
+
+static hsd_status_t manhattan_f64_resolver_trampoline(const double *a, const double *b, size_t n,
+                                                      double *result) {
+    hsd_log("Manhattan F64: resolving backend");
+    hsd_manhattan_f64_func_t resolved_func = resolve_manhattan_f64_internal();
+    uintptr_t expected = (uintptr_t)manhattan_f64_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_manhattan_f64_ptr, &expected,
+                                            (uintptr_t)resolved_func, memory_order_release,
+                                            memory_order_relaxed);
+    hsd_manhattan_f64_func_t current_func = (hsd_manhattan_f64_func_t)atomic_load_explicit(
+        &hsd_manhattan_f64_ptr, memory_order_acquire);
+    return current_func(a, b, n, result);
+}
+
+static hsd_manhattan_f64_func_t resolve_manhattan_f64_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_manhattan_f64_func_t chosen_func = manhattan_f64_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Manhattan F64: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen_func = manhattan_f64_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2()) {
+                    chosen_func = manhattan_f64_avx2_internal;
+                    reason = "AVX2 (Forced)";
+                    supported = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen_func = manhattan_f64_avx_internal;
+                    reason = "AVX (fallback from forced AVX2)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen_func = manhattan_f64_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen_func = manhattan_f64_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen_func = manhattan_f64_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                chosen_func = manhattan_f64_scalar_internal;
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen_func = manhattan_f64_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen_func = manhattan_f64_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx2()) {
+            chosen_func = manhattan_f64_avx2_internal;
+            reason = "AVX2 (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen_func = manhattan_f64_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen_func = manhattan_f64_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen_func = manhattan_f64_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen_func = manhattan_f64_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Manhattan F64 to: %s", reason);
+    return chosen_func;
+}
@@ -0,0 +1,452 @@
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+/*
+ * Chebyshev (L-infinity) and the vectorized Minkowski sums share one backend choice, so they
+ * are resolved together as a table. A max does not propagate NaN the way a sum does (x86 max
+ * returns its second operand when either is NaN), so the x86 max kernels track unordered lanes
+ * separately and return NaN if any difference was NaN.
+ *
+ * A general order p is computed as m * (sum (|d_i| / m)^p)^(1/p) with m = max |d_i|, so every
+ * term lies in [0, 1], the sum in [1, n], and neither overflows however large p is. The SIMD
+ * kernels evaluate (|d| / m)^p as exp(p * log(|d| / m)) with the vector log and exp from
+ * hsd_internal.h; those need 256-bit integer ops, so AVX-only hosts use the scalar powf loop.
+ */
+typedef struct {
+    float (*max_abs_diff)(const float *a, const float *b, size_t n);
+    float (*sum_abs_diff_cubed)(const float *a, const float *b, size_t n);
+    float (*sum_scaled_pow)(const float *a, const float *b, size_t n, float m, float p);
+    const char *name;
+} hsd_minkowski_kernels_t;
+
+static float max_abs_diff_scalar(const float *a, const float *b, size_t n) {
+    float m = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float d = fabsf(a[i] - b[i]);
+        if (d > m || isnan(d)) m = d;
+        if (isnan(m)) break;
+    }
+    return m;
+}
+
+static float sum_abs_diff_cubed_scalar(const float *a, const float *b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float d = a[i] - b[i];
+        sum += fabsf(d) * d * d;
+    }
+    return sum;
+}
+
+static float sum_scaled_pow_scalar(const float *a, const float *b, size_t n, float m, float p) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += powf(fabsf(a[i] - b[i]) / m, p);
+    return sum;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static float max_abs_diff_avx(const float *a, const float *b,
+                                                             size_t n) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 acc = _mm256_setzero_ps();
+    __m256 unordered = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        unordered = _mm256_or_ps(unordered, _mm256_cmp_ps(d, d, _CMP_UNORD_Q));
+        acc = _mm256_max_ps(acc, _mm256_andnot_ps(sign, d));
+    }
+    if (_mm256_movemask_ps(unordered) != 0) return NAN;
+    __m128 m = _mm_max_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+    m = _mm_max_ss(m, _mm_shuffle_ps(m, m, 1));
+    float tail = max_abs_diff_scalar(a + i, b + i, n - i);
+    float head = _mm_cvtss_f32(m);
+    return (tail > head || isnan(tail)) ? tail : head;
+}
+
+__attribute__((target("avx"))) static float sum_abs_diff_cubed_avx(const float *a, const float *b,
+                                                                   size_t n) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 cube = _mm256_mul_ps(_mm256_andnot_ps(sign, d), _mm256_mul_ps(d, d));
+        acc = _mm256_add_ps(acc, cube);
+    }
+    return hsd_internal_hsum_avx_f32(acc) + sum_abs_diff_cubed_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2,fma"))) static float sum_abs_diff_cubed_avx2(const float *a,
+                                                                         const float *b,
+                                                                         size_t n) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        acc0 = _mm256_fmadd_ps(_mm256_andnot_ps(sign, d0), _mm256_mul_ps(d0, d0), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_andnot_ps(sign, d1), _mm256_mul_ps(d1, d1), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        acc0 = _mm256_fmadd_ps(_mm256_andnot_ps(sign, d), _mm256_mul_ps(d, d), acc0);
+    }
+    return hsd_internal_hsum_avx_f32(_mm256_add_ps(acc0, acc1)) +
+           sum_abs_diff_cubed_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static float max_abs_diff_avx512(const float *a,
+                                                                    const float *b, size_t n) {
+    __m512 acc = _mm512_setzero_ps();
+    __mmask16 unordered = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        unordered |= _mm512_cmp_ps_mask(d, d, _CMP_UNORD_Q);
+        acc = _mm512_max_ps(acc, _mm512_abs_ps(d));
+    }
+    if (i < n) {
+        __mmask16 m = (__mmask16)((1u << (n - i)) - 1u);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i));
+        unordered |= _mm512_cmp_ps_mask(d, d, _CMP_UNORD_Q);
+        acc = _mm512_max_ps(acc, _mm512_abs_ps(d));
+    }
+    if (unordered != 0) return NAN;
+    return _mm512_reduce_max_ps(acc);
+}
+
+__attribute__((target("avx512f"))) static float sum_abs_diff_cubed_avx512(const float *a,
+                                                                          const float *b,
+                                                                          size_t n) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        acc = _mm512_fmadd_ps(_mm512_abs_ps(d), _mm512_mul_ps(d, d), acc);
+    }
+    if (i < n) {
+        __mmask16 m = (__mmask16)((1u << (n - i)) - 1u);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(m, a + i), _mm512_maskz_loadu_ps(m, b + i));
+        acc = _mm512_fmadd_ps(_mm512_abs_ps(d), _mm512_mul_ps(d, d), acc);
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+
+/* Zero differences are masked out, since the log of 0 is not defined. */
+__attribute__((target("avx2,fma"))) static float sum_scaled_pow_avx2(const float *a,
+                                                                     const float *b, size_t n,
+                                                                     float m, float p) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 vm = _mm256_set1_ps(m);
+    const __m256 vp = _mm256_set1_ps(p);
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 r = _mm256_div_ps(_mm256_andnot_ps(sign, d), vm);
+        __m256 live = _mm256_cmp_ps(r, _mm256_setzero_ps(), _CMP_GT_OQ);
+        __m256 t = hsd_internal_exp_avx2(_mm256_mul_ps(vp, hsd_internal_log_avx2(r)));
+        acc = _mm256_add_ps(acc, _mm256_and_ps(live, t));
+    }
+    return hsd_internal_hsum_avx_f32(acc) + sum_scaled_pow_scalar(a + i, b + i, n - i, m, p);
+}
+
+__attribute__((target("avx512f"))) static float sum_scaled_pow_avx512(const float *a,
+                                                                      const float *b, size_t n,
+                                                                      float m, float p) {
+    const __m512 vm = _mm512_set1_ps(m);
+    const __m512 vp = _mm512_set1_ps(p);
+    __m512 acc = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 k = n - i >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1u);
+        __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(k, a + i), _mm512_maskz_loadu_ps(k, b + i));
+        __m512 r = _mm512_div_ps(_mm512_abs_ps(d), vm);
+        __mmask16 live = _mm512_cmp_ps_mask(r, _mm512_setzero_ps(), _CMP_GT_OQ);
+        __m512 t = hsd_internal_exp_avx512(_mm512_mul_ps(vp, hsd_internal_log_avx512(r)));
+        acc = _mm512_mask_add_ps(acc, live, acc, t);
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+#endif
+
+#if defined(__aarch64__)
+/* FMAX returns NaN when either operand is NaN, so the NEON and SVE max needs no extra check. */
+static float max_abs_diff_neon(const float *a, const float *b, size_t n) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) acc = vmaxq_f32(acc, vabdq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+    float head = vmaxvq_f32(acc);
+    float tail = max_abs_diff_scalar(a + i, b + i, n - i);
+    return (tail > head || isnan(tail)) ? tail : head;
+}
+
+static float sum_abs_diff_cubed_neon(const float *a, const float *b, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t d0 = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        float32x4_t d1 = vsubq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        acc0 = vfmaq_f32(acc0, vabsq_f32(d0), vmulq_f32(d0, d0));
+        acc1 = vfmaq_f32(acc1, vabsq_f32(d1), vmulq_f32(d1, d1));
+    }
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t d = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        acc0 = vfmaq_f32(acc0, vabsq_f32(d), vmulq_f32(d, d));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1)) + sum_abs_diff_cubed_scalar(a + i, b + i, n - i);
+}
+
+static float sum_scaled_pow_neon(const float *a, const float *b, size_t n, float m, float p) {
+    const float32x4_t vm = vdupq_n_f32(m);
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t r = vdivq_f32(vabdq_f32(vld1q_f32(a + i), vld1q_f32(b + i)), vm);
+        uint32x4_t live = vcgtq_f32(r, vdupq_n_f32(0.0f));
+        float32x4_t t = hsd_internal_exp_neon(vmulq_n_f32(hsd_internal_log_neon(r), p));
+        acc = vaddq_f32(acc, vreinterpretq_f32_u32(vandq_u32(live, vreinterpretq_u32_f32(t))));
+    }
+    return vaddvq_f32(acc) + sum_scaled_pow_scalar(a + i, b + i, n - i, m, p);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static float max_abs_diff_sve(const float *a, const float *b,
+                                                              size_t n) {
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        acc = svmax_f32_m(pg, acc, svabd_f32_x(pg, svld1_f32(pg, a + i), svld1_f32(pg, b + i)));
+    }
+    return svmaxv_f32(svptrue_b32(), acc);
+}
+
+__attribute__((target("+sve"))) static float sum_abs_diff_cubed_sve(const float *a,
+                                                                    const float *b, size_t n) {
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t d = svsub_f32_x(pg, svld1_f32(pg, a + i), svld1_f32(pg, b + i));
+        acc = svmla_f32_m(pg, acc, svabs_f32_x(pg, d), svmul_f32_x(pg, d, d));
+    }
+    return svaddv_f32(svptrue_b32(), acc);
+}
+
+__attribute__((target("+sve"))) static float sum_scaled_pow_sve(const float *a, const float *b,
+                                                                size_t n, float m, float p) {
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t d = svabd_f32_x(pg, svld1_f32(pg, a + i), svld1_f32(pg, b + i));
+        svfloat32_t r = svdiv_n_f32_x(pg, d, m);
+        svbool_t live = svcmpgt_n_f32(pg, r, 0.0f);
+        svfloat32_t t =
+            hsd_internal_exp_sve(live, svmul_n_f32_x(live, hsd_internal_log_sve(live, r), p));
+        acc = svadd_f32_m(live, acc, t);
+    }
+    return svaddv_f32(svptrue_b32(), acc);
+}
+#endif
+#endif
+
+static const hsd_minkowski_kernels_t minkowski_kernels_scalar = {
+    max_abs_diff_scalar, sum_abs_diff_cubed_scalar, sum_scaled_pow_scalar, "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_minkowski_kernels_t minkowski_kernels_avx = {
+    max_abs_diff_avx, sum_abs_diff_cubed_avx, sum_scaled_pow_scalar, "AVX"};
+static const hsd_minkowski_kernels_t minkowski_kernels_avx2 = {
+    max_abs_diff_avx, sum_abs_diff_cubed_avx2, sum_scaled_pow_avx2, "AVX2"};
+static const hsd_minkowski_kernels_t minkowski_kernels_avx512 = {
+    max_abs_diff_avx512, sum_abs_diff_cubed_avx512, sum_scaled_pow_avx512, "AVX512F"};
+#endif
+#if defined(__aarch64__)
+static const hsd_minkowski_kernels_t minkowski_kernels_neon = {
+    max_abs_diff_neon, sum_abs_diff_cubed_neon, sum_scaled_pow_neon, "NEON"};
+#if defined(__ARM_FEATURE_SVE)
+static const hsd_minkowski_kernels_t minkowski_kernels_sve = {
+    max_abs_diff_sve, sum_abs_diff_cubed_sve, sum_scaled_pow_sve, "SVE"};
+#endif
+#endif
+
+static const hsd_minkowski_kernels_t *resolve_minkowski_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_minkowski_kernels_t *chosen = &minkowski_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Minkowski F32: Manual backend requested: %d", forced);
+        bool ok = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = &minkowski_kernels_avx512;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2() && hsd_cpu_has_fma()) {
+                    chosen = &minkowski_kernels_avx2;
+                    ok = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen = &minkowski_kernels_avx;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen = &minkowski_kernels_avx;
+                    ok = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = &minkowski_kernels_sve;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = &minkowski_kernels_neon;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                ok = true;
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            hsd_log("Forced backend %d not supported, fallback to scalar", forced);
+            chosen = &minkowski_kernels_scalar;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &minkowski_kernels_avx512;
+        else if (hsd_cpu_has_avx2() && hsd_cpu_has_fma())
+            chosen = &minkowski_kernels_avx2;
+        else if (hsd_cpu_has_avx())
+            chosen = &minkowski_kernels_avx;
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve())
+            chosen = &minkowski_kernels_sve;
+        else if (hsd_cpu_has_neon())
+            chosen = &minkowski_kernels_neon;
+#else
+        if (hsd_cpu_has_neon()) chosen = &minkowski_kernels_neon;
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Minkowski F32 to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_minkowski_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_minkowski_kernels_t *minkowski_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_minkowski_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_minkowski_kernels_t *)cur;
+    const hsd_minkowski_kernels_t *resolved = resolve_minkowski_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_minkowski_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+static hsd_status_t minkowski_result(double value, float *result) {
+    *result = (float)value;
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(*result) || isinf(*result)) return HSD_ERR_INVALID_INPUT;
+#endif
+    return HSD_SUCCESS;
+}
+
+/*
+ * The non-fast modes keep a sequential f64 loop over pow(): it is accurate to the last bit of
+ * the float result and its order does not depend on the backend.
+ */
+static double minkowski_scaled_pow_f64(const float *a, const float *b, size_t n, double m,
+                                       double p) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += pow(fabs((double)a[i] - (double)b[i]) / m, p);
+    return sum;
+}
+
+hsd_status_t hsd_dist_chebyshev_f32(const float *a, const float *b, size_t n, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    /* A max has no summation order, so every precision mode gets the same answer. */
+    return minkowski_result(minkowski_kernels()->max_abs_diff(a, b, n), result);
+}
+
+hsd_status_t hsd_dist_minkowski_f32(const float *a, const float *b, size_t n, float p,
+                                    float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (isnan(p) || p <= 0.0f) {
+        *result = NAN;
+        return HSD_ERR_INVALID_INPUT;
+    }
+    if (isinf(p)) return hsd_dist_chebyshev_f32(a, b, n, result);
+    if (p == 1.0f) return hsd_dist_manhattan_f32(a, b, n, result);
+    if (p == 2.0f) {
+        hsd_status_t status = hsd_dist_sqeuclidean_f32(a, b, n, result);
+        if (status == HSD_SUCCESS) *result = sqrtf(*result);
+        return status;
+    }
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    const hsd_minkowski_kernels_t *k = minkowski_kernels();
+    bool fast = hsd_get_precision() == HSD_PRECISION_FAST;
+    if (p == 3.0f && fast) {
+        /* Unscaled cubes overflow above |a - b| of about 7e12 and underflow below about 1e-13;
+         * those cases, and NaN, fall through to the scaled path. */
+        float cubed = k->sum_abs_diff_cubed(a, b, n);
+        if (cubed >= FLT_MIN && !isinf(cubed)) return minkowski_result(cbrtf(cubed), result);
+    }
+
+    /* m is 0 for identical vectors, and NaN or inf is passed through for the checks. */
+    float m = k->max_abs_diff(a, b, n);
+    if (!(m > 0.0f) || isinf(m)) return minkowski_result(m, result);
+    double sum = fast ? (double)k->sum_scaled_pow(a, b, n, m, p)
+                      : minkowski_scaled_pow_f64(a, b, n, (double)m, (double)p);
+    return minkowski_result((double)m * pow(sum, 1.0 / (double)p), result);
+}
@@ -0,0 +1,537 @@
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+/*
+ * Z-normalized Euclidean distance and the matrix profile.
+ *
+ * For two windows of length m with Pearson correlation r, the Euclidean distance between their
+ * z-normalized copies is sqrt(2m(1 - r)), so both functions work with correlations. A constant
+ * window cannot be z-normalized; following the usual matrix-profile convention, two constant
+ * windows are at distance 0 and a constant window is at sqrt(m) from any other window, which
+ * is the same as a correlation of 1 or 1/2.
+ *
+ * The matrix profile is the self-join P[i] = min over |i - j| > ceil(m / 4) of d(i, j). It
+ * walks the diagonals j = i + k of the distance matrix with the centered-covariance update
+ * of SCAMP:
+ *
+ *   C[i + 1][j + 1] = C[i][j] + df[i] dg[j] + df[j] dg[i]
+ *   df[i] = (t[i + m] - t[i]) / 2,  dg[i] = (t[i + m] - mu[i + 1]) + (t[i] - mu[i])
+ *
+ * in double precision, so a cell costs two multiply-adds and stays accurate on long series.
+ * Each SIMD lane follows one diagonal, and the lanes update the column entries P[j..] with
+ * one vector compare; the row entry P[i] falls back to scalar code only when a lane ties or
+ * beats it. Ties go to the smaller neighbour index, and every backend does the same cell
+ * arithmetic without fused multiply-adds, so the profile and the indices do not depend on the
+ * backend or on the thread count.
+ */
+typedef struct {
+    const double *df;
+    const double *dg;
+    const double *inv; /* 1 / sqrt(sum of squared deviations), 0 for constant windows */
+    const double *cst; /* 1 for constant windows, 0 otherwise */
+    size_t count;      /* number of windows */
+} hsd_mp_series_t;
+
+typedef struct {
+    /*
+     * Walks rows [i0, i1) of the diagonals [k0, k1). cov[k - k0] holds the covariance of
+     * the diagonal's cell in row i0 on entry and in row i1 on return. corr and idx are the
+     * best correlation and neighbour index found so far for every window.
+     */
+    void (*diagonals)(const hsd_mp_series_t *s, size_t k0, size_t k1, size_t i0, size_t i1,
+                      double *cov, double *corr, double *idx);
+    const char *name;
+} hsd_mp_kernels_t;
+
+static inline double mp_cell(const hsd_mp_series_t *s, double cov, size_t i, size_t j) {
+    double c = cov * s->inv[i] * s->inv[j];
+    double flags = s->cst[i] + s->cst[j];
+    return flags > 0.0 ? 0.5 * flags : c;
+}
+
+static inline void mp_offer(double *corr, double *idx, size_t pos, double c, double neighbour) {
+    if (c > corr[pos] || (c == corr[pos] && neighbour < idx[pos])) {
+        corr[pos] = c;
+        idx[pos] = neighbour;
+    }
+}
+
+static void mp_diagonal_scalar(const hsd_mp_series_t *s, size_t k, size_t i, size_t i1,
+                               double *cov, double *corr, double *idx) {
+    double c_ij = *cov;
+    for (; i < i1 && i + k < s->count; ++i) {
+        size_t j = i + k;
+        double c = mp_cell(s, c_ij, i, j);
+        mp_offer(corr, idx, j, c, (double)i);
+        mp_offer(corr, idx, i, c, (double)j);
+        c_ij = c_ij + s->df[i] * s->dg[j] + s->df[j] * s->dg[i];
+    }
+    *cov = c_ij;
+}
+
+static void mp_diagonals_scalar(const hsd_mp_series_t *s, size_t k0, size_t k1, size_t i0,
+                                size_t i1, double *cov, double *corr, double *idx) {
+    for (size_t k = k0; k < k1; ++k) mp_diagonal_scalar(s, k, i0, i1, &cov[k - k0], corr, idx);
+}
+
+/* Rows of [i0, i1) in which all of the diagonals k .. k + width - 1 still have a cell. */
+static inline size_t mp_vector_rows_end(const hsd_mp_series_t *s, size_t k, size_t width,
+                                        size_t i1) {
+    size_t last = k + width - 1;
+    if (last >= s->count) return 0;
+    return s->count - last < i1 ? s->count - last : i1;
+}
+
+/* Finishes the lanes of a vector chunk, whose diagonals end at different rows. */
+static void mp_finish_lanes(const hsd_mp_series_t *s, size_t k, size_t width, size_t i,
+                            size_t i1, double *lanes, double *corr, double *idx) {
+    for (size_t l = 0; l < width; ++l) mp_diagonal_scalar(s, k + l, i, i1, &lanes[l], corr, idx);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static void mp_diagonals_avx(const hsd_mp_series_t *s,
+                                                            size_t k0, size_t k1, size_t i0,
+                                                            size_t i1, double *cov,
+                                                            double *corr, double *idx) {
+    const __m256d half = _mm256_set1_pd(0.5), zero = _mm256_setzero_pd();
+    size_t k = k0;
+    for (; k + 4 <= k1; k += 4) {
+        __m256d c_ij = _mm256_loadu_pd(cov + (k - k0));
+        size_t i = i0;
+        size_t end = mp_vector_rows_end(s, k, 4, i1);
+        for (; i < end; ++i) {
+            size_t j = i + k;
+            __m256d c = _mm256_mul_pd(_mm256_mul_pd(c_ij, _mm256_set1_pd(s->inv[i])),
+                                      _mm256_loadu_pd(s->inv + j));
+            __m256d flags = _mm256_add_pd(_mm256_set1_pd(s->cst[i]), _mm256_loadu_pd(s->cst + j));
+            c = _mm256_blendv_pd(c, _mm256_mul_pd(half, flags),
+                                 _mm256_cmp_pd(flags, zero, _CMP_GT_OQ));
+
+            __m256d nb = _mm256_set1_pd((double)i);
+            __m256d p = _mm256_loadu_pd(corr + j), q = _mm256_loadu_pd(idx + j);
+            __m256d better =
+                _mm256_or_pd(_mm256_cmp_pd(c, p, _CMP_GT_OQ),
+                             _mm256_and_pd(_mm256_cmp_pd(c, p, _CMP_EQ_OQ),
+                                           _mm256_cmp_pd(nb, q, _CMP_LT_OQ)));
+            _mm256_storeu_pd(corr + j, _mm256_blendv_pd(p, c, better));
+            _mm256_storeu_pd(idx + j, _mm256_blendv_pd(q, nb, better));
+
+            if (_mm256_movemask_pd(_mm256_cmp_pd(c, _mm256_set1_pd(corr[i]), _CMP_GE_OQ))) {
+                double lanes[4];
+                _mm256_storeu_pd(lanes, c);
+                for (size_t l = 0; l < 4; ++l) mp_offer(corr, idx, i, lanes[l], (double)(j + l));
+            }
+
+            __m256d up = _mm256_mul_pd(_mm256_set1_pd(s->df[i]), _mm256_loadu_pd(s->dg + j));
+            __m256d down = _mm256_mul_pd(_mm256_loadu_pd(s->df + j), _mm256_set1_pd(s->dg[i]));
+            c_ij = _mm256_add_pd(_mm256_add_pd(c_ij, up), down);
+        }
+        _mm256_storeu_pd(cov + (k - k0), c_ij);
+        mp_finish_lanes(s, k, 4, i, i1, cov + (k - k0), corr, idx);
+    }
+    for (; k < k1; ++k) mp_diagonal_scalar(s, k, i0, i1, &cov[k - k0], corr, idx);
+}
+
+__attribute__((target("avx512f"))) static void mp_diagonals_avx512(const hsd_mp_series_t *s,
+                                                                   size_t k0, size_t k1,
+                                                                   size_t i0, size_t i1,
+                                                                   double *cov, double *corr,
+                                                                   double *idx) {
+    const __m512d half = _mm512_set1_pd(0.5), zero = _mm512_setzero_pd();
+    size_t k = k0;
+    for (; k + 8 <= k1; k += 8) {
+        __m512d c_ij = _mm512_loadu_pd(cov + (k - k0));
+        size_t i = i0;
+        size_t end = mp_vector_rows_end(s, k, 8, i1);
+        for (; i < end; ++i) {
+            size_t j = i + k;
+            __m512d c = _mm512_mul_pd(_mm512_mul_pd(c_ij, _mm512_set1_pd(s->inv[i])),
+                                      _mm512_loadu_pd(s->inv + j));
+            __m512d flags = _mm512_add_pd(_mm512_set1_pd(s->cst[i]), _mm512_loadu_pd(s->cst + j));
+            c = _mm512_mask_mul_pd(c, _mm512_cmp_pd_mask(flags, zero, _CMP_GT_OQ), half, flags);
+
+            __m512d nb = _mm512_set1_pd((double)i);
+            __m512d p = _mm512_loadu_pd(corr + j), q = _mm512_loadu_pd(idx + j);
+            __mmask8 better = _mm512_cmp_pd_mask(c, p, _CMP_GT_OQ) |
+                              (_mm512_cmp_pd_mask(c, p, _CMP_EQ_OQ) &
+                               _mm512_cmp_pd_mask(nb, q, _CMP_LT_OQ));
+            _mm512_storeu_pd(corr + j, _mm512_mask_blend_pd(better, p, c));
+            _mm512_storeu_pd(idx + j, _mm512_mask_blend_pd(better, q, nb));
+
+            if (_mm512_cmp_pd_mask(c, _mm512_set1_pd(corr[i]), _CMP_GE_OQ)) {
+                double lanes[8];
+                _mm512_storeu_pd(lanes, c);
+                for (size_t l = 0; l < 8; ++l) mp_offer(corr, idx, i, lanes[l], (double)(j + l));
+            }
+
+            __m512d up = _mm512_mul_pd(_mm512_set1_pd(s->df[i]), _mm512_loadu_pd(s->dg + j));
+            __m512d down = _mm512_mul_pd(_mm512_loadu_pd(s->df + j), _mm512_set1_pd(s->dg[i]));
+            c_ij = _mm512_add_pd(_mm512_add_pd(c_ij, up), down);
+        }
+        _mm512_storeu_pd(cov + (k - k0), c_ij);
+        mp_finish_lanes(s, k, 8, i, i1, cov + (k - k0), corr, idx);
+    }
+    for (; k < k1; ++k) mp_diagonal_scalar(s, k, i0, i1, &cov[k - k0], corr, idx);
+}
+#endif
+
+#if defined(__aarch64__)
+static void mp_diagonals_neon(const hsd_mp_series_t *s, size_t k0, size_t k1, size_t i0,
+                              size_t i1, double *cov, double *corr, double *idx) {
+    const float64x2_t half = vdupq_n_f64(0.5), zero = vdupq_n_f64(0.0);
+    size_t k = k0;
+    for (; k + 2 <= k1; k += 2) {
+        float64x2_t c_ij = vld1q_f64(cov + (k - k0));
+        size_t i = i0;
+        size_t end = mp_vector_rows_end(s, k, 2, i1);
+        for (; i < end; ++i) {
+            size_t j = i + k;
+            float64x2_t c =
+                vmulq_f64(vmulq_f64(c_ij, vdupq_n_f64(s->inv[i])), vld1q_f64(s->inv + j));
+            float64x2_t flags = vaddq_f64(vdupq_n_f64(s->cst[i]), vld1q_f64(s->cst + j));
+            c = vbslq_f64(vcgtq_f64(flags, zero), vmulq_f64(half, flags), c);
+
+            float64x2_t nb = vdupq_n_f64((double)i);
+            float64x2_t p = vld1q_f64(corr + j), q = vld1q_f64(idx + j);
+            uint64x2_t better = vorrq_u64(vcgtq_f64(c, p),
+                                          vandq_u64(vceqq_f64(c, p), vcltq_f64(nb, q)));
+            vst1q_f64(corr + j, vbslq_f64(better, c, p));
+            vst1q_f64(idx + j, vbslq_f64(better, nb, q));
+
+            uint64x2_t row = vcgeq_f64(c, vdupq_n_f64(corr[i]));
+            if (vmaxvq_u32(vreinterpretq_u32_u64(row)) != 0) {
+                mp_offer(corr, idx, i, vgetq_lane_f64(c, 0), (double)j);
+                mp_offer(corr, idx, i, vgetq_lane_f64(c, 1), (double)(j + 1));
+            }
+
+            float64x2_t up = vmulq_f64(vdupq_n_f64(s->df[i]), vld1q_f64(s->dg + j));
+            float64x2_t down = vmulq_f64(vld1q_f64(s->df + j), vdupq_n_f64(s->dg[i]));
+            c_ij = vaddq_f64(vaddq_f64(c_ij, up), down);
+        }
+        vst1q_f64(cov + (k - k0), c_ij);
+        mp_finish_lanes(s, k, 2, i, i1, cov + (k - k0), corr, idx);
+    }
+    for (; k < k1; ++k) mp_diagonal_scalar(s, k, i0, i1, &cov[k - k0], corr, idx);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static void mp_diagonals_sve(const hsd_mp_series_t *s,
+                                                             size_t k0, size_t k1, size_t i0,
+                                                             size_t i1, double *cov,
+                                                             double *corr, double *idx) {
+    const size_t width = svcntd();
+    const svbool_t all = svptrue_b64();
+    /* Separate multiplies and adds keep the cells bit-identical to the other backends. */
+    size_t k = k0;
+    for (; k + width <= k1; k += width) {
+        svfloat64_t c_ij = svld1_f64(all, cov + (k - k0));
+        size_t i = i0;
+        size_t end = mp_vector_rows_end(s, k, width, i1);
+        for (; i < end; ++i) {
+            size_t j = i + k;
+            svfloat64_t c = svmul_f64_x(all, svmul_n_f64_x(all, c_ij, s->inv[i]),
+                                        svld1_f64(all, s->inv + j));
+            svfloat64_t flags = svadd_n_f64_x(all, svld1_f64(all, s->cst + j), s->cst[i]);
+            c = svsel_f64(svcmpgt_n_f64(all, flags, 0.0), svmul_n_f64_x(all, flags, 0.5), c);
+
+            svfloat64_t nb = svdup_n_f64((double)i);
+            svfloat64_t p = svld1_f64(all, corr + j), q = svld1_f64(all, idx + j);
+            svbool_t better = svorr_b_z(all, svcmpgt_f64(all, c, p),
+                                        svand_b_z(all, svcmpeq_f64(all, c, p),
+                                                  svcmplt_f64(all, nb, q)));
+            svst1_f64(all, corr + j, svsel_f64(better, c, p));
+            svst1_f64(all, idx + j, svsel_f64(better, nb, q));
+
+            if (svptest_any(all, svcmpge_n_f64(all, c, corr[i]))) {
+                double lanes[32];
+                svst1_f64(all, lanes, c);
+                for (size_t l = 0; l < width; ++l)
+                    mp_offer(corr, idx, i, lanes[l], (double)(j + l));
+            }
+
+            svfloat64_t up = svmul_n_f64_x(all, svld1_f64(all, s->dg + j), s->df[i]);
+            svfloat64_t down = svmul_n_f64_x(all, svld1_f64(all, s->df + j), s->dg[i]);
+            c_ij = svadd_f64_x(all, svadd_f64_x(all, c_ij, up), down);
+        }
+        svst1_f64(all, cov + (k - k0), c_ij);
+        mp_finish_lanes(s, k, width, i, i1, cov + (k - k0), corr, idx);
+    }
+    for (; k < k1; ++k) mp_diagonal_scalar(s, k, i0, i1, &cov[k - k0], corr, idx);
+}
+#endif
+#endif
+
+static const hsd_mp_kernels_t mp_kernels_scalar = {mp_diagonals_scalar, "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_mp_kernels_t mp_kernels_avx = {mp_diagonals_avx, "AVX"};
+static const hsd_mp_kernels_t mp_kernels_avx512 = {mp_diagonals_avx512, "AVX512F"};
+#endif
+#if defined(__aarch64__)
+static const hsd_mp_kernels_t mp_kernels_neon = {mp_diagonals_neon, "NEON"};
+#if defined(__ARM_FEATURE_SVE)
+static const hsd_mp_kernels_t mp_kernels_sve = {mp_diagonals_sve, "SVE"};
+#endif
+#endif
+
+/* The kernels avoid fused multiply-adds on purpose, so AVX2 hosts use the AVX kernel. */
+static const hsd_mp_kernels_t *resolve_mp_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_mp_kernels_t *chosen = &mp_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Matrix profile: Manual backend requested: %d", forced);
+        bool ok = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = &mp_kernels_avx512;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen = &mp_kernels_avx;
+                    ok = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = &mp_kernels_sve;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = &mp_kernels_neon;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                ok = true;
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            hsd_log("Forced backend %d not supported, fallback to scalar", forced);
+            chosen = &mp_kernels_scalar;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &mp_kernels_avx512;
+        else if (hsd_cpu_has_avx())
+            chosen = &mp_kernels_avx;
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve())
+            chosen = &mp_kernels_sve;
+        else if (hsd_cpu_has_neon())
+            chosen = &mp_kernels_neon;
+#else
+        if (hsd_cpu_has_neon()) chosen = &mp_kernels_neon;
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved matrix profile to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_mp_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_mp_kernels_t *mp_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_mp_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_mp_kernels_t *)cur;
+    const hsd_mp_kernels_t *resolved = resolve_mp_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_mp_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+hsd_status_t hsd_dist_znorm_euclidean_f32(const float *a, const float *b, size_t n,
+                                          float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    double sums[5];
+    hsd_internal_centered_moments_f32(a, b, n, sums);
+#if HSD_ALLOW_FP_CHECKS
+    for (int k = 0; k < 5; ++k) {
+        if (isnan(sums[k]) || isinf(sums[k])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+    }
+#endif
+    double inv_n = 1.0 / (double)n;
+    double var_a = sums[3] - sums[0] * sums[0] * inv_n;
+    double var_b = sums[4] - sums[1] * sums[1] * inv_n;
+    double r;
+    if (var_a > 0.0 && var_b > 0.0) {
+        r = (sums[2] - sums[0] * sums[1] * inv_n) / (sqrt(var_a) * sqrt(var_b));
+        if (r > 1.0) r = 1.0;
+    } else {
+        r = var_a > 0.0 || var_b > 0.0 ? 0.5 : 1.0;
+    }
+    *result = (float)sqrt(2.0 * (double)n * (1.0 - r));
+    return HSD_SUCCESS;
+}
+
+/* Diagonals per task, and rows per pass over them so the touched windows stay in cache. */
+#define HSD_MP_DIAG_BLOCK 64
+#define HSD_MP_ROW_TILE 2048
+
+typedef struct {
+    const hsd_mp_kernels_t *kernels;
+    hsd_mp_series_t series;
+    const float *t;
+    const double *mu;
+    size_t m;
+    size_t first; /* first diagonal outside the exclusion zone */
+    double *corr; /* one profile per slot */
+    double *idx;
+} hsd_mp_job_t;
+
+static double mp_centered_dot(const float *x, const float *y, size_t m, double mx, double my) {
+    double sum = 0.0;
+    for (size_t t = 0; t < m; ++t) sum += ((double)x[t] - mx) * ((double)y[t] - my);
+    return sum;
+}
+
+static hsd_status_t mp_task(void *ctx, size_t block, size_t slot) {
+    hsd_mp_job_t *job = (hsd_mp_job_t *)ctx;
+    const size_t count = job->series.count;
+    size_t k0 = job->first + block * HSD_MP_DIAG_BLOCK;
+    size_t k1 = k0 + HSD_MP_DIAG_BLOCK < count ? k0 + HSD_MP_DIAG_BLOCK : count;
+    double cov[HSD_MP_DIAG_BLOCK];
+    for (size_t k = k0; k < k1; ++k)
+        cov[k - k0] = mp_centered_dot(job->t, job->t + k, job->m, job->mu[0], job->mu[k]);
+    double *corr = job->corr + slot * count, *idx = job->idx + slot * count;
+    for (size_t i0 = 0; i0 < count - k0; i0 += HSD_MP_ROW_TILE) {
+        size_t i1 = count - k0 - i0 > HSD_MP_ROW_TILE ? i0 + HSD_MP_ROW_TILE : count - k0;
+        job->kernels->diagonals(&job->series, k0, k1, i0, i1, cov, corr, idx);
+    }
+    return HSD_SUCCESS;
+}
+
+/* Mean, inverse norm and constant flag of every window, then the SCAMP update terms. */
+static void mp_window_stats(const float *t, size_t m, size_t count, double *mu, double *inv,
+                            double *cst, double *df, double *dg) {
+    for (size_t i = 0; i < count; ++i) {
+        const float *w = t + i;
+        double sum = 0.0;
+        float lo = w[0], hi = w[0];
+        for (size_t x = 0; x < m; ++x) {
+            sum += w[x];
+            lo = w[x] < lo ? w[x] : lo;
+            hi = w[x] > hi ? w[x] : hi;
+        }
+        mu[i] = sum / (double)m;
+        cst[i] = lo == hi ? 1.0 : 0.0;
+        inv[i] = 0.0;
+        if (lo != hi) {
+            double ss = mp_centered_dot(w, w, m, mu[i], mu[i]);
+            if (ss > 0.0) inv[i] = 1.0 / sqrt(ss);
+        }
+    }
+    for (size_t i = 0; i + 1 < count; ++i) {
+        df[i] = 0.5 * ((double)t[i + m] - (double)t[i]);
+        dg[i] = ((double)t[i + m] - mu[i + 1]) + ((double)t[i] - mu[i]);
+    }
+    df[count - 1] = 0.0;
+    dg[count - 1] = 0.0;
+}
+
+hsd_status_t hsd_matrix_profile_f32(const float *t, size_t n, size_t m, float *profile,
+                                    size_t *index) {
+    if (t == NULL || profile == NULL) return HSD_ERR_NULL_PTR;
+    if (m < 2 || m > n) return HSD_ERR_INVALID_INPUT;
+#if HSD_ALLOW_FP_CHECKS
+    for (size_t i = 0; i < n; ++i) {
+        if (isnan(t[i]) || isinf(t[i])) return HSD_ERR_INVALID_INPUT;
+    }
+#endif
+    const size_t count = n - m + 1;
+    const size_t first = (m + 3) / 4 + 1;
+    size_t diagonals = count > first ? count - first : 0;
+    size_t blocks = (diagonals + HSD_MP_DIAG_BLOCK - 1) / HSD_MP_DIAG_BLOCK;
+    size_t slots = blocks > 1 ? hsd_get_num_threads() : 1;
+    if (slots > blocks) slots = blocks;
+    if (slots == 0) slots = 1;
+
+    double *mem = (double *)malloc((5 + 2 * slots) * count * sizeof(double));
+    if (mem == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    double *mu = mem, *inv = mu + count, *cst = inv + count, *df = cst + count, *dg = df + count;
+    double *corr = dg + count, *idx = corr + slots * count;
+    mp_window_stats(t, m, count, mu, inv, cst, df, dg);
+    for (size_t i = 0; i < slots * count; ++i) {
+        corr[i] = -INFINITY;
+        idx[i] = INFINITY;
+    }
+
+    hsd_mp_job_t job;
+    job.kernels = mp_kernels();
+    job.series.df = df;
+    job.series.dg = dg;
+    job.series.inv = inv;
+    job.series.cst = cst;
+    job.series.count = count;
+    job.t = t;
+    job.mu = mu;
+    job.m = m;
+    job.first = first;
+    job.corr = corr;
+    job.idx = idx;
+    hsd_status_t status = HSD_SUCCESS;
+    if (blocks > 0) status = hsd_internal_parallel_for(blocks, slots, mp_task, &job);
+
+    if (status == HSD_SUCCESS) {
+        for (size_t slot = 1; slot < slots; ++slot) {
+            for (size_t i = 0; i < count; ++i)
+                mp_offer(corr, idx, i, corr[slot * count + i], idx[slot * count + i]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (isinf(idx[i])) {
+                profile[i] = INFINITY;
+                if (index != NULL) index[i] = SIZE_MAX;
+                continue;
+            }
+            double d2 = 2.0 * (double)m * (1.0 - corr[i]);
+            profile[i] = (float)sqrt(d2 > 0.0 ? d2 : 0.0);
+            if (index != NULL) index[i] = (size_t)idx[i];
+        }
+    }
+    free(mem);
+    return status;
+}
@@ -0,0 +1,367 @@
+#ifndef HSD_INTERNAL_H
+#define HSD_INTERNAL_H
+
+#include <float.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+#define HSD_INTERNAL_ALIGNMENT 64
+
+#if defined(__GNUC__) || defined(__clang__)
+#define hsd_internal_prefetch(p) __builtin_prefetch((p), 0, 3)
+#else
+#define hsd_internal_prefetch(p) ((void)(p))
+#endif
+
+static inline size_t hsd_internal_round_up(size_t x, size_t multiple) {
+    return (x + multiple - 1) / multiple * multiple;
+}
+
+static inline void *hsd_internal_aligned_alloc(size_t size) {
+    if (size == 0) size = HSD_INTERNAL_ALIGNMENT;
+    size = hsd_internal_round_up(size, HSD_INTERNAL_ALIGNMENT);
+#if defined(_WIN32)
+    return _aligned_malloc(size, HSD_INTERNAL_ALIGNMENT);
+#else
+    return aligned_alloc(HSD_INTERNAL_ALIGNMENT, size);
+#endif
+}
+
+static inline void hsd_internal_aligned_free(void *p) {
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+/*
+ * Cosine similarity from a dot product and the two L2 norms. Two zero vectors are identical
+ * (1), one zero vector is orthogonal to everything (0), and rounding is clamped to [-1, 1].
+ */
+static inline float hsd_internal_cosine_from_dot(float dot, float norm_a, float norm_b) {
+    bool a_zero = norm_a * norm_a < FLT_MIN;
+    bool b_zero = norm_b * norm_b < FLT_MIN;
+    if (a_zero && b_zero) return 1.0f;
+    if (a_zero || b_zero) return 0.0f;
+    float denom = norm_a * norm_b;
+    if (denom < FLT_MIN) return 0.0f;
+    float sim = dot / denom;
+    if (sim > 1.0f) sim = 1.0f;
+    if (sim < -1.0f) sim = -1.0f;
+    return sim;
+}
+
+float hsd_internal_f16_to_f32(uint16_t h);
+
+/*
+ * Bounded max-heap keeping the k entries with the smallest key. Callers map
+ * similarities to keys by negation so that "smaller is better" holds for every metric.
+ */
+typedef struct {
+    size_t k;
+    size_t size;
+    float *keys;
+    uint64_t *ids;
+} hsd_internal_topk_t;
+
+hsd_status_t hsd_internal_topk_init(hsd_internal_topk_t *heap, size_t k);
+void hsd_internal_topk_free(hsd_internal_topk_t *heap);
+void hsd_internal_topk_push(hsd_internal_topk_t *heap, float key, uint64_t id);
+size_t hsd_internal_topk_finish(hsd_internal_topk_t *heap, uint64_t *ids, float *keys);
+
+static inline float hsd_internal_topk_worst(const hsd_internal_topk_t *heap) {
+    return heap->size < heap->k ? INFINITY : heap->keys[0];
+}
+
+/* Row-by-row dot products out[i * out_stride + j] = x_i . y_j over the first dim elements. */
+void hsd_internal_dot_block_f32(const float *x, size_t nx, size_t x_stride, const float *y,
+                                size_t ny, size_t y_stride, size_t dim, float *out,
+                                size_t out_stride);
+
+/*
+ * Assigns each of the n points to its closest centroid. With inner_product the score is the
+ * negated dot product; otherwise it is the squared L2 distance expanded from the cached squared
+ * norms. best receives the winning score of each point.
+ */
+hsd_status_t hsd_internal_kmeans_assign(const float *points, size_t n, const float *point_norms,
+                                        const float *centroids, size_t k,
+                                        const float *centroid_norms, size_t dim,
+                                        bool inner_product, uint32_t *assign, float *best);
+
+/*
+ * Thread pool. A job is split into independent tasks; fn(ctx, task, slot) is called once per
+ * task with slot < max_slots identifying the participating thread, so callers can keep
+ * per-slot partial results and merge them after the run. The first failing status wins.
+ */
+typedef hsd_status_t (*hsd_internal_task_fn_t)(void *ctx, size_t task, size_t slot);
+typedef struct hsd_internal_pool hsd_internal_pool_t;
+typedef struct hsd_internal_pool_job hsd_internal_pool_job_t;
+
+hsd_internal_pool_t *hsd_internal_pool_create(size_t width, const int *cpus, size_t cpu_count);
+void hsd_internal_pool_destroy(hsd_internal_pool_t *pool);
+size_t hsd_internal_pool_width(const hsd_internal_pool_t *pool);
+hsd_status_t hsd_internal_pool_run(hsd_internal_pool_t *pool, size_t tasks, size_t max_slots,
+                                   hsd_internal_task_fn_t fn, void *ctx);
+
+/*
+ * Queues a job for the pool's workers without the caller taking part, so jobs on several
+ * pools can run at once. Returns NULL when out of memory; every job must be passed to
+ * hsd_internal_pool_wait(), which runs it on the waiting thread if the pool has no workers.
+ */
+hsd_internal_pool_job_t *hsd_internal_pool_submit(hsd_internal_pool_t *pool, size_t tasks,
+                                                  size_t max_slots, hsd_internal_task_fn_t fn,
+                                                  void *ctx);
+hsd_status_t hsd_internal_pool_wait(hsd_internal_pool_t *pool, hsd_internal_pool_job_t *job);
+
+/* Shared process-wide pool sized by hsd_set_num_threads(). */
+hsd_internal_pool_t *hsd_internal_pool_acquire(void);
+void hsd_internal_pool_release(hsd_internal_pool_t *pool);
+hsd_status_t hsd_internal_parallel_for(size_t tasks, size_t max_slots, hsd_internal_task_fn_t fn,
+                                       void *ctx);
+
+/*
+ * f64-accumulating kernels used by the public functions when hsd_get_precision() is
+ * HSD_PRECISION_F64. They return raw sums; cosine fills {dot, |a|^2, |b|^2} and moments the
+ * Pearson moments of a - ka and b - kb in the layout of pearson.c.
+ */
+double hsd_internal_precise_dot_f32(const float *a, const float *b, size_t n);
+double hsd_internal_precise_sq_diff_f32(const float *a, const float *b, size_t n);
+double hsd_internal_precise_weighted_sq_diff_f32(const float *a, const float *b, const float *w,
+                                                 size_t n);
+double hsd_internal_precise_abs_diff_f32(const float *a, const float *b, size_t n);
+void hsd_internal_precise_cosine_f32(const float *a, const float *b, size_t n, double sums[3]);
+double hsd_internal_precise_sum_sq_f32(const float *v, size_t n);
+double hsd_internal_precise_sum_abs_f32(const float *v, size_t n);
+void hsd_internal_precise_moments_f32(const float *a, const float *b, size_t n, double ka,
+                                      double kb, double sums[5]);
+
+/*
+ * Kernels used when hsd_get_precision() is HSD_PRECISION_DETERMINISTIC: a fixed 16-lane f32
+ * accumulation and reduction order that gives bit-identical sums on every backend.
+ */
+float hsd_internal_det_dot_f32(const float *a, const float *b, size_t n);
+float hsd_internal_det_sq_diff_f32(const float *a, const float *b, size_t n);
+float hsd_internal_det_abs_diff_f32(const float *a, const float *b, size_t n);
+float hsd_internal_det_sum_abs_f32(const float *v, size_t n);
+/* {a.b, a.a, b.b} in one pass, each bit-identical to hsd_internal_det_dot_f32. */
+void hsd_internal_det_cosine_f32(const float *a, const float *b, size_t n, float sums[3]);
+
+/*
+ * Pearson moments of a and b shifted by their means (two passes), in the layout of
+ * pearson.c: {sum(a'), sum(b'), sum(a'b'), sum(a'^2), sum(b'^2)}. A constant vector has
+ * a' = 0 exactly. Non-finite inputs leave non-finite sums.
+ */
+void hsd_internal_centered_moments_f32(const float *a, const float *b, size_t n,
+                                       double sums[5]);
+
+/* Stores an f64 kernel result; with FP checks, a non-finite result is rejected. */
+static inline hsd_status_t hsd_internal_f64_result(double value, double *result) {
+    *result = value;
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(value) || isinf(value)) return HSD_ERR_INVALID_INPUT;
+#endif
+    return HSD_SUCCESS;
+}
+
+/* Rounds a result to float; with FP checks, a non-finite result is rejected. */
+static inline hsd_status_t hsd_internal_round_result(double value, float *result) {
+    *result = (float)value;
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(*result) || isinf(*result)) return HSD_ERR_INVALID_INPUT;
+#endif
+    return HSD_SUCCESS;
+}
+
+static inline bool hsd_internal_metric_is_similarity(HSD_Metric metric) {
+    return metric == HSD_METRIC_DOT || metric == HSD_METRIC_COSINE;
+}
+
+/*
+ * Vector log and exp on f32 lanes, after Cephes logf and expf; both have a relative error of
+ * about 1e-7. log splits x into m * 2^e with m in [sqrt(1/2), sqrt(2)), then log(x) =
+ * e * ln2 + log1p(m - 1) with a degree-8 polynomial for log1p. It is valid only for x > 0
+ * (subnormals are rescaled by 2^23 first); callers mask out other lanes. exp writes x as
+ * k * ln2 + r with |r| <= ln2 / 2 and scales a degree-5 polynomial for exp(r) by 2^k. Inputs
+ * are clamped so that 2^k stays a normal float: results below about 1e-38 come out near
+ * FLT_MIN instead of 0, and results above FLT_MAX are not produced.
+ */
+#define HSD_LOG_SQRTHF 0.707106781186547524f
+#define HSD_LOG_LN2_HI 0.693359375f
+#define HSD_LOG_LN2_LO -2.12194440e-4f
+#define HSD_LOG_SUBNORMAL_SCALE 8388608.0f
+#define HSD_EXP_LOG2E 1.44269504088896341f
+#define HSD_EXP_MIN -87.33f
+#define HSD_EXP_MAX 88.37f
+
+static const float hsd_internal_log_poly[9] = {
+    7.0376836292e-2f,  -1.1514610310e-1f, 1.1676998740e-1f,  -1.2420140846e-1f, 1.4249322787e-1f,
+    -1.6668057665e-1f, 2.0000714765e-1f,  -2.4999993993e-1f, 3.3333331174e-1f};
+static const float hsd_internal_exp_poly[6] = {1.9875691500e-4f, 1.3981999507e-3f,
+                                               8.3334519073e-3f, 4.1665795894e-2f,
+                                               1.6666665459e-1f, 5.0000001201e-1f};
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx2,fma"))) static inline __m256 hsd_internal_log_avx2(__m256 x) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 tiny = _mm256_cmp_ps(x, _mm256_set1_ps(FLT_MIN), _CMP_LT_OQ);
+    x = _mm256_blendv_ps(x, _mm256_mul_ps(x, _mm256_set1_ps(HSD_LOG_SUBNORMAL_SCALE)), tiny);
+    __m256i bits = _mm256_castps_si256(x);
+    __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23),
+                                                   _mm256_set1_epi32(126)));
+    e = _mm256_sub_ps(e, _mm256_and_ps(tiny, _mm256_set1_ps(23.0f)));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F000000)));
+    __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(HSD_LOG_SQRTHF), _CMP_LT_OQ);
+    e = _mm256_sub_ps(e, _mm256_and_ps(small, one));
+    m = _mm256_add_ps(_mm256_sub_ps(m, one), _mm256_and_ps(small, m));
+    __m256 z = _mm256_mul_ps(m, m);
+    __m256 y = _mm256_set1_ps(hsd_internal_log_poly[0]);
+    for (int k = 1; k < 9; ++k)
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(hsd_internal_log_poly[k]));
+    y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+    y = _mm256_fmadd_ps(e, _mm256_set1_ps(HSD_LOG_LN2_LO), y);
+    y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+    return _mm256_fmadd_ps(e, _mm256_set1_ps(HSD_LOG_LN2_HI), _mm256_add_ps(m, y));
+}
+
+__attribute__((target("avx2,fma"))) static inline __m256 hsd_internal_exp_avx2(__m256 x) {
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(HSD_EXP_MIN)), _mm256_set1_ps(HSD_EXP_MAX));
+    __m256 k = _mm256_floor_ps(
+        _mm256_fmadd_ps(x, _mm256_set1_ps(HSD_EXP_LOG2E), _mm256_set1_ps(0.5f)));
+    x = _mm256_fnmadd_ps(k, _mm256_set1_ps(HSD_LOG_LN2_HI), x);
+    x = _mm256_fnmadd_ps(k, _mm256_set1_ps(HSD_LOG_LN2_LO), x);
+    __m256 y = _mm256_set1_ps(hsd_internal_exp_poly[0]);
+    for (int i = 1; i < 6; ++i)
+        y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(hsd_internal_exp_poly[i]));
+    y = _mm256_fmadd_ps(y, _mm256_mul_ps(x, x), _mm256_add_ps(x, _mm256_set1_ps(1.0f)));
+    __m256i scale = _mm256_slli_epi32(
+        _mm256_add_epi32(_mm256_cvtps_epi32(k), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(y, _mm256_castsi256_ps(scale));
+}
+
+__attribute__((target("avx512f"))) static inline __m512 hsd_internal_log_avx512(__m512 x) {
+    __mmask16 tiny = _mm512_cmp_ps_mask(x, _mm512_set1_ps(FLT_MIN), _CMP_LT_OQ);
+    x = _mm512_mask_mul_ps(x, tiny, x, _mm512_set1_ps(HSD_LOG_SUBNORMAL_SCALE));
+    __m512i bits = _mm512_castps_si512(x);
+    __m512 e = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, 23),
+                                                   _mm512_set1_epi32(126)));
+    e = _mm512_mask_sub_ps(e, tiny, e, _mm512_set1_ps(23.0f));
+    __m512 m = _mm512_castsi512_ps(_mm512_or_si512(
+        _mm512_and_si512(bits, _mm512_set1_epi32(0x007FFFFF)), _mm512_set1_epi32(0x3F000000)));
+    __mmask16 small = _mm512_cmp_ps_mask(m, _mm512_set1_ps(HSD_LOG_SQRTHF), _CMP_LT_OQ);
+    e = _mm512_mask_sub_ps(e, small, e, _mm512_set1_ps(1.0f));
+    __m512 m1 = _mm512_sub_ps(m, _mm512_set1_ps(1.0f));
+    m = _mm512_mask_add_ps(m1, small, m1, m);
+    __m512 z = _mm512_mul_ps(m, m);
+    __m512 y = _mm512_set1_ps(hsd_internal_log_poly[0]);
+    for (int k = 1; k < 9; ++k)
+        y = _mm512_fmadd_ps(y, m, _mm512_set1_ps(hsd_internal_log_poly[k]));
+    y = _mm512_mul_ps(_mm512_mul_ps(y, m), z);
+    y = _mm512_fmadd_ps(e, _mm512_set1_ps(HSD_LOG_LN2_LO), y);
+    y = _mm512_fnmadd_ps(z, _mm512_set1_ps(0.5f), y);
+    return _mm512_fmadd_ps(e, _mm512_set1_ps(HSD_LOG_LN2_HI), _mm512_add_ps(m, y));
+}
+
+__attribute__((target("avx512f"))) static inline __m512 hsd_internal_exp_avx512(__m512 x) {
+    x = _mm512_min_ps(_mm512_max_ps(x, _mm512_set1_ps(HSD_EXP_MIN)), _mm512_set1_ps(HSD_EXP_MAX));
+    __m512 k = _mm512_roundscale_ps(
+        _mm512_fmadd_ps(x, _mm512_set1_ps(HSD_EXP_LOG2E), _mm512_set1_ps(0.5f)),
+        _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    x = _mm512_fnmadd_ps(k, _mm512_set1_ps(HSD_LOG_LN2_HI), x);
+    x = _mm512_fnmadd_ps(k, _mm512_set1_ps(HSD_LOG_LN2_LO), x);
+    __m512 y = _mm512_set1_ps(hsd_internal_exp_poly[0]);
+    for (int i = 1; i < 6; ++i)
+        y = _mm512_fmadd_ps(y, x, _mm512_set1_ps(hsd_internal_exp_poly[i]));
+    y = _mm512_fmadd_ps(y, _mm512_mul_ps(x, x), _mm512_add_ps(x, _mm512_set1_ps(1.0f)));
+    __m512i scale = _mm512_slli_epi32(
+        _mm512_add_epi32(_mm512_cvtps_epi32(k), _mm512_set1_epi32(127)), 23);
+    return _mm512_mul_ps(y, _mm512_castsi512_ps(scale));
+}
+#endif
+
+#if defined(__aarch64__)
+static inline float32x4_t hsd_internal_log_neon(float32x4_t x) {
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    uint32x4_t tiny = vcltq_f32(x, vdupq_n_f32(FLT_MIN));
+    x = vbslq_f32(tiny, vmulq_n_f32(x, HSD_LOG_SUBNORMAL_SCALE), x);
+    int32x4_t bits = vreinterpretq_s32_f32(x);
+    float32x4_t e = vcvtq_f32_s32(vsubq_s32(vshrq_n_s32(bits, 23), vdupq_n_s32(126)));
+    e = vsubq_f32(e, vbslq_f32(tiny, vdupq_n_f32(23.0f), vdupq_n_f32(0.0f)));
+    float32x4_t m = vreinterpretq_f32_s32(
+        vorrq_s32(vandq_s32(bits, vdupq_n_s32(0x007FFFFF)), vdupq_n_s32(0x3F000000)));
+    uint32x4_t small = vcltq_f32(m, vdupq_n_f32(HSD_LOG_SQRTHF));
+    e = vsubq_f32(e, vbslq_f32(small, one, vdupq_n_f32(0.0f)));
+    m = vaddq_f32(vsubq_f32(m, one), vbslq_f32(small, m, vdupq_n_f32(0.0f)));
+    float32x4_t z = vmulq_f32(m, m);
+    float32x4_t y = vdupq_n_f32(hsd_internal_log_poly[0]);
+    for (int k = 1; k < 9; ++k) y = vfmaq_f32(vdupq_n_f32(hsd_internal_log_poly[k]), y, m);
+    y = vmulq_f32(vmulq_f32(y, m), z);
+    y = vfmaq_n_f32(y, e, HSD_LOG_LN2_LO);
+    y = vfmsq_f32(y, z, vdupq_n_f32(0.5f));
+    return vfmaq_n_f32(vaddq_f32(m, y), e, HSD_LOG_LN2_HI);
+}
+
+static inline float32x4_t hsd_internal_exp_neon(float32x4_t x) {
+    x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(HSD_EXP_MIN)), vdupq_n_f32(HSD_EXP_MAX));
+    float32x4_t k = vrndmq_f32(vfmaq_n_f32(vdupq_n_f32(0.5f), x, HSD_EXP_LOG2E));
+    x = vfmsq_n_f32(x, k, HSD_LOG_LN2_HI);
+    x = vfmsq_n_f32(x, k, HSD_LOG_LN2_LO);
+    float32x4_t y = vdupq_n_f32(hsd_internal_exp_poly[0]);
+    for (int i = 1; i < 6; ++i) y = vfmaq_f32(vdupq_n_f32(hsd_internal_exp_poly[i]), y, x);
+    y = vfmaq_f32(vaddq_f32(x, vdupq_n_f32(1.0f)), y, vmulq_f32(x, x));
+    int32x4_t scale = vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(k), vdupq_n_s32(127)), 23);
+    return vmulq_f32(y, vreinterpretq_f32_s32(scale));
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static inline svfloat32_t hsd_internal_log_sve(svbool_t pg,
+                                                                               svfloat32_t x) {
+    svbool_t tiny = svcmplt_n_f32(pg, x, FLT_MIN);
+    x = svmul_n_f32_m(tiny, x, HSD_LOG_SUBNORMAL_SCALE);
+    svint32_t bits = svreinterpret_s32_f32(x);
+    svfloat32_t e = svcvt_f32_s32_x(pg, svsub_n_s32_x(pg, svasr_n_s32_x(pg, bits, 23), 126));
+    e = svsub_n_f32_m(tiny, e, 23.0f);
+    svfloat32_t m = svreinterpret_f32_s32(
+        svorr_n_s32_x(pg, svand_n_s32_x(pg, bits, 0x007FFFFF), 0x3F000000));
+    svbool_t small = svcmplt_n_f32(pg, m, HSD_LOG_SQRTHF);
+    e = svsub_n_f32_m(small, e, 1.0f);
+    m = svadd_f32_m(small, svsub_n_f32_x(pg, m, 1.0f), m);
+    svfloat32_t z = svmul_f32_x(pg, m, m);
+    svfloat32_t y = svdup_n_f32(hsd_internal_log_poly[0]);
+    for (int k = 1; k < 9; ++k) y = svmad_n_f32_x(pg, y, m, hsd_internal_log_poly[k]);
+    y = svmul_f32_x(pg, svmul_f32_x(pg, y, m), z);
+    y = svmla_n_f32_x(pg, y, e, HSD_LOG_LN2_LO);
+    y = svmls_n_f32_x(pg, y, z, 0.5f);
+    return svmla_n_f32_x(pg, svadd_f32_x(pg, m, y), e, HSD_LOG_LN2_HI);
+}
+
+__attribute__((target("+sve"))) static inline svfloat32_t hsd_internal_exp_sve(svbool_t pg,
+                                                                               svfloat32_t x) {
+    x = svmin_n_f32_x(pg, svmax_n_f32_x(pg, x, HSD_EXP_MIN), HSD_EXP_MAX);
+    svfloat32_t k = svrintm_f32_x(pg, svmla_n_f32_x(pg, svdup_n_f32(0.5f), x, HSD_EXP_LOG2E));
+    x = svmls_n_f32_x(pg, x, k, HSD_LOG_LN2_HI);
+    x = svmls_n_f32_x(pg, x, k, HSD_LOG_LN2_LO);
+    svfloat32_t y = svdup_n_f32(hsd_internal_exp_poly[0]);
+    for (int i = 1; i < 6; ++i) y = svmad_n_f32_x(pg, y, x, hsd_internal_exp_poly[i]);
+    y = svmla_f32_x(pg, svadd_n_f32_x(pg, x, 1.0f), y, svmul_f32_x(pg, x, x));
+    svint32_t scale = svlsl_n_s32_x(pg, svadd_n_s32_x(pg, svcvt_s32_f32_x(pg, k), 127), 23);
+    return svmul_f32_x(pg, y, svreinterpret_f32_s32(scale));
+}
+#endif
+#endif
+
+#endif
@@ -0,0 +1,409 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#define HSD_FLAT_MIN_CAPACITY 64
+#define HSD_FLAT_PREFETCH_ROWS 2
+#define HSD_FLAT_SEARCH_BLOCK 4096
+
+typedef hsd_status_t (*hsd_flat_f32_kernel_t)(const float *, const float *, size_t, float *);
+typedef hsd_status_t (*hsd_flat_bounded_kernel_t)(const float *, const float *, size_t, float,
+                                                  float *);
+
+struct hsd_index_flat {
+    size_t dim;
+    HSD_DType dtype;
+    HSD_Metric metric;
+    size_t row_bytes;
+    size_t score_dim;
+    size_t count;
+    size_t live;
+    size_t capacity;
+    unsigned char *rows;
+    uint64_t *ids;
+    uint8_t *deleted;
+    float *norms;
+    uint64_t next_id;
+};
+
+static size_t flat_elem_size(HSD_DType dtype) {
+    switch (dtype) {
+        case HSD_DTYPE_F32:
+            return sizeof(float);
+        case HSD_DTYPE_F16:
+            return sizeof(uint16_t);
+        case HSD_DTYPE_U8:
+            return sizeof(uint8_t);
+        default:
+            return 0;
+    }
+}
+
+static bool flat_config_valid(HSD_DType dtype, HSD_Metric metric) {
+    switch (dtype) {
+        case HSD_DTYPE_F32:
+        case HSD_DTYPE_F16:
+            return metric == HSD_METRIC_SQEUCLIDEAN || metric == HSD_METRIC_MANHATTAN ||
+                   metric == HSD_METRIC_DOT || metric == HSD_METRIC_COSINE;
+        case HSD_DTYPE_U8:
+            return metric == HSD_METRIC_HAMMING;
+        default:
+            return false;
+    }
+}
+
+static inline unsigned char *flat_row(const hsd_index_flat_t *index, size_t row) {
+    return index->rows + row * index->row_bytes;
+}
+
+/* Converts a stored or user-supplied vector to the zero-padded f32 layout used for scoring. */
+static void flat_to_f32(const hsd_index_flat_t *index, const void *src, float *dst) {
+    if (index->dtype == HSD_DTYPE_F16) {
+        const uint16_t *h = (const uint16_t *)src;
+        for (size_t i = 0; i < index->dim; ++i) dst[i] = hsd_internal_f16_to_f32(h[i]);
+    } else {
+        memcpy(dst, src, index->dim * sizeof(float));
+    }
+    for (size_t i = index->dim; i < index->score_dim; ++i) dst[i] = 0.0f;
+}
+
+static hsd_status_t flat_row_norm(const hsd_index_flat_t *index, const float *v, float *norm) {
+    return hsd_norm_l2_f32(v, index->score_dim, norm);
+}
+
+static hsd_status_t flat_reserve(hsd_index_flat_t *index, size_t needed) {
+    if (needed <= index->capacity) return HSD_SUCCESS;
+    size_t new_cap = index->capacity ? index->capacity * 2 : HSD_FLAT_MIN_CAPACITY;
+    if (new_cap < needed) new_cap = needed;
+
+    unsigned char *rows = (unsigned char *)hsd_internal_aligned_alloc(new_cap * index->row_bytes);
+    if (rows == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    if (index->count > 0) memcpy(rows, index->rows, index->count * index->row_bytes);
+
+    uint64_t *ids = (uint64_t *)realloc(index->ids, new_cap * sizeof(uint64_t));
+    if (ids == NULL) {
+        hsd_internal_aligned_free(rows);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    index->ids = ids;
+    uint8_t *deleted = (uint8_t *)realloc(index->deleted, new_cap * sizeof(uint8_t));
+    if (deleted == NULL) {
+        hsd_internal_aligned_free(rows);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    index->deleted = deleted;
+    if (index->metric == HSD_METRIC_COSINE) {
+        float *norms = (float *)realloc(index->norms, new_cap * sizeof(float));
+        if (norms == NULL) {
+            hsd_internal_aligned_free(rows);
+            return HSD_ERR_OUT_OF_MEMORY;
+        }
+        index->norms = norms;
+    }
+
+    hsd_internal_aligned_free(index->rows);
+    index->rows = rows;
+    index->capacity = new_cap;
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_index_flat_create(size_t dim, HSD_DType dtype, HSD_Metric metric,
+                                   hsd_index_flat_t **index) {
+    if (index == NULL) return HSD_ERR_NULL_PTR;
+    *index = NULL;
+    if (dim == 0 || !flat_config_valid(dtype, metric)) return HSD_ERR_INVALID_INPUT;
+
+    hsd_index_flat_t *idx = (hsd_index_flat_t *)calloc(1, sizeof(*idx));
+    if (idx == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    size_t elem = flat_elem_size(dtype);
+    idx->dim = dim;
+    idx->dtype = dtype;
+    idx->metric = metric;
+    idx->row_bytes = hsd_internal_round_up(dim * elem, HSD_INTERNAL_ALIGNMENT);
+    idx->score_dim = dtype == HSD_DTYPE_U8
+                         ? idx->row_bytes
+                         : hsd_internal_round_up(dim, HSD_INTERNAL_ALIGNMENT / sizeof(float));
+    hsd_log("Flat index: dim=%zu dtype=%d metric=%d row_bytes=%zu", dim, dtype, metric,
+            idx->row_bytes);
+    *index = idx;
+    return HSD_SUCCESS;
+}
+
+void hsd_index_flat_free(hsd_index_flat_t *index) {
+    if (index == NULL) return;
+    hsd_internal_aligned_free(index->rows);
+    free(index->ids);
+    free(index->deleted);
+    free(index->norms);
+    free(index);
+}
+
+hsd_status_t hsd_index_flat_add(hsd_index_flat_t *index, const void *vectors, size_t count,
+                                uint64_t *first_id) {
+    if (index == NULL || (vectors == NULL && count > 0)) return HSD_ERR_NULL_PTR;
+    if (first_id != NULL) *first_id = index->next_id;
+    if (count == 0) return HSD_SUCCESS;
+
+    hsd_status_t status = flat_reserve(index, index->count + count);
+    if (status != HSD_SUCCESS) return status;
+
+    float *scratch = NULL;
+    if (index->metric == HSD_METRIC_COSINE) {
+        scratch = (float *)hsd_internal_aligned_alloc(index->score_dim * sizeof(float));
+        if (scratch == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    }
+
+    size_t elem = flat_elem_size(index->dtype);
+    size_t vec_bytes = index->dim * elem;
+    const unsigned char *src = (const unsigned char *)vectors;
+    for (size_t i = 0; i < count; ++i) {
+        size_t row = index->count + i;
+        unsigned char *dst = flat_row(index, row);
+        memcpy(dst, src + i * vec_bytes, vec_bytes);
+        memset(dst + vec_bytes, 0, index->row_bytes - vec_bytes);
+        if (index->metric == HSD_METRIC_COSINE) {
+            const float *v = (const float *)dst;
+            if (index->dtype == HSD_DTYPE_F16) {
+                flat_to_f32(index, dst, scratch);
+                v = scratch;
+            }
+            status = flat_row_norm(index, v, &index->norms[row]);
+            if (status != HSD_SUCCESS) {
+                hsd_internal_aligned_free(scratch);
+                return status;
+            }
+        }
+        index->ids[row] = index->next_id + i;
+        index->deleted[row] = 0;
+    }
+    hsd_internal_aligned_free(scratch);
+
+    index->count += count;
+    index->live += count;
+    index->next_id += count;
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_index_flat_compact(hsd_index_flat_t *index) {
+    if (index == NULL) return HSD_ERR_NULL_PTR;
+    size_t out = 0;
+    for (size_t row = 0; row < index->count; ++row) {
+        if (index->deleted[row]) continue;
+        if (out != row) {
+            memcpy(flat_row(index, out), flat_row(index, row), index->row_bytes);
+            index->ids[out] = index->ids[row];
+            if (index->norms != NULL) index->norms[out] = index->norms[row];
+        }
+        index->deleted[out] = 0;
+        out++;
+    }
+    hsd_log("Flat index: compacted %zu rows to %zu", index->count, out);
+    index->count = out;
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_index_flat_remove(hsd_index_flat_t *index, uint64_t id) {
+    if (index == NULL) return HSD_ERR_NULL_PTR;
+
+    /* Ids are handed out in increasing order and compaction keeps rows ordered. */
+    size_t lo = 0, hi = index->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index->ids[mid] < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == index->count || index->ids[lo] != id || index->deleted[lo])
+        return HSD_ERR_INVALID_INPUT;
+
+    index->deleted[lo] = 1;
+    index->live--;
+    if (index->count >= HSD_FLAT_MIN_CAPACITY && index->count - index->live > index->count / 2)
+        return hsd_index_flat_compact(index);
+    return HSD_SUCCESS;
+}
+
+size_t hsd_index_flat_size(const hsd_index_flat_t *index) {
+    return index == NULL ? 0 : index->live;
+}
+
+/*
+ * One search pass. Rows are scanned in blocks of HSD_FLAT_SEARCH_BLOCK on the thread pool;
+ * every block fills its own heap and the heaps are merged in block order afterwards, so the
+ * result does not depend on how many threads took part. Distance metrics use the bounded
+ * kernels with the block heap's worst key as threshold: a row they abandon could not have
+ * entered the heap, and the rows they finish get the same score as the unbounded kernel.
+ */
+typedef struct {
+    const hsd_index_flat_t *index;
+    const void *query;
+    hsd_flat_f32_kernel_t kernel;
+    hsd_flat_bounded_kernel_t bounded;
+    float query_norm;
+    float *scratch;
+    hsd_internal_topk_t *heaps;
+} hsd_flat_search_job_t;
+
+static hsd_status_t flat_scan_f32(const hsd_flat_search_job_t *job, size_t begin, size_t end,
+                                  float *scratch, hsd_internal_topk_t *heap) {
+    const hsd_index_flat_t *index = job->index;
+    const float *query = (const float *)job->query;
+    bool similarity = hsd_internal_metric_is_similarity(index->metric);
+    for (size_t row = begin; row < end; ++row) {
+        if (row + HSD_FLAT_PREFETCH_ROWS < end) {
+            const unsigned char *next = flat_row(index, row + HSD_FLAT_PREFETCH_ROWS);
+            for (size_t off = 0; off < index->row_bytes; off += HSD_INTERNAL_ALIGNMENT)
+                hsd_internal_prefetch(next + off);
+        }
+        if (index->deleted[row]) continue;
+
+        const float *v = (const float *)flat_row(index, row);
+        if (scratch != NULL) {
+            flat_to_f32(index, v, scratch);
+            v = scratch;
+        }
+        float score;
+        hsd_status_t status =
+            job->bounded != NULL
+                ? job->bounded(query, v, index->score_dim, hsd_internal_topk_worst(heap), &score)
+                : job->kernel(query, v, index->score_dim, &score);
+        if (status != HSD_SUCCESS) return status;
+        if (index->metric == HSD_METRIC_COSINE)
+            score = hsd_internal_cosine_from_dot(score, job->query_norm, index->norms[row]);
+        hsd_internal_topk_push(heap, similarity ? -score : score, index->ids[row]);
+    }
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t flat_scan_u8(const hsd_flat_search_job_t *job, size_t begin, size_t end,
+                                 hsd_internal_topk_t *heap) {
+    const hsd_index_flat_t *index = job->index;
+    const uint8_t *query = (const uint8_t *)job->query;
+    for (size_t row = begin; row < end; ++row) {
+        /* Keys are whole numbers, so rows above floor(worst) can never enter the heap. */
+        float worst = hsd_internal_topk_worst(heap);
+        uint64_t threshold = isinf(worst) ? UINT64_MAX : (uint64_t)worst;
+        if (row + HSD_FLAT_PREFETCH_ROWS < end)
+            hsd_internal_prefetch(flat_row(index, row + HSD_FLAT_PREFETCH_ROWS));
+        if (index->deleted[row]) continue;
+        uint64_t dist;
+        hsd_status_t status = hsd_dist_hamming_bounded_u8(query, flat_row(index, row),
+                                                          index->row_bytes, threshold, &dist);
+        if (status != HSD_SUCCESS) return status;
+        hsd_internal_topk_push(heap, (float)dist, index->ids[row]);
+    }
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t flat_search_task(void *ctx, size_t block, size_t slot) {
+    hsd_flat_search_job_t *job = (hsd_flat_search_job_t *)ctx;
+    size_t count = job->index->count;
+    size_t begin = block * HSD_FLAT_SEARCH_BLOCK;
+    size_t end = begin + HSD_FLAT_SEARCH_BLOCK < count ? begin + HSD_FLAT_SEARCH_BLOCK : count;
+    if (job->index->dtype == HSD_DTYPE_U8)
+        return flat_scan_u8(job, begin, end, &job->heaps[block]);
+    float *scratch = NULL;
+    if (job->scratch != NULL) scratch = job->scratch + slot * job->index->score_dim;
+    return flat_scan_f32(job, begin, end, scratch, &job->heaps[block]);
+}
+
+static hsd_status_t flat_search_blocks(hsd_flat_search_job_t *job, hsd_internal_topk_t *heap) {
+    const hsd_index_flat_t *index = job->index;
+    size_t blocks = (index->count + HSD_FLAT_SEARCH_BLOCK - 1) / HSD_FLAT_SEARCH_BLOCK;
+    size_t slots = blocks > 1 ? hsd_get_num_threads() : 1;
+    if (slots > blocks) slots = blocks;
+
+    job->scratch = NULL;
+    if (index->dtype == HSD_DTYPE_F16) {
+        job->scratch =
+            (float *)hsd_internal_aligned_alloc(slots * index->score_dim * sizeof(float));
+        if (job->scratch == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    }
+
+    hsd_status_t status = HSD_SUCCESS;
+    if (blocks == 1) {
+        job->heaps = heap;
+        status = hsd_internal_parallel_for(1, 1, flat_search_task, job);
+        hsd_internal_aligned_free(job->scratch);
+        return status;
+    }
+
+    job->heaps = (hsd_internal_topk_t *)calloc(blocks, sizeof(hsd_internal_topk_t));
+    if (job->heaps == NULL) status = HSD_ERR_OUT_OF_MEMORY;
+    for (size_t b = 0; status == HSD_SUCCESS && b < blocks; ++b)
+        status = hsd_internal_topk_init(&job->heaps[b], heap->k);
+    if (status == HSD_SUCCESS)
+        status = hsd_internal_parallel_for(blocks, slots, flat_search_task, job);
+    for (size_t b = 0; job->heaps != NULL && b < blocks; ++b) {
+        const hsd_internal_topk_t *part = &job->heaps[b];
+        for (size_t i = 0; status == HSD_SUCCESS && i < part->size; ++i)
+            hsd_internal_topk_push(heap, part->keys[i], part->ids[i]);
+        hsd_internal_topk_free(&job->heaps[b]);
+    }
+    free(job->heaps);
+    hsd_internal_aligned_free(job->scratch);
+    return status;
+}
+
+hsd_status_t hsd_index_flat_search(const hsd_index_flat_t *index, const void *query, size_t k,
+                                   uint64_t *ids, float *scores, size_t *found) {
+    if (found == NULL) return HSD_ERR_NULL_PTR;
+    *found = 0;
+    if (index == NULL || query == NULL || (k > 0 && ids == NULL)) return HSD_ERR_NULL_PTR;
+    if (k == 0 || index->live == 0) return HSD_SUCCESS;
+
+    /* The query is copied into the same padded, aligned layout as the stored rows. */
+    void *padded = hsd_internal_aligned_alloc(index->score_dim * sizeof(float));
+    if (padded == NULL) return HSD_ERR_OUT_OF_MEMORY;
+
+    hsd_flat_search_job_t job;
+    job.index = index;
+    job.query = padded;
+    job.query_norm = 0.0f;
+    job.bounded = NULL;
+    switch (index->metric) {
+        case HSD_METRIC_SQEUCLIDEAN:
+            job.kernel = hsd_dist_sqeuclidean_f32;
+            job.bounded = hsd_dist_sqeuclidean_bounded_f32;
+            break;
+        case HSD_METRIC_MANHATTAN:
+            job.kernel = hsd_dist_manhattan_f32;
+            job.bounded = hsd_dist_manhattan_bounded_f32;
+            break;
+        default:
+            job.kernel = hsd_sim_dot_f32;
+            break;
+    }
+
+    hsd_status_t status = HSD_SUCCESS;
+    if (index->dtype == HSD_DTYPE_U8) {
+        memcpy(padded, query, index->dim);
+        memset((unsigned char *)padded + index->dim, 0, index->row_bytes - index->dim);
+    } else {
+        flat_to_f32(index, query, (float *)padded);
+        if (index->metric == HSD_METRIC_COSINE)
+            status = flat_row_norm(index, (const float *)padded, &job.query_norm);
+    }
+
+    hsd_internal_topk_t heap;
+    if (status == HSD_SUCCESS) status = hsd_internal_topk_init(&heap, k);
+    if (status != HSD_SUCCESS) {
+        hsd_internal_aligned_free(padded);
+        return status;
+    }
+
+    status = flat_search_blocks(&job, &heap);
+    if (status == HSD_SUCCESS) {
+        *found = hsd_internal_topk_finish(&heap, ids, scores);
+        if (scores != NULL && hsd_internal_metric_is_similarity(index->metric)) {
+            for (size_t i = 0; i < *found; ++i) scores[i] = -scores[i];
+        }
+    }
+    hsd_internal_topk_free(&heap);
+    hsd_internal_aligned_free(padded);
+    return status;
+}
@@ -0,0 +1,637 @@
+#include <math.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#define HSD_HNSW_DEFAULT_M 16
+#define HSD_HNSW_DEFAULT_EF_CONSTRUCTION 200
+#define HSD_HNSW_DEFAULT_EF_SEARCH 64
+#define HSD_HNSW_MAX_LEVEL 16
+#define HSD_HNSW_EMPTY UINT32_MAX
+#define HSD_HNSW_SPINS_BEFORE_YIELD 64
+
+typedef hsd_status_t (*hsd_hnsw_kernel_t)(const float *, const float *, size_t, float *);
+
+/*
+ * Node storage: every node owns one fixed-size block in `level0` holding its layer-0 link list
+ * ([count, ids...]) immediately followed by its zero-padded vector, so expanding a node touches
+ * a single contiguous region. Links for the (rare) upper layers live in per-node side arrays.
+ */
+struct hsd_index_hnsw {
+    size_t dim;
+    size_t padded_dim;
+    HSD_Metric metric;
+    hsd_hnsw_kernel_t kernel;
+    bool negate;
+    size_t m;
+    size_t m0;
+    size_t ef_construction;
+    size_t ef_search;
+    double level_mult;
+    size_t capacity;
+    size_t links_bytes;
+    size_t stride;
+    unsigned char *level0;
+    uint32_t **upper;
+    atomic_flag *locks;
+    atomic_flag global_lock;
+    atomic_size_t count;
+    atomic_int max_level;
+    atomic_uint entry;
+    atomic_uint_fast64_t rng_state;
+};
+
+typedef struct {
+    float dist;
+    uint32_t id;
+} hsd_hnsw_pair_t;
+
+static inline void hnsw_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    HSD_ASM("pause");
+#elif defined(__aarch64__)
+    HSD_ASM("yield");
+#endif
+}
+
+/*
+ * Node locks are held for a few hundred cycles at most, so waiters spin with a pause first and
+ * only give up the CPU when the holder has been descheduled.
+ */
+static inline void hnsw_lock(atomic_flag *flag) {
+    unsigned spins = 0;
+    while (atomic_flag_test_and_set_explicit(flag, memory_order_acquire)) {
+        if (++spins < HSD_HNSW_SPINS_BEFORE_YIELD) {
+            hnsw_cpu_relax();
+        } else {
+            sched_yield();
+            spins = 0;
+        }
+    }
+}
+
+static inline void hnsw_unlock(atomic_flag *flag) {
+    atomic_flag_clear_explicit(flag, memory_order_release);
+}
+
+static inline uint32_t *hnsw_links(const hsd_index_hnsw_t *index, uint32_t node, int level) {
+    if (level == 0) return (uint32_t *)(index->level0 + (size_t)node * index->stride);
+    return index->upper[node] + (size_t)(level - 1) * (index->m + 1);
+}
+
+static inline const float *hnsw_vector(const hsd_index_hnsw_t *index, uint32_t node) {
+    return (const float *)(index->level0 + (size_t)node * index->stride + index->links_bytes);
+}
+
+static inline hsd_status_t hnsw_distance(const hsd_index_hnsw_t *index, const float *a,
+                                         const float *b, float *dist) {
+    hsd_status_t status = index->kernel(a, b, index->padded_dim, dist);
+    if (index->negate) *dist = -*dist;
+    return status;
+}
+
+/* Open-addressing set of node ids visited during one graph traversal. */
+typedef struct {
+    uint32_t *slots;
+    size_t mask;
+    size_t size;
+} hsd_hnsw_visited_t;
+
+static hsd_status_t visited_init(hsd_hnsw_visited_t *set, size_t expected) {
+    size_t cap = 64;
+    while (cap < expected * 2) cap <<= 1;
+    set->slots = (uint32_t *)malloc(cap * sizeof(uint32_t));
+    if (set->slots == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    memset(set->slots, 0xFF, cap * sizeof(uint32_t));
+    set->mask = cap - 1;
+    set->size = 0;
+    return HSD_SUCCESS;
+}
+
+static bool visited_insert(hsd_hnsw_visited_t *set, uint32_t id);
+
+static bool visited_grow(hsd_hnsw_visited_t *set) {
+    size_t old_cap = set->mask + 1;
+    uint32_t *old = set->slots;
+    set->slots = (uint32_t *)malloc(old_cap * 2 * sizeof(uint32_t));
+    if (set->slots == NULL) {
+        set->slots = old;
+        return false;
+    }
+    memset(set->slots, 0xFF, old_cap * 2 * sizeof(uint32_t));
+    set->mask = old_cap * 2 - 1;
+    set->size = 0;
+    for (size_t i = 0; i < old_cap; ++i) {
+        if (old[i] != HSD_HNSW_EMPTY) visited_insert(set, old[i]);
+    }
+    free(old);
+    return true;
+}
+
+/* Returns true if `id` was not in the set before. */
+static bool visited_insert(hsd_hnsw_visited_t *set, uint32_t id) {
+    if ((set->size + 1) * 2 > set->mask + 1 && !visited_grow(set)) return false;
+    size_t pos = ((uint64_t)id * 0x9E3779B97F4A7C15ull >> 32) & set->mask;
+    while (set->slots[pos] != HSD_HNSW_EMPTY) {
+        if (set->slots[pos] == id) return false;
+        pos = (pos + 1) & set->mask;
+    }
+    set->slots[pos] = id;
+    set->size++;
+    return true;
+}
+
+/* Growable binary min-heap of candidates ordered by distance. */
+typedef struct {
+    hsd_hnsw_pair_t *items;
+    size_t size;
+    size_t cap;
+} hsd_hnsw_minheap_t;
+
+static bool minheap_push(hsd_hnsw_minheap_t *heap, float dist, uint32_t id) {
+    if (heap->size == heap->cap) {
+        size_t cap = heap->cap ? heap->cap * 2 : 64;
+        hsd_hnsw_pair_t *items = (hsd_hnsw_pair_t *)realloc(heap->items, cap * sizeof(*items));
+        if (items == NULL) return false;
+        heap->items = items;
+        heap->cap = cap;
+    }
+    size_t pos = heap->size++;
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (heap->items[parent].dist <= dist) break;
+        heap->items[pos] = heap->items[parent];
+        pos = parent;
+    }
+    heap->items[pos].dist = dist;
+    heap->items[pos].id = id;
+    return true;
+}
+
+static hsd_hnsw_pair_t minheap_pop(hsd_hnsw_minheap_t *heap) {
+    hsd_hnsw_pair_t top = heap->items[0];
+    hsd_hnsw_pair_t last = heap->items[--heap->size];
+    size_t pos = 0;
+    for (;;) {
+        size_t child = 2 * pos + 1;
+        if (child >= heap->size) break;
+        if (child + 1 < heap->size && heap->items[child + 1].dist < heap->items[child].dist)
+            child++;
+        if (heap->items[child].dist >= last.dist) break;
+        heap->items[pos] = heap->items[child];
+        pos = child;
+    }
+    if (heap->size > 0) heap->items[pos] = last;
+    return top;
+}
+
+static int hnsw_pair_cmp(const void *lhs, const void *rhs) {
+    const hsd_hnsw_pair_t *a = (const hsd_hnsw_pair_t *)lhs;
+    const hsd_hnsw_pair_t *b = (const hsd_hnsw_pair_t *)rhs;
+    if (a->dist < b->dist) return -1;
+    if (a->dist > b->dist) return 1;
+    return (a->id > b->id) - (a->id < b->id);
+}
+
+/* Copies a node's link list at `level` while holding its lock. Returns the number of links. */
+static size_t hnsw_copy_links(const hsd_index_hnsw_t *index, uint32_t node, int level,
+                              uint32_t *out) {
+    hnsw_lock(&index->locks[node]);
+    const uint32_t *links = hnsw_links(index, node, level);
+    size_t count = links[0];
+    memcpy(out, links + 1, count * sizeof(uint32_t));
+    hnsw_unlock(&index->locks[node]);
+    return count;
+}
+
+static hsd_status_t hnsw_greedy_closest(const hsd_index_hnsw_t *index, const float *query,
+                                        uint32_t entry, int from_level, int to_level,
+                                        uint32_t *scratch, uint32_t *closest) {
+    uint32_t cur = entry;
+    float cur_dist;
+    hsd_status_t status = hnsw_distance(index, query, hnsw_vector(index, cur), &cur_dist);
+    for (int level = from_level; level > to_level && status == HSD_SUCCESS; --level) {
+        bool changed = true;
+        while (changed && status == HSD_SUCCESS) {
+            changed = false;
+            size_t count = hnsw_copy_links(index, cur, level, scratch);
+            for (size_t i = 0; i < count; ++i)
+                hsd_internal_prefetch(hnsw_vector(index, scratch[i]));
+            for (size_t i = 0; i < count; ++i) {
+                float d;
+                status = hnsw_distance(index, query, hnsw_vector(index, scratch[i]), &d);
+                if (status != HSD_SUCCESS) break;
+                if (d < cur_dist) {
+                    cur_dist = d;
+                    cur = scratch[i];
+                    changed = true;
+                }
+            }
+        }
+    }
+    *closest = cur;
+    return status;
+}
+
+/*
+ * Best-first search on one layer. Neighbours of each expanded node are filtered against the
+ * visited set first and then scored as one batch, after prefetching all of their vectors.
+ */
+static hsd_status_t hnsw_search_layer(const hsd_index_hnsw_t *index, const float *query,
+                                      const uint32_t *entries, size_t num_entries, size_t ef,
+                                      int level, hsd_internal_topk_t *results) {
+    hsd_hnsw_visited_t visited;
+    hsd_status_t status = visited_init(&visited, ef * index->m0);
+    if (status != HSD_SUCCESS) return status;
+    hsd_hnsw_minheap_t candidates = {NULL, 0, 0};
+    uint32_t *batch = (uint32_t *)malloc(index->m0 * sizeof(uint32_t));
+    if (batch == NULL) {
+        free(visited.slots);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+
+    for (size_t i = 0; i < num_entries && status == HSD_SUCCESS; ++i) {
+        if (!visited_insert(&visited, entries[i])) continue;
+        float d;
+        status = hnsw_distance(index, query, hnsw_vector(index, entries[i]), &d);
+        if (status != HSD_SUCCESS) break;
+        hsd_internal_topk_push(results, d, entries[i]);
+        if (!minheap_push(&candidates, d, entries[i])) status = HSD_ERR_OUT_OF_MEMORY;
+    }
+
+    while (status == HSD_SUCCESS && candidates.size > 0) {
+        hsd_hnsw_pair_t cur = minheap_pop(&candidates);
+        if (cur.dist > hsd_internal_topk_worst(results)) break;
+
+        size_t count = hnsw_copy_links(index, cur.id, level, batch);
+        size_t fresh = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (visited_insert(&visited, batch[i])) batch[fresh++] = batch[i];
+        }
+        for (size_t i = 0; i < fresh; ++i) hsd_internal_prefetch(hnsw_vector(index, batch[i]));
+        for (size_t i = 0; i < fresh; ++i) {
+            float d;
+            status = hnsw_distance(index, query, hnsw_vector(index, batch[i]), &d);
+            if (status != HSD_SUCCESS) break;
+            if (d < hsd_internal_topk_worst(results)) {
+                hsd_internal_topk_push(results, d, batch[i]);
+                if (!minheap_push(&candidates, d, batch[i])) {
+                    status = HSD_ERR_OUT_OF_MEMORY;
+                    break;
+                }
+            }
+        }
+    }
+
+    free(batch);
+    free(candidates.items);
+    free(visited.slots);
+    return status;
+}
+
+/*
+ * Neighbour selection heuristic from the HNSW paper: walking candidates from nearest to farthest,
+ * keep one only if it is closer to the base point than to every neighbour already kept.
+ */
+static hsd_status_t hnsw_select_neighbors(const hsd_index_hnsw_t *index,
+                                          const hsd_hnsw_pair_t *sorted, size_t count,
+                                          size_t max_links, uint32_t *out, size_t *kept) {
+    *kept = 0;
+    for (size_t i = 0; i < count && *kept < max_links; ++i) {
+        const float *cand = hnsw_vector(index, sorted[i].id);
+        bool good = true;
+        for (size_t j = 0; j < *kept; ++j) {
+            float d;
+            hsd_status_t status = hnsw_distance(index, cand, hnsw_vector(index, out[j]), &d);
+            if (status != HSD_SUCCESS) return status;
+            if (d < sorted[i].dist) {
+                good = false;
+                break;
+            }
+        }
+        if (good) out[(*kept)++] = sorted[i].id;
+    }
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t hnsw_add_reverse_link(hsd_index_hnsw_t *index, uint32_t node, uint32_t target,
+                                          int level, hsd_hnsw_pair_t *pairs) {
+    size_t max_links = level == 0 ? index->m0 : index->m;
+    hnsw_lock(&index->locks[node]);
+    uint32_t *links = hnsw_links(index, node, level);
+    size_t count = links[0];
+    for (size_t i = 0; i < count; ++i) {
+        if (links[1 + i] == target) {
+            hnsw_unlock(&index->locks[node]);
+            return HSD_SUCCESS;
+        }
+    }
+    hsd_status_t status = HSD_SUCCESS;
+    if (count < max_links) {
+        links[1 + count] = target;
+        links[0] = (uint32_t)(count + 1);
+    } else {
+        const float *base = hnsw_vector(index, node);
+        for (size_t i = 0; i <= count && status == HSD_SUCCESS; ++i) {
+            pairs[i].id = i < count ? links[1 + i] : target;
+            status = hnsw_distance(index, base, hnsw_vector(index, pairs[i].id), &pairs[i].dist);
+        }
+        /* On error the list keeps its old length and only ever holds ids taken from pairs. */
+        size_t kept = 0;
+        if (status == HSD_SUCCESS) {
+            qsort(pairs, count + 1, sizeof(*pairs), hnsw_pair_cmp);
+            status = hnsw_select_neighbors(index, pairs, count + 1, max_links, links + 1, &kept);
+        }
+        if (status == HSD_SUCCESS) links[0] = (uint32_t)kept;
+    }
+    hnsw_unlock(&index->locks[node]);
+    return status;
+}
+
+static hsd_status_t hnsw_prepare_vector(const hsd_index_hnsw_t *index, const float *src,
+                                        float *dst) {
+    memcpy(dst, src, index->dim * sizeof(float));
+    for (size_t i = index->dim; i < index->padded_dim; ++i) dst[i] = 0.0f;
+    float sq;
+    hsd_status_t status = hsd_sim_dot_f32(dst, dst, index->padded_dim, &sq);
+    if (status != HSD_SUCCESS) return status;
+    if (index->metric == HSD_METRIC_COSINE && sq > 0.0f) {
+        float inv = 1.0f / sqrtf(sq);
+        for (size_t i = 0; i < index->dim; ++i) dst[i] *= inv;
+    }
+    return HSD_SUCCESS;
+}
+
+static int hnsw_random_level(hsd_index_hnsw_t *index) {
+    uint64_t z = atomic_fetch_add_explicit(&index->rng_state, 0x9E3779B97F4A7C15ull,
+                                           memory_order_relaxed) +
+                 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    double u = (double)((z >> 11) + 1) * 0x1.0p-53;
+    int level = (int)(-log(u) * index->level_mult);
+    return level > HSD_HNSW_MAX_LEVEL ? HSD_HNSW_MAX_LEVEL : level;
+}
+
+hsd_status_t hsd_index_hnsw_create(size_t dim, HSD_Metric metric, size_t max_elements,
+                                   const hsd_hnsw_params_t *params, hsd_index_hnsw_t **index) {
+    if (index == NULL) return HSD_ERR_NULL_PTR;
+    *index = NULL;
+    if (dim == 0 || max_elements == 0 || max_elements >= HSD_HNSW_EMPTY)
+        return HSD_ERR_INVALID_INPUT;
+    if (metric != HSD_METRIC_SQEUCLIDEAN && metric != HSD_METRIC_DOT &&
+        metric != HSD_METRIC_COSINE)
+        return HSD_ERR_INVALID_INPUT;
+
+    size_t m = params && params->m ? params->m : HSD_HNSW_DEFAULT_M;
+    if (m < 2) return HSD_ERR_INVALID_INPUT;
+
+    hsd_index_hnsw_t *idx = (hsd_index_hnsw_t *)calloc(1, sizeof(*idx));
+    if (idx == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    idx->dim = dim;
+    idx->padded_dim = hsd_internal_round_up(dim, HSD_INTERNAL_ALIGNMENT / sizeof(float));
+    idx->metric = metric;
+    idx->kernel = metric == HSD_METRIC_SQEUCLIDEAN ? hsd_dist_sqeuclidean_f32 : hsd_sim_dot_f32;
+    idx->negate = metric != HSD_METRIC_SQEUCLIDEAN;
+    idx->m = m;
+    idx->m0 = 2 * m;
+    idx->ef_construction =
+        params && params->ef_construction ? params->ef_construction
+                                          : HSD_HNSW_DEFAULT_EF_CONSTRUCTION;
+    if (idx->ef_construction < m) idx->ef_construction = m;
+    idx->ef_search = params && params->ef_search ? params->ef_search : HSD_HNSW_DEFAULT_EF_SEARCH;
+    idx->level_mult = 1.0 / log((double)m);
+    idx->capacity = max_elements;
+    idx->links_bytes =
+        hsd_internal_round_up((idx->m0 + 1) * sizeof(uint32_t), HSD_INTERNAL_ALIGNMENT);
+    idx->stride = idx->links_bytes + idx->padded_dim * sizeof(float);
+
+    idx->level0 = (unsigned char *)hsd_internal_aligned_alloc(max_elements * idx->stride);
+    idx->upper = (uint32_t **)calloc(max_elements, sizeof(uint32_t *));
+    idx->locks = (atomic_flag *)malloc(max_elements * sizeof(atomic_flag));
+    if (idx->level0 == NULL || idx->upper == NULL || idx->locks == NULL) {
+        hsd_index_hnsw_free(idx);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    for (size_t i = 0; i < max_elements; ++i) atomic_flag_clear(&idx->locks[i]);
+    atomic_flag_clear(&idx->global_lock);
+    atomic_init(&idx->count, 0);
+    atomic_init(&idx->max_level, -1);
+    atomic_init(&idx->entry, 0);
+    atomic_init(&idx->rng_state, params ? params->seed : 0);
+
+    hsd_log("HNSW index: dim=%zu metric=%d M=%zu efC=%zu efS=%zu capacity=%zu", dim, metric, m,
+            idx->ef_construction, idx->ef_search, max_elements);
+    *index = idx;
+    return HSD_SUCCESS;
+}
+
+void hsd_index_hnsw_free(hsd_index_hnsw_t *index) {
+    if (index == NULL) return;
+    if (index->upper != NULL) {
+        for (size_t i = 0; i < index->capacity; ++i) free(index->upper[i]);
+    }
+    hsd_internal_aligned_free(index->level0);
+    free(index->upper);
+    free(index->locks);
+    free(index);
+}
+
+hsd_status_t hsd_index_hnsw_set_ef_search(hsd_index_hnsw_t *index, size_t ef_search) {
+    if (index == NULL) return HSD_ERR_NULL_PTR;
+    if (ef_search == 0) return HSD_ERR_INVALID_INPUT;
+    index->ef_search = ef_search;
+    return HSD_SUCCESS;
+}
+
+size_t hsd_index_hnsw_size(const hsd_index_hnsw_t *index) {
+    if (index == NULL) return 0;
+    size_t count = atomic_load_explicit(&((hsd_index_hnsw_t *)index)->count, memory_order_acquire);
+    return count < index->capacity ? count : index->capacity;
+}
+
+static hsd_status_t hnsw_connect(hsd_index_hnsw_t *index, uint32_t node, int node_level,
+                                 uint32_t entry, int top_level) {
+    const float *vec = hnsw_vector(index, node);
+    uint32_t *scratch = (uint32_t *)malloc((index->m0 + 1) * sizeof(uint32_t));
+    hsd_hnsw_pair_t *pairs =
+        (hsd_hnsw_pair_t *)malloc((index->ef_construction + index->m0 + 1) * sizeof(*pairs));
+    uint32_t *entries = (uint32_t *)malloc(index->ef_construction * sizeof(uint32_t));
+    hsd_internal_topk_t results;
+    hsd_status_t status = hsd_internal_topk_init(&results, index->ef_construction);
+    if (scratch == NULL || pairs == NULL || entries == NULL || status != HSD_SUCCESS) {
+        if (status == HSD_SUCCESS) hsd_internal_topk_free(&results);
+        free(scratch);
+        free(pairs);
+        free(entries);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+
+    status = hnsw_greedy_closest(index, vec, entry, top_level, node_level, scratch, &entries[0]);
+    size_t num_entries = 1;
+    int start = node_level < top_level ? node_level : top_level;
+
+    for (int level = start; level >= 0 && status == HSD_SUCCESS; --level) {
+        status = hnsw_search_layer(index, vec, entries, num_entries, index->ef_construction, level,
+                                   &results);
+        if (status != HSD_SUCCESS) break;
+        size_t found = results.size;
+        uint64_t *ids = (uint64_t *)malloc(found * sizeof(uint64_t));
+        float *dists = (float *)malloc(found * sizeof(float));
+        if (ids == NULL || dists == NULL) {
+            free(ids);
+            free(dists);
+            status = HSD_ERR_OUT_OF_MEMORY;
+            break;
+        }
+        found = hsd_internal_topk_finish(&results, ids, dists);
+        for (size_t i = 0; i < found; ++i) {
+            pairs[i].id = (uint32_t)ids[i];
+            pairs[i].dist = dists[i];
+            entries[i] = (uint32_t)ids[i];
+        }
+        num_entries = found;
+        free(ids);
+        free(dists);
+
+        size_t kept = 0;
+        status = hnsw_select_neighbors(index, pairs, found, index->m, scratch, &kept);
+        if (status != HSD_SUCCESS) break;
+        hnsw_lock(&index->locks[node]);
+        uint32_t *links = hnsw_links(index, node, level);
+        memcpy(links + 1, scratch, kept * sizeof(uint32_t));
+        links[0] = (uint32_t)kept;
+        hnsw_unlock(&index->locks[node]);
+
+        for (size_t i = 0; i < kept && status == HSD_SUCCESS; ++i)
+            status = hnsw_add_reverse_link(index, scratch[i], node, level, pairs);
+    }
+
+    hsd_internal_topk_free(&results);
+    free(scratch);
+    free(pairs);
+    free(entries);
+    return status;
+}
+
+hsd_status_t hsd_index_hnsw_add(hsd_index_hnsw_t *index, const float *vector, uint64_t *id) {
+    if (index == NULL || vector == NULL) return HSD_ERR_NULL_PTR;
+
+    /*
+     * The vector and its upper links are prepared before a slot is taken, so those failures
+     * leave no hole. If linking fails after that, the node keeps its slot and the links made so
+     * far, and the error is returned.
+     */
+    float *vec = (float *)hsd_internal_aligned_alloc(index->padded_dim * sizeof(float));
+    if (vec == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    hsd_status_t status = hnsw_prepare_vector(index, vector, vec);
+    if (status != HSD_SUCCESS) {
+        hsd_internal_aligned_free(vec);
+        return status;
+    }
+    int level = hnsw_random_level(index);
+    uint32_t *upper = NULL;
+    if (level > 0) {
+        upper = (uint32_t *)calloc((size_t)level * (index->m + 1), sizeof(uint32_t));
+        if (upper == NULL) {
+            hsd_internal_aligned_free(vec);
+            return HSD_ERR_OUT_OF_MEMORY;
+        }
+    }
+
+    size_t slot = atomic_load_explicit(&index->count, memory_order_acquire);
+    do {
+        if (slot >= index->capacity) {
+            free(upper);
+            hsd_internal_aligned_free(vec);
+            return HSD_ERR_INVALID_INPUT;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&index->count, &slot, slot + 1,
+                                                    memory_order_acq_rel, memory_order_acquire));
+    uint32_t node = (uint32_t)slot;
+
+    memcpy((float *)hnsw_vector(index, node), vec, index->padded_dim * sizeof(float));
+    hsd_internal_aligned_free(vec);
+    hnsw_links(index, node, 0)[0] = 0;
+    index->upper[node] = upper;
+    if (id != NULL) *id = node;
+
+    hnsw_lock(&index->global_lock);
+    int top_level = atomic_load_explicit(&index->max_level, memory_order_acquire);
+    uint32_t entry = atomic_load_explicit(&index->entry, memory_order_acquire);
+    if (top_level < 0) {
+        atomic_store_explicit(&index->entry, node, memory_order_release);
+        atomic_store_explicit(&index->max_level, level, memory_order_release);
+    }
+    hnsw_unlock(&index->global_lock);
+    if (top_level < 0) return HSD_SUCCESS;
+
+    status = hnsw_connect(index, node, level, entry, top_level);
+
+    /* A concurrent insert may have raised the top level further while this one was linking. */
+    if (status == HSD_SUCCESS && level > top_level) {
+        hnsw_lock(&index->global_lock);
+        if (level > atomic_load_explicit(&index->max_level, memory_order_acquire)) {
+            atomic_store_explicit(&index->entry, node, memory_order_release);
+            atomic_store_explicit(&index->max_level, level, memory_order_release);
+        }
+        hnsw_unlock(&index->global_lock);
+    }
+    return status;
+}
+
+hsd_status_t hsd_index_hnsw_search(const hsd_index_hnsw_t *index, const float *query, size_t k,
+                                   uint64_t *ids, float *scores, size_t *found) {
+    if (found == NULL) return HSD_ERR_NULL_PTR;
+    *found = 0;
+    if (index == NULL || query == NULL || (k > 0 && ids == NULL)) return HSD_ERR_NULL_PTR;
+    hsd_index_hnsw_t *idx = (hsd_index_hnsw_t *)index;
+    int top_level = atomic_load_explicit(&idx->max_level, memory_order_acquire);
+    if (k == 0 || top_level < 0) return HSD_SUCCESS;
+    uint32_t entry = atomic_load_explicit(&idx->entry, memory_order_acquire);
+
+    float *q = (float *)hsd_internal_aligned_alloc(index->padded_dim * sizeof(float));
+    uint32_t *scratch = (uint32_t *)malloc((index->m0 + 1) * sizeof(uint32_t));
+    if (q == NULL || scratch == NULL) {
+        hsd_internal_aligned_free(q);
+        free(scratch);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    hsd_status_t status = hnsw_prepare_vector(index, query, q);
+
+    size_t ef = index->ef_search > k ? index->ef_search : k;
+    hsd_internal_topk_t results;
+    if (status == HSD_SUCCESS) status = hsd_internal_topk_init(&results, ef);
+    if (status == HSD_SUCCESS) {
+        uint32_t ep = entry;
+        status = hnsw_greedy_closest(index, q, entry, top_level, 0, scratch, &ep);
+        if (status == HSD_SUCCESS) status = hnsw_search_layer(index, q, &ep, 1, ef, 0, &results);
+        if (status == HSD_SUCCESS) {
+            uint64_t *all_ids = (uint64_t *)malloc(ef * sizeof(uint64_t));
+            float *all_dists = (float *)malloc(ef * sizeof(float));
+            if (all_ids == NULL || all_dists == NULL) {
+                status = HSD_ERR_OUT_OF_MEMORY;
+            } else {
+                size_t n = hsd_internal_topk_finish(&results, all_ids, all_dists);
+                if (n > k) n = k;
+                for (size_t i = 0; i < n; ++i) {
+                    ids[i] = all_ids[i];
+                    if (scores != NULL) scores[i] = index->negate ? -all_dists[i] : all_dists[i];
+                }
+                *found = n;
+            }
+            free(all_ids);
+            free(all_dists);
+        }
+        hsd_internal_topk_free(&results);
+    }
+
+    hsd_internal_aligned_free(q);
+    free(scratch);
+    return status;
+}
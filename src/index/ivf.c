@@ -0,0 +1,390 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#define HSD_IVF_DEFAULT_NPROBE 8
+#define HSD_IVF_TRAIN_SEED 0x2545F4914F6CDD1Dull
+#define HSD_IVF_MIN_LIST_CAPACITY 16
+#define HSD_IVF_PREFETCH_ROWS 2
+#define HSD_IVF_FILE_VERSION 1
+
+static const char hsd_ivf_magic[8] = {'H', 'S', 'D', 'I', 'V', 'F', '\0', '\0'};
+
+typedef hsd_status_t (*hsd_ivf_kernel_t)(const float *, const float *, size_t, float *);
+
+/* One inverted list: ids and zero-padded vectors stored contiguously in insertion order. */
+typedef struct {
+    size_t count;
+    size_t capacity;
+    float *vectors;
+    uint64_t *ids;
+} hsd_ivf_list_t;
+
+struct hsd_index_ivf {
+    size_t dim;
+    size_t padded_dim;
+    size_t nlist;
+    size_t nprobe;
+    HSD_Metric metric;
+    bool trained;
+    float *centroids;
+    float *centroid_norms;
+    hsd_ivf_list_t *lists;
+    size_t size;
+    uint64_t next_id;
+};
+
+/*
+ * Copies vectors into the padded layout, normalizing them for cosine similarity. When norms
+ * is not NULL it receives the squared L2 norm of each prepared row.
+ */
+static hsd_status_t ivf_prepare(const hsd_index_ivf_t *index, const float *src, size_t count,
+                                float *dst, float *norms) {
+    for (size_t r = 0; r < count; ++r) {
+        float *row = dst + r * index->padded_dim;
+        memcpy(row, src + r * index->dim, index->dim * sizeof(float));
+        for (size_t i = index->dim; i < index->padded_dim; ++i) row[i] = 0.0f;
+        float sq;
+        hsd_status_t status = hsd_sim_dot_f32(row, row, index->padded_dim, &sq);
+        if (status != HSD_SUCCESS) return status;
+        if (index->metric == HSD_METRIC_COSINE && sq > 0.0f) {
+            float inv = 1.0f / sqrtf(sq);
+            for (size_t i = 0; i < index->dim; ++i) row[i] *= inv;
+            sq = 1.0f;
+        }
+        if (norms != NULL) norms[r] = sq;
+    }
+    return HSD_SUCCESS;
+}
+
+/* Caches the squared centroid norms used by the expanded L2 assignment. */
+static hsd_status_t ivf_update_centroid_norms(hsd_index_ivf_t *index) {
+    for (size_t c = 0; c < index->nlist; ++c) {
+        const float *centroid = index->centroids + c * index->padded_dim;
+        hsd_status_t status =
+            hsd_sim_dot_f32(centroid, centroid, index->padded_dim, &index->centroid_norms[c]);
+        if (status != HSD_SUCCESS) return status;
+    }
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t ivf_list_reserve(hsd_ivf_list_t *list, size_t needed, size_t padded_dim) {
+    if (needed <= list->capacity) return HSD_SUCCESS;
+    size_t new_cap = list->capacity ? list->capacity * 2 : HSD_IVF_MIN_LIST_CAPACITY;
+    if (new_cap < needed) new_cap = needed;
+
+    float *vectors = (float *)hsd_internal_aligned_alloc(new_cap * padded_dim * sizeof(float));
+    if (vectors == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    uint64_t *ids = (uint64_t *)realloc(list->ids, new_cap * sizeof(uint64_t));
+    if (ids == NULL) {
+        hsd_internal_aligned_free(vectors);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    if (list->count > 0) memcpy(vectors, list->vectors, list->count * padded_dim * sizeof(float));
+    hsd_internal_aligned_free(list->vectors);
+    list->vectors = vectors;
+    list->ids = ids;
+    list->capacity = new_cap;
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t ivf_list_append(hsd_ivf_list_t *list, const float *vector, uint64_t id,
+                                    size_t padded_dim) {
+    hsd_status_t status = ivf_list_reserve(list, list->count + 1, padded_dim);
+    if (status != HSD_SUCCESS) return status;
+    memcpy(list->vectors + list->count * padded_dim, vector, padded_dim * sizeof(float));
+    list->ids[list->count++] = id;
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_index_ivf_create(size_t dim, HSD_Metric metric, size_t nlist,
+                                  hsd_index_ivf_t **index) {
+    if (index == NULL) return HSD_ERR_NULL_PTR;
+    *index = NULL;
+    if (dim == 0 || nlist == 0 || nlist > UINT32_MAX) return HSD_ERR_INVALID_INPUT;
+    if (metric != HSD_METRIC_SQEUCLIDEAN && metric != HSD_METRIC_DOT &&
+        metric != HSD_METRIC_COSINE)
+        return HSD_ERR_INVALID_INPUT;
+
+    hsd_index_ivf_t *idx = (hsd_index_ivf_t *)calloc(1, sizeof(*idx));
+    if (idx == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    idx->dim = dim;
+    idx->padded_dim = hsd_internal_round_up(dim, HSD_INTERNAL_ALIGNMENT / sizeof(float));
+    idx->nlist = nlist;
+    idx->nprobe = nlist < HSD_IVF_DEFAULT_NPROBE ? nlist : HSD_IVF_DEFAULT_NPROBE;
+    idx->metric = metric;
+    idx->centroids = (float *)hsd_internal_aligned_alloc(nlist * idx->padded_dim * sizeof(float));
+    idx->centroid_norms = (float *)calloc(nlist, sizeof(float));
+    idx->lists = (hsd_ivf_list_t *)calloc(nlist, sizeof(hsd_ivf_list_t));
+    if (idx->centroids == NULL || idx->centroid_norms == NULL || idx->lists == NULL) {
+        hsd_index_ivf_free(idx);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    memset(idx->centroids, 0, nlist * idx->padded_dim * sizeof(float));
+    hsd_log("IVF index: dim=%zu metric=%d nlist=%zu", dim, metric, nlist);
+    *index = idx;
+    return HSD_SUCCESS;
+}
+
+void hsd_index_ivf_free(hsd_index_ivf_t *index) {
+    if (index == NULL) return;
+    if (index->lists != NULL) {
+        for (size_t i = 0; i < index->nlist; ++i) {
+            hsd_internal_aligned_free(index->lists[i].vectors);
+            free(index->lists[i].ids);
+        }
+    }
+    hsd_internal_aligned_free(index->centroids);
+    free(index->centroid_norms);
+    free(index->lists);
+    free(index);
+}
+
+hsd_status_t hsd_index_ivf_train(hsd_index_ivf_t *index, const float *vectors, size_t count) {
+    if (index == NULL || vectors == NULL) return HSD_ERR_NULL_PTR;
+    if (count < index->nlist || index->size > 0) return HSD_ERR_INVALID_INPUT;
+
+    float *points = (float *)hsd_internal_aligned_alloc(count * index->padded_dim * sizeof(float));
+    if (points == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    /* Padding columns are zero in every point, so they stay zero in the centroids. */
+    hsd_kmeans_params_t params = {0, 0, HSD_IVF_TRAIN_SEED};
+    hsd_status_t status = ivf_prepare(index, vectors, count, points, NULL);
+    if (status == HSD_SUCCESS)
+        status = hsd_kmeans_f32(points, count, index->padded_dim, index->nlist, &params,
+                                index->centroids, NULL, NULL);
+    if (status == HSD_SUCCESS) status = ivf_update_centroid_norms(index);
+    hsd_internal_aligned_free(points);
+    index->trained = (status == HSD_SUCCESS);
+    hsd_log("IVF index: trained on %zu vectors (status=%d)", count, status);
+    return status;
+}
+
+hsd_status_t hsd_index_ivf_add(hsd_index_ivf_t *index, const float *vectors, size_t count,
+                               uint64_t *first_id) {
+    if (index == NULL || (vectors == NULL && count > 0)) return HSD_ERR_NULL_PTR;
+    if (!index->trained) return HSD_ERR_INVALID_INPUT;
+    if (first_id != NULL) *first_id = index->next_id;
+    if (count == 0) return HSD_SUCCESS;
+
+    float *points = (float *)hsd_internal_aligned_alloc(count * index->padded_dim * sizeof(float));
+    float *norms = (float *)malloc(count * sizeof(float));
+    uint32_t *assign = (uint32_t *)malloc(count * sizeof(uint32_t));
+    float *best = (float *)malloc(count * sizeof(float));
+    hsd_status_t status = HSD_ERR_OUT_OF_MEMORY;
+    if (points != NULL && norms != NULL && assign != NULL && best != NULL) {
+        status = ivf_prepare(index, vectors, count, points, norms);
+        /* Inner-product indexes file vectors under the centroid with the largest dot product. */
+        if (status == HSD_SUCCESS)
+            status = hsd_internal_kmeans_assign(points, count, norms, index->centroids,
+                                                index->nlist, index->centroid_norms,
+                                                index->padded_dim,
+                                                index->metric == HSD_METRIC_DOT, assign, best);
+        for (size_t i = 0; status == HSD_SUCCESS && i < count; ++i) {
+            status = ivf_list_append(&index->lists[assign[i]], points + i * index->padded_dim,
+                                     index->next_id, index->padded_dim);
+            if (status == HSD_SUCCESS) {
+                index->next_id++;
+                index->size++;
+            }
+        }
+    }
+    hsd_internal_aligned_free(points);
+    free(norms);
+    free(assign);
+    free(best);
+    return status;
+}
+
+hsd_status_t hsd_index_ivf_set_nprobe(hsd_index_ivf_t *index, size_t nprobe) {
+    if (index == NULL) return HSD_ERR_NULL_PTR;
+    if (nprobe == 0) return HSD_ERR_INVALID_INPUT;
+    index->nprobe = nprobe < index->nlist ? nprobe : index->nlist;
+    return HSD_SUCCESS;
+}
+
+size_t hsd_index_ivf_size(const hsd_index_ivf_t *index) {
+    return index == NULL ? 0 : index->size;
+}
+
+static hsd_status_t ivf_scan_list(const hsd_index_ivf_t *index, const hsd_ivf_list_t *list,
+                                  const float *query, hsd_internal_topk_t *heap) {
+    hsd_ivf_kernel_t kernel =
+        index->metric == HSD_METRIC_SQEUCLIDEAN ? hsd_dist_sqeuclidean_f32 : hsd_sim_dot_f32;
+    bool similarity = hsd_internal_metric_is_similarity(index->metric);
+    size_t row_bytes = index->padded_dim * sizeof(float);
+    for (size_t row = 0; row < list->count; ++row) {
+        if (row + HSD_IVF_PREFETCH_ROWS < list->count) {
+            const char *next =
+                (const char *)(list->vectors + (row + HSD_IVF_PREFETCH_ROWS) * index->padded_dim);
+            for (size_t off = 0; off < row_bytes; off += HSD_INTERNAL_ALIGNMENT)
+                hsd_internal_prefetch(next + off);
+        }
+        float score;
+        hsd_status_t status =
+            kernel(query, list->vectors + row * index->padded_dim, index->padded_dim, &score);
+        if (status != HSD_SUCCESS) return status;
+        hsd_internal_topk_push(heap, similarity ? -score : score, list->ids[row]);
+    }
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_index_ivf_search(const hsd_index_ivf_t *index, const float *query, size_t k,
+                                  uint64_t *ids, float *scores, size_t *found) {
+    if (found == NULL) return HSD_ERR_NULL_PTR;
+    *found = 0;
+    if (index == NULL || query == NULL || (k > 0 && ids == NULL)) return HSD_ERR_NULL_PTR;
+    if (k == 0 || index->size == 0) return HSD_SUCCESS;
+
+    float *q = (float *)hsd_internal_aligned_alloc(index->padded_dim * sizeof(float));
+    uint64_t *probe = (uint64_t *)malloc(index->nprobe * sizeof(uint64_t));
+    float *dots = (float *)malloc(index->nlist * sizeof(float));
+    if (q == NULL || probe == NULL || dots == NULL) {
+        hsd_internal_aligned_free(q);
+        free(probe);
+        free(dots);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+
+    /* Lists are probed with the same coarse score that hsd_index_ivf_add uses to fill them. */
+    hsd_internal_topk_t coarse, heap;
+    float query_norm = 0.0f;
+    hsd_status_t status = ivf_prepare(index, query, 1, q, &query_norm);
+    if (status == HSD_SUCCESS) status = hsd_internal_topk_init(&coarse, index->nprobe);
+    if (status == HSD_SUCCESS) {
+        hsd_internal_dot_block_f32(index->centroids, index->nlist, index->padded_dim, q, 1,
+                                   index->padded_dim, index->padded_dim, dots, 1);
+        for (size_t c = 0; c < index->nlist; ++c) {
+            float score = index->metric == HSD_METRIC_DOT
+                              ? -dots[c]
+                              : query_norm - 2.0f * dots[c] + index->centroid_norms[c];
+            hsd_internal_topk_push(&coarse, score, c);
+        }
+        size_t probes = hsd_internal_topk_finish(&coarse, probe, NULL);
+        hsd_internal_topk_free(&coarse);
+
+        status = hsd_internal_topk_init(&heap, k);
+        if (status == HSD_SUCCESS) {
+            for (size_t p = 0; status == HSD_SUCCESS && p < probes; ++p)
+                status = ivf_scan_list(index, &index->lists[probe[p]], q, &heap);
+            if (status == HSD_SUCCESS) {
+                *found = hsd_internal_topk_finish(&heap, ids, scores);
+                if (scores != NULL && hsd_internal_metric_is_similarity(index->metric)) {
+                    for (size_t i = 0; i < *found; ++i) scores[i] = -scores[i];
+                }
+            }
+            hsd_internal_topk_free(&heap);
+        }
+    }
+
+    hsd_internal_aligned_free(q);
+    free(probe);
+    free(dots);
+    return status;
+}
+
+/*
+ * File layout (native byte order): magic, version, metric, dim, nlist, nprobe, next_id,
+ * nlist centroids of dim floats, then for each list its row count, ids and dim-float rows.
+ */
+static bool ivf_write_u64(FILE *f, uint64_t v) { return fwrite(&v, sizeof(v), 1, f) == 1; }
+
+static bool ivf_read_u64(FILE *f, uint64_t *v) { return fread(v, sizeof(*v), 1, f) == 1; }
+
+static bool ivf_write_rows(FILE *f, const float *rows, size_t count, size_t dim,
+                           size_t padded_dim) {
+    for (size_t r = 0; r < count; ++r) {
+        if (fwrite(rows + r * padded_dim, sizeof(float), dim, f) != dim) return false;
+    }
+    return true;
+}
+
+static bool ivf_read_rows(FILE *f, float *rows, size_t count, size_t dim, size_t padded_dim) {
+    for (size_t r = 0; r < count; ++r) {
+        float *row = rows + r * padded_dim;
+        if (fread(row, sizeof(float), dim, f) != dim) return false;
+        for (size_t i = dim; i < padded_dim; ++i) row[i] = 0.0f;
+    }
+    return true;
+}
+
+hsd_status_t hsd_index_ivf_save(const hsd_index_ivf_t *index, const char *path) {
+    if (index == NULL || path == NULL) return HSD_ERR_NULL_PTR;
+    if (!index->trained) return HSD_ERR_INVALID_INPUT;
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) return HSD_FAILURE;
+
+    uint32_t header[2] = {HSD_IVF_FILE_VERSION, (uint32_t)index->metric};
+    bool ok = fwrite(hsd_ivf_magic, sizeof(hsd_ivf_magic), 1, f) == 1 &&
+              fwrite(header, sizeof(header), 1, f) == 1 && ivf_write_u64(f, index->dim) &&
+              ivf_write_u64(f, index->nlist) && ivf_write_u64(f, index->nprobe) &&
+              ivf_write_u64(f, index->next_id) &&
+              ivf_write_rows(f, index->centroids, index->nlist, index->dim, index->padded_dim);
+    for (size_t l = 0; ok && l < index->nlist; ++l) {
+        const hsd_ivf_list_t *list = &index->lists[l];
+        ok = ivf_write_u64(f, list->count) &&
+             fwrite(list->ids, sizeof(uint64_t), list->count, f) == list->count &&
+             ivf_write_rows(f, list->vectors, list->count, index->dim, index->padded_dim);
+    }
+    if (fclose(f) != 0) ok = false;
+    return ok ? HSD_SUCCESS : HSD_FAILURE;
+}
+
+hsd_status_t hsd_index_ivf_load(const char *path, hsd_index_ivf_t **index) {
+    if (path == NULL || index == NULL) return HSD_ERR_NULL_PTR;
+    *index = NULL;
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return HSD_FAILURE;
+
+    char magic[sizeof(hsd_ivf_magic)];
+    uint32_t header[2];
+    uint64_t dim, nlist, nprobe, next_id;
+    if (fread(magic, sizeof(magic), 1, f) != 1 || fread(header, sizeof(header), 1, f) != 1 ||
+        !ivf_read_u64(f, &dim) || !ivf_read_u64(f, &nlist) || !ivf_read_u64(f, &nprobe) ||
+        !ivf_read_u64(f, &next_id) || memcmp(magic, hsd_ivf_magic, sizeof(magic)) != 0 ||
+        header[0] != HSD_IVF_FILE_VERSION) {
+        fclose(f);
+        return HSD_ERR_INVALID_INPUT;
+    }
+
+    hsd_index_ivf_t *idx = NULL;
+    hsd_status_t status = hsd_index_ivf_create((size_t)dim, (HSD_Metric)header[1], (size_t)nlist,
+                                               &idx);
+    if (status == HSD_SUCCESS) {
+        if (!ivf_read_rows(f, idx->centroids, idx->nlist, idx->dim, idx->padded_dim) ||
+            hsd_index_ivf_set_nprobe(idx, (size_t)nprobe) != HSD_SUCCESS)
+            status = HSD_ERR_INVALID_INPUT;
+        else
+            status = ivf_update_centroid_norms(idx);
+    }
+    for (size_t l = 0; status == HSD_SUCCESS && l < idx->nlist; ++l) {
+        hsd_ivf_list_t *list = &idx->lists[l];
+        uint64_t count;
+        if (!ivf_read_u64(f, &count)) {
+            status = HSD_ERR_INVALID_INPUT;
+            break;
+        }
+        status = ivf_list_reserve(list, (size_t)count, idx->padded_dim);
+        if (status != HSD_SUCCESS) break;
+        if (fread(list->ids, sizeof(uint64_t), (size_t)count, f) != count ||
+            !ivf_read_rows(f, list->vectors, (size_t)count, idx->dim, idx->padded_dim)) {
+            status = HSD_ERR_INVALID_INPUT;
+            break;
+        }
+        list->count = (size_t)count;
+        idx->size += list->count;
+    }
+    fclose(f);
+
+    if (status != HSD_SUCCESS) {
+        hsd_index_ivf_free(idx);
+        return status;
+    }
+    idx->next_id = next_id;
+    idx->trained = true;
+    *index = idx;
+    return HSD_SUCCESS;
+}
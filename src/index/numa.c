@@ -0,0 +1,484 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#define HSD_NUMA_CHUNK_ROWS 4096
+#define HSD_NUMA_PAGE_BYTES 4096
+#define HSD_NUMA_MAX_NODES 64
+#define HSD_NUMA_MAX_CPUS 4096
+#define HSD_NUMA_PREFETCH_ROWS 2
+#define HSD_NUMA_MPOL_PREFERRED 1
+
+typedef hsd_status_t (*hsd_numa_kernel_t)(const float *, const float *, size_t, float *);
+
+/*
+ * One shard per NUMA node. Rows live in fixed-size chunks that are never reallocated: each
+ * chunk holds HSD_NUMA_CHUNK_ROWS padded vectors followed by their ids, is bound to the node
+ * when the kernel allows it, and is first written by a worker pinned to that node, so the
+ * pages end up local to the threads that later scan them.
+ */
+typedef struct {
+    int node;
+    hsd_internal_pool_t *pool;
+    size_t workers;
+    size_t count;
+    size_t chunk_count;
+    void **chunks;
+} hsd_numa_shard_t;
+
+struct hsd_index_numa {
+    size_t dim;
+    size_t padded_dim;
+    HSD_Metric metric;
+    size_t chunk_bytes;
+    size_t shard_count;
+    hsd_numa_shard_t *shards;
+    size_t size;
+    uint64_t next_id;
+};
+
+static inline float *numa_chunk_rows(void *chunk) { return (float *)chunk; }
+
+static inline uint64_t *numa_chunk_ids(const hsd_index_numa_t *index, void *chunk) {
+    return (uint64_t *)((unsigned char *)chunk +
+                        HSD_NUMA_CHUNK_ROWS * index->padded_dim * sizeof(float));
+}
+
+static void *numa_alloc_chunk(size_t bytes, int node) {
+#if defined(_WIN32)
+    (void)node;
+    return _aligned_malloc(bytes, HSD_NUMA_PAGE_BYTES);
+#else
+    void *chunk = aligned_alloc(HSD_NUMA_PAGE_BYTES, bytes);
+#if defined(__linux__) && defined(SYS_mbind)
+    /* Best effort: when the node does not exist the pages still follow first touch. */
+    if (chunk != NULL && node >= 0 && node < HSD_NUMA_MAX_NODES) {
+        unsigned long mask = 1ul << node;
+        syscall(SYS_mbind, chunk, bytes, HSD_NUMA_MPOL_PREFERRED, &mask,
+                (unsigned long)(sizeof(mask) * 8 + 1), 0);
+    }
+#else
+    (void)node;
+#endif
+    return chunk;
+#endif
+}
+
+static void numa_free_chunk(void *chunk) {
+#if defined(_WIN32)
+    _aligned_free(chunk);
+#else
+    free(chunk);
+#endif
+}
+
+/* Parses a sysfs CPU list such as "0-3,8-11" into cpu_nodes[cpu] = node. */
+static void numa_parse_cpulist(const char *list, int node, int *cpu_nodes, size_t *cpu_count) {
+    const char *p = list;
+    while (*p != '\0' && *p != '\n') {
+        char *end;
+        long first = strtol(p, &end, 10);
+        if (end == p) return;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long cpu = first; cpu <= last && cpu < HSD_NUMA_MAX_CPUS; ++cpu) {
+            if (cpu < 0) continue;
+            cpu_nodes[cpu] = node;
+            if ((size_t)cpu + 1 > *cpu_count) *cpu_count = (size_t)cpu + 1;
+        }
+        if (*p == ',') p++;
+    }
+}
+
+/* Reads the host topology from sysfs, or reports one node with every online CPU. */
+static size_t numa_detect_topology(int *cpu_nodes) {
+    size_t cpu_count = 0;
+    for (size_t i = 0; i < HSD_NUMA_MAX_CPUS; ++i) cpu_nodes[i] = -1;
+#if defined(__linux__)
+    for (int node = 0; node < HSD_NUMA_MAX_NODES; ++node) {
+        char path[64];
+        char list[1024];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *file = fopen(path, "r");
+        if (file == NULL) continue;
+        if (fgets(list, sizeof(list), file) != NULL)
+            numa_parse_cpulist(list, node, cpu_nodes, &cpu_count);
+        fclose(file);
+    }
+#endif
+    if (cpu_count == 0) {
+        long online = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+        online = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        cpu_count = online > 0 ? (size_t)online : 1;
+        if (cpu_count > HSD_NUMA_MAX_CPUS) cpu_count = HSD_NUMA_MAX_CPUS;
+        for (size_t i = 0; i < cpu_count; ++i) cpu_nodes[i] = 0;
+    }
+    return cpu_count;
+}
+
+/* Creates one shard, with a worker pinned to each CPU, for every node that has CPUs. */
+static hsd_status_t numa_create_shards(hsd_index_numa_t *index, const int *cpu_nodes,
+                                       size_t cpu_count) {
+    int *cpus = (int *)malloc(cpu_count * sizeof(int));
+    if (cpus == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    index->shards = (hsd_numa_shard_t *)calloc(cpu_count, sizeof(hsd_numa_shard_t));
+    if (index->shards == NULL) {
+        free(cpus);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+
+    hsd_status_t status = HSD_SUCCESS;
+    int previous = -1;
+    for (;;) {
+        /* Nodes are visited in ascending order. */
+        int node = -1;
+        for (size_t c = 0; c < cpu_count; ++c) {
+            if (cpu_nodes[c] > previous && (node < 0 || cpu_nodes[c] < node)) node = cpu_nodes[c];
+        }
+        if (node < 0) break;
+        previous = node;
+
+        size_t n = 0;
+        for (size_t c = 0; c < cpu_count; ++c) {
+            if (cpu_nodes[c] == node) cpus[n++] = (int)c;
+        }
+        hsd_numa_shard_t *shard = &index->shards[index->shard_count];
+        shard->node = node;
+        shard->workers = n;
+        shard->pool = hsd_internal_pool_create(n + 1, cpus, n);
+        if (shard->pool == NULL) {
+            status = HSD_ERR_OUT_OF_MEMORY;
+            break;
+        }
+        index->shard_count++;
+        hsd_log("NUMA index: shard %zu on node %d with %zu CPUs", index->shard_count - 1, node,
+                n);
+    }
+    free(cpus);
+    if (status == HSD_SUCCESS && index->shard_count == 0) status = HSD_ERR_INVALID_INPUT;
+    return status;
+}
+
+hsd_status_t hsd_index_numa_create(size_t dim, HSD_Metric metric,
+                                   const hsd_numa_topology_t *topology,
+                                   hsd_index_numa_t **index) {
+    if (index == NULL) return HSD_ERR_NULL_PTR;
+    *index = NULL;
+    if (topology != NULL && topology->cpu_count > 0 && topology->cpu_nodes == NULL)
+        return HSD_ERR_NULL_PTR;
+    if (dim == 0 || (topology != NULL && topology->cpu_count > HSD_NUMA_MAX_CPUS))
+        return HSD_ERR_INVALID_INPUT;
+    if (metric != HSD_METRIC_SQEUCLIDEAN && metric != HSD_METRIC_DOT &&
+        metric != HSD_METRIC_COSINE)
+        return HSD_ERR_INVALID_INPUT;
+
+    int *detected = NULL;
+    const int *cpu_nodes;
+    size_t cpu_count;
+    if (topology != NULL) {
+        cpu_nodes = topology->cpu_nodes;
+        cpu_count = topology->cpu_count;
+    } else {
+        detected = (int *)malloc(HSD_NUMA_MAX_CPUS * sizeof(int));
+        if (detected == NULL) return HSD_ERR_OUT_OF_MEMORY;
+        cpu_count = numa_detect_topology(detected);
+        cpu_nodes = detected;
+    }
+    if (cpu_count == 0) return HSD_ERR_INVALID_INPUT;
+
+    hsd_index_numa_t *idx = (hsd_index_numa_t *)calloc(1, sizeof(*idx));
+    if (idx == NULL) {
+        free(detected);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    idx->dim = dim;
+    idx->padded_dim = hsd_internal_round_up(dim, HSD_INTERNAL_ALIGNMENT / sizeof(float));
+    idx->metric = metric;
+    idx->chunk_bytes = hsd_internal_round_up(
+        HSD_NUMA_CHUNK_ROWS * (idx->padded_dim * sizeof(float) + sizeof(uint64_t)),
+        HSD_NUMA_PAGE_BYTES);
+    hsd_status_t status = numa_create_shards(idx, cpu_nodes, cpu_count);
+    free(detected);
+    if (status != HSD_SUCCESS) {
+        hsd_index_numa_free(idx);
+        return status;
+    }
+    hsd_log("NUMA index: dim=%zu metric=%d shards=%zu", dim, metric, idx->shard_count);
+    *index = idx;
+    return HSD_SUCCESS;
+}
+
+void hsd_index_numa_free(hsd_index_numa_t *index) {
+    if (index == NULL) return;
+    if (index->shards != NULL) {
+        for (size_t s = 0; s < index->shard_count; ++s) {
+            hsd_numa_shard_t *shard = &index->shards[s];
+            hsd_internal_pool_destroy(shard->pool);
+            for (size_t c = 0; c < shard->chunk_count; ++c) numa_free_chunk(shard->chunks[c]);
+            free(shard->chunks);
+        }
+    }
+    free(index->shards);
+    free(index);
+}
+
+static hsd_status_t numa_shard_reserve(const hsd_index_numa_t *index, hsd_numa_shard_t *shard,
+                                       size_t rows) {
+    size_t needed = (rows + HSD_NUMA_CHUNK_ROWS - 1) / HSD_NUMA_CHUNK_ROWS;
+    if (needed <= shard->chunk_count) return HSD_SUCCESS;
+    void **chunks = (void **)realloc(shard->chunks, needed * sizeof(void *));
+    if (chunks == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    shard->chunks = chunks;
+    while (shard->chunk_count < needed) {
+        void *chunk = numa_alloc_chunk(index->chunk_bytes, shard->node);
+        if (chunk == NULL) return HSD_ERR_OUT_OF_MEMORY;
+        shard->chunks[shard->chunk_count++] = chunk;
+    }
+    return HSD_SUCCESS;
+}
+
+/* Copies a contiguous run of input rows into one shard, one destination chunk per task. */
+typedef struct {
+    const hsd_index_numa_t *index;
+    hsd_numa_shard_t *shard;
+    const float *src;
+    size_t rows;
+    size_t start;
+    uint64_t first_id;
+} hsd_numa_copy_job_t;
+
+static hsd_status_t numa_copy_task(void *ctx, size_t task, size_t slot) {
+    (void)slot;
+    hsd_numa_copy_job_t *job = (hsd_numa_copy_job_t *)ctx;
+    const hsd_index_numa_t *index = job->index;
+    size_t chunk = job->start / HSD_NUMA_CHUNK_ROWS + task;
+    size_t begin = chunk * HSD_NUMA_CHUNK_ROWS;
+    if (begin < job->start) begin = job->start;
+    size_t end = (chunk + 1) * HSD_NUMA_CHUNK_ROWS;
+    if (end > job->start + job->rows) end = job->start + job->rows;
+
+    float *rows = numa_chunk_rows(job->shard->chunks[chunk]);
+    uint64_t *ids = numa_chunk_ids(index, job->shard->chunks[chunk]);
+    for (size_t pos = begin; pos < end; ++pos) {
+        size_t input = pos - job->start;
+        float *row = rows + (pos % HSD_NUMA_CHUNK_ROWS) * index->padded_dim;
+        memcpy(row, job->src + input * index->dim, index->dim * sizeof(float));
+        for (size_t i = index->dim; i < index->padded_dim; ++i) row[i] = 0.0f;
+        float sq;
+        hsd_status_t status = hsd_sim_dot_f32(row, row, index->padded_dim, &sq);
+        if (status != HSD_SUCCESS) return status;
+        if (index->metric == HSD_METRIC_COSINE && sq > 0.0f) {
+            float inv = 1.0f / sqrtf(sq);
+            for (size_t i = 0; i < index->dim; ++i) row[i] *= inv;
+        }
+        ids[pos % HSD_NUMA_CHUNK_ROWS] = job->first_id + input;
+    }
+    return HSD_SUCCESS;
+}
+
+hsd_status_t hsd_index_numa_add(hsd_index_numa_t *index, const float *vectors, size_t count,
+                                uint64_t *first_id) {
+    if (index == NULL || (count > 0 && vectors == NULL)) return HSD_ERR_NULL_PTR;
+    if (first_id != NULL) *first_id = index->next_id;
+    if (count == 0) return HSD_SUCCESS;
+
+    hsd_numa_copy_job_t *jobs =
+        (hsd_numa_copy_job_t *)calloc(index->shard_count, sizeof(hsd_numa_copy_job_t));
+    hsd_internal_pool_job_t **pending =
+        (hsd_internal_pool_job_t **)calloc(index->shard_count, sizeof(hsd_internal_pool_job_t *));
+    hsd_status_t status = jobs != NULL && pending != NULL ? HSD_SUCCESS : HSD_ERR_OUT_OF_MEMORY;
+
+    /* Contiguous runs per shard; the shard receiving the extra rows rotates with the ids. */
+    size_t base = count / index->shard_count;
+    size_t extra = count % index->shard_count;
+    size_t rotate = (size_t)(index->next_id % index->shard_count);
+    size_t offset = 0;
+    for (size_t s = 0; status == HSD_SUCCESS && s < index->shard_count; ++s) {
+        hsd_numa_shard_t *shard = &index->shards[s];
+        size_t rows = base + ((s + index->shard_count - rotate) % index->shard_count < extra);
+        jobs[s].index = index;
+        jobs[s].shard = shard;
+        jobs[s].src = vectors + offset * index->dim;
+        jobs[s].rows = rows;
+        jobs[s].start = shard->count;
+        jobs[s].first_id = index->next_id + offset;
+        offset += rows;
+        if (rows == 0) continue;
+        status = numa_shard_reserve(index, shard, shard->count + rows);
+        if (status != HSD_SUCCESS) break;
+        size_t tasks = (shard->count + rows - 1) / HSD_NUMA_CHUNK_ROWS -
+                       shard->count / HSD_NUMA_CHUNK_ROWS + 1;
+        pending[s] =
+            hsd_internal_pool_submit(shard->pool, tasks, shard->workers, numa_copy_task, &jobs[s]);
+        if (pending[s] == NULL) status = HSD_ERR_OUT_OF_MEMORY;
+    }
+    for (size_t s = 0; pending != NULL && s < index->shard_count; ++s) {
+        if (pending[s] == NULL) continue;
+        hsd_status_t job_status = hsd_internal_pool_wait(index->shards[s].pool, pending[s]);
+        if (status == HSD_SUCCESS) status = job_status;
+    }
+
+    /* Rows only become visible once every shard has copied its run. */
+    if (status == HSD_SUCCESS) {
+        for (size_t s = 0; s < index->shard_count; ++s) index->shards[s].count += jobs[s].rows;
+        index->size += count;
+        index->next_id += count;
+    }
+    free(pending);
+    free(jobs);
+    return status;
+}
+
+/* Scans one shard into per-chunk heaps, so the merged result is independent of scheduling. */
+typedef struct {
+    const hsd_index_numa_t *index;
+    const hsd_numa_shard_t *shard;
+    const float *query;
+    hsd_numa_kernel_t kernel;
+    hsd_internal_topk_t *heaps;
+} hsd_numa_scan_job_t;
+
+static hsd_status_t numa_scan_task(void *ctx, size_t chunk, size_t slot) {
+    (void)slot;
+    hsd_numa_scan_job_t *job = (hsd_numa_scan_job_t *)ctx;
+    const hsd_index_numa_t *index = job->index;
+    size_t rows = job->shard->count - chunk * HSD_NUMA_CHUNK_ROWS;
+    if (rows > HSD_NUMA_CHUNK_ROWS) rows = HSD_NUMA_CHUNK_ROWS;
+    const float *vectors = numa_chunk_rows(job->shard->chunks[chunk]);
+    const uint64_t *ids = numa_chunk_ids(index, job->shard->chunks[chunk]);
+    bool similarity = hsd_internal_metric_is_similarity(index->metric);
+    for (size_t r = 0; r < rows; ++r) {
+        if (r + HSD_NUMA_PREFETCH_ROWS < rows) {
+            const unsigned char *next =
+                (const unsigned char *)(vectors + (r + HSD_NUMA_PREFETCH_ROWS) * index->padded_dim);
+            for (size_t off = 0; off < index->padded_dim * sizeof(float);
+                 off += HSD_INTERNAL_ALIGNMENT)
+                hsd_internal_prefetch(next + off);
+        }
+        float score;
+        hsd_status_t status =
+            job->kernel(job->query, vectors + r * index->padded_dim, index->padded_dim, &score);
+        if (status != HSD_SUCCESS) return status;
+        hsd_internal_topk_push(&job->heaps[chunk], similarity ? -score : score, ids[r]);
+    }
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t numa_scan_shards(const hsd_index_numa_t *index, const float *query,
+                                     hsd_internal_topk_t *heaps, hsd_internal_topk_t *heap) {
+    hsd_numa_scan_job_t *jobs =
+        (hsd_numa_scan_job_t *)calloc(index->shard_count, sizeof(hsd_numa_scan_job_t));
+    hsd_internal_pool_job_t **pending =
+        (hsd_internal_pool_job_t **)calloc(index->shard_count, sizeof(hsd_internal_pool_job_t *));
+    hsd_status_t status = jobs != NULL && pending != NULL ? HSD_SUCCESS : HSD_ERR_OUT_OF_MEMORY;
+
+    size_t heap_offset = 0;
+    for (size_t s = 0; status == HSD_SUCCESS && s < index->shard_count; ++s) {
+        const hsd_numa_shard_t *shard = &index->shards[s];
+        size_t chunks = (shard->count + HSD_NUMA_CHUNK_ROWS - 1) / HSD_NUMA_CHUNK_ROWS;
+        jobs[s].index = index;
+        jobs[s].shard = shard;
+        jobs[s].query = query;
+        jobs[s].kernel = index->metric == HSD_METRIC_SQEUCLIDEAN ? hsd_dist_sqeuclidean_f32
+                                                                 : hsd_sim_dot_f32;
+        jobs[s].heaps = heaps + heap_offset;
+        heap_offset += chunks;
+        if (chunks == 0) continue;
+        pending[s] =
+            hsd_internal_pool_submit(shard->pool, chunks, shard->workers, numa_scan_task, &jobs[s]);
+        if (pending[s] == NULL) status = HSD_ERR_OUT_OF_MEMORY;
+    }
+    for (size_t s = 0; pending != NULL && s < index->shard_count; ++s) {
+        if (pending[s] == NULL) continue;
+        hsd_status_t job_status = hsd_internal_pool_wait(index->shards[s].pool, pending[s]);
+        if (status == HSD_SUCCESS) status = job_status;
+    }
+    for (size_t h = 0; status == HSD_SUCCESS && h < heap_offset; ++h) {
+        for (size_t i = 0; i < heaps[h].size; ++i)
+            hsd_internal_topk_push(heap, heaps[h].keys[i], heaps[h].ids[i]);
+    }
+    free(pending);
+    free(jobs);
+    return status;
+}
+
+hsd_status_t hsd_index_numa_search(const hsd_index_numa_t *index, const float *query, size_t k,
+                                   uint64_t *ids, float *scores, size_t *found) {
+    if (found == NULL) return HSD_ERR_NULL_PTR;
+    *found = 0;
+    if (index == NULL || query == NULL || (k > 0 && ids == NULL)) return HSD_ERR_NULL_PTR;
+    if (k == 0 || index->size == 0) return HSD_SUCCESS;
+
+    float *padded = (float *)hsd_internal_aligned_alloc(index->padded_dim * sizeof(float));
+    if (padded == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    memcpy(padded, query, index->dim * sizeof(float));
+    for (size_t i = index->dim; i < index->padded_dim; ++i) padded[i] = 0.0f;
+    float sq;
+    hsd_status_t status = hsd_sim_dot_f32(padded, padded, index->padded_dim, &sq);
+    if (status == HSD_SUCCESS && index->metric == HSD_METRIC_COSINE && sq > 0.0f) {
+        float inv = 1.0f / sqrtf(sq);
+        for (size_t i = 0; i < index->dim; ++i) padded[i] *= inv;
+    }
+
+    size_t total_chunks = 0;
+    for (size_t s = 0; s < index->shard_count; ++s)
+        total_chunks += (index->shards[s].count + HSD_NUMA_CHUNK_ROWS - 1) / HSD_NUMA_CHUNK_ROWS;
+    hsd_internal_topk_t *heaps =
+        (hsd_internal_topk_t *)calloc(total_chunks, sizeof(hsd_internal_topk_t));
+    if (status == HSD_SUCCESS && heaps == NULL) status = HSD_ERR_OUT_OF_MEMORY;
+    for (size_t h = 0; status == HSD_SUCCESS && h < total_chunks; ++h)
+        status = hsd_internal_topk_init(&heaps[h], k);
+
+    hsd_internal_topk_t heap;
+    if (status == HSD_SUCCESS) status = hsd_internal_topk_init(&heap, k);
+    if (status == HSD_SUCCESS) {
+        status = numa_scan_shards(index, padded, heaps, &heap);
+        if (status == HSD_SUCCESS) {
+            *found = hsd_internal_topk_finish(&heap, ids, scores);
+            if (scores != NULL && hsd_internal_metric_is_similarity(index->metric)) {
+                for (size_t i = 0; i < *found; ++i) scores[i] = -scores[i];
+            }
+        }
+        hsd_internal_topk_free(&heap);
+    }
+    for (size_t h = 0; heaps != NULL && h < total_chunks; ++h) hsd_internal_topk_free(&heaps[h]);
+    free(heaps);
+    hsd_internal_aligned_free(padded);
+    return status;
+}
+
+size_t hsd_index_numa_size(const hsd_index_numa_t *index) {
+    return index == NULL ? 0 : index->size;
+}
+
+size_t hsd_index_numa_shard_count(const hsd_index_numa_t *index) {
+    return index == NULL ? 0 : index->shard_count;
+}
+
+hsd_status_t hsd_index_numa_shard_info(const hsd_index_numa_t *index, size_t shard, int *node,
+                                       size_t *count) {
+    if (index == NULL) return HSD_ERR_NULL_PTR;
+    if (shard >= index->shard_count) return HSD_ERR_INVALID_INPUT;
+    if (node != NULL) *node = index->shards[shard].node;
+    if (count != NULL) *count = index->shards[shard].count;
+    return HSD_SUCCESS;
+}
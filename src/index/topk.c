@@ -0,0 +1,76 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "hsd_internal.h"
+
+hsd_status_t hsd_internal_topk_init(hsd_internal_topk_t *heap, size_t k) {
+    heap->k = k;
+    heap->size = 0;
+    heap->keys = NULL;
+    heap->ids = NULL;
+    if (k == 0) return HSD_SUCCESS;
+    heap->keys = (float *)malloc(k * sizeof(float));
+    heap->ids = (uint64_t *)malloc(k * sizeof(uint64_t));
+    if (heap->keys == NULL || heap->ids == NULL) {
+        hsd_internal_topk_free(heap);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    return HSD_SUCCESS;
+}
+
+void hsd_internal_topk_free(hsd_internal_topk_t *heap) {
+    free(heap->keys);
+    free(heap->ids);
+    heap->keys = NULL;
+    heap->ids = NULL;
+    heap->size = 0;
+}
+
+static void topk_sift_down(hsd_internal_topk_t *heap, size_t pos) {
+    float key = heap->keys[pos];
+    uint64_t id = heap->ids[pos];
+    for (;;) {
+        size_t child = 2 * pos + 1;
+        if (child >= heap->size) break;
+        if (child + 1 < heap->size && heap->keys[child + 1] > heap->keys[child]) child++;
+        if (heap->keys[child] <= key) break;
+        heap->keys[pos] = heap->keys[child];
+        heap->ids[pos] = heap->ids[child];
+        pos = child;
+    }
+    heap->keys[pos] = key;
+    heap->ids[pos] = id;
+}
+
+void hsd_internal_topk_push(hsd_internal_topk_t *heap, float key, uint64_t id) {
+    if (heap->k == 0) return;
+    if (heap->size < heap->k) {
+        size_t pos = heap->size++;
+        while (pos > 0) {
+            size_t parent = (pos - 1) / 2;
+            if (heap->keys[parent] >= key) break;
+            heap->keys[pos] = heap->keys[parent];
+            heap->ids[pos] = heap->ids[parent];
+            pos = parent;
+        }
+        heap->keys[pos] = key;
+        heap->ids[pos] = id;
+    } else if (key < heap->keys[0]) {
+        heap->keys[0] = key;
+        heap->ids[0] = id;
+        topk_sift_down(heap, 0);
+    }
+}
+
+size_t hsd_internal_topk_finish(hsd_internal_topk_t *heap, uint64_t *ids, float *keys) {
+    size_t found = heap->size;
+    while (heap->size > 0) {
+        size_t last = --heap->size;
+        if (ids != NULL) ids[last] = heap->ids[0];
+        if (keys != NULL) keys[last] = heap->keys[0];
+        heap->keys[0] = heap->keys[last];
+        heap->ids[0] = heap->ids[last];
+        topk_sift_down(heap, 0);
+    }
+    return found;
+}
@@ -0,0 +1,708 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#define HSD_VECFILE_VERSION 1
+#define HSD_VECFILE_ROW_ALIGNMENT 64
+#define HSD_VECFILE_DATA_OFFSET 4096
+#define HSD_VECFILE_SCAN_BLOCK 4096
+#define HSD_VECFILE_PREFETCH_ROWS 2
+#define HSD_VECFILE_STREAM_CHUNK_BYTES (8u << 20)
+#define HSD_VECFILE_STREAM_MAX_DEPTH 64
+
+static const char hsd_vecfile_magic[8] = {'H', 'S', 'D', 'V', 'E', 'C', '\0', '\0'};
+
+/*
+ * On-disk header, stored in native byte order at offset 0 (a byte-swapped file fails the
+ * version check). Rows start at data_offset, which is page aligned, and are zero-padded to
+ * row_bytes, a multiple of the alignment, so mapped rows can be passed straight to the
+ * kernels. The optional norms section holds one float L2 norm per row.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t dtype;
+    uint64_t dim;
+    uint64_t count;
+    uint64_t row_bytes;
+    uint64_t alignment;
+    uint64_t data_offset;
+    uint64_t norms_offset;
+} hsd_vecfile_header_t;
+
+struct hsd_vecfile {
+    HSD_DType dtype;
+    size_t dim;
+    size_t count;
+    size_t row_bytes;
+    const unsigned char *rows;
+    const float *norms;
+    void *map;
+    size_t map_bytes;
+};
+
+typedef hsd_status_t (*hsd_vecfile_kernel_t)(const float *, const float *, size_t, float *);
+
+static size_t vecfile_elem_size(HSD_DType dtype) {
+    switch (dtype) {
+        case HSD_DTYPE_F32:
+            return sizeof(float);
+        case HSD_DTYPE_F16:
+            return sizeof(uint16_t);
+        case HSD_DTYPE_U8:
+            return sizeof(uint8_t);
+        default:
+            return 0;
+    }
+}
+
+/* Converts a row to f32, zero-padded to score_dim elements. */
+static void vecfile_to_f32(HSD_DType dtype, const void *src, size_t dim, size_t score_dim,
+                           float *dst) {
+    if (dtype == HSD_DTYPE_F16) {
+        const uint16_t *h = (const uint16_t *)src;
+        for (size_t i = 0; i < dim; ++i) dst[i] = hsd_internal_f16_to_f32(h[i]);
+    } else {
+        memcpy(dst, src, dim * sizeof(float));
+    }
+    for (size_t i = dim; i < score_dim; ++i) dst[i] = 0.0f;
+}
+
+static bool vecfile_write_zeros(FILE *f, size_t bytes) {
+    static const unsigned char zeros[HSD_VECFILE_ROW_ALIGNMENT] = {0};
+    while (bytes > 0) {
+        size_t n = bytes < sizeof(zeros) ? bytes : sizeof(zeros);
+        if (fwrite(zeros, 1, n, f) != n) return false;
+        bytes -= n;
+    }
+    return true;
+}
+
+/* Computes the L2 norm of every row, which also rejects non-finite values. */
+static hsd_status_t vecfile_compute_norms(HSD_DType dtype, size_t dim, const void *vectors,
+                                          size_t count, float *norms) {
+    if (dtype == HSD_DTYPE_F32) return hsd_norms_l2_f32((const float *)vectors, count, dim, norms);
+    const size_t row_bytes = dim * vecfile_elem_size(dtype);
+    float *scratch = (float *)malloc(dim * sizeof(float));
+    if (scratch == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    hsd_status_t status = HSD_SUCCESS;
+    for (size_t r = 0; status == HSD_SUCCESS && r < count; ++r) {
+        vecfile_to_f32(dtype, (const unsigned char *)vectors + r * row_bytes, dim, dim, scratch);
+        float sq;
+        status = hsd_sim_dot_f32(scratch, scratch, dim, &sq);
+        norms[r] = sqrtf(sq);
+    }
+    free(scratch);
+    return status;
+}
+
+hsd_status_t hsd_vecfile_write(const char *path, HSD_DType dtype, size_t dim, const void *vectors,
+                               size_t count, bool with_norms) {
+    if (path == NULL || (count > 0 && vectors == NULL)) return HSD_ERR_NULL_PTR;
+    size_t elem = vecfile_elem_size(dtype);
+    if (dim == 0 || elem == 0) return HSD_ERR_INVALID_INPUT;
+    if (with_norms && dtype == HSD_DTYPE_U8) return HSD_ERR_INVALID_INPUT;
+
+    hsd_vecfile_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, hsd_vecfile_magic, sizeof(header.magic));
+    header.version = HSD_VECFILE_VERSION;
+    header.dtype = (uint32_t)dtype;
+    header.dim = dim;
+    header.count = count;
+    header.row_bytes = hsd_internal_round_up(dim * elem, HSD_VECFILE_ROW_ALIGNMENT);
+    header.alignment = HSD_VECFILE_ROW_ALIGNMENT;
+    header.data_offset = HSD_VECFILE_DATA_OFFSET;
+    uint64_t data_end = header.data_offset + header.count * header.row_bytes;
+    if (with_norms)
+        header.norms_offset = hsd_internal_round_up(data_end, HSD_VECFILE_ROW_ALIGNMENT);
+
+    float *norms = NULL;
+    if (with_norms) {
+        norms = (float *)malloc((count ? count : 1) * sizeof(float));
+        if (norms == NULL) return HSD_ERR_OUT_OF_MEMORY;
+        hsd_status_t status = vecfile_compute_norms(dtype, dim, vectors, count, norms);
+        if (status != HSD_SUCCESS) {
+            free(norms);
+            return status;
+        }
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        free(norms);
+        return HSD_FAILURE;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              vecfile_write_zeros(f, header.data_offset - sizeof(header));
+    const size_t packed = dim * elem;
+    for (size_t r = 0; ok && r < count; ++r) {
+        ok = fwrite((const unsigned char *)vectors + r * packed, 1, packed, f) == packed &&
+             vecfile_write_zeros(f, header.row_bytes - packed);
+    }
+    if (ok && with_norms) {
+        ok = vecfile_write_zeros(f, header.norms_offset - data_end) &&
+             fwrite(norms, sizeof(float), count, f) == count;
+    }
+    if (fclose(f) != 0) ok = false;
+    free(norms);
+    hsd_log("Vecfile: wrote %zu rows (dim=%zu dtype=%d norms=%d)", count, dim, dtype,
+            (int)with_norms);
+    return ok ? HSD_SUCCESS : HSD_FAILURE;
+}
+
+/* Checks that the header describes a file of file_bytes bytes this version can map. */
+static bool vecfile_header_valid(const hsd_vecfile_header_t *h, uint64_t file_bytes) {
+    if (memcmp(h->magic, hsd_vecfile_magic, sizeof(h->magic)) != 0) return false;
+    if (h->version != HSD_VECFILE_VERSION) return false;
+    size_t elem = vecfile_elem_size((HSD_DType)h->dtype);
+    if (elem == 0 || h->dim == 0 || h->dim > UINT64_MAX / elem) return false;
+    if (h->alignment < HSD_VECFILE_ROW_ALIGNMENT || (h->alignment & (h->alignment - 1)) != 0)
+        return false;
+    if (h->row_bytes < h->dim * elem || h->row_bytes % h->alignment != 0) return false;
+    if (h->data_offset < sizeof(*h) || h->data_offset % h->alignment != 0) return false;
+    if (h->data_offset > file_bytes) return false;
+    if (h->count > (file_bytes - h->data_offset) / h->row_bytes) return false;
+    if (h->norms_offset != 0) {
+        if ((HSD_DType)h->dtype == HSD_DTYPE_U8 || h->norms_offset % sizeof(float) != 0)
+            return false;
+        if (h->norms_offset < h->data_offset + h->count * h->row_bytes ||
+            h->norms_offset > file_bytes ||
+            h->count > (file_bytes - h->norms_offset) / sizeof(float))
+            return false;
+    }
+    return true;
+}
+
+hsd_status_t hsd_vecfile_open(const char *path, hsd_vecfile_t **file) {
+    if (file == NULL) return HSD_ERR_NULL_PTR;
+    *file = NULL;
+    if (path == NULL) return HSD_ERR_NULL_PTR;
+#if defined(_WIN32)
+    return HSD_ERR_UNSUPPORTED;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return HSD_FAILURE;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return HSD_FAILURE;
+    }
+    if ((uint64_t)st.st_size < sizeof(hsd_vecfile_header_t)) {
+        close(fd);
+        return HSD_ERR_INVALID_INPUT;
+    }
+    size_t map_bytes = (size_t)st.st_size;
+    void *map = mmap(NULL, map_bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return HSD_FAILURE;
+
+    hsd_vecfile_header_t header;
+    memcpy(&header, map, sizeof(header));
+    if (!vecfile_header_valid(&header, (uint64_t)map_bytes)) {
+        munmap(map, map_bytes);
+        return HSD_ERR_INVALID_INPUT;
+    }
+    hsd_vecfile_t *vf = (hsd_vecfile_t *)calloc(1, sizeof(*vf));
+    if (vf == NULL) {
+        munmap(map, map_bytes);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    vf->dtype = (HSD_DType)header.dtype;
+    vf->dim = (size_t)header.dim;
+    vf->count = (size_t)header.count;
+    vf->row_bytes = (size_t)header.row_bytes;
+    vf->rows = (const unsigned char *)map + header.data_offset;
+    vf->norms = header.norms_offset ? (const float *)((const unsigned char *)map +
+                                                      header.norms_offset)
+                                    : NULL;
+    vf->map = map;
+    vf->map_bytes = map_bytes;
+    hsd_log("Vecfile: mapped %zu rows (dim=%zu dtype=%d) from %s", vf->count, vf->dim,
+            vf->dtype, path);
+    *file = vf;
+    return HSD_SUCCESS;
+#endif
+}
+
+void hsd_vecfile_close(hsd_vecfile_t *file) {
+    if (file == NULL) return;
+#if !defined(_WIN32)
+    munmap(file->map, file->map_bytes);
+#endif
+    free(file);
+}
+
+size_t hsd_vecfile_count(const hsd_vecfile_t *file) { return file == NULL ? 0 : file->count; }
+
+size_t hsd_vecfile_dim(const hsd_vecfile_t *file) { return file == NULL ? 0 : file->dim; }
+
+HSD_DType hsd_vecfile_dtype(const hsd_vecfile_t *file) {
+    return file == NULL ? HSD_DTYPE_F32 : file->dtype;
+}
+
+size_t hsd_vecfile_row_stride(const hsd_vecfile_t *file) {
+    return file == NULL ? 0 : file->row_bytes;
+}
+
+const void *hsd_vecfile_row(const hsd_vecfile_t *file, size_t row) {
+    if (file == NULL || row >= file->count) return NULL;
+    return file->rows + row * file->row_bytes;
+}
+
+const float *hsd_vecfile_norms(const hsd_vecfile_t *file) {
+    return file == NULL ? NULL : file->norms;
+}
+
+#if !defined(_WIN32)
+static void vecfile_madvise(const hsd_vecfile_t *file, size_t first_row, size_t rows, int advice) {
+    if (rows == 0) return;
+    /* posix_madvise wants a page-aligned start; widen the range down to the page boundary. */
+    uintptr_t base = (uintptr_t)file->map;
+    uintptr_t start = (uintptr_t)(file->rows + first_row * file->row_bytes);
+    uintptr_t end = start + rows * file->row_bytes;
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0) page = HSD_VECFILE_DATA_OFFSET;
+    start = base + (start - base) / (uintptr_t)page * (uintptr_t)page;
+    posix_madvise((void *)start, end - start, advice);
+}
+#endif
+
+hsd_status_t hsd_vecfile_advise(const hsd_vecfile_t *file, HSD_Advice advice) {
+    if (file == NULL) return HSD_ERR_NULL_PTR;
+#if defined(_WIN32)
+    (void)advice;
+    return HSD_ERR_UNSUPPORTED;
+#else
+    int hint;
+    switch (advice) {
+        case HSD_ADVICE_NORMAL:
+            hint = POSIX_MADV_NORMAL;
+            break;
+        case HSD_ADVICE_SEQUENTIAL:
+            hint = POSIX_MADV_SEQUENTIAL;
+            break;
+        case HSD_ADVICE_RANDOM:
+            hint = POSIX_MADV_RANDOM;
+            break;
+        case HSD_ADVICE_WILLNEED:
+            hint = POSIX_MADV_WILLNEED;
+            break;
+        default:
+            return HSD_ERR_INVALID_INPUT;
+    }
+    vecfile_madvise(file, 0, file->count, hint);
+    return HSD_SUCCESS;
+#endif
+}
+
+/*
+ * One exact search. A pass scans `count` rows starting at `rows` in blocks of
+ * HSD_VECFILE_SCAN_BLOCK on the thread pool, each block into its own heap, and merges the
+ * blocks in order. Mapped scans cover the whole file in one pass and ask the kernel to read
+ * ahead the block after the current one; streamed scans run one pass per buffer.
+ */
+typedef struct {
+    HSD_DType dtype;
+    size_t dim;
+    size_t row_bytes;
+    HSD_Metric metric;
+    void *query;
+    float query_norm;
+    size_t score_dim;
+    hsd_vecfile_kernel_t kernel;
+    float *scratch;
+    const hsd_vecfile_t *mapped;
+    const unsigned char *rows;
+    const float *norms;
+    size_t count;
+    uint64_t first_row;
+    hsd_internal_topk_t *heaps;
+} hsd_vecfile_scan_job_t;
+
+static hsd_status_t vecfile_scan_task(void *ctx, size_t block, size_t slot) {
+    hsd_vecfile_scan_job_t *job = (hsd_vecfile_scan_job_t *)ctx;
+    size_t begin = block * HSD_VECFILE_SCAN_BLOCK;
+    size_t end = begin + HSD_VECFILE_SCAN_BLOCK < job->count ? begin + HSD_VECFILE_SCAN_BLOCK
+                                                              : job->count;
+    hsd_internal_topk_t *heap = &job->heaps[block];
+#if !defined(_WIN32)
+    if (job->mapped != NULL && end < job->count) {
+        size_t ahead = job->count - end;
+        vecfile_madvise(job->mapped, end,
+                        ahead < HSD_VECFILE_SCAN_BLOCK ? ahead : HSD_VECFILE_SCAN_BLOCK,
+                        POSIX_MADV_WILLNEED);
+    }
+#endif
+
+    bool similarity = hsd_internal_metric_is_similarity(job->metric);
+    float *scratch = job->scratch != NULL ? job->scratch + slot * job->score_dim : NULL;
+    for (size_t row = begin; row < end; ++row) {
+        const unsigned char *v = job->rows + row * job->row_bytes;
+        if (row + HSD_VECFILE_PREFETCH_ROWS < end) {
+            const unsigned char *next = v + HSD_VECFILE_PREFETCH_ROWS * job->row_bytes;
+            for (size_t off = 0; off < job->row_bytes; off += HSD_INTERNAL_ALIGNMENT)
+                hsd_internal_prefetch(next + off);
+        }
+        if (job->metric == HSD_METRIC_HAMMING) {
+            uint64_t dist;
+            hsd_status_t status =
+                hsd_dist_hamming_u8((const uint8_t *)job->query, v, job->row_bytes, &dist);
+            if (status != HSD_SUCCESS) return status;
+            hsd_internal_topk_push(heap, (float)dist, job->first_row + row);
+            continue;
+        }
+
+        const float *x = (const float *)v;
+        if (scratch != NULL) {
+            vecfile_to_f32(job->dtype, v, job->dim, job->score_dim, scratch);
+            x = scratch;
+        }
+        float score;
+        hsd_status_t status = job->kernel((const float *)job->query, x, job->score_dim, &score);
+        if (status != HSD_SUCCESS) return status;
+        if (job->metric == HSD_METRIC_COSINE) {
+            float norm;
+            if (job->norms != NULL) {
+                norm = job->norms[row];
+            } else {
+                status = hsd_sim_dot_f32(x, x, job->score_dim, &norm);
+                if (status != HSD_SUCCESS) return status;
+                norm = sqrtf(norm);
+            }
+            score = hsd_internal_cosine_from_dot(score, job->query_norm, norm);
+        }
+        hsd_internal_topk_push(heap, similarity ? -score : score, job->first_row + row);
+    }
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t vecfile_scan_pass(hsd_vecfile_scan_job_t *job, hsd_internal_topk_t *heap) {
+    size_t blocks = (job->count + HSD_VECFILE_SCAN_BLOCK - 1) / HSD_VECFILE_SCAN_BLOCK;
+    if (blocks == 0) return HSD_SUCCESS;
+    size_t slots = hsd_get_num_threads();
+    if (slots > blocks) slots = blocks;
+
+    job->heaps = (hsd_internal_topk_t *)calloc(blocks, sizeof(hsd_internal_topk_t));
+    hsd_status_t status = job->heaps != NULL ? HSD_SUCCESS : HSD_ERR_OUT_OF_MEMORY;
+    for (size_t b = 0; status == HSD_SUCCESS && b < blocks; ++b)
+        status = hsd_internal_topk_init(&job->heaps[b], heap->k);
+    if (status == HSD_SUCCESS)
+        status = hsd_internal_parallel_for(blocks, slots, vecfile_scan_task, job);
+    for (size_t b = 0; job->heaps != NULL && b < blocks; ++b) {
+        const hsd_internal_topk_t *part = &job->heaps[b];
+        for (size_t i = 0; status == HSD_SUCCESS && i < part->size; ++i)
+            hsd_internal_topk_push(heap, part->keys[i], part->ids[i]);
+        hsd_internal_topk_free(&job->heaps[b]);
+    }
+    free(job->heaps);
+    job->heaps = NULL;
+    return status;
+}
+
+static void vecfile_end_search(hsd_vecfile_scan_job_t *job) {
+    hsd_internal_aligned_free(job->query);
+    hsd_internal_aligned_free(job->scratch);
+}
+
+/* Checks the metric, picks the kernel, and copies the query into the padded row layout. */
+static hsd_status_t vecfile_begin_search(hsd_vecfile_scan_job_t *job, HSD_DType dtype, size_t dim,
+                                         size_t row_bytes, const void *query, HSD_Metric metric) {
+    memset(job, 0, sizeof(*job));
+    bool binary = dtype == HSD_DTYPE_U8;
+    if (binary != (metric == HSD_METRIC_HAMMING)) return HSD_ERR_INVALID_INPUT;
+    if (metric != HSD_METRIC_SQEUCLIDEAN && metric != HSD_METRIC_MANHATTAN &&
+        metric != HSD_METRIC_DOT && metric != HSD_METRIC_COSINE && metric != HSD_METRIC_HAMMING)
+        return HSD_ERR_INVALID_INPUT;
+
+    job->dtype = dtype;
+    job->dim = dim;
+    job->row_bytes = row_bytes;
+    job->metric = metric;
+    job->score_dim = binary ? row_bytes : row_bytes / vecfile_elem_size(dtype);
+    switch (metric) {
+        case HSD_METRIC_SQEUCLIDEAN:
+            job->kernel = hsd_dist_sqeuclidean_f32;
+            break;
+        case HSD_METRIC_MANHATTAN:
+            job->kernel = hsd_dist_manhattan_f32;
+            break;
+        default:
+            job->kernel = hsd_sim_dot_f32;
+            break;
+    }
+
+    job->query = hsd_internal_aligned_alloc(binary ? row_bytes : job->score_dim * sizeof(float));
+    if (dtype == HSD_DTYPE_F16)
+        job->scratch = (float *)hsd_internal_aligned_alloc(hsd_get_num_threads() *
+                                                           job->score_dim * sizeof(float));
+    if (job->query == NULL || (dtype == HSD_DTYPE_F16 && job->scratch == NULL)) {
+        vecfile_end_search(job);
+        return HSD_ERR_OUT_OF_MEMORY;
+    }
+    if (binary) {
+        memcpy(job->query, query, dim);
+        memset((unsigned char *)job->query + dim, 0, row_bytes - dim);
+        return HSD_SUCCESS;
+    }
+    vecfile_to_f32(dtype, query, dim, job->score_dim, (float *)job->query);
+    if (metric != HSD_METRIC_COSINE) return HSD_SUCCESS;
+    hsd_status_t status = hsd_sim_dot_f32((const float *)job->query, (const float *)job->query,
+                                          job->score_dim, &job->query_norm);
+    job->query_norm = sqrtf(job->query_norm);
+    if (status != HSD_SUCCESS) vecfile_end_search(job);
+    return status;
+}
+
+static void vecfile_finish_heap(hsd_internal_topk_t *heap, HSD_Metric metric, uint64_t *rows,
+                                float *scores, size_t *found) {
+    *found = hsd_internal_topk_finish(heap, rows, scores);
+    if (scores != NULL && hsd_internal_metric_is_similarity(metric)) {
+        for (size_t i = 0; i < *found; ++i) scores[i] = -scores[i];
+    }
+}
+
+hsd_status_t hsd_vecfile_search(const hsd_vecfile_t *file, const void *query, HSD_Metric metric,
+                                size_t k, uint64_t *rows, float *scores, size_t *found) {
+    if (found == NULL) return HSD_ERR_NULL_PTR;
+    *found = 0;
+    if (file == NULL || query == NULL || (k > 0 && rows == NULL)) return HSD_ERR_NULL_PTR;
+
+    hsd_vecfile_scan_job_t job;
+    hsd_status_t status =
+        vecfile_begin_search(&job, file->dtype, file->dim, file->row_bytes, query, metric);
+    if (status != HSD_SUCCESS) return status;
+    hsd_internal_topk_t heap;
+    if (k > 0 && file->count > 0 && (status = hsd_internal_topk_init(&heap, k)) == HSD_SUCCESS) {
+        job.mapped = file;
+        job.rows = file->rows;
+        job.norms = file->norms;
+        job.count = file->count;
+        status = vecfile_scan_pass(&job, &heap);
+        if (status == HSD_SUCCESS) vecfile_finish_heap(&heap, metric, rows, scores, found);
+        hsd_internal_topk_free(&heap);
+    }
+    vecfile_end_search(&job);
+    return status;
+}
+
+#if !defined(_WIN32)
+/*
+ * Streaming pipeline. A reader thread fills a ring of `depth` buffers with consecutive chunks
+ * of rows (and their norms) using pread, while the calling thread scores the oldest filled
+ * buffer on the thread pool, so disk reads overlap with the kernels and memory use stays at
+ * depth * chunk_bytes whatever the file size.
+ */
+typedef struct {
+    unsigned char *rows;
+    float *norms;
+    size_t count;
+    uint64_t first_row;
+    bool ready;
+} hsd_vecfile_buffer_t;
+
+typedef struct {
+    int fd;
+    hsd_vecfile_header_t header;
+    size_t chunk_rows;
+    size_t depth;
+    hsd_vecfile_buffer_t *buffers;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool stop;
+    hsd_status_t status;
+} hsd_vecfile_stream_t;
+
+static bool vecfile_pread_full(int fd, void *dst, size_t bytes, uint64_t offset) {
+    size_t done = 0;
+    while (done < bytes) {
+        ssize_t n = pread(fd, (unsigned char *)dst + done, bytes - done, (off_t)(offset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += (size_t)n;
+    }
+    return true;
+}
+
+static void *vecfile_reader_main(void *arg) {
+    hsd_vecfile_stream_t *stream = (hsd_vecfile_stream_t *)arg;
+    const hsd_vecfile_header_t *h = &stream->header;
+    for (uint64_t first = 0, chunk = 0; first < h->count; first += stream->chunk_rows, ++chunk) {
+        hsd_vecfile_buffer_t *buffer = &stream->buffers[chunk % stream->depth];
+        pthread_mutex_lock(&stream->mutex);
+        while (buffer->ready && !stream->stop) pthread_cond_wait(&stream->cond, &stream->mutex);
+        bool stop = stream->stop;
+        pthread_mutex_unlock(&stream->mutex);
+        if (stop) break;
+
+        size_t rows = (size_t)(h->count - first < stream->chunk_rows ? h->count - first
+                                                                     : stream->chunk_rows);
+        bool ok = vecfile_pread_full(stream->fd, buffer->rows, rows * h->row_bytes,
+                                     h->data_offset + first * h->row_bytes);
+        if (ok && buffer->norms != NULL)
+            ok = vecfile_pread_full(stream->fd, buffer->norms, rows * sizeof(float),
+                                    h->norms_offset + first * sizeof(float));
+
+        pthread_mutex_lock(&stream->mutex);
+        buffer->count = rows;
+        buffer->first_row = first;
+        buffer->ready = ok;
+        if (!ok) stream->status = HSD_FAILURE;
+        pthread_cond_broadcast(&stream->cond);
+        pthread_mutex_unlock(&stream->mutex);
+        if (!ok) break;
+    }
+    return NULL;
+}
+
+static hsd_status_t vecfile_stream_scan(hsd_vecfile_stream_t *stream, hsd_vecfile_scan_job_t *job,
+                                        hsd_internal_topk_t *heap) {
+    pthread_t reader;
+    if (pthread_create(&reader, NULL, vecfile_reader_main, stream) != 0) return HSD_FAILURE;
+
+    hsd_status_t status = HSD_SUCCESS;
+    const uint64_t count = stream->header.count;
+    for (uint64_t first = 0, chunk = 0; first < count; first += stream->chunk_rows, ++chunk) {
+        hsd_vecfile_buffer_t *buffer = &stream->buffers[chunk % stream->depth];
+        pthread_mutex_lock(&stream->mutex);
+        while (!buffer->ready && stream->status == HSD_SUCCESS)
+            pthread_cond_wait(&stream->cond, &stream->mutex);
+        status = stream->status;
+        pthread_mutex_unlock(&stream->mutex);
+        if (status != HSD_SUCCESS) break;
+
+        job->rows = buffer->rows;
+        job->norms = buffer->norms;
+        job->count = buffer->count;
+        job->first_row = buffer->first_row;
+        status = vecfile_scan_pass(job, heap);
+
+        pthread_mutex_lock(&stream->mutex);
+        buffer->ready = false;
+        if (status != HSD_SUCCESS) stream->stop = true;
+        pthread_cond_broadcast(&stream->cond);
+        pthread_mutex_unlock(&stream->mutex);
+        if (status != HSD_SUCCESS) break;
+    }
+
+    pthread_mutex_lock(&stream->mutex);
+    stream->stop = true;
+    pthread_cond_broadcast(&stream->cond);
+    pthread_mutex_unlock(&stream->mutex);
+    pthread_join(reader, NULL);
+    return status;
+}
+
+static void vecfile_stream_free(hsd_vecfile_stream_t *stream) {
+    for (size_t i = 0; stream->buffers != NULL && i < stream->depth; ++i) {
+        hsd_internal_aligned_free(stream->buffers[i].rows);
+        free(stream->buffers[i].norms);
+    }
+    free(stream->buffers);
+    pthread_cond_destroy(&stream->cond);
+    pthread_mutex_destroy(&stream->mutex);
+    if (stream->fd >= 0) close(stream->fd);
+}
+
+/* Opens the file, validates its header and allocates the buffer ring. */
+static hsd_status_t vecfile_stream_open(hsd_vecfile_stream_t *stream, const char *path,
+                                        const hsd_stream_params_t *params, bool need_norms) {
+    memset(stream, 0, sizeof(*stream));
+    pthread_mutex_init(&stream->mutex, NULL);
+    pthread_cond_init(&stream->cond, NULL);
+    stream->status = HSD_SUCCESS;
+    stream->fd = open(path, O_RDONLY);
+    if (stream->fd < 0) return HSD_FAILURE;
+
+    struct stat st;
+    if (fstat(stream->fd, &st) != 0) return HSD_FAILURE;
+    if ((uint64_t)st.st_size < sizeof(stream->header)) return HSD_ERR_INVALID_INPUT;
+    if (!vecfile_pread_full(stream->fd, &stream->header, sizeof(stream->header), 0))
+        return HSD_FAILURE;
+    if (!vecfile_header_valid(&stream->header, (uint64_t)st.st_size)) return HSD_ERR_INVALID_INPUT;
+
+    size_t chunk_bytes = params != NULL && params->chunk_bytes ? params->chunk_bytes
+                                                               : HSD_VECFILE_STREAM_CHUNK_BYTES;
+    stream->chunk_rows = chunk_bytes / (size_t)stream->header.row_bytes;
+    if (stream->chunk_rows > stream->header.count)
+        stream->chunk_rows = (size_t)stream->header.count;
+    if (stream->chunk_rows == 0) stream->chunk_rows = 1;
+    stream->depth = params != NULL && params->depth ? params->depth : 2;
+    if (stream->depth < 2) stream->depth = 2;
+    if (stream->depth > HSD_VECFILE_STREAM_MAX_DEPTH) stream->depth = HSD_VECFILE_STREAM_MAX_DEPTH;
+
+    stream->buffers = (hsd_vecfile_buffer_t *)calloc(stream->depth, sizeof(hsd_vecfile_buffer_t));
+    if (stream->buffers == NULL) return HSD_ERR_OUT_OF_MEMORY;
+    bool with_norms = need_norms && stream->header.norms_offset != 0;
+    for (size_t i = 0; i < stream->depth; ++i) {
+        hsd_vecfile_buffer_t *buffer = &stream->buffers[i];
+        buffer->rows = (unsigned char *)hsd_internal_aligned_alloc(
+            stream->chunk_rows * (size_t)stream->header.row_bytes);
+        if (buffer->rows == NULL) return HSD_ERR_OUT_OF_MEMORY;
+        if (with_norms) {
+            buffer->norms = (float *)malloc(stream->chunk_rows * sizeof(float));
+            if (buffer->norms == NULL) return HSD_ERR_OUT_OF_MEMORY;
+        }
+    }
+    posix_fadvise(stream->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return HSD_SUCCESS;
+}
+#endif
+
+hsd_status_t hsd_vecfile_stream_search(const char *path, const void *query, HSD_Metric metric,
+                                       size_t k, const hsd_stream_params_t *params,
+                                       uint64_t *rows, float *scores, size_t *found) {
+    if (found == NULL) return HSD_ERR_NULL_PTR;
+    *found = 0;
+    if (path == NULL || query == NULL || (k > 0 && rows == NULL)) return HSD_ERR_NULL_PTR;
+#if defined(_WIN32)
+    (void)metric;
+    (void)params;
+    (void)scores;
+    return HSD_ERR_UNSUPPORTED;
+#else
+    hsd_vecfile_stream_t stream;
+    hsd_status_t status = vecfile_stream_open(&stream, path, params, metric == HSD_METRIC_COSINE);
+    if (status != HSD_SUCCESS) {
+        vecfile_stream_free(&stream);
+        return status;
+    }
+    hsd_log("Vecfile stream: %llu rows, chunk=%zu rows, depth=%zu",
+            (unsigned long long)stream.header.count, stream.chunk_rows, stream.depth);
+
+    hsd_vecfile_scan_job_t job;
+    const hsd_vecfile_header_t *h = &stream.header;
+    status = vecfile_begin_search(&job, (HSD_DType)h->dtype, (size_t)h->dim,
+                                  (size_t)h->row_bytes, query, metric);
+    if (status != HSD_SUCCESS) {
+        vecfile_stream_free(&stream);
+        return status;
+    }
+    hsd_internal_topk_t heap;
+    if (k > 0 && h->count > 0 && (status = hsd_internal_topk_init(&heap, k)) == HSD_SUCCESS) {
+        status = vecfile_stream_scan(&stream, &job, &heap);
+        if (status == HSD_SUCCESS) vecfile_finish_heap(&heap, metric, rows, scores, found);
+        hsd_internal_topk_free(&heap);
+    }
+    vecfile_end_search(&job);
+    vecfile_stream_free(&stream);
+    return status;
+#endif
+}
@@ -0,0 +1,395 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#define HSD_POOL_MAX_THREADS 256
+
+/*
+ * A job is a range of independent tasks. hsd_internal_pool_run() queues it, works on it
+ * alongside the pool workers and waits until every participant has left before returning,
+ * so jobs can live on the caller's stack and several callers can share one pool. Jobs from
+ * hsd_internal_pool_submit() are left to the workers until hsd_internal_pool_wait().
+ */
+struct hsd_internal_pool_job {
+    hsd_internal_task_fn_t fn;
+    void *ctx;
+    size_t tasks;
+    size_t max_slots;
+    atomic_size_t next_task;
+    atomic_int status;
+    size_t slots;
+    size_t active;
+    bool queued;
+    bool pooled;
+    pthread_cond_t done;
+    struct hsd_internal_pool_job *next;
+};
+
+struct hsd_internal_pool {
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    hsd_internal_pool_job_t *head;
+    hsd_internal_pool_job_t *tail;
+    bool stop;
+    size_t width;
+    size_t started;
+    pthread_t *workers;
+    int *cpus;
+    size_t cpu_count;
+    size_t refs;
+    bool retired;
+};
+
+typedef struct {
+    hsd_internal_pool_t *pool;
+    size_t index;
+} hsd_pool_worker_arg_t;
+
+static bool pool_job_exhausted(hsd_internal_pool_job_t *job) {
+    return atomic_load_explicit(&job->next_task, memory_order_relaxed) >= job->tasks ||
+           atomic_load_explicit(&job->status, memory_order_relaxed) != HSD_SUCCESS;
+}
+
+static void pool_unlink(hsd_internal_pool_t *pool, hsd_internal_pool_job_t *job) {
+    if (!job->queued) return;
+    hsd_internal_pool_job_t **link = &pool->head;
+    hsd_internal_pool_job_t *prev = NULL;
+    while (*link != job) {
+        prev = *link;
+        link = &(*link)->next;
+    }
+    *link = job->next;
+    if (pool->tail == job) pool->tail = prev;
+    job->queued = false;
+}
+
+static void pool_run_job(hsd_internal_pool_job_t *job, size_t slot) {
+    for (;;) {
+        if (atomic_load_explicit(&job->status, memory_order_relaxed) != HSD_SUCCESS) break;
+        size_t task = atomic_fetch_add(&job->next_task, 1);
+        if (task >= job->tasks) break;
+        hsd_status_t status = job->fn(job->ctx, task, slot);
+        if (status != HSD_SUCCESS) {
+            int expected = HSD_SUCCESS;
+            atomic_compare_exchange_strong(&job->status, &expected, status);
+        }
+    }
+}
+
+/* Called with the pool mutex held: finds a queued job that still has tasks and a free slot. */
+static hsd_internal_pool_job_t *pool_take_job(hsd_internal_pool_t *pool, size_t *slot) {
+    hsd_internal_pool_job_t *job = pool->head;
+    while (job != NULL) {
+        hsd_internal_pool_job_t *next = job->next;
+        if (pool_job_exhausted(job)) {
+            pool_unlink(pool, job);
+        } else if (job->slots < job->max_slots) {
+            *slot = job->slots++;
+            job->active++;
+            return job;
+        }
+        job = next;
+    }
+    return NULL;
+}
+
+static void pool_leave_job(hsd_internal_pool_t *pool, hsd_internal_pool_job_t *job) {
+    pthread_mutex_lock(&pool->mutex);
+    if (--job->active == 0) pthread_cond_broadcast(&job->done);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void *pool_worker_main(void *arg) {
+    hsd_pool_worker_arg_t *worker = (hsd_pool_worker_arg_t *)arg;
+    hsd_internal_pool_t *pool = worker->pool;
+#if defined(__linux__)
+    if (pool->cpu_count > 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(pool->cpus[worker->index % pool->cpu_count], &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+    free(worker);
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        size_t slot = 0;
+        hsd_internal_pool_job_t *job = NULL;
+        while (!pool->stop && (job = pool_take_job(pool, &slot)) == NULL)
+            pthread_cond_wait(&pool->wake, &pool->mutex);
+        if (job == NULL) break;
+        pthread_mutex_unlock(&pool->mutex);
+        pool_run_job(job, slot);
+        pool_leave_job(pool, job);
+        pthread_mutex_lock(&pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+hsd_internal_pool_t *hsd_internal_pool_create(size_t width, const int *cpus, size_t cpu_count) {
+    if (width == 0) width = 1;
+    if (width > HSD_POOL_MAX_THREADS) width = HSD_POOL_MAX_THREADS;
+    hsd_internal_pool_t *pool = (hsd_internal_pool_t *)calloc(1, sizeof(*pool));
+    if (pool == NULL) return NULL;
+    pool->width = width;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    if (cpu_count > 0) {
+        pool->cpus = (int *)malloc(cpu_count * sizeof(int));
+        if (pool->cpus == NULL) {
+            hsd_internal_pool_destroy(pool);
+            return NULL;
+        }
+        memcpy(pool->cpus, cpus, cpu_count * sizeof(int));
+        pool->cpu_count = cpu_count;
+    }
+
+    /* The submitting thread always takes part, so width - 1 workers saturate the pool. */
+    if (width > 1) {
+        pool->workers = (pthread_t *)malloc((width - 1) * sizeof(pthread_t));
+        if (pool->workers == NULL) {
+            hsd_internal_pool_destroy(pool);
+            return NULL;
+        }
+    }
+    for (size_t i = 0; i + 1 < width; ++i) {
+        hsd_pool_worker_arg_t *arg = (hsd_pool_worker_arg_t *)malloc(sizeof(*arg));
+        if (arg == NULL) break;
+        arg->pool = pool;
+        arg->index = i;
+        if (pthread_create(&pool->workers[i], NULL, pool_worker_main, arg) != 0) {
+            free(arg);
+            break;
+        }
+        pool->started++;
+    }
+    hsd_log("Thread pool: width=%zu workers=%zu pinned=%zu", width, pool->started, cpu_count);
+    return pool;
+}
+
+void hsd_internal_pool_destroy(hsd_internal_pool_t *pool) {
+    if (pool == NULL) return;
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+    for (size_t i = 0; i < pool->started; ++i) pthread_join(pool->workers[i], NULL);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->workers);
+    free(pool->cpus);
+    free(pool);
+}
+
+size_t hsd_internal_pool_width(const hsd_internal_pool_t *pool) {
+    return pool == NULL ? 1 : pool->started + 1;
+}
+
+static void pool_job_init(hsd_internal_pool_job_t *job, size_t tasks, size_t max_slots,
+                          hsd_internal_task_fn_t fn, void *ctx) {
+    job->fn = fn;
+    job->ctx = ctx;
+    job->tasks = tasks;
+    job->max_slots = max_slots == 0 ? 1 : max_slots;
+    atomic_init(&job->next_task, 0);
+    atomic_init(&job->status, HSD_SUCCESS);
+    job->slots = 0;
+    job->active = 0;
+    job->queued = false;
+    job->pooled = false;
+    job->next = NULL;
+    pthread_cond_init(&job->done, NULL);
+}
+
+/* Called with the pool mutex held. */
+static void pool_enqueue(hsd_internal_pool_t *pool, hsd_internal_pool_job_t *job) {
+    job->queued = true;
+    job->pooled = true;
+    if (pool->tail != NULL)
+        pool->tail->next = job;
+    else
+        pool->head = job;
+    pool->tail = job;
+    pthread_cond_broadcast(&pool->wake);
+}
+
+/* Waits until every task is claimed and every participant has left, then retires the job. */
+static hsd_status_t pool_finish(hsd_internal_pool_t *pool, hsd_internal_pool_job_t *job) {
+    pthread_mutex_lock(&pool->mutex);
+    while (job->active > 0 || !pool_job_exhausted(job))
+        pthread_cond_wait(&job->done, &pool->mutex);
+    pool_unlink(pool, job);
+    pthread_mutex_unlock(&pool->mutex);
+    pthread_cond_destroy(&job->done);
+    return (hsd_status_t)atomic_load(&job->status);
+}
+
+hsd_status_t hsd_internal_pool_run(hsd_internal_pool_t *pool, size_t tasks, size_t max_slots,
+                                   hsd_internal_task_fn_t fn, void *ctx) {
+    if (tasks == 0) return HSD_SUCCESS;
+    if (max_slots == 0) max_slots = 1;
+
+    /* Nothing to share: run inline without touching the queue. */
+    if (pool == NULL || pool->started == 0 || tasks == 1 || max_slots == 1) {
+        for (size_t t = 0; t < tasks; ++t) {
+            hsd_status_t status = fn(ctx, t, 0);
+            if (status != HSD_SUCCESS) return status;
+        }
+        return HSD_SUCCESS;
+    }
+
+    hsd_internal_pool_job_t job;
+    pool_job_init(&job, tasks, max_slots, fn, ctx);
+    job.slots = 1;
+    job.active = 1;
+    pthread_mutex_lock(&pool->mutex);
+    pool_enqueue(pool, &job);
+    pthread_mutex_unlock(&pool->mutex);
+
+    pool_run_job(&job, 0);
+    pool_leave_job(pool, &job);
+    return pool_finish(pool, &job);
+}
+
+hsd_internal_pool_job_t *hsd_internal_pool_submit(hsd_internal_pool_t *pool, size_t tasks,
+                                                  size_t max_slots, hsd_internal_task_fn_t fn,
+                                                  void *ctx) {
+    hsd_internal_pool_job_t *job = (hsd_internal_pool_job_t *)malloc(sizeof(*job));
+    if (job == NULL) return NULL;
+    pool_job_init(job, tasks, max_slots, fn, ctx);
+    if (pool != NULL && pool->started > 0 && tasks > 0) {
+        pthread_mutex_lock(&pool->mutex);
+        pool_enqueue(pool, job);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    return job;
+}
+
+hsd_status_t hsd_internal_pool_wait(hsd_internal_pool_t *pool, hsd_internal_pool_job_t *job) {
+    if (job == NULL) return HSD_ERR_NULL_PTR;
+    hsd_status_t status;
+    if (job->pooled) {
+        status = pool_finish(pool, job);
+    } else {
+        /* No worker to hand the job to: the waiting thread runs it. */
+        pool_run_job(job, 0);
+        pthread_cond_destroy(&job->done);
+        status = (hsd_status_t)atomic_load(&job->status);
+    }
+    free(job);
+    return status;
+}
+
+/*
+ * Process-wide pool used by the batch, matrix and index APIs. It is created on first use and
+ * replaced when the thread count or affinity changes; a replaced pool is destroyed once the
+ * last call still running on it returns.
+ */
+static pthread_mutex_t hsd_global_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static hsd_internal_pool_t *hsd_global_pool = NULL;
+static size_t hsd_global_threads = 0;
+static int *hsd_global_cpus = NULL;
+static size_t hsd_global_cpu_count = 0;
+
+static size_t pool_default_threads(void) {
+    long online = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+    online = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    size_t threads = online > 0 ? (size_t)online : 1;
+    return threads > HSD_POOL_MAX_THREADS ? HSD_POOL_MAX_THREADS : threads;
+}
+
+/* Called with the global mutex held. */
+static void pool_retire_global(void) {
+    hsd_internal_pool_t *old = hsd_global_pool;
+    hsd_global_pool = NULL;
+    if (old == NULL) return;
+    old->retired = true;
+    if (old->refs == 0) hsd_internal_pool_destroy(old);
+}
+
+hsd_internal_pool_t *hsd_internal_pool_acquire(void) {
+    pthread_mutex_lock(&hsd_global_pool_mutex);
+    if (hsd_global_pool == NULL) {
+        size_t threads = hsd_global_threads ? hsd_global_threads : pool_default_threads();
+        hsd_global_pool =
+            hsd_internal_pool_create(threads, hsd_global_cpus, hsd_global_cpu_count);
+    }
+    hsd_internal_pool_t *pool = hsd_global_pool;
+    if (pool != NULL) pool->refs++;
+    pthread_mutex_unlock(&hsd_global_pool_mutex);
+    return pool;
+}
+
+void hsd_internal_pool_release(hsd_internal_pool_t *pool) {
+    if (pool == NULL) return;
+    pthread_mutex_lock(&hsd_global_pool_mutex);
+    bool destroy = --pool->refs == 0 && pool->retired;
+    pthread_mutex_unlock(&hsd_global_pool_mutex);
+    if (destroy) hsd_internal_pool_destroy(pool);
+}
+
+hsd_status_t hsd_internal_parallel_for(size_t tasks, size_t max_slots, hsd_internal_task_fn_t fn,
+                                       void *ctx) {
+    if (tasks <= 1 || max_slots <= 1) return hsd_internal_pool_run(NULL, tasks, 1, fn, ctx);
+    hsd_internal_pool_t *pool = hsd_internal_pool_acquire();
+    hsd_status_t status = hsd_internal_pool_run(pool, tasks, max_slots, fn, ctx);
+    hsd_internal_pool_release(pool);
+    return status;
+}
+
+hsd_status_t hsd_set_num_threads(size_t num_threads) {
+    if (num_threads > HSD_POOL_MAX_THREADS) return HSD_ERR_INVALID_INPUT;
+    pthread_mutex_lock(&hsd_global_pool_mutex);
+    hsd_global_threads = num_threads;
+    pool_retire_global();
+    pthread_mutex_unlock(&hsd_global_pool_mutex);
+    hsd_log("Thread pool: thread count set to %zu", num_threads);
+    return HSD_SUCCESS;
+}
+
+size_t hsd_get_num_threads(void) {
+    pthread_mutex_lock(&hsd_global_pool_mutex);
+    size_t threads = hsd_global_threads ? hsd_global_threads : pool_default_threads();
+    pthread_mutex_unlock(&hsd_global_pool_mutex);
+    return threads;
+}
+
+hsd_status_t hsd_set_thread_affinity(const int *cpus, size_t count) {
+    if (cpus == NULL && count > 0) return HSD_ERR_NULL_PTR;
+#if !defined(__linux__)
+    if (count > 0) return HSD_ERR_UNSUPPORTED;
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        if (cpus[i] < 0) return HSD_ERR_INVALID_INPUT;
+    }
+    int *copy = NULL;
+    if (count > 0) {
+        copy = (int *)malloc(count * sizeof(int));
+        if (copy == NULL) return HSD_ERR_OUT_OF_MEMORY;
+        memcpy(copy, cpus, count * sizeof(int));
+    }
+    pthread_mutex_lock(&hsd_global_pool_mutex);
+    free(hsd_global_cpus);
+    hsd_global_cpus = copy;
+    hsd_global_cpu_count = count;
+    pool_retire_global();
+    pthread_mutex_unlock(&hsd_global_pool_mutex);
+    return HSD_SUCCESS;
+}
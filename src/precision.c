@@ -0,0 +1,584 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/*
+ * f64-accumulating kernels behind HSD_PRECISION_F64. Every input is widened to double before it
+ * is used; the product of two floats is exact in double, so the only rounding left is in the
+ * additions, which have 29 more bits of headroom than in f32. Kernels return raw sums and the
+ * public functions finish the metric.
+ */
+typedef struct {
+    double (*dot)(const float *a, const float *b, size_t n);
+    double (*sq_diff)(const float *a, const float *b, size_t n);
+    double (*weighted_sq_diff)(const float *a, const float *b, const float *w, size_t n);
+    double (*abs_diff)(const float *a, const float *b, size_t n);
+    void (*cosine)(const float *a, const float *b, size_t n, double sums[3]);
+    double (*sum_sq)(const float *v, size_t n);
+    double (*sum_abs)(const float *v, size_t n);
+    void (*moments)(const float *a, const float *b, size_t n, double ka, double kb,
+                    double sums[5]);
+    const char *name;
+} hsd_precise_kernels_t;
+
+static atomic_int hsd_precision_mode = ATOMIC_VAR_INIT(HSD_PRECISION_FAST);
+
+hsd_status_t hsd_set_precision(HSD_Precision precision) {
+    if (precision != HSD_PRECISION_FAST && precision != HSD_PRECISION_F64 &&
+        precision != HSD_PRECISION_DETERMINISTIC)
+        return HSD_ERR_INVALID_INPUT;
+    hsd_log("Setting precision mode to: %d", precision);
+    atomic_store_explicit(&hsd_precision_mode, precision, memory_order_release);
+    return HSD_SUCCESS;
+}
+
+HSD_Precision hsd_get_precision(void) {
+    return (HSD_Precision)atomic_load_explicit(&hsd_precision_mode, memory_order_relaxed);
+}
+
+static double precise_dot_scalar(const float *a, const float *b, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += (double)a[i] * (double)b[i];
+    return sum;
+}
+
+static double precise_sq_diff_scalar(const float *a, const float *b, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double d = (double)a[i] - (double)b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+static double precise_weighted_sq_diff_scalar(const float *a, const float *b, const float *w,
+                                              size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double d = (double)a[i] - (double)b[i];
+        sum += (double)w[i] * d * d;
+    }
+    return sum;
+}
+
+static double precise_abs_diff_scalar(const float *a, const float *b, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += fabs((double)a[i] - (double)b[i]);
+    return sum;
+}
+
+static void precise_cosine_scalar(const float *a, const float *b, size_t n, double sums[3]) {
+    double dot = 0.0, na = 0.0, nb = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double x = a[i], y = b[i];
+        dot += x * y;
+        na += x * x;
+        nb += y * y;
+    }
+    sums[0] = dot;
+    sums[1] = na;
+    sums[2] = nb;
+}
+
+static double precise_sum_sq_scalar(const float *v, size_t n) {
+    return precise_dot_scalar(v, v, n);
+}
+
+static double precise_sum_abs_scalar(const float *v, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += fabs((double)v[i]);
+    return sum;
+}
+
+/* Shifted Pearson moments {sum(x), sum(y), sum(xy), sum(x^2), sum(y^2)}, x = a - ka, y = b - kb. */
+static void precise_moments_scalar(const float *a, const float *b, size_t n, double ka,
+                                   double kb, double sums[5]) {
+    for (int k = 0; k < 5; ++k) sums[k] = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double x = (double)a[i] - ka, y = (double)b[i] - kb;
+        sums[0] += x;
+        sums[1] += y;
+        sums[2] += x * y;
+        sums[3] += x * x;
+        sums[4] += y * y;
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static inline double precise_hsum_avx(__m256d acc) {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+/* Each step widens eight floats into two registers of four doubles. */
+__attribute__((target("avx"))) static double precise_dot_avx(const float *a, const float *b,
+                                                             size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)),
+                                                 _mm256_cvtps_pd(_mm_loadu_ps(b + i))));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)),
+                                                 _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4))));
+    }
+    return precise_hsum_avx(_mm256_add_pd(acc0, acc1)) + precise_dot_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx"))) static double precise_sq_diff_avx(const float *a, const float *b,
+                                                                 size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d d0 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)),
+                                   _mm256_cvtps_pd(_mm_loadu_ps(b + i)));
+        __m256d d1 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)),
+                                   _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4)));
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(d0, d0));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(d1, d1));
+    }
+    return precise_hsum_avx(_mm256_add_pd(acc0, acc1)) +
+           precise_sq_diff_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx"))) static double precise_weighted_sq_diff_avx(const float *a,
+                                                                          const float *b,
+                                                                          const float *w,
+                                                                          size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d d0 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)),
+                                   _mm256_cvtps_pd(_mm_loadu_ps(b + i)));
+        __m256d d1 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)),
+                                   _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4)));
+        __m256d w0 = _mm256_cvtps_pd(_mm_loadu_ps(w + i));
+        __m256d w1 = _mm256_cvtps_pd(_mm_loadu_ps(w + i + 4));
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_mul_pd(w0, d0), d0));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_mul_pd(w1, d1), d1));
+    }
+    return precise_hsum_avx(_mm256_add_pd(acc0, acc1)) +
+           precise_weighted_sq_diff_scalar(a + i, b + i, w + i, n - i);
+}
+
+__attribute__((target("avx"))) static double precise_abs_diff_avx(const float *a, const float *b,
+                                                                  size_t n) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d d0 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)),
+                                   _mm256_cvtps_pd(_mm_loadu_ps(b + i)));
+        __m256d d1 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)),
+                                   _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4)));
+        acc0 = _mm256_add_pd(acc0, _mm256_andnot_pd(sign, d0));
+        acc1 = _mm256_add_pd(acc1, _mm256_andnot_pd(sign, d1));
+    }
+    return precise_hsum_avx(_mm256_add_pd(acc0, acc1)) +
+           precise_abs_diff_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx"))) static void precise_cosine_avx(const float *a, const float *b,
+                                                              size_t n, double sums[3]) {
+    __m256d dot = _mm256_setzero_pd(), na = _mm256_setzero_pd(), nb = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(a + i));
+        __m256d y = _mm256_cvtps_pd(_mm_loadu_ps(b + i));
+        dot = _mm256_add_pd(dot, _mm256_mul_pd(x, y));
+        na = _mm256_add_pd(na, _mm256_mul_pd(x, x));
+        nb = _mm256_add_pd(nb, _mm256_mul_pd(y, y));
+    }
+    precise_cosine_scalar(a + i, b + i, n - i, sums);
+    sums[0] += precise_hsum_avx(dot);
+    sums[1] += precise_hsum_avx(na);
+    sums[2] += precise_hsum_avx(nb);
+}
+
+__attribute__((target("avx"))) static double precise_sum_sq_avx(const float *v, size_t n) {
+    return precise_dot_avx(v, v, n);
+}
+
+__attribute__((target("avx"))) static double precise_sum_abs_avx(const float *v, size_t n) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_andnot_pd(sign, _mm256_cvtps_pd(_mm_loadu_ps(v + i))));
+        acc1 = _mm256_add_pd(acc1,
+                             _mm256_andnot_pd(sign, _mm256_cvtps_pd(_mm_loadu_ps(v + i + 4))));
+    }
+    return precise_hsum_avx(_mm256_add_pd(acc0, acc1)) + precise_sum_abs_scalar(v + i, n - i);
+}
+
+__attribute__((target("avx"))) static void precise_moments_avx(const float *a, const float *b,
+                                                               size_t n, double ka, double kb,
+                                                               double sums[5]) {
+    const __m256d vka = _mm256_set1_pd(ka), vkb = _mm256_set1_pd(kb);
+    __m256d sa = _mm256_setzero_pd(), sb = _mm256_setzero_pd(), sab = _mm256_setzero_pd();
+    __m256d saa = _mm256_setzero_pd(), sbb = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)), vka);
+        __m256d y = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(b + i)), vkb);
+        sa = _mm256_add_pd(sa, x);
+        sb = _mm256_add_pd(sb, y);
+        sab = _mm256_add_pd(sab, _mm256_mul_pd(x, y));
+        saa = _mm256_add_pd(saa, _mm256_mul_pd(x, x));
+        sbb = _mm256_add_pd(sbb, _mm256_mul_pd(y, y));
+    }
+    precise_moments_scalar(a + i, b + i, n - i, ka, kb, sums);
+    sums[0] += precise_hsum_avx(sa);
+    sums[1] += precise_hsum_avx(sb);
+    sums[2] += precise_hsum_avx(sab);
+    sums[3] += precise_hsum_avx(saa);
+    sums[4] += precise_hsum_avx(sbb);
+}
+
+/* Each step widens sixteen floats into two registers of eight doubles. */
+__attribute__((target("avx512f"))) static double precise_dot_avx512(const float *a,
+                                                                    const float *b, size_t n) {
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)),
+                               _mm512_cvtps_pd(_mm256_loadu_ps(b + i)), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i + 8)),
+                               _mm512_cvtps_pd(_mm256_loadu_ps(b + i + 8)), acc1);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1)) +
+           precise_dot_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static double precise_sq_diff_avx512(const float *a,
+                                                                        const float *b, size_t n) {
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d d0 = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)),
+                                   _mm512_cvtps_pd(_mm256_loadu_ps(b + i)));
+        __m512d d1 = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i + 8)),
+                                   _mm512_cvtps_pd(_mm256_loadu_ps(b + i + 8)));
+        acc0 = _mm512_fmadd_pd(d0, d0, acc0);
+        acc1 = _mm512_fmadd_pd(d1, d1, acc1);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1)) +
+           precise_sq_diff_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static double precise_weighted_sq_diff_avx512(const float *a,
+                                                                                 const float *b,
+                                                                                 const float *w,
+                                                                                 size_t n) {
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d d0 = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)),
+                                   _mm512_cvtps_pd(_mm256_loadu_ps(b + i)));
+        __m512d d1 = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i + 8)),
+                                   _mm512_cvtps_pd(_mm256_loadu_ps(b + i + 8)));
+        __m512d w0 = _mm512_cvtps_pd(_mm256_loadu_ps(w + i));
+        __m512d w1 = _mm512_cvtps_pd(_mm256_loadu_ps(w + i + 8));
+        acc0 = _mm512_fmadd_pd(_mm512_mul_pd(w0, d0), d0, acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_mul_pd(w1, d1), d1, acc1);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1)) +
+           precise_weighted_sq_diff_scalar(a + i, b + i, w + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static double precise_abs_diff_avx512(const float *a,
+                                                                         const float *b,
+                                                                         size_t n) {
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d d0 = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)),
+                                   _mm512_cvtps_pd(_mm256_loadu_ps(b + i)));
+        __m512d d1 = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i + 8)),
+                                   _mm512_cvtps_pd(_mm256_loadu_ps(b + i + 8)));
+        acc0 = _mm512_add_pd(acc0, _mm512_abs_pd(d0));
+        acc1 = _mm512_add_pd(acc1, _mm512_abs_pd(d1));
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1)) +
+           precise_abs_diff_scalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void precise_cosine_avx512(const float *a,
+                                                                    const float *b, size_t n,
+                                                                    double sums[3]) {
+    __m512d dot = _mm512_setzero_pd(), na = _mm512_setzero_pd(), nb = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d x = _mm512_cvtps_pd(_mm256_loadu_ps(a + i));
+        __m512d y = _mm512_cvtps_pd(_mm256_loadu_ps(b + i));
+        dot = _mm512_fmadd_pd(x, y, dot);
+        na = _mm512_fmadd_pd(x, x, na);
+        nb = _mm512_fmadd_pd(y, y, nb);
+    }
+    precise_cosine_scalar(a + i, b + i, n - i, sums);
+    sums[0] += _mm512_reduce_add_pd(dot);
+    sums[1] += _mm512_reduce_add_pd(na);
+    sums[2] += _mm512_reduce_add_pd(nb);
+}
+
+__attribute__((target("avx512f"))) static double precise_sum_sq_avx512(const float *v, size_t n) {
+    return precise_dot_avx512(v, v, n);
+}
+
+__attribute__((target("avx512f"))) static double precise_sum_abs_avx512(const float *v,
+                                                                        size_t n) {
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_add_pd(acc0, _mm512_abs_pd(_mm512_cvtps_pd(_mm256_loadu_ps(v + i))));
+        acc1 = _mm512_add_pd(acc1, _mm512_abs_pd(_mm512_cvtps_pd(_mm256_loadu_ps(v + i + 8))));
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1)) +
+           precise_sum_abs_scalar(v + i, n - i);
+}
+
+__attribute__((target("avx512f"))) static void precise_moments_avx512(const float *a,
+                                                                     const float *b, size_t n,
+                                                                     double ka, double kb,
+                                                                     double sums[5]) {
+    const __m512d vka = _mm512_set1_pd(ka), vkb = _mm512_set1_pd(kb);
+    __m512d sa = _mm512_setzero_pd(), sb = _mm512_setzero_pd(), sab = _mm512_setzero_pd();
+    __m512d saa = _mm512_setzero_pd(), sbb = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d x = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)), vka);
+        __m512d y = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(b + i)), vkb);
+        sa = _mm512_add_pd(sa, x);
+        sb = _mm512_add_pd(sb, y);
+        sab = _mm512_fmadd_pd(x, y, sab);
+        saa = _mm512_fmadd_pd(x, x, saa);
+        sbb = _mm512_fmadd_pd(y, y, sbb);
+    }
+    precise_moments_scalar(a + i, b + i, n - i, ka, kb, sums);
+    sums[0] += _mm512_reduce_add_pd(sa);
+    sums[1] += _mm512_reduce_add_pd(sb);
+    sums[2] += _mm512_reduce_add_pd(sab);
+    sums[3] += _mm512_reduce_add_pd(saa);
+    sums[4] += _mm512_reduce_add_pd(sbb);
+}
+#endif
+
+#if defined(__aarch64__)
+/* Each step widens four floats into two registers of two doubles; SVE hosts use these too. */
+static double precise_dot_neon(const float *a, const float *b, size_t n) {
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(a + i), y = vld1q_f32(b + i);
+        acc0 = vfmaq_f64(acc0, vcvt_f64_f32(vget_low_f32(x)), vcvt_f64_f32(vget_low_f32(y)));
+        acc1 = vfmaq_f64(acc1, vcvt_high_f64_f32(x), vcvt_high_f64_f32(y));
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) + precise_dot_scalar(a + i, b + i, n - i);
+}
+
+static double precise_sq_diff_neon(const float *a, const float *b, size_t n) {
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(a + i), y = vld1q_f32(b + i);
+        float64x2_t d0 = vsubq_f64(vcvt_f64_f32(vget_low_f32(x)), vcvt_f64_f32(vget_low_f32(y)));
+        float64x2_t d1 = vsubq_f64(vcvt_high_f64_f32(x), vcvt_high_f64_f32(y));
+        acc0 = vfmaq_f64(acc0, d0, d0);
+        acc1 = vfmaq_f64(acc1, d1, d1);
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) + precise_sq_diff_scalar(a + i, b + i, n - i);
+}
+
+static double precise_weighted_sq_diff_neon(const float *a, const float *b, const float *w,
+                                            size_t n) {
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(a + i), y = vld1q_f32(b + i), v = vld1q_f32(w + i);
+        float64x2_t d0 = vsubq_f64(vcvt_f64_f32(vget_low_f32(x)), vcvt_f64_f32(vget_low_f32(y)));
+        float64x2_t d1 = vsubq_f64(vcvt_high_f64_f32(x), vcvt_high_f64_f32(y));
+        acc0 = vfmaq_f64(acc0, vmulq_f64(vcvt_f64_f32(vget_low_f32(v)), d0), d0);
+        acc1 = vfmaq_f64(acc1, vmulq_f64(vcvt_high_f64_f32(v), d1), d1);
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) +
+           precise_weighted_sq_diff_scalar(a + i, b + i, w + i, n - i);
+}
+
+static double precise_abs_diff_neon(const float *a, const float *b, size_t n) {
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(a + i), y = vld1q_f32(b + i);
+        acc0 = vaddq_f64(acc0, vabdq_f64(vcvt_f64_f32(vget_low_f32(x)),
+                                         vcvt_f64_f32(vget_low_f32(y))));
+        acc1 = vaddq_f64(acc1, vabdq_f64(vcvt_high_f64_f32(x), vcvt_high_f64_f32(y)));
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) + precise_abs_diff_scalar(a + i, b + i, n - i);
+}
+
+static void precise_cosine_neon(const float *a, const float *b, size_t n, double sums[3]) {
+    float64x2_t dot = vdupq_n_f64(0.0), na = vdupq_n_f64(0.0), nb = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t x = vcvt_f64_f32(vld1_f32(a + i));
+        float64x2_t y = vcvt_f64_f32(vld1_f32(b + i));
+        dot = vfmaq_f64(dot, x, y);
+        na = vfmaq_f64(na, x, x);
+        nb = vfmaq_f64(nb, y, y);
+    }
+    precise_cosine_scalar(a + i, b + i, n - i, sums);
+    sums[0] += vaddvq_f64(dot);
+    sums[1] += vaddvq_f64(na);
+    sums[2] += vaddvq_f64(nb);
+}
+
+static double precise_sum_sq_neon(const float *v, size_t n) { return precise_dot_neon(v, v, n); }
+
+static double precise_sum_abs_neon(const float *v, size_t n) {
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(v + i);
+        acc0 = vaddq_f64(acc0, vabsq_f64(vcvt_f64_f32(vget_low_f32(x))));
+        acc1 = vaddq_f64(acc1, vabsq_f64(vcvt_high_f64_f32(x)));
+    }
+    return vaddvq_f64(vaddq_f64(acc0, acc1)) + precise_sum_abs_scalar(v + i, n - i);
+}
+
+static void precise_moments_neon(const float *a, const float *b, size_t n, double ka, double kb,
+                                 double sums[5]) {
+    const float64x2_t vka = vdupq_n_f64(ka), vkb = vdupq_n_f64(kb);
+    float64x2_t sa = vdupq_n_f64(0.0), sb = vdupq_n_f64(0.0), sab = vdupq_n_f64(0.0);
+    float64x2_t saa = vdupq_n_f64(0.0), sbb = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t x = vsubq_f64(vcvt_f64_f32(vld1_f32(a + i)), vka);
+        float64x2_t y = vsubq_f64(vcvt_f64_f32(vld1_f32(b + i)), vkb);
+        sa = vaddq_f64(sa, x);
+        sb = vaddq_f64(sb, y);
+        sab = vfmaq_f64(sab, x, y);
+        saa = vfmaq_f64(saa, x, x);
+        sbb = vfmaq_f64(sbb, y, y);
+    }
+    precise_moments_scalar(a + i, b + i, n - i, ka, kb, sums);
+    sums[0] += vaddvq_f64(sa);
+    sums[1] += vaddvq_f64(sb);
+    sums[2] += vaddvq_f64(sab);
+    sums[3] += vaddvq_f64(saa);
+    sums[4] += vaddvq_f64(sbb);
+}
+#endif
+
+static const hsd_precise_kernels_t precise_kernels_scalar = {
+    precise_dot_scalar,      precise_sq_diff_scalar, precise_weighted_sq_diff_scalar,
+    precise_abs_diff_scalar, precise_cosine_scalar,  precise_sum_sq_scalar,
+    precise_sum_abs_scalar,  precise_moments_scalar, "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_precise_kernels_t precise_kernels_avx = {
+    precise_dot_avx,    precise_sq_diff_avx, precise_weighted_sq_diff_avx, precise_abs_diff_avx,
+    precise_cosine_avx, precise_sum_sq_avx,  precise_sum_abs_avx,          precise_moments_avx,
+    "AVX"};
+static const hsd_precise_kernels_t precise_kernels_avx512 = {
+    precise_dot_avx512,      precise_sq_diff_avx512, precise_weighted_sq_diff_avx512,
+    precise_abs_diff_avx512, precise_cosine_avx512,  precise_sum_sq_avx512,
+    precise_sum_abs_avx512,  precise_moments_avx512, "AVX512F"};
+#elif defined(__aarch64__)
+static const hsd_precise_kernels_t precise_kernels_neon = {
+    precise_dot_neon,      precise_sq_diff_neon, precise_weighted_sq_diff_neon,
+    precise_abs_diff_neon, precise_cosine_neon,  precise_sum_sq_neon,
+    precise_sum_abs_neon,  precise_moments_neon, "NEON"};
+#endif
+
+/* AVX2 needs nothing beyond AVX here, since the products are exact and FMA cannot help. */
+static const hsd_precise_kernels_t *resolve_precise_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_precise_kernels_t *chosen = &precise_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Precise F32: Manual backend requested: %d", forced);
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) chosen = &precise_kernels_avx512;
+                break;
+            case HSD_BACKEND_AVX2:
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) chosen = &precise_kernels_avx;
+                break;
+#elif defined(__aarch64__)
+            case HSD_BACKEND_SVE:
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) chosen = &precise_kernels_neon;
+                break;
+#endif
+            default:
+                break;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &precise_kernels_avx512;
+        else if (hsd_cpu_has_avx())
+            chosen = &precise_kernels_avx;
+#elif defined(__aarch64__)
+        if (hsd_cpu_has_neon()) chosen = &precise_kernels_neon;
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Precise F32 to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_precise_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_precise_kernels_t *precise_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_precise_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_precise_kernels_t *)cur;
+    const hsd_precise_kernels_t *resolved = resolve_precise_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_precise_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+double hsd_internal_precise_dot_f32(const float *a, const float *b, size_t n) {
+    return precise_kernels()->dot(a, b, n);
+}
+
+double hsd_internal_precise_sq_diff_f32(const float *a, const float *b, size_t n) {
+    return precise_kernels()->sq_diff(a, b, n);
+}
+
+double hsd_internal_precise_weighted_sq_diff_f32(const float *a, const float *b, const float *w,
+                                                 size_t n) {
+    return precise_kernels()->weighted_sq_diff(a, b, w, n);
+}
+
+double hsd_internal_precise_abs_diff_f32(const float *a, const float *b, size_t n) {
+    return precise_kernels()->abs_diff(a, b, n);
+}
+
+void hsd_internal_precise_cosine_f32(const float *a, const float *b, size_t n, double sums[3]) {
+    precise_kernels()->cosine(a, b, n, sums);
+}
+
+double hsd_internal_precise_sum_sq_f32(const float *v, size_t n) {
+    return precise_kernels()->sum_sq(v, n);
+}
+
+double hsd_internal_precise_sum_abs_f32(const float *v, size_t n) {
+    return precise_kernels()->sum_abs(v, n);
+}
+
+void hsd_internal_precise_moments_f32(const float *a, const float *b, size_t n, double ka,
+                                      double kb, double sums[5]) {
+    precise_kernels()->moments(a, b, n, ka, kb, sums);
+}
@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include <stdio.h>
 
+#include "hsd_internal.h"
 #include "hsdlib.h"
 
 #if defined(__x86_64__) || defined(_M_X64)
@@ -268,6 +269,87 @@ __attribute__((target("+sve"))) static hsd_status_t cosine_sve_internal(const fl
 #endif
 #endif
 
+/*
+ * With both L2 norms known up front only the dot product is left to compute, so this costs the
+ * same as hsd_sim_dot_f32. Zero-vector handling and clamping match hsd_sim_cosine_f32.
+ */
+hsd_status_t hsd_sim_cosine_normed_f32(const float *a, const float *b, size_t n, float norm_a,
+                                       float norm_b, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 1.0f;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    if (!(norm_a >= 0.0f) || !(norm_b >= 0.0f) || isinf(norm_a) || isinf(norm_b)) {
+        *result = NAN;
+        return HSD_ERR_INVALID_INPUT;
+    }
+
+    float dot;
+    hsd_status_t status = hsd_sim_dot_f32(a, b, n, &dot);
+    if (status != HSD_SUCCESS) {
+        *result = NAN;
+        return status;
+    }
+    *result = hsd_internal_cosine_from_dot(dot, norm_a, norm_b);
+    return HSD_SUCCESS;
+}
+
+/*
+ * One query against `count` rows of `dim` floats whose L2 norms are already known, as returned
+ * by hsd_norms_l2_f32. Each row costs one dot product; out[i] is the similarity to row i.
+ */
+hsd_status_t hsd_sim_cosine_normed_batch_f32(const float *query, float query_norm,
+                                             const float *rows, const float *row_norms,
+                                             size_t count, size_t dim, float *out) {
+    if (count == 0) return HSD_SUCCESS;
+    if (query == NULL || rows == NULL || row_norms == NULL || out == NULL)
+        return HSD_ERR_NULL_PTR;
+    if (!(query_norm >= 0.0f) || isinf(query_norm)) return HSD_ERR_INVALID_INPUT;
+    for (size_t i = 0; i < count; ++i) {
+        if (!(row_norms[i] >= 0.0f) || isinf(row_norms[i])) return HSD_ERR_INVALID_INPUT;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        float dot = 0.0f;
+        if (dim > 0) {
+            hsd_status_t status = hsd_sim_dot_f32(query, rows + i * dim, dim, &dot);
+            if (status != HSD_SUCCESS) return status;
+        }
+        /* An empty pair counts as two zero vectors, as in hsd_sim_cosine_normed_f32. */
+        out[i] = dim == 0 ? 1.0f : hsd_internal_cosine_from_dot(dot, query_norm, row_norms[i]);
+    }
+    return HSD_SUCCESS;
+}
+
+/* HSD_PRECISION_F64 path: the sums are accumulated and the division done in double. */
+static hsd_status_t cosine_precise(const float *a, const float *b, size_t n, float *result) {
+    double sums[3];
+    hsd_internal_precise_cosine_f32(a, b, n, sums);
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(sums[0]) || isnan(sums[1]) || isnan(sums[2]) || isinf(sums[0]) ||
+        isinf(sums[1]) || isinf(sums[2])) {
+        *result = NAN;
+        return HSD_ERR_INVALID_INPUT;
+    }
+#endif
+    bool a_zero = sums[1] < FLT_MIN;
+    bool b_zero = sums[2] < FLT_MIN;
+    if (a_zero || b_zero) {
+        *result = (a_zero && b_zero) ? 1.0f : 0.0f;
+        return HSD_SUCCESS;
+    }
+    double similarity = sums[0] / (sqrt(sums[1]) * sqrt(sums[2]));
+    if (similarity > 1.0) similarity = 1.0;
+    if (similarity < -1.0) similarity = -1.0;
+    *result = (float)similarity;
+    return HSD_SUCCESS;
+}
+
 static hsd_cosine_f32_func_t resolve_cosine_f32_internal(void);
 static hsd_status_t cosine_f32_resolver_trampoline(const float *a, const float *b, size_t n,
                                                    float *result);
@@ -286,6 +368,13 @@ hsd_status_t hsd_sim_cosine_f32(const float *a, const float *b, size_t n, float
         return HSD_ERR_NULL_PTR;
     }
 
+    HSD_Precision precision = hsd_get_precision();
+    if (precision == HSD_PRECISION_F64) return cosine_precise(a, b, n, result);
+    if (precision == HSD_PRECISION_DETERMINISTIC) {
+        float sums[3];
+        hsd_internal_det_cosine_f32(a, b, n, sums);
+        return calculate_cosine_similarity_from_sums(sums[0], sums[1], sums[2], result);
+    }
     hsd_cosine_f32_func_t func =
         (hsd_cosine_f32_func_t)atomic_load_explicit(&hsd_cosine_f32_ptr, memory_order_acquire);
     return func(a, b, n, result);
@@ -392,3 +481,325 @@ static hsd_cosine_f32_func_t resolve_cosine_f32_internal(void) {
     hsd_log("Dispatch: Resolved Cosine F32 to: %s", reason);
     return chosen;
 }
+
+typedef hsd_status_t (*hsd_cosine_f64_func_t)(const double *, const double *, size_t, double *);
+
+static hsd_status_t cosine_f64_from_sums(double dot, double norm_a_sq, double norm_b_sq,
+                                         double *result) {
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(dot) || isnan(norm_a_sq) || isnan(norm_b_sq) || isinf(dot) || isinf(norm_a_sq) ||
+        isinf(norm_b_sq)) {
+        *result = NAN;
+        return HSD_ERR_INVALID_INPUT;
+    }
+#endif
+    int a_zero = (norm_a_sq < DBL_MIN);
+    int b_zero = (norm_b_sq < DBL_MIN);
+    double similarity;
+    if (a_zero && b_zero) {
+        similarity = 1.0;
+    } else if (a_zero || b_zero) {
+        similarity = 0.0;
+    } else {
+        similarity = dot / (sqrt(norm_a_sq) * sqrt(norm_b_sq));
+        if (similarity > 1.0) similarity = 1.0;
+        if (similarity < -1.0) similarity = -1.0;
+    }
+    *result = similarity;
+    return HSD_SUCCESS;
+}
+
+static hsd_status_t cosine_f64_scalar_internal(const double *a, const double *b, size_t n,
+                                               double *result) {
+    hsd_log("Enter cosine_f64_scalar_internal (n=%zu)", n);
+    double dot = 0.0, na = 0.0, nb = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        dot += a[i] * b[i];
+        na += a[i] * a[i];
+        nb += b[i] * b[i];
+    }
+    return cosine_f64_from_sums(dot, na, nb, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static hsd_status_t cosine_f64_avx_internal(const double *a,
+                                                                           const double *b,
+                                                                           size_t n,
+                                                                           double *result) {
+    hsd_log("Enter cosine_f64_avx_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256d dot_acc = _mm256_setzero_pd();
+    __m256d na_acc = _mm256_setzero_pd();
+    __m256d nb_acc = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        __m256d vb = _mm256_loadu_pd(b + i);
+#if defined(__FMA__)
+        dot_acc = _mm256_fmadd_pd(va, vb, dot_acc);
+        na_acc = _mm256_fmadd_pd(va, va, na_acc);
+        nb_acc = _mm256_fmadd_pd(vb, vb, nb_acc);
+#else
+        dot_acc = _mm256_add_pd(dot_acc, _mm256_mul_pd(va, vb));
+        na_acc = _mm256_add_pd(na_acc, _mm256_mul_pd(va, va));
+        nb_acc = _mm256_add_pd(nb_acc, _mm256_mul_pd(vb, vb));
+#endif
+    }
+    double dot = hsd_internal_hsum_avx_f64(dot_acc);
+    double na = hsd_internal_hsum_avx_f64(na_acc);
+    double nb = hsd_internal_hsum_avx_f64(nb_acc);
+    for (; i < n; ++i) {
+        dot += a[i] * b[i];
+        na += a[i] * a[i];
+        nb += b[i] * b[i];
+    }
+    return cosine_f64_from_sums(dot, na, nb, result);
+}
+
+__attribute__((target("avx2,fma"))) static hsd_status_t cosine_f64_avx2_internal(const double *a,
+                                                                                 const double *b,
+                                                                                 size_t n,
+                                                                                 double *result) {
+    hsd_log("Enter cosine_f64_avx2_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256d dot_acc = _mm256_setzero_pd();
+    __m256d na_acc = _mm256_setzero_pd();
+    __m256d nb_acc = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        __m256d vb = _mm256_loadu_pd(b + i);
+        dot_acc = _mm256_fmadd_pd(va, vb, dot_acc);
+        na_acc = _mm256_fmadd_pd(va, va, na_acc);
+        nb_acc = _mm256_fmadd_pd(vb, vb, nb_acc);
+    }
+    double dot = hsd_internal_hsum_avx_f64(dot_acc);
+    double na = hsd_internal_hsum_avx_f64(na_acc);
+    double nb = hsd_internal_hsum_avx_f64(nb_acc);
+    for (; i < n; ++i) {
+        dot += a[i] * b[i];
+        na += a[i] * a[i];
+        nb += b[i] * b[i];
+    }
+    return cosine_f64_from_sums(dot, na, nb, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t cosine_f64_avx512_internal(const double *a,
+                                                                                  const double *b,
+                                                                                  size_t n,
+                                                                                  double *result) {
+    hsd_log("Enter cosine_f64_avx512_internal (n=%zu)", n);
+    size_t i = 0;
+    __m512d dot_acc = _mm512_setzero_pd();
+    __m512d na_acc = _mm512_setzero_pd();
+    __m512d nb_acc = _mm512_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        __m512d va = _mm512_loadu_pd(a + i);
+        __m512d vb = _mm512_loadu_pd(b + i);
+        dot_acc = _mm512_fmadd_pd(va, vb, dot_acc);
+        na_acc = _mm512_fmadd_pd(va, va, na_acc);
+        nb_acc = _mm512_fmadd_pd(vb, vb, nb_acc);
+    }
+    double dot = _mm512_reduce_add_pd(dot_acc);
+    double na = _mm512_reduce_add_pd(na_acc);
+    double nb = _mm512_reduce_add_pd(nb_acc);
+    for (; i < n; ++i) {
+        dot += a[i] * b[i];
+        na += a[i] * a[i];
+        nb += b[i] * b[i];
+    }
+    return cosine_f64_from_sums(dot, na, nb, result);
+}
+
+#endif
+
+#if defined(__aarch64__)
+static hsd_status_t cosine_f64_neon_internal(const double *a, const double *b, size_t n,
+                                             double *result) {
+    hsd_log("Enter cosine_f64_neon_internal (n=%zu)", n);
+    size_t i = 0;
+    float64x2_t dot_acc = vdupq_n_f64(0.0);
+    float64x2_t na_acc = vdupq_n_f64(0.0);
+    float64x2_t nb_acc = vdupq_n_f64(0.0);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t va = vld1q_f64(a + i);
+        float64x2_t vb = vld1q_f64(b + i);
+        dot_acc = vfmaq_f64(dot_acc, va, vb);
+        na_acc = vfmaq_f64(na_acc, va, va);
+        nb_acc = vfmaq_f64(nb_acc, vb, vb);
+    }
+    double dot = vaddvq_f64(dot_acc);
+    double na = vaddvq_f64(na_acc);
+    double nb = vaddvq_f64(nb_acc);
+    for (; i < n; ++i) {
+        dot += a[i] * b[i];
+        na += a[i] * a[i];
+        nb += b[i] * b[i];
+    }
+    return cosine_f64_from_sums(dot, na, nb, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t cosine_f64_sve_internal(const double *a,
+                                                                            const double *b,
+                                                                            size_t n,
+                                                                            double *result) {
+    hsd_log("Enter cosine_f64_sve_internal (n=%zu)", n);
+    int64_t i = 0;
+    svfloat64_t dot_acc = svdup_n_f64(0.0);
+    svfloat64_t na_acc = svdup_n_f64(0.0);
+    svfloat64_t nb_acc = svdup_n_f64(0.0);
+    while (i < (int64_t)n) {
+        svbool_t pg = svwhilelt_b64((uint64_t)i, (uint64_t)n);
+        svfloat64_t va = svld1_f64(pg, a + i);
+        svfloat64_t vb = svld1_f64(pg, b + i);
+        dot_acc = svmla_f64_m(pg, dot_acc, va, vb);
+        na_acc = svmla_f64_m(pg, na_acc, va, va);
+        nb_acc = svmla_f64_m(pg, nb_acc, vb, vb);
+        i += svcntd();
+    }
+    double dot = svaddv_f64(svptrue_b64(), dot_acc);
+    double na = svaddv_f64(svptrue_b64(), na_acc);
+    double nb = svaddv_f64(svptrue_b64(), nb_acc);
+    return cosine_f64_from_sums(dot, na, nb, result);
+}
+
+#endif
+#endif
+
+static hsd_cosine_f64_func_t resolve_cosine_f64_internal(void);
+static hsd_status_t cosine_f64_resolver_trampoline(const double *a, const double *b, size_t n,
+                                                   double *result);
+
+static atomic_uintptr_t hsd_cosine_f64_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)cosine_f64_resolver_trampoline);
+
+hsd_status_t hsd_sim_cosine_f64(const double *a, const double *b, size_t n, double *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 1.0;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    hsd_cosine_f64_func_t func =
+        (hsd_cosine_f64_func_t)atomic_load_explicit(&hsd_cosine_f64_ptr, memory_order_acquire);
+    return func(a, b, n, result);
+}
+
+static hsd_status_t cosine_f64_resolver_trampoline(const double *a, const double *b, size_t n,
+                                                   double *result) {
+    hsd_log("Cosine F64: resolving backend");
+    hsd_cosine_f64_func_t resolved_func = resolve_cosine_f64_internal();
+    uintptr_t expected = (uintptr_t)cosine_f64_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_cosine_f64_ptr, &expected,
+                                            (uintptr_t)resolved_func, memory_order_release,
+                                            memory_order_relaxed);
+    hsd_cosine_f64_func_t current_func =
+        (hsd_cosine_f64_func_t)atomic_load_explicit(&hsd_cosine_f64_ptr, memory_order_acquire);
+    return current_func(a, b, n, result);
+}
+
+static hsd_cosine_f64_func_t resolve_cosine_f64_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_cosine_f64_func_t chosen_func = cosine_f64_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Cosine F64: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen_func = cosine_f64_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2()) {
+                    chosen_func = cosine_f64_avx2_internal;
+                    reason = "AVX2 (Forced)";
+                    supported = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen_func = cosine_f64_avx_internal;
+                    reason = "AVX (fallback from forced AVX2)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen_func = cosine_f64_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen_func = cosine_f64_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen_func = cosine_f64_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                chosen_func = cosine_f64_scalar_internal;
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen_func = cosine_f64_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen_func = cosine_f64_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx2()) {
+            chosen_func = cosine_f64_avx2_internal;
+            reason = "AVX2 (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen_func = cosine_f64_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen_func = cosine_f64_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen_func = cosine_f64_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen_func = cosine_f64_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Cosine F64 to: %s", reason);
+    return chosen_func;
+}
@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include <stdio.h>
 
+#include "hsd_internal.h"
 #include "hsdlib.h"
 
 #if defined(__x86_64__) || defined(_M_X64)
@@ -221,6 +222,11 @@ hsd_status_t hsd_sim_dot_f32(const float *a, const float *b, size_t n, float *re
         *result = NAN;
         return HSD_ERR_NULL_PTR;
     }
+    HSD_Precision precision = hsd_get_precision();
+    if (precision == HSD_PRECISION_F64)
+        return hsd_internal_round_result(hsd_internal_precise_dot_f32(a, b, n), result);
+    if (precision == HSD_PRECISION_DETERMINISTIC)
+        return hsd_internal_round_result(hsd_internal_det_dot_f32(a, b, n), result);
     hsd_dot_f32_func_t func =
         (hsd_dot_f32_func_t)atomic_load_explicit(&hsd_dot_f32_ptr, memory_order_acquire);
     return func(a, b, n, result);
@@ -336,3 +342,255 @@ static hsd_dot_f32_func_t resolve_dot_f32_internal(void) {
     hsd_log("Dispatch: Resolved Dot F32 to: %s", reason);
     return chosen_func;
 }
+
+typedef hsd_status_t (*hsd_dot_f64_func_t)(const double *, const double *, size_t, double *);
+
+static hsd_status_t dot_f64_scalar_internal(const double *a, const double *b, size_t n,
+                                            double *result) {
+    hsd_log("Enter dot_f64_scalar_internal (n=%zu)", n);
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static hsd_status_t dot_f64_avx_internal(const double *a,
+                                                                        const double *b, size_t n,
+                                                                        double *result) {
+    hsd_log("Enter dot_f64_avx_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256d acc = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        __m256d vb = _mm256_loadu_pd(b + i);
+#if defined(__FMA__)
+        acc = _mm256_fmadd_pd(va, vb, acc);
+#else
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(va, vb));
+#endif
+    }
+    double sum = hsd_internal_hsum_avx_f64(acc);
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+__attribute__((target("avx2,fma"))) static hsd_status_t dot_f64_avx2_internal(const double *a,
+                                                                              const double *b,
+                                                                              size_t n,
+                                                                              double *result) {
+    hsd_log("Enter dot_f64_avx2_internal (n=%zu)", n);
+    size_t i = 0;
+    __m256d acc = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d va = _mm256_loadu_pd(a + i);
+        __m256d vb = _mm256_loadu_pd(b + i);
+        acc = _mm256_fmadd_pd(va, vb, acc);
+    }
+    double sum = hsd_internal_hsum_avx_f64(acc);
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+__attribute__((target("avx512f"))) static hsd_status_t dot_f64_avx512_internal(const double *a,
+                                                                               const double *b,
+                                                                               size_t n,
+                                                                               double *result) {
+    hsd_log("Enter dot_f64_avx512_internal (n=%zu)", n);
+    size_t i = 0;
+    __m512d acc = _mm512_setzero_pd();
+    for (; i + 8 <= n; i += 8) {
+        __m512d va = _mm512_loadu_pd(a + i);
+        __m512d vb = _mm512_loadu_pd(b + i);
+        acc = _mm512_fmadd_pd(va, vb, acc);
+    }
+    double sum = _mm512_reduce_add_pd(acc);
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+#endif
+
+#if defined(__aarch64__)
+static hsd_status_t dot_f64_neon_internal(const double *a, const double *b, size_t n,
+                                          double *result) {
+    hsd_log("Enter dot_f64_neon_internal (n=%zu)", n);
+    size_t i = 0;
+    float64x2_t acc = vdupq_n_f64(0.0);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t va = vld1q_f64(a + i);
+        float64x2_t vb = vld1q_f64(b + i);
+        acc = vfmaq_f64(acc, va, vb);
+    }
+    double sum = vaddvq_f64(acc);
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return hsd_internal_f64_result(sum, result);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static hsd_status_t dot_f64_sve_internal(const double *a,
+                                                                         const double *b, size_t n,
+                                                                         double *result) {
+    hsd_log("Enter dot_f64_sve_internal (n=%zu)", n);
+    int64_t i = 0;
+    svfloat64_t acc = svdup_n_f64(0.0);
+    while (i < (int64_t)n) {
+        svbool_t pg = svwhilelt_b64((uint64_t)i, (uint64_t)n);
+        svfloat64_t va = svld1_f64(pg, a + i);
+        svfloat64_t vb = svld1_f64(pg, b + i);
+        acc = svmla_f64_m(pg, acc, va, vb);
+        i += svcntd();
+    }
+    double sum = svaddv_f64(svptrue_b64(), acc);
+    return hsd_internal_f64_result(sum, result);
+}
+
+#endif
+#endif
+
+static hsd_dot_f64_func_t resolve_dot_f64_internal(void);
+static hsd_status_t dot_f64_resolver_trampoline(const double *a, const double *b, size_t n,
+                                                double *result);
+
+static atomic_uintptr_t hsd_dot_f64_ptr = ATOMIC_VAR_INIT((uintptr_t)dot_f64_resolver_trampoline);
+
+hsd_status_t hsd_sim_dot_f64(const double *a, const double *b, size_t n, double *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0;
+        return HSD_SUCCESS;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    hsd_dot_f64_func_t func =
+        (hsd_dot_f64_func_t)atomic_load_explicit(&hsd_dot_f64_ptr, memory_order_acquire);
+    return func(a, b, n, result);
+}
+
+static hsd_status_t dot_f64_resolver_trampoline(const double *a, const double *b, size_t n,
+                                                double *result) {
+    hsd_log("Dot F64: resolving backend");
+    hsd_dot_f64_func_t resolved_func = resolve_dot_f64_internal();
+    uintptr_t expected = (uintptr_t)dot_f64_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_dot_f64_ptr, &expected,
+                                            (uintptr_t)resolved_func, memory_order_release,
+                                            memory_order_relaxed);
+    hsd_dot_f64_func_t current_func =
+        (hsd_dot_f64_func_t)atomic_load_explicit(&hsd_dot_f64_ptr, memory_order_acquire);
+    return current_func(a, b, n, result);
+}
+
+static hsd_dot_f64_func_t resolve_dot_f64_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_dot_f64_func_t chosen_func = dot_f64_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Dot F64: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen_func = dot_f64_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2()) {
+                    chosen_func = dot_f64_avx2_internal;
+                    reason = "AVX2 (Forced)";
+                    supported = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen_func = dot_f64_avx_internal;
+                    reason = "AVX (fallback from forced AVX2)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen_func = dot_f64_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen_func = dot_f64_sve_internal;
+                    reason = "SVE (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen_func = dot_f64_neon_internal;
+                    reason = "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                chosen_func = dot_f64_scalar_internal;
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen_func = dot_f64_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen_func = dot_f64_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx2()) {
+            chosen_func = dot_f64_avx2_internal;
+            reason = "AVX2 (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen_func = dot_f64_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve()) {
+            chosen_func = dot_f64_sve_internal;
+            reason = "SVE (Auto)";
+        } else if (hsd_cpu_has_neon()) {
+            chosen_func = dot_f64_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#else
+        if (hsd_cpu_has_neon()) {
+            chosen_func = dot_f64_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Dot F64 to: %s", reason);
+    return chosen_func;
+}
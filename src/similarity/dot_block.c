@@ -0,0 +1,499 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#endif
+
+/*
+ * Dot products between every row of x (nx rows) and every row of y (ny rows):
+ * out[i * out_stride + j] = x_i . y_j. The SIMD kernels work on 2x4 register tiles so
+ * each loaded chunk of x is reused against four rows of y and each chunk of y against
+ * two rows of x. Inputs are assumed finite; callers validate them (e.g. via their norms).
+ */
+typedef void (*hsd_dot_block_f32_func_t)(const float *, size_t, size_t, const float *, size_t,
+                                         size_t, size_t, float *, size_t);
+
+static void dot_block_scalar_internal(const float *x, size_t nx, size_t x_stride, const float *y,
+                                      size_t ny, size_t y_stride, size_t dim, float *out,
+                                      size_t out_stride) {
+    hsd_log("Enter dot_block_scalar_internal (nx=%zu, ny=%zu, dim=%zu)", nx, ny, dim);
+    for (size_t i = 0; i < nx; ++i) {
+        const float *xi = x + i * x_stride;
+        for (size_t j = 0; j < ny; ++j) {
+            const float *yj = y + j * y_stride;
+            float sum = 0.0f;
+            for (size_t d = 0; d < dim; ++d) sum += xi[d] * yj[d];
+            out[i * out_stride + j] = sum;
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+static const int32_t dot_block_mask_table[16] = {-1, -1, -1, -1, -1, -1, -1, -1,
+                                                 0,  0,  0,  0,  0,  0,  0,  0};
+
+__attribute__((target("avx"))) static float dot_block_dot1_avx(const float *a, const float *b,
+                                                               size_t dim, __m256i mask) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t d = 0;
+    for (; d + 8 <= dim; d += 8)
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + d), _mm256_loadu_ps(b + d)));
+    if (d < dim)
+        acc = _mm256_add_ps(
+            acc, _mm256_mul_ps(_mm256_maskload_ps(a + d, mask), _mm256_maskload_ps(b + d, mask)));
+    return hsd_internal_hsum_avx_f32(acc);
+}
+
+__attribute__((target("avx"))) static void dot_block_avx_internal(const float *x, size_t nx,
+                                                                  size_t x_stride, const float *y,
+                                                                  size_t ny, size_t y_stride,
+                                                                  size_t dim, float *out,
+                                                                  size_t out_stride) {
+    hsd_log("Enter dot_block_avx_internal (nx=%zu, ny=%zu, dim=%zu)", nx, ny, dim);
+    const __m256i mask =
+        _mm256_loadu_si256((const __m256i *)(dot_block_mask_table + 8 - dim % 8));
+    const size_t body = dim - dim % 8;
+    size_t i = 0;
+    for (; i + 2 <= nx; i += 2) {
+        const float *x0 = x + i * x_stride, *x1 = x0 + x_stride;
+        float *o0 = out + i * out_stride, *o1 = o0 + out_stride;
+        size_t j = 0;
+        for (; j + 4 <= ny; j += 4) {
+            const float *y0 = y + j * y_stride, *y1 = y0 + y_stride, *y2 = y1 + y_stride,
+                        *y3 = y2 + y_stride;
+            __m256 a00 = _mm256_setzero_ps(), a01 = _mm256_setzero_ps();
+            __m256 a02 = _mm256_setzero_ps(), a03 = _mm256_setzero_ps();
+            __m256 a10 = _mm256_setzero_ps(), a11 = _mm256_setzero_ps();
+            __m256 a12 = _mm256_setzero_ps(), a13 = _mm256_setzero_ps();
+            for (size_t d = 0; d < body; d += 8) {
+                __m256 v0 = _mm256_loadu_ps(x0 + d), v1 = _mm256_loadu_ps(x1 + d);
+                __m256 w = _mm256_loadu_ps(y0 + d);
+                a00 = _mm256_add_ps(a00, _mm256_mul_ps(v0, w));
+                a10 = _mm256_add_ps(a10, _mm256_mul_ps(v1, w));
+                w = _mm256_loadu_ps(y1 + d);
+                a01 = _mm256_add_ps(a01, _mm256_mul_ps(v0, w));
+                a11 = _mm256_add_ps(a11, _mm256_mul_ps(v1, w));
+                w = _mm256_loadu_ps(y2 + d);
+                a02 = _mm256_add_ps(a02, _mm256_mul_ps(v0, w));
+                a12 = _mm256_add_ps(a12, _mm256_mul_ps(v1, w));
+                w = _mm256_loadu_ps(y3 + d);
+                a03 = _mm256_add_ps(a03, _mm256_mul_ps(v0, w));
+                a13 = _mm256_add_ps(a13, _mm256_mul_ps(v1, w));
+            }
+            if (body < dim) {
+                __m256 v0 = _mm256_maskload_ps(x0 + body, mask);
+                __m256 v1 = _mm256_maskload_ps(x1 + body, mask);
+                __m256 w = _mm256_maskload_ps(y0 + body, mask);
+                a00 = _mm256_add_ps(a00, _mm256_mul_ps(v0, w));
+                a10 = _mm256_add_ps(a10, _mm256_mul_ps(v1, w));
+                w = _mm256_maskload_ps(y1 + body, mask);
+                a01 = _mm256_add_ps(a01, _mm256_mul_ps(v0, w));
+                a11 = _mm256_add_ps(a11, _mm256_mul_ps(v1, w));
+                w = _mm256_maskload_ps(y2 + body, mask);
+                a02 = _mm256_add_ps(a02, _mm256_mul_ps(v0, w));
+                a12 = _mm256_add_ps(a12, _mm256_mul_ps(v1, w));
+                w = _mm256_maskload_ps(y3 + body, mask);
+                a03 = _mm256_add_ps(a03, _mm256_mul_ps(v0, w));
+                a13 = _mm256_add_ps(a13, _mm256_mul_ps(v1, w));
+            }
+            o0[j] = hsd_internal_hsum_avx_f32(a00);
+            o0[j + 1] = hsd_internal_hsum_avx_f32(a01);
+            o0[j + 2] = hsd_internal_hsum_avx_f32(a02);
+            o0[j + 3] = hsd_internal_hsum_avx_f32(a03);
+            o1[j] = hsd_internal_hsum_avx_f32(a10);
+            o1[j + 1] = hsd_internal_hsum_avx_f32(a11);
+            o1[j + 2] = hsd_internal_hsum_avx_f32(a12);
+            o1[j + 3] = hsd_internal_hsum_avx_f32(a13);
+        }
+        for (; j < ny; ++j) {
+            o0[j] = dot_block_dot1_avx(x0, y + j * y_stride, dim, mask);
+            o1[j] = dot_block_dot1_avx(x1, y + j * y_stride, dim, mask);
+        }
+    }
+    for (; i < nx; ++i) {
+        for (size_t j = 0; j < ny; ++j)
+            out[i * out_stride + j] = dot_block_dot1_avx(x + i * x_stride, y + j * y_stride, dim,
+                                                         mask);
+    }
+}
+
+__attribute__((target("avx2,fma"))) static float dot_block_dot1_avx2(const float *a,
+                                                                     const float *b, size_t dim,
+                                                                     __m256i mask) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t d = 0;
+    for (; d + 8 <= dim; d += 8)
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + d), _mm256_loadu_ps(b + d), acc);
+    if (d < dim)
+        acc = _mm256_fmadd_ps(_mm256_maskload_ps(a + d, mask), _mm256_maskload_ps(b + d, mask),
+                              acc);
+    return hsd_internal_hsum_avx_f32(acc);
+}
+
+__attribute__((target("avx2,fma"))) static void dot_block_avx2_internal(
+    const float *x, size_t nx, size_t x_stride, const float *y, size_t ny, size_t y_stride,
+    size_t dim, float *out, size_t out_stride) {
+    hsd_log("Enter dot_block_avx2_internal (nx=%zu, ny=%zu, dim=%zu)", nx, ny, dim);
+    const __m256i mask =
+        _mm256_loadu_si256((const __m256i *)(dot_block_mask_table + 8 - dim % 8));
+    const size_t body = dim - dim % 8;
+    size_t i = 0;
+    for (; i + 2 <= nx; i += 2) {
+        const float *x0 = x + i * x_stride, *x1 = x0 + x_stride;
+        float *o0 = out + i * out_stride, *o1 = o0 + out_stride;
+        size_t j = 0;
+        for (; j + 4 <= ny; j += 4) {
+            const float *y0 = y + j * y_stride, *y1 = y0 + y_stride, *y2 = y1 + y_stride,
+                        *y3 = y2 + y_stride;
+            __m256 a00 = _mm256_setzero_ps(), a01 = _mm256_setzero_ps();
+            __m256 a02 = _mm256_setzero_ps(), a03 = _mm256_setzero_ps();
+            __m256 a10 = _mm256_setzero_ps(), a11 = _mm256_setzero_ps();
+            __m256 a12 = _mm256_setzero_ps(), a13 = _mm256_setzero_ps();
+            for (size_t d = 0; d < body; d += 8) {
+                __m256 v0 = _mm256_loadu_ps(x0 + d), v1 = _mm256_loadu_ps(x1 + d);
+                __m256 w = _mm256_loadu_ps(y0 + d);
+                a00 = _mm256_fmadd_ps(v0, w, a00);
+                a10 = _mm256_fmadd_ps(v1, w, a10);
+                w = _mm256_loadu_ps(y1 + d);
+                a01 = _mm256_fmadd_ps(v0, w, a01);
+                a11 = _mm256_fmadd_ps(v1, w, a11);
+                w = _mm256_loadu_ps(y2 + d);
+                a02 = _mm256_fmadd_ps(v0, w, a02);
+                a12 = _mm256_fmadd_ps(v1, w, a12);
+                w = _mm256_loadu_ps(y3 + d);
+                a03 = _mm256_fmadd_ps(v0, w, a03);
+                a13 = _mm256_fmadd_ps(v1, w, a13);
+            }
+            if (body < dim) {
+                __m256 v0 = _mm256_maskload_ps(x0 + body, mask);
+                __m256 v1 = _mm256_maskload_ps(x1 + body, mask);
+                __m256 w = _mm256_maskload_ps(y0 + body, mask);
+                a00 = _mm256_fmadd_ps(v0, w, a00);
+                a10 = _mm256_fmadd_ps(v1, w, a10);
+                w = _mm256_maskload_ps(y1 + body, mask);
+                a01 = _mm256_fmadd_ps(v0, w, a01);
+                a11 = _mm256_fmadd_ps(v1, w, a11);
+                w = _mm256_maskload_ps(y2 + body, mask);
+                a02 = _mm256_fmadd_ps(v0, w, a02);
+                a12 = _mm256_fmadd_ps(v1, w, a12);
+                w = _mm256_maskload_ps(y3 + body, mask);
+                a03 = _mm256_fmadd_ps(v0, w, a03);
+                a13 = _mm256_fmadd_ps(v1, w, a13);
+            }
+            o0[j] = hsd_internal_hsum_avx_f32(a00);
+            o0[j + 1] = hsd_internal_hsum_avx_f32(a01);
+            o0[j + 2] = hsd_internal_hsum_avx_f32(a02);
+            o0[j + 3] = hsd_internal_hsum_avx_f32(a03);
+            o1[j] = hsd_internal_hsum_avx_f32(a10);
+            o1[j + 1] = hsd_internal_hsum_avx_f32(a11);
+            o1[j + 2] = hsd_internal_hsum_avx_f32(a12);
+            o1[j + 3] = hsd_internal_hsum_avx_f32(a13);
+        }
+        for (; j < ny; ++j) {
+            o0[j] = dot_block_dot1_avx2(x0, y + j * y_stride, dim, mask);
+            o1[j] = dot_block_dot1_avx2(x1, y + j * y_stride, dim, mask);
+        }
+    }
+    for (; i < nx; ++i) {
+        for (size_t j = 0; j < ny; ++j)
+            out[i * out_stride + j] = dot_block_dot1_avx2(x + i * x_stride, y + j * y_stride,
+                                                          dim, mask);
+    }
+}
+
+__attribute__((target("avx512f"))) static float dot_block_dot1_avx512(const float *a,
+                                                                      const float *b, size_t dim,
+                                                                      __mmask16 mask) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t d = 0;
+    for (; d + 16 <= dim; d += 16)
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(a + d), _mm512_loadu_ps(b + d), acc);
+    if (d < dim)
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + d),
+                              _mm512_maskz_loadu_ps(mask, b + d), acc);
+    return _mm512_reduce_add_ps(acc);
+}
+
+__attribute__((target("avx512f"))) static void dot_block_avx512_internal(
+    const float *x, size_t nx, size_t x_stride, const float *y, size_t ny, size_t y_stride,
+    size_t dim, float *out, size_t out_stride) {
+    hsd_log("Enter dot_block_avx512_internal (nx=%zu, ny=%zu, dim=%zu)", nx, ny, dim);
+    const __mmask16 mask = (__mmask16)((1u << (dim % 16)) - 1u);
+    const size_t body = dim - dim % 16;
+    size_t i = 0;
+    for (; i + 2 <= nx; i += 2) {
+        const float *x0 = x + i * x_stride, *x1 = x0 + x_stride;
+        float *o0 = out + i * out_stride, *o1 = o0 + out_stride;
+        size_t j = 0;
+        for (; j + 4 <= ny; j += 4) {
+            const float *y0 = y + j * y_stride, *y1 = y0 + y_stride, *y2 = y1 + y_stride,
+                        *y3 = y2 + y_stride;
+            __m512 a00 = _mm512_setzero_ps(), a01 = _mm512_setzero_ps();
+            __m512 a02 = _mm512_setzero_ps(), a03 = _mm512_setzero_ps();
+            __m512 a10 = _mm512_setzero_ps(), a11 = _mm512_setzero_ps();
+            __m512 a12 = _mm512_setzero_ps(), a13 = _mm512_setzero_ps();
+            for (size_t d = 0; d < body; d += 16) {
+                __m512 v0 = _mm512_loadu_ps(x0 + d), v1 = _mm512_loadu_ps(x1 + d);
+                __m512 w = _mm512_loadu_ps(y0 + d);
+                a00 = _mm512_fmadd_ps(v0, w, a00);
+                a10 = _mm512_fmadd_ps(v1, w, a10);
+                w = _mm512_loadu_ps(y1 + d);
+                a01 = _mm512_fmadd_ps(v0, w, a01);
+                a11 = _mm512_fmadd_ps(v1, w, a11);
+                w = _mm512_loadu_ps(y2 + d);
+                a02 = _mm512_fmadd_ps(v0, w, a02);
+                a12 = _mm512_fmadd_ps(v1, w, a12);
+                w = _mm512_loadu_ps(y3 + d);
+                a03 = _mm512_fmadd_ps(v0, w, a03);
+                a13 = _mm512_fmadd_ps(v1, w, a13);
+            }
+            if (body < dim) {
+                __m512 v0 = _mm512_maskz_loadu_ps(mask, x0 + body);
+                __m512 v1 = _mm512_maskz_loadu_ps(mask, x1 + body);
+                __m512 w = _mm512_maskz_loadu_ps(mask, y0 + body);
+                a00 = _mm512_fmadd_ps(v0, w, a00);
+                a10 = _mm512_fmadd_ps(v1, w, a10);
+                w = _mm512_maskz_loadu_ps(mask, y1 + body);
+                a01 = _mm512_fmadd_ps(v0, w, a01);
+                a11 = _mm512_fmadd_ps(v1, w, a11);
+                w = _mm512_maskz_loadu_ps(mask, y2 + body);
+                a02 = _mm512_fmadd_ps(v0, w, a02);
+                a12 = _mm512_fmadd_ps(v1, w, a12);
+                w = _mm512_maskz_loadu_ps(mask, y3 + body);
+                a03 = _mm512_fmadd_ps(v0, w, a03);
+                a13 = _mm512_fmadd_ps(v1, w, a13);
+            }
+            o0[j] = _mm512_reduce_add_ps(a00);
+            o0[j + 1] = _mm512_reduce_add_ps(a01);
+            o0[j + 2] = _mm512_reduce_add_ps(a02);
+            o0[j + 3] = _mm512_reduce_add_ps(a03);
+            o1[j] = _mm512_reduce_add_ps(a10);
+            o1[j + 1] = _mm512_reduce_add_ps(a11);
+            o1[j + 2] = _mm512_reduce_add_ps(a12);
+            o1[j + 3] = _mm512_reduce_add_ps(a13);
+        }
+        for (; j < ny; ++j) {
+            o0[j] = dot_block_dot1_avx512(x0, y + j * y_stride, dim, mask);
+            o1[j] = dot_block_dot1_avx512(x1, y + j * y_stride, dim, mask);
+        }
+    }
+    for (; i < nx; ++i) {
+        for (size_t j = 0; j < ny; ++j)
+            out[i * out_stride + j] = dot_block_dot1_avx512(x + i * x_stride, y + j * y_stride,
+                                                            dim, mask);
+    }
+}
+#endif
+
+#if defined(__aarch64__) || defined(__arm__)
+static inline float dot_block_hsum_neon(float32x4_t acc) {
+#if defined(__aarch64__)
+    return vaddvq_f32(acc);
+#else
+    float32x2_t tmp = vpadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    tmp = vpadd_f32(tmp, tmp);
+    return vget_lane_f32(tmp, 0);
+#endif
+}
+
+static float dot_block_dot1_neon(const float *a, const float *b, size_t dim) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    size_t d = 0;
+    for (; d + 4 <= dim; d += 4) acc = vfmaq_f32(acc, vld1q_f32(a + d), vld1q_f32(b + d));
+    float sum = dot_block_hsum_neon(acc);
+    for (; d < dim; ++d) sum += a[d] * b[d];
+    return sum;
+}
+
+static void dot_block_neon_internal(const float *x, size_t nx, size_t x_stride, const float *y,
+                                    size_t ny, size_t y_stride, size_t dim, float *out,
+                                    size_t out_stride) {
+    hsd_log("Enter dot_block_neon_internal (nx=%zu, ny=%zu, dim=%zu)", nx, ny, dim);
+    const size_t body = dim - dim % 4;
+    size_t i = 0;
+    for (; i + 2 <= nx; i += 2) {
+        const float *x0 = x + i * x_stride, *x1 = x0 + x_stride;
+        float *o0 = out + i * out_stride, *o1 = o0 + out_stride;
+        size_t j = 0;
+        for (; j + 4 <= ny; j += 4) {
+            const float *y0 = y + j * y_stride, *y1 = y0 + y_stride, *y2 = y1 + y_stride,
+                        *y3 = y2 + y_stride;
+            float32x4_t a00 = vdupq_n_f32(0.0f), a01 = vdupq_n_f32(0.0f);
+            float32x4_t a02 = vdupq_n_f32(0.0f), a03 = vdupq_n_f32(0.0f);
+            float32x4_t a10 = vdupq_n_f32(0.0f), a11 = vdupq_n_f32(0.0f);
+            float32x4_t a12 = vdupq_n_f32(0.0f), a13 = vdupq_n_f32(0.0f);
+            for (size_t d = 0; d < body; d += 4) {
+                float32x4_t v0 = vld1q_f32(x0 + d), v1 = vld1q_f32(x1 + d);
+                float32x4_t w = vld1q_f32(y0 + d);
+                a00 = vfmaq_f32(a00, v0, w);
+                a10 = vfmaq_f32(a10, v1, w);
+                w = vld1q_f32(y1 + d);
+                a01 = vfmaq_f32(a01, v0, w);
+                a11 = vfmaq_f32(a11, v1, w);
+                w = vld1q_f32(y2 + d);
+                a02 = vfmaq_f32(a02, v0, w);
+                a12 = vfmaq_f32(a12, v1, w);
+                w = vld1q_f32(y3 + d);
+                a03 = vfmaq_f32(a03, v0, w);
+                a13 = vfmaq_f32(a13, v1, w);
+            }
+            float s00 = dot_block_hsum_neon(a00), s01 = dot_block_hsum_neon(a01);
+            float s02 = dot_block_hsum_neon(a02), s03 = dot_block_hsum_neon(a03);
+            float s10 = dot_block_hsum_neon(a10), s11 = dot_block_hsum_neon(a11);
+            float s12 = dot_block_hsum_neon(a12), s13 = dot_block_hsum_neon(a13);
+            for (size_t d = body; d < dim; ++d) {
+                s00 += x0[d] * y0[d];
+                s01 += x0[d] * y1[d];
+                s02 += x0[d] * y2[d];
+                s03 += x0[d] * y3[d];
+                s10 += x1[d] * y0[d];
+                s11 += x1[d] * y1[d];
+                s12 += x1[d] * y2[d];
+                s13 += x1[d] * y3[d];
+            }
+            o0[j] = s00;
+            o0[j + 1] = s01;
+            o0[j + 2] = s02;
+            o0[j + 3] = s03;
+            o1[j] = s10;
+            o1[j + 1] = s11;
+            o1[j + 2] = s12;
+            o1[j + 3] = s13;
+        }
+        for (; j < ny; ++j) {
+            o0[j] = dot_block_dot1_neon(x0, y + j * y_stride, dim);
+            o1[j] = dot_block_dot1_neon(x1, y + j * y_stride, dim);
+        }
+    }
+    for (; i < nx; ++i) {
+        for (size_t j = 0; j < ny; ++j)
+            out[i * out_stride + j] = dot_block_dot1_neon(x + i * x_stride, y + j * y_stride, dim);
+    }
+}
+#endif
+
+static hsd_dot_block_f32_func_t resolve_dot_block_f32_internal(void);
+static void dot_block_f32_resolver_trampoline(const float *x, size_t nx, size_t x_stride,
+                                              const float *y, size_t ny, size_t y_stride,
+                                              size_t dim, float *out, size_t out_stride);
+
+static atomic_uintptr_t hsd_dot_block_f32_ptr =
+    ATOMIC_VAR_INIT((uintptr_t)dot_block_f32_resolver_trampoline);
+
+void hsd_internal_dot_block_f32(const float *x, size_t nx, size_t x_stride, const float *y,
+                                size_t ny, size_t y_stride, size_t dim, float *out,
+                                size_t out_stride) {
+    if (nx == 0 || ny == 0) return;
+    hsd_dot_block_f32_func_t func = (hsd_dot_block_f32_func_t)atomic_load_explicit(
+        &hsd_dot_block_f32_ptr, memory_order_acquire);
+    func(x, nx, x_stride, y, ny, y_stride, dim, out, out_stride);
+}
+
+static void dot_block_f32_resolver_trampoline(const float *x, size_t nx, size_t x_stride,
+                                              const float *y, size_t ny, size_t y_stride,
+                                              size_t dim, float *out, size_t out_stride) {
+    hsd_log("Dot Block F32: resolving backend");
+    hsd_dot_block_f32_func_t resolved_func = resolve_dot_block_f32_internal();
+    uintptr_t expected = (uintptr_t)dot_block_f32_resolver_trampoline;
+    atomic_compare_exchange_strong_explicit(&hsd_dot_block_f32_ptr, &expected,
+                                            (uintptr_t)resolved_func, memory_order_release,
+                                            memory_order_relaxed);
+    hsd_dot_block_f32_func_t current_func = (hsd_dot_block_f32_func_t)atomic_load_explicit(
+        &hsd_dot_block_f32_ptr, memory_order_acquire);
+    current_func(x, nx, x_stride, y, ny, y_stride, dim, out, out_stride);
+}
+
+static hsd_dot_block_f32_func_t resolve_dot_block_f32_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    hsd_dot_block_f32_func_t chosen_func = dot_block_scalar_internal;
+    const char *reason = "Scalar (Default)";
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Dot Block F32: Manual backend requested: %d", forced);
+        bool supported = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen_func = dot_block_avx512_internal;
+                    reason = "AVX512F (Forced)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2() && hsd_cpu_has_fma()) {
+                    chosen_func = dot_block_avx2_internal;
+                    reason = "AVX2 (Forced)";
+                    supported = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen_func = dot_block_avx_internal;
+                    reason = "AVX (fallback from forced AVX2)";
+                    supported = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen_func = dot_block_avx_internal;
+                    reason = "AVX (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+            case HSD_BACKEND_SVE:
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen_func = dot_block_neon_internal;
+                    reason = forced == HSD_BACKEND_SVE ? "NEON (fallback from forced SVE)"
+                                                       : "NEON (Forced)";
+                    supported = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                chosen_func = dot_block_scalar_internal;
+                reason = "Scalar (Forced)";
+                supported = true;
+                break;
+            default:
+                reason = "Scalar (Forced backend invalid)";
+                break;
+        }
+
+        if (!supported && forced != HSD_BACKEND_SCALAR) {
+            hsd_log("Warning: Forced backend %d not supported. Falling back to Scalar.", forced);
+            chosen_func = dot_block_scalar_internal;
+            reason = "Scalar (Forced fallback)";
+        }
+    } else {
+        reason = "Scalar (Auto)";
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f()) {
+            chosen_func = dot_block_avx512_internal;
+            reason = "AVX512F (Auto)";
+        } else if (hsd_cpu_has_avx2() && hsd_cpu_has_fma()) {
+            chosen_func = dot_block_avx2_internal;
+            reason = "AVX2 (Auto)";
+        } else if (hsd_cpu_has_avx()) {
+            chosen_func = dot_block_avx_internal;
+            reason = "AVX (Auto)";
+        }
+#elif defined(__aarch64__) || defined(__arm__)
+        if (hsd_cpu_has_neon()) {
+            chosen_func = dot_block_neon_internal;
+            reason = "NEON (Auto)";
+        }
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Dot Block F32 to: %s", reason);
+    return chosen_func;
+}
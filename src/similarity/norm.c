@@ -0,0 +1,477 @@
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+#define HSD_NORMS_BLOCK 1024
+
+/*
+ * The norm functions share one backend choice, so the three kernels are resolved together as a
+ * table: the sum of squares (L2), the sum of absolute values (L1), and an in-place scale used
+ * for normalization. Sums of non-negative terms cannot cancel, so a non-finite input always
+ * shows up in the final sum and the public functions only check that.
+ */
+typedef struct {
+    float (*sum_sq)(const float *v, size_t n);
+    float (*sum_abs)(const float *v, size_t n);
+    void (*scale)(float *v, size_t n, float factor);
+    const char *name;
+} hsd_norm_kernels_t;
+
+static float norm_sum_sq_scalar(const float *v, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += v[i] * v[i];
+    return sum;
+}
+
+static float norm_sum_abs_scalar(const float *v, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += fabsf(v[i]);
+    return sum;
+}
+
+static void norm_scale_scalar(float *v, size_t n, float factor) {
+    for (size_t i = 0; i < n; ++i) v[i] *= factor;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static float norm_sum_sq_avx(const float *v, size_t n) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        __m256 x0 = _mm256_loadu_ps(v + i);
+        __m256 x1 = _mm256_loadu_ps(v + i + 8);
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(x0, x0));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(x1, x1));
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(v + i);
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(x, x));
+    }
+    float sum = hsd_internal_hsum_avx_f32(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += v[i] * v[i];
+    return sum;
+}
+
+__attribute__((target("avx"))) static float norm_sum_abs_avx(const float *v, size_t n) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_andnot_ps(sign, _mm256_loadu_ps(v + i)));
+        acc1 = _mm256_add_ps(acc1, _mm256_andnot_ps(sign, _mm256_loadu_ps(v + i + 8)));
+    }
+    for (; i + 8 <= n; i += 8)
+        acc0 = _mm256_add_ps(acc0, _mm256_andnot_ps(sign, _mm256_loadu_ps(v + i)));
+    float sum = hsd_internal_hsum_avx_f32(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += fabsf(v[i]);
+    return sum;
+}
+
+__attribute__((target("avx"))) static void norm_scale_avx(float *v, size_t n, float factor) {
+    const __m256 f = _mm256_set1_ps(factor);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(v + i, _mm256_mul_ps(_mm256_loadu_ps(v + i), f));
+    for (; i < n; ++i) v[i] *= factor;
+}
+
+__attribute__((target("avx2,fma"))) static float norm_sum_sq_avx2(const float *v, size_t n) {
+    size_t i = 0;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        __m256 x0 = _mm256_loadu_ps(v + i);
+        __m256 x1 = _mm256_loadu_ps(v + i + 8);
+        acc0 = _mm256_fmadd_ps(x0, x0, acc0);
+        acc1 = _mm256_fmadd_ps(x1, x1, acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(v + i);
+        acc0 = _mm256_fmadd_ps(x, x, acc0);
+    }
+    float sum = hsd_internal_hsum_avx_f32(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += v[i] * v[i];
+    return sum;
+}
+
+__attribute__((target("avx512f"))) static float norm_sum_sq_avx512(const float *v, size_t n) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= n; i += 32) {
+        __m512 x0 = _mm512_loadu_ps(v + i);
+        __m512 x1 = _mm512_loadu_ps(v + i + 16);
+        acc0 = _mm512_fmadd_ps(x0, x0, acc0);
+        acc1 = _mm512_fmadd_ps(x1, x1, acc1);
+    }
+    if (i + 16 <= n) {
+        __m512 x = _mm512_loadu_ps(v + i);
+        acc0 = _mm512_fmadd_ps(x, x, acc0);
+        i += 16;
+    }
+    if (i < n) {
+        __mmask16 m = (__mmask16)((1u << (n - i)) - 1u);
+        __m512 x = _mm512_maskz_loadu_ps(m, v + i);
+        acc1 = _mm512_fmadd_ps(x, x, acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+__attribute__((target("avx512f"))) static float norm_sum_abs_avx512(const float *v, size_t n) {
+    size_t i = 0;
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_add_ps(acc0, _mm512_abs_ps(_mm512_loadu_ps(v + i)));
+        acc1 = _mm512_add_ps(acc1, _mm512_abs_ps(_mm512_loadu_ps(v + i + 16)));
+    }
+    if (i + 16 <= n) {
+        acc0 = _mm512_add_ps(acc0, _mm512_abs_ps(_mm512_loadu_ps(v + i)));
+        i += 16;
+    }
+    if (i < n) {
+        __mmask16 m = (__mmask16)((1u << (n - i)) - 1u);
+        acc1 = _mm512_add_ps(acc1, _mm512_abs_ps(_mm512_maskz_loadu_ps(m, v + i)));
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+__attribute__((target("avx512f"))) static void norm_scale_avx512(float *v, size_t n,
+                                                                 float factor) {
+    const __m512 f = _mm512_set1_ps(factor);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) _mm512_storeu_ps(v + i, _mm512_mul_ps(_mm512_loadu_ps(v + i), f));
+    if (i < n) {
+        __mmask16 m = (__mmask16)((1u << (n - i)) - 1u);
+        _mm512_mask_storeu_ps(v + i, m, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, v + i), f));
+    }
+}
+#endif
+
+#if defined(__aarch64__) || defined(__arm__)
+static inline float norm_hsum_neon(float32x4_t acc) {
+#if defined(__aarch64__)
+    return vaddvq_f32(acc);
+#else
+    float32x2_t tmp = vpadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    tmp = vpadd_f32(tmp, tmp);
+    return vget_lane_f32(tmp, 0);
+#endif
+}
+
+static float norm_sum_sq_neon(const float *v, size_t n) {
+    size_t i = 0;
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t x0 = vld1q_f32(v + i);
+        float32x4_t x1 = vld1q_f32(v + i + 4);
+        acc0 = vfmaq_f32(acc0, x0, x0);
+        acc1 = vfmaq_f32(acc1, x1, x1);
+    }
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vld1q_f32(v + i);
+        acc0 = vfmaq_f32(acc0, x, x);
+    }
+    float sum = norm_hsum_neon(vaddq_f32(acc0, acc1));
+    for (; i < n; ++i) sum += v[i] * v[i];
+    return sum;
+}
+
+static float norm_sum_abs_neon(const float *v, size_t n) {
+    size_t i = 0;
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vaddq_f32(acc0, vabsq_f32(vld1q_f32(v + i)));
+        acc1 = vaddq_f32(acc1, vabsq_f32(vld1q_f32(v + i + 4)));
+    }
+    for (; i + 4 <= n; i += 4) acc0 = vaddq_f32(acc0, vabsq_f32(vld1q_f32(v + i)));
+    float sum = norm_hsum_neon(vaddq_f32(acc0, acc1));
+    for (; i < n; ++i) sum += fabsf(v[i]);
+    return sum;
+}
+
+static void norm_scale_neon(float *v, size_t n, float factor) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) vst1q_f32(v + i, vmulq_n_f32(vld1q_f32(v + i), factor));
+    for (; i < n; ++i) v[i] *= factor;
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static float norm_sum_sq_sve(const float *v, size_t n) {
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t x = svld1_f32(pg, v + i);
+        acc = svmla_f32_m(pg, acc, x, x);
+    }
+    return svaddv_f32(svptrue_b32(), acc);
+}
+
+__attribute__((target("+sve"))) static float norm_sum_abs_sve(const float *v, size_t n) {
+    svfloat32_t acc = svdup_n_f32(0.0f);
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        acc = svadd_f32_m(pg, acc, svabs_f32_x(pg, svld1_f32(pg, v + i)));
+    }
+    return svaddv_f32(svptrue_b32(), acc);
+}
+
+__attribute__((target("+sve"))) static void norm_scale_sve(float *v, size_t n, float factor) {
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svst1_f32(pg, v + i, svmul_n_f32_x(pg, svld1_f32(pg, v + i), factor));
+    }
+}
+#endif
+#endif
+
+static const hsd_norm_kernels_t norm_kernels_scalar = {norm_sum_sq_scalar, norm_sum_abs_scalar,
+                                                       norm_scale_scalar, "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_norm_kernels_t norm_kernels_avx = {norm_sum_sq_avx, norm_sum_abs_avx,
+                                                    norm_scale_avx, "AVX"};
+static const hsd_norm_kernels_t norm_kernels_avx2 = {norm_sum_sq_avx2, norm_sum_abs_avx,
+                                                     norm_scale_avx, "AVX2"};
+static const hsd_norm_kernels_t norm_kernels_avx512 = {norm_sum_sq_avx512, norm_sum_abs_avx512,
+                                                       norm_scale_avx512, "AVX512F"};
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+static const hsd_norm_kernels_t norm_kernels_neon = {norm_sum_sq_neon, norm_sum_abs_neon,
+                                                     norm_scale_neon, "NEON"};
+#if defined(__ARM_FEATURE_SVE)
+static const hsd_norm_kernels_t norm_kernels_sve = {norm_sum_sq_sve, norm_sum_abs_sve,
+                                                    norm_scale_sve, "SVE"};
+#endif
+#endif
+
+static const hsd_norm_kernels_t *resolve_norm_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_norm_kernels_t *chosen = &norm_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Norm F32: Manual backend requested: %d", forced);
+        bool ok = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = &norm_kernels_avx512;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2() && hsd_cpu_has_fma()) {
+                    chosen = &norm_kernels_avx2;
+                    ok = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen = &norm_kernels_avx;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen = &norm_kernels_avx;
+                    ok = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = &norm_kernels_sve;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = &norm_kernels_neon;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                ok = true;
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            hsd_log("Forced backend %d not supported, fallback to scalar", forced);
+            chosen = &norm_kernels_scalar;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &norm_kernels_avx512;
+        else if (hsd_cpu_has_avx2() && hsd_cpu_has_fma())
+            chosen = &norm_kernels_avx2;
+        else if (hsd_cpu_has_avx())
+            chosen = &norm_kernels_avx;
+#elif defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve())
+            chosen = &norm_kernels_sve;
+        else if (hsd_cpu_has_neon())
+            chosen = &norm_kernels_neon;
+#else
+        if (hsd_cpu_has_neon()) chosen = &norm_kernels_neon;
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Norm F32 to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_norm_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_norm_kernels_t *norm_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_norm_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_norm_kernels_t *)cur;
+    const hsd_norm_kernels_t *resolved = resolve_norm_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_norm_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+static inline hsd_status_t norm_check(double sum) {
+#if HSD_ALLOW_FP_CHECKS
+    if (isnan(sum) || isinf(sum)) return HSD_ERR_INVALID_INPUT;
+#else
+    (void)sum;
+#endif
+    return HSD_SUCCESS;
+}
+
+/* Sum of squares (or of absolute values for l1), accumulated as the precision mode asks. */
+static double norm_sum(const hsd_norm_kernels_t *k, HSD_Precision precision, bool l1,
+                       const float *v, size_t n) {
+    if (precision == HSD_PRECISION_F64)
+        return l1 ? hsd_internal_precise_sum_abs_f32(v, n) : hsd_internal_precise_sum_sq_f32(v, n);
+    if (precision == HSD_PRECISION_DETERMINISTIC)
+        return l1 ? hsd_internal_det_sum_abs_f32(v, n) : hsd_internal_det_dot_f32(v, v, n);
+    return l1 ? k->sum_abs(v, n) : k->sum_sq(v, n);
+}
+
+/* Scales v to unit length given its sum of squares; zero vectors are left unchanged. */
+static void norm_apply(const hsd_norm_kernels_t *k, float *v, size_t n, double sum_sq) {
+    if (sum_sq < FLT_MIN) return;
+    k->scale(v, n, (float)(1.0 / sqrt(sum_sq)));
+}
+
+static hsd_status_t norm_single(const float *v, size_t n, bool l1, float *result) {
+    if (result == NULL) return HSD_ERR_NULL_PTR;
+    if (n == 0) {
+        *result = 0.0f;
+        return HSD_SUCCESS;
+    }
+    if (v == NULL) {
+        *result = NAN;
+        return HSD_ERR_NULL_PTR;
+    }
+    double sum = norm_sum(norm_kernels(), hsd_get_precision(), l1, v, n);
+    hsd_status_t status = norm_check(sum);
+    *result = (float)(l1 ? sum : sqrt(sum));
+    return status;
+}
+
+hsd_status_t hsd_norm_l2_f32(const float *v, size_t n, float *result) {
+    return norm_single(v, n, false, result);
+}
+
+hsd_status_t hsd_norm_l1_f32(const float *v, size_t n, float *result) {
+    return norm_single(v, n, true, result);
+}
+
+hsd_status_t hsd_normalize_f32(float *v, size_t n) {
+    if (n == 0) return HSD_SUCCESS;
+    if (v == NULL) return HSD_ERR_NULL_PTR;
+    const hsd_norm_kernels_t *k = norm_kernels();
+    double sum = norm_sum(k, hsd_get_precision(), false, v, n);
+    hsd_status_t status = norm_check(sum);
+    if (status == HSD_SUCCESS) norm_apply(k, v, n, sum);
+    return status;
+}
+
+typedef enum { NORMS_L2, NORMS_L1, NORMS_NORMALIZE } hsd_norms_op_t;
+
+typedef struct {
+    const hsd_norm_kernels_t *kernels;
+    HSD_Precision precision;
+    hsd_norms_op_t op;
+    const float *data;
+    float *normalized;
+    size_t count;
+    size_t dim;
+    float *norms;
+} hsd_norms_job_t;
+
+static hsd_status_t norms_task(void *ctx, size_t block, size_t slot) {
+    (void)slot;
+    hsd_norms_job_t *job = (hsd_norms_job_t *)ctx;
+    const bool l1 = job->op == NORMS_L1;
+    size_t end = (block + 1) * HSD_NORMS_BLOCK;
+    if (end > job->count) end = job->count;
+    for (size_t i = block * HSD_NORMS_BLOCK; i < end; ++i) {
+        double sum = norm_sum(job->kernels, job->precision, l1, job->data + i * job->dim, job->dim);
+        hsd_status_t status = norm_check(sum);
+        if (status != HSD_SUCCESS) return status;
+        if (job->normalized != NULL)
+            norm_apply(job->kernels, job->normalized + i * job->dim, job->dim, sum);
+        if (job->norms != NULL) job->norms[i] = (float)(l1 ? sum : sqrt(sum));
+    }
+    return HSD_SUCCESS;
+}
+
+/* Rows are read from data; normalized, when not NULL, receives the rows scaled in place. */
+static hsd_status_t norms_run(hsd_norms_op_t op, const float *data, float *normalized,
+                              size_t count, size_t dim, float *norms) {
+    hsd_norms_job_t job;
+    job.kernels = norm_kernels();
+    job.precision = hsd_get_precision();
+    job.op = op;
+    job.data = data;
+    job.normalized = normalized;
+    job.count = count;
+    job.dim = dim;
+    job.norms = norms;
+    size_t blocks = (count + HSD_NORMS_BLOCK - 1) / HSD_NORMS_BLOCK;
+    return hsd_internal_parallel_for(blocks, hsd_get_num_threads(), norms_task, &job);
+}
+
+hsd_status_t hsd_norms_l2_f32(const float *data, size_t count, size_t dim, float *norms) {
+    if (count == 0) return HSD_SUCCESS;
+    if (data == NULL || norms == NULL) return HSD_ERR_NULL_PTR;
+    return norms_run(NORMS_L2, data, NULL, count, dim, norms);
+}
+
+hsd_status_t hsd_norms_l1_f32(const float *data, size_t count, size_t dim, float *norms) {
+    if (count == 0) return HSD_SUCCESS;
+    if (data == NULL || norms == NULL) return HSD_ERR_NULL_PTR;
+    return norms_run(NORMS_L1, data, NULL, count, dim, norms);
+}
+
+hsd_status_t hsd_normalize_rows_f32(float *data, size_t count, size_t dim, float *norms) {
+    if (count == 0) return HSD_SUCCESS;
+    if (data == NULL) return HSD_ERR_NULL_PTR;
+    return norms_run(NORMS_NORMALIZE, data, data, count, dim, norms);
+}
@@ -0,0 +1,398 @@
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "hsd_internal.h"
+#include "hsdlib.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <arm_neon.h>
+#if defined(__ARM_FEATURE_SVE)
+#include <arm_sve.h>
+#endif
+#endif
+
+/*
+ * Pearson correlation from one pass over both vectors. The kernel subtracts a shift (ka, kb)
+ * from every element and accumulates the five moments of the shifted data: sums[0] = sum(a'),
+ * sums[1] = sum(b'), sums[2] = sum(a'b'), sums[3] = sum(a'^2), sums[4] = sum(b'^2). The
+ * correlation does not depend on the shift, but the raw-moment formula cancels badly when the
+ * mean is large next to the spread, so the fast mode shifts by the first elements and the
+ * centered mode by the exact means from a first pass.
+ */
+typedef struct {
+    void (*moments)(const float *a, const float *b, size_t n, float ka, float kb, float *sums);
+    const char *name;
+} hsd_pearson_kernels_t;
+
+static void pearson_moments_scalar(const float *a, const float *b, size_t n, float ka, float kb,
+                                   float *sums) {
+    float sa = 0.0f, sb = 0.0f, sab = 0.0f, saa = 0.0f, sbb = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float x = a[i] - ka, y = b[i] - kb;
+        sa += x;
+        sb += y;
+        sab += x * y;
+        saa += x * x;
+        sbb += y * y;
+    }
+    sums[0] = sa;
+    sums[1] = sb;
+    sums[2] = sab;
+    sums[3] = saa;
+    sums[4] = sbb;
+}
+
+/* Adds the scalar tail's moments to the vector part's. */
+static void pearson_add_tail(const float *a, const float *b, size_t n, float ka, float kb,
+                             float *sums) {
+    float tail[5];
+    pearson_moments_scalar(a, b, n, ka, kb, tail);
+    for (int k = 0; k < 5; ++k) sums[k] += tail[k];
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+__attribute__((target("avx"))) static void pearson_moments_avx(const float *a, const float *b,
+                                                               size_t n, float ka, float kb,
+                                                               float *sums) {
+    const __m256 vka = _mm256_set1_ps(ka), vkb = _mm256_set1_ps(kb);
+    __m256 sa = _mm256_setzero_ps(), sb = _mm256_setzero_ps(), sab = _mm256_setzero_ps();
+    __m256 saa = _mm256_setzero_ps(), sbb = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_sub_ps(_mm256_loadu_ps(a + i), vka);
+        __m256 y = _mm256_sub_ps(_mm256_loadu_ps(b + i), vkb);
+        sa = _mm256_add_ps(sa, x);
+        sb = _mm256_add_ps(sb, y);
+        sab = _mm256_add_ps(sab, _mm256_mul_ps(x, y));
+        saa = _mm256_add_ps(saa, _mm256_mul_ps(x, x));
+        sbb = _mm256_add_ps(sbb, _mm256_mul_ps(y, y));
+    }
+    sums[0] = hsd_internal_hsum_avx_f32(sa);
+    sums[1] = hsd_internal_hsum_avx_f32(sb);
+    sums[2] = hsd_internal_hsum_avx_f32(sab);
+    sums[3] = hsd_internal_hsum_avx_f32(saa);
+    sums[4] = hsd_internal_hsum_avx_f32(sbb);
+    pearson_add_tail(a + i, b + i, n - i, ka, kb, sums);
+}
+
+__attribute__((target("avx2,fma"))) static void pearson_moments_avx2(const float *a,
+                                                                     const float *b, size_t n,
+                                                                     float ka, float kb,
+                                                                     float *sums) {
+    const __m256 vka = _mm256_set1_ps(ka), vkb = _mm256_set1_ps(kb);
+    __m256 sa = _mm256_setzero_ps(), sb = _mm256_setzero_ps(), sab = _mm256_setzero_ps();
+    __m256 saa = _mm256_setzero_ps(), sbb = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_sub_ps(_mm256_loadu_ps(a + i), vka);
+        __m256 y = _mm256_sub_ps(_mm256_loadu_ps(b + i), vkb);
+        sa = _mm256_add_ps(sa, x);
+        sb = _mm256_add_ps(sb, y);
+        sab = _mm256_fmadd_ps(x, y, sab);
+        saa = _mm256_fmadd_ps(x, x, saa);
+        sbb = _mm256_fmadd_ps(y, y, sbb);
+    }
+    sums[0] = hsd_internal_hsum_avx_f32(sa);
+    sums[1] = hsd_internal_hsum_avx_f32(sb);
+    sums[2] = hsd_internal_hsum_avx_f32(sab);
+    sums[3] = hsd_internal_hsum_avx_f32(saa);
+    sums[4] = hsd_internal_hsum_avx_f32(sbb);
+    pearson_add_tail(a + i, b + i, n - i, ka, kb, sums);
+}
+
+__attribute__((target("avx512f"))) static void pearson_moments_avx512(const float *a,
+                                                                      const float *b, size_t n,
+                                                                      float ka, float kb,
+                                                                      float *sums) {
+    const __m512 vka = _mm512_set1_ps(ka), vkb = _mm512_set1_ps(kb);
+    __m512 sa = _mm512_setzero_ps(), sb = _mm512_setzero_ps(), sab = _mm512_setzero_ps();
+    __m512 saa = _mm512_setzero_ps(), sbb = _mm512_setzero_ps();
+    for (size_t i = 0; i < n; i += 16) {
+        __mmask16 m = n - i >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << (n - i)) - 1u);
+        __m512 x = _mm512_maskz_sub_ps(m, _mm512_maskz_loadu_ps(m, a + i), vka);
+        __m512 y = _mm512_maskz_sub_ps(m, _mm512_maskz_loadu_ps(m, b + i), vkb);
+        sa = _mm512_add_ps(sa, x);
+        sb = _mm512_add_ps(sb, y);
+        sab = _mm512_fmadd_ps(x, y, sab);
+        saa = _mm512_fmadd_ps(x, x, saa);
+        sbb = _mm512_fmadd_ps(y, y, sbb);
+    }
+    sums[0] = _mm512_reduce_add_ps(sa);
+    sums[1] = _mm512_reduce_add_ps(sb);
+    sums[2] = _mm512_reduce_add_ps(sab);
+    sums[3] = _mm512_reduce_add_ps(saa);
+    sums[4] = _mm512_reduce_add_ps(sbb);
+}
+#endif
+
+#if defined(__aarch64__) || defined(__arm__)
+static inline float pearson_hsum_neon(float32x4_t acc) {
+#if defined(__aarch64__)
+    return vaddvq_f32(acc);
+#else
+    float32x2_t tmp = vpadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    tmp = vpadd_f32(tmp, tmp);
+    return vget_lane_f32(tmp, 0);
+#endif
+}
+
+static void pearson_moments_neon(const float *a, const float *b, size_t n, float ka, float kb,
+                                 float *sums) {
+    const float32x4_t vka = vdupq_n_f32(ka), vkb = vdupq_n_f32(kb);
+    float32x4_t sa = vdupq_n_f32(0.0f), sb = vdupq_n_f32(0.0f), sab = vdupq_n_f32(0.0f);
+    float32x4_t saa = vdupq_n_f32(0.0f), sbb = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t x = vsubq_f32(vld1q_f32(a + i), vka);
+        float32x4_t y = vsubq_f32(vld1q_f32(b + i), vkb);
+        sa = vaddq_f32(sa, x);
+        sb = vaddq_f32(sb, y);
+        sab = vfmaq_f32(sab, x, y);
+        saa = vfmaq_f32(saa, x, x);
+        sbb = vfmaq_f32(sbb, y, y);
+    }
+    sums[0] = pearson_hsum_neon(sa);
+    sums[1] = pearson_hsum_neon(sb);
+    sums[2] = pearson_hsum_neon(sab);
+    sums[3] = pearson_hsum_neon(saa);
+    sums[4] = pearson_hsum_neon(sbb);
+    pearson_add_tail(a + i, b + i, n - i, ka, kb, sums);
+}
+
+#if defined(__ARM_FEATURE_SVE)
+__attribute__((target("+sve"))) static void pearson_moments_sve(const float *a, const float *b,
+                                                                size_t n, float ka, float kb,
+                                                                float *sums) {
+    svfloat32_t sa = svdup_n_f32(0.0f), sb = svdup_n_f32(0.0f), sab = svdup_n_f32(0.0f);
+    svfloat32_t saa = svdup_n_f32(0.0f), sbb = svdup_n_f32(0.0f);
+    for (uint64_t i = 0; i < n; i += svcntw()) {
+        svbool_t pg = svwhilelt_b32(i, (uint64_t)n);
+        svfloat32_t x = svsub_n_f32_x(pg, svld1_f32(pg, a + i), ka);
+        svfloat32_t y = svsub_n_f32_x(pg, svld1_f32(pg, b + i), kb);
+        sa = svadd_f32_m(pg, sa, x);
+        sb = svadd_f32_m(pg, sb, y);
+        sab = svmla_f32_m(pg, sab, x, y);
+        saa = svmla_f32_m(pg, saa, x, x);
+        sbb = svmla_f32_m(pg, sbb, y, y);
+    }
+    sums[0] = svaddv_f32(svptrue_b32(), sa);
+    sums[1] = svaddv_f32(svptrue_b32(), sb);
+    sums[2] = svaddv_f32(svptrue_b32(), sab);
+    sums[3] = svaddv_f32(svptrue_b32(), saa);
+    sums[4] = svaddv_f32(svptrue_b32(), sbb);
+}
+#endif
+#endif
+
+static const hsd_pearson_kernels_t pearson_kernels_scalar = {pearson_moments_scalar, "Scalar"};
+#if defined(__x86_64__) || defined(_M_X64)
+static const hsd_pearson_kernels_t pearson_kernels_avx = {pearson_moments_avx, "AVX"};
+static const hsd_pearson_kernels_t pearson_kernels_avx2 = {pearson_moments_avx2, "AVX2"};
+static const hsd_pearson_kernels_t pearson_kernels_avx512 = {pearson_moments_avx512, "AVX512F"};
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+static const hsd_pearson_kernels_t pearson_kernels_neon = {pearson_moments_neon, "NEON"};
+#if defined(__ARM_FEATURE_SVE)
+static const hsd_pearson_kernels_t pearson_kernels_sve = {pearson_moments_sve, "SVE"};
+#endif
+#endif
+
+static const hsd_pearson_kernels_t *resolve_pearson_kernels_internal(void) {
+    HSD_Backend forced = hsd_get_current_backend_choice();
+    const hsd_pearson_kernels_t *chosen = &pearson_kernels_scalar;
+
+    if (forced != HSD_BACKEND_AUTO) {
+        hsd_log("Pearson F32: Manual backend requested: %d", forced);
+        bool ok = false;
+        switch (forced) {
+#if defined(__x86_64__) || defined(_M_X64)
+            case HSD_BACKEND_AVX512F:
+                if (hsd_cpu_has_avx512f()) {
+                    chosen = &pearson_kernels_avx512;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX2:
+                if (hsd_cpu_has_avx2() && hsd_cpu_has_fma()) {
+                    chosen = &pearson_kernels_avx2;
+                    ok = true;
+                } else if (hsd_cpu_has_avx()) {
+                    chosen = &pearson_kernels_avx;
+                    ok = true;
+                }
+                break;
+            case HSD_BACKEND_AVX:
+                if (hsd_cpu_has_avx()) {
+                    chosen = &pearson_kernels_avx;
+                    ok = true;
+                }
+                break;
+#endif
+#if defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+            case HSD_BACKEND_SVE:
+                if (hsd_cpu_has_sve()) {
+                    chosen = &pearson_kernels_sve;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_NEON:
+                if (hsd_cpu_has_neon()) {
+                    chosen = &pearson_kernels_neon;
+                    ok = true;
+                }
+                break;
+#endif
+            case HSD_BACKEND_SCALAR:
+                ok = true;
+                break;
+            default:
+                break;
+        }
+        if (!ok) {
+            hsd_log("Forced backend %d not supported, fallback to scalar", forced);
+            chosen = &pearson_kernels_scalar;
+        }
+    } else {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (hsd_cpu_has_avx512f())
+            chosen = &pearson_kernels_avx512;
+        else if (hsd_cpu_has_avx2() && hsd_cpu_has_fma())
+            chosen = &pearson_kernels_avx2;
+        else if (hsd_cpu_has_avx())
+            chosen = &pearson_kernels_avx;
+#elif defined(__aarch64__) || defined(__arm__)
+#if defined(__ARM_FEATURE_SVE)
+        if (hsd_cpu_has_sve())
+            chosen = &pearson_kernels_sve;
+        else if (hsd_cpu_has_neon())
+            chosen = &pearson_kernels_neon;
+#else
+        if (hsd_cpu_has_neon()) chosen = &pearson_kernels_neon;
+#endif
+#endif
+    }
+
+    hsd_log("Dispatch: Resolved Pearson F32 to: %s", chosen->name);
+    return chosen;
+}
+
+static atomic_uintptr_t hsd_pearson_kernels_ptr = ATOMIC_VAR_INIT((uintptr_t)0);
+
+static const hsd_pearson_kernels_t *pearson_kernels(void) {
+    uintptr_t cur = atomic_load_explicit(&hsd_pearson_kernels_ptr, memory_order_acquire);
+    if (cur != 0) return (const hsd_pearson_kernels_t *)cur;
+    const hsd_pearson_kernels_t *resolved = resolve_pearson_kernels_internal();
+    atomic_compare_exchange_strong_explicit(&hsd_pearson_kernels_ptr, &cur, (uintptr_t)resolved,
+                                            memory_order_release, memory_order_relaxed);
+    return resolved;
+}
+
+/*
+ * The deterministic mode uses this sequential f64 loop, whose order does not depend on the
+ * backend; the f64 mode uses the vectorized hsd_internal_precise_moments_f32.
+ */
+static void pearson_moments_sequential(const float *a, const float *b, size_t n, double ka,
+                                       double kb, double *sums) {
+    for (int k = 0; k < 5; ++k) sums[k] = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double x = (double)a[i] - ka, y = (double)b[i] - kb;
+        sums[0] += x;
+        sums[1] += y;
+        sums[2] += x * y;
+        sums[3] += x * x;
+        sums[4] += y * y;
+    }
+}
+
+static void pearson_moments(const float *a, const float *b, size_t n, double ka, double kb,
+                            double *sums) {
+    HSD_Precision precision = hsd_get_precision();
+    if (precision == HSD_PRECISION_F64) {
+        hsd_internal_precise_moments_f32(a, b, n, ka, kb, sums);
+        return;
+    }
+    if (precision == HSD_PRECISION_DETERMINISTIC) {
+        pearson_moments_sequential(a, b, n, ka, kb, sums);
+        return;
+    }
+    float f[5];
+    pearson_kernels()->moments(a, b, n, (float)ka, (float)kb, f);
+    for (int k = 0; k < 5; ++k) sums[k] = f[k];
+}
+
+/* Correlation of the shifted moments; a constant vector has no correlation and gives 0. */
+static hsd_status_t pearson_from_moments(const double *sums, size_t n, float *result) {
+#if HSD_ALLOW_FP_CHECKS
+    for (int k = 0; k < 5; ++k) {
+        if (isnan(sums[k]) || isinf(sums[k])) {
+            *result = NAN;
+            return HSD_ERR_INVALID_INPUT;
+        }
+    }
+#endif
+    double inv_n = 1.0 / (double)n;
+    double cov = sums[2] - sums[0] * sums[1] * inv_n;
+    double var_a = sums[3] - sums[0] * sums[0] * inv_n;
+    double var_b = sums[4] - sums[1] * sums[1] * inv_n;
+    double r = 0.0;
+    if (var_a > 0.0 && var_b > 0.0) {
+        r = cov / (sqrt(var_a) * sqrt(var_b));
+        if (r > 1.0) r = 1.0;
+        if (r < -1.0) r = -1.0;
+    }
+    *result = (float)r;
+    return HSD_SUCCESS;
+}
+
+/* Handles NULL pointers and empty vectors; true means the call is over and *status is final. */
+static bool pearson_early_exit(const float *a, const float *b, size_t n, float *result,
+                               hsd_status_t *status) {
+    if (result == NULL) {
+        *status = HSD_ERR_NULL_PTR;
+        return true;
+    }
+    if (n == 0) {
+        *result = 0.0f;
+        *status = HSD_SUCCESS;
+        return true;
+    }
+    if (a == NULL || b == NULL) {
+        *result = NAN;
+        *status = HSD_ERR_NULL_PTR;
+        return true;
+    }
+    return false;
+}
+
+hsd_status_t hsd_sim_pearson_f32(const float *a, const float *b, size_t n, float *result) {
+    hsd_status_t status;
+    if (pearson_early_exit(a, b, n, result, &status)) return status;
+    double sums[5];
+    pearson_moments(a, b, n, a[0], b[0], sums);
+    return pearson_from_moments(sums, n, result);
+}
+
+void hsd_internal_centered_moments_f32(const float *a, const float *b, size_t n,
+                                       double sums[5]) {
+    pearson_moments(a, b, n, a[0], b[0], sums);
+    double mean_a = a[0] + sums[0] / (double)n;
+    double mean_b = b[0] + sums[1] / (double)n;
+    if (isnan(mean_a) || isinf(mean_a) || isnan(mean_b) || isinf(mean_b)) return;
+    pearson_moments(a, b, n, mean_a, mean_b, sums);
+}
+
+hsd_status_t hsd_sim_pearson_centered_f32(const float *a, const float *b, size_t n,
+                                          float *result) {
+    hsd_status_t status;
+    if (pearson_early_exit(a, b, n, result, &status)) return status;
+    double sums[5];
+    hsd_internal_centered_moments_f32(a, b, n, sums);
+    return pearson_from_moments(sums, n, result);
+}
@@ -1,6 +1,8 @@
 #include <stdatomic.h>
 #include <stdio.h>
+#include <string.h>
 
+#include "hsd_internal.h"
 #include "hsdlib.h"
 
 #if defined(__x86_64__) || defined(_M_X64)
@@ -235,3 +237,29 @@ hsd_fp_status_t hsd_get_fp_mode_status(void) {
 #endif
     return status;
 }
+
+float hsd_internal_f16_to_f32(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    uint32_t exp = (h >> 10) & 0x1Fu;
+    uint32_t mant = h & 0x3FFu;
+    uint32_t bits;
+    if (exp == 0) {
+        if (mant == 0) {
+            bits = sign;
+        } else {
+            exp = 127 - 15 + 1;
+            while ((mant & 0x400u) == 0) {
+                mant <<= 1;
+                exp--;
+            }
+            bits = sign | (exp << 23) | ((mant & 0x3FFu) << 13);
+        }
+    } else if (exp == 0x1F) {
+        bits = sign | 0x7F800000u | (mant << 13);
+    } else {
+        bits = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    }
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
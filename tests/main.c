@@ -23,9 +23,31 @@ extern void run_utils_tests(void);
 extern void run_sqeuclidean_dist_tests(void);
 extern void run_manhattan_dist_tests(void);
 extern void run_hamming_dist_tests(void);
+extern void run_bounded_dist_tests(void);
+extern void run_minkowski_tests(void);
+extern void run_divergence_tests(void);
+extern void run_canberra_tests(void);
+extern void run_haversine_tests(void);
+extern void run_dtw_tests(void);
+extern void run_znorm_tests(void);
+extern void run_levenshtein_tests(void);
+extern void run_sliding_tests(void);
+extern void run_mahalanobis_tests(void);
+extern void run_wasserstein_tests(void);
 extern void run_cosine_sim_tests(void);
 extern void run_dot_sim_tests(void);
+extern void run_pearson_tests(void);
 extern void run_jaccard_sim_tests(void);
+extern void run_f64_tests(void);
+extern void run_norm_tests(void);
+extern void run_precision_tests(void);
+extern void run_index_flat_tests(void);
+extern void run_index_hnsw_tests(void);
+extern void run_index_ivf_tests(void);
+extern void run_index_numa_tests(void);
+extern void run_kmeans_tests(void);
+extern void run_vecfile_tests(void);
+extern void run_parallel_tests(void);
 
 int main(void) {
     const char* forced_backend_str = getenv("HSD_TEST_FORCE_BACKEND");
@@ -49,9 +71,31 @@ int main(void) {
     run_manhattan_dist_tests();
     run_sqeuclidean_dist_tests();
     run_hamming_dist_tests();
+    run_bounded_dist_tests();
+    run_minkowski_tests();
+    run_divergence_tests();
+    run_canberra_tests();
+    run_haversine_tests();
+    run_dtw_tests();
+    run_znorm_tests();
+    run_levenshtein_tests();
+    run_sliding_tests();
+    run_mahalanobis_tests();
+    run_wasserstein_tests();
     run_cosine_sim_tests();
     run_dot_sim_tests();
+    run_pearson_tests();
     run_jaccard_sim_tests();
+    run_f64_tests();
+    run_norm_tests();
+    run_precision_tests();
+    run_index_flat_tests();
+    run_index_hnsw_tests();
+    run_index_ivf_tests();
+    run_index_numa_tests();
+    run_kmeans_tests();
+    run_vecfile_tests();
+    run_parallel_tests();
     run_utils_tests();
 
     printf("\n--- Test Suite Summary ---\n");
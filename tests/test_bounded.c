@@ -0,0 +1,113 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define BOUNDED_TEST_MAX_N 1537
+
+typedef hsd_status_t (*bounded_f32_t)(const float *, const float *, size_t, float, float *);
+
+/* A bound at or above the distance keeps it bit for bit; anything below rejects it. */
+static int bounded_f32_consistent(hsd_func_f32_f32 full_fn, bounded_f32_t bounded_fn,
+                                  const float *a, const float *b, size_t n) {
+    float full, r1, r2, r3, r4;
+    if (full_fn(a, b, n, &full) != HSD_SUCCESS) return 0;
+    return bounded_fn(a, b, n, INFINITY, &r1) == HSD_SUCCESS && r1 == full &&
+           bounded_fn(a, b, n, full, &r2) == HSD_SUCCESS && r2 == full &&
+           bounded_fn(a, b, n, nextafterf(full, 0.0f), &r3) == HSD_SUCCESS && isinf(r3) &&
+           bounded_fn(a, b, n, 0.25f * full, &r4) == HSD_SUCCESS && isinf(r4);
+}
+
+void run_bounded_dist_tests(void) {
+    printf("\n======= Running Bounded Distance Tests =======\n");
+
+    uint64_t state = 45;
+    static float a[BOUNDED_TEST_MAX_N], b[BOUNDED_TEST_MAX_N];
+    static uint8_t ua[BOUNDED_TEST_MAX_N], ub[BOUNDED_TEST_MAX_N];
+    for (size_t i = 0; i < BOUNDED_TEST_MAX_N; ++i) {
+        a[i] = test_rand_f32(&state) * 3.0f;
+        b[i] = test_rand_f32(&state) * 3.0f;
+        ua[i] = (uint8_t)(test_rand_f32(&state) * 128.0f + 128.0f);
+        ub[i] = (uint8_t)(test_rand_f32(&state) * 128.0f + 128.0f);
+    }
+    /* Lengths around the vector widths and the periodic check strides. */
+    const size_t lengths[] = {1, 7, 8, 17, 127, 128, 129, 255, 256, 300, 1536, BOUNDED_TEST_MAX_N};
+    const size_t n_lengths = sizeof(lengths) / sizeof(lengths[0]);
+
+    {
+        int ok = 1;
+        for (size_t l = 0; ok && l < n_lengths; ++l) {
+            ok = bounded_f32_consistent(hsd_dist_sqeuclidean_f32, hsd_dist_sqeuclidean_bounded_f32,
+                                        a, b, lengths[l]) &&
+                 bounded_f32_consistent(hsd_dist_manhattan_f32, hsd_dist_manhattan_bounded_f32, a,
+                                        b, lengths[l]);
+        }
+        test_check(ok, "Squared Euclidean and Manhattan match unbounded kernels", "hsd_bounded");
+    }
+
+    {
+        int ok = 1;
+        for (size_t l = 0; ok && l < n_lengths; ++l) {
+            size_t n = lengths[l];
+            uint64_t full, r1, r2, r3;
+            ok = hsd_dist_hamming_u8(ua, ub, n, &full) == HSD_SUCCESS && full > 0 &&
+                 hsd_dist_hamming_bounded_u8(ua, ub, n, UINT64_MAX, &r1) == HSD_SUCCESS &&
+                 r1 == full && hsd_dist_hamming_bounded_u8(ua, ub, n, full, &r2) == HSD_SUCCESS &&
+                 r2 == full &&
+                 hsd_dist_hamming_bounded_u8(ua, ub, n, full - 1, &r3) == HSD_SUCCESS &&
+                 r3 == UINT64_MAX;
+        }
+        test_check(ok, "Hamming matches unbounded kernel", "hsd_bounded");
+    }
+
+    {
+        /* A far-off prefix ends the scan before the NaN near the end is ever read. */
+        static float x[BOUNDED_TEST_MAX_N], y[BOUNDED_TEST_MAX_N];
+        for (size_t i = 0; i < BOUNDED_TEST_MAX_N; ++i) {
+            x[i] = i < 256 ? 100.0f : 0.0f;
+            y[i] = 0.0f;
+        }
+        x[BOUNDED_TEST_MAX_N - 40] = NAN;
+        float r1 = 0.0f, r2 = 0.0f;
+        int ok = hsd_dist_sqeuclidean_bounded_f32(x, y, BOUNDED_TEST_MAX_N, 1.0f, &r1) ==
+                     HSD_SUCCESS &&
+                 isinf(r1) &&
+                 hsd_dist_manhattan_bounded_f32(x, y, BOUNDED_TEST_MAX_N, 1.0f, &r2) ==
+                     HSD_SUCCESS &&
+                 isinf(r2) &&
+                 hsd_dist_sqeuclidean_bounded_f32(x, y, BOUNDED_TEST_MAX_N, INFINITY, &r1) ==
+                     HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Early abandoning skips the rest of the vector", "hsd_bounded");
+    }
+
+    {
+        /* The non-fast precision modes compute the full distance and then apply the bound. */
+        float full, r1, r2;
+        int ok = hsd_set_precision(HSD_PRECISION_F64) == HSD_SUCCESS &&
+                 hsd_dist_sqeuclidean_f32(a, b, 300, &full) == HSD_SUCCESS &&
+                 hsd_dist_sqeuclidean_bounded_f32(a, b, 300, full, &r1) == HSD_SUCCESS &&
+                 r1 == full &&
+                 hsd_dist_sqeuclidean_bounded_f32(a, b, 300, 0.5f * full, &r2) == HSD_SUCCESS &&
+                 isinf(r2);
+        ok = hsd_set_precision(HSD_PRECISION_FAST) == HSD_SUCCESS && ok;
+        test_check(ok, "Precision mode applies the bound to the full distance", "hsd_bounded");
+    }
+
+    {
+        float r = 1.0f;
+        uint64_t u = 1;
+        int ok = hsd_dist_sqeuclidean_bounded_f32(a, b, 0, 0.0f, &r) == HSD_SUCCESS && r == 0.0f &&
+                 hsd_dist_manhattan_bounded_f32(a, b, 0, -1.0f, &r) == HSD_SUCCESS && isinf(r) &&
+                 hsd_dist_hamming_bounded_u8(ua, ub, 0, 0, &u) == HSD_SUCCESS && u == 0 &&
+                 hsd_dist_sqeuclidean_bounded_f32(a, b, 8, NAN, &r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_manhattan_bounded_f32(a, b, 8, NAN, &r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_sqeuclidean_bounded_f32(NULL, b, 8, 1.0f, &r) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_manhattan_bounded_f32(a, b, 8, 1.0f, NULL) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_hamming_bounded_u8(ua, NULL, 8, 1, &u) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Invalid inputs", "hsd_bounded");
+    }
+
+    printf("======= Finished Bounded Distance Tests =======\n");
+}
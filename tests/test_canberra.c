@@ -0,0 +1,100 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define CANBERRA_TEST_MAX_N 1031
+
+static double simple_canberra(const float *a, const float *b, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double den = fabs((double)a[i]) + fabs((double)b[i]);
+        if (den != 0.0) sum += fabs((double)a[i] - (double)b[i]) / den;
+    }
+    return sum;
+}
+
+static double simple_braycurtis(const float *a, const float *b, size_t n) {
+    double num = 0.0, den = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        num += fabs((double)a[i] - (double)b[i]);
+        den += fabs((double)a[i] + (double)b[i]);
+    }
+    return den == 0.0 ? 0.0 : num / den;
+}
+
+static int canberra_close(float got, double want) {
+    return fabs((double)got - want) <= 1e-5 * (1.0 + fabs(want));
+}
+
+void run_canberra_tests(void) {
+    printf("\n======= Running Canberra and Bray-Curtis Tests =======\n");
+
+    uint64_t state = 41;
+    float a[CANBERRA_TEST_MAX_N], b[CANBERRA_TEST_MAX_N];
+    float ca[CANBERRA_TEST_MAX_N], cb[CANBERRA_TEST_MAX_N];
+    for (size_t i = 0; i < CANBERRA_TEST_MAX_N; ++i) {
+        a[i] = test_rand_f32(&state) * 5.0f;
+        b[i] = test_rand_f32(&state) * 5.0f;
+        /* Abundance-style counts with shared zeros, as in ecological data. */
+        ca[i] = (i % 5 == 2) ? 0.0f : floorf(fabsf(a[i]) * 4.0f);
+        cb[i] = (i % 5 == 2 || i % 11 == 0) ? 0.0f : floorf(fabsf(b[i]) * 4.0f);
+    }
+
+    {
+        /* Lengths around every backend's vector width. */
+        const size_t lengths[] = {1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 100, CANBERRA_TEST_MAX_N};
+        int ok = 1;
+        for (size_t l = 0; ok && l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            size_t n = lengths[l];
+            float c, cz, bc, bcz;
+            ok = hsd_dist_canberra_f32(a, b, n, &c) == HSD_SUCCESS &&
+                 hsd_dist_canberra_f32(ca, cb, n, &cz) == HSD_SUCCESS &&
+                 hsd_dist_braycurtis_f32(a, b, n, &bc) == HSD_SUCCESS &&
+                 hsd_dist_braycurtis_f32(ca, cb, n, &bcz) == HSD_SUCCESS;
+            ok = ok && canberra_close(c, simple_canberra(a, b, n)) &&
+                 canberra_close(cz, simple_canberra(ca, cb, n)) &&
+                 canberra_close(bc, simple_braycurtis(a, b, n)) &&
+                 canberra_close(bcz, simple_braycurtis(ca, cb, n)) && bcz >= 0.0f &&
+                 bcz <= 1.0f;
+        }
+        test_check(ok, "Canberra and Bray-Curtis match reference", "hsd_canberra");
+    }
+
+    {
+        /* All-zero coordinates sit in full vectors and in the scalar tail. */
+        float x[37] = {0.0f}, y[37] = {0.0f};
+        float c = -1.0f, bc = -1.0f;
+        int ok = hsd_dist_canberra_f32(x, y, 37, &c) == HSD_SUCCESS && c == 0.0f &&
+                 hsd_dist_braycurtis_f32(x, y, 37, &bc) == HSD_SUCCESS && bc == 0.0f;
+        x[5] = 2.0f;
+        y[36] = -3.0f;
+        ok = ok && hsd_dist_canberra_f32(x, y, 37, &c) == HSD_SUCCESS && c == 2.0f &&
+             hsd_dist_braycurtis_f32(x, y, 37, &bc) == HSD_SUCCESS && bc == 1.0f;
+        ok = ok && hsd_dist_canberra_f32(a, a, 100, &c) == HSD_SUCCESS && c == 0.0f &&
+             hsd_dist_braycurtis_f32(ca, ca, 100, &bc) == HSD_SUCCESS && bc == 0.0f;
+        test_check(ok, "Zero denominators", "hsd_canberra");
+    }
+
+    {
+        float bad[20], neg[4] = {1.0f, -1.0f, 2.0f, -2.0f}, pos[4] = {-1.0f, 1.0f, -2.0f, 2.0f};
+        for (size_t i = 0; i < 20; ++i) bad[i] = (float)i;
+        float r = 1.0f;
+        int ok = hsd_dist_canberra_f32(a, b, 0, &r) == HSD_SUCCESS && r == 0.0f &&
+                 hsd_dist_braycurtis_f32(a, b, 0, &r) == HSD_SUCCESS && r == 0.0f &&
+                 hsd_dist_braycurtis_f32(neg, pos, 4, &r) == HSD_ERR_INVALID_INPUT;
+        for (size_t pos_i = 0; ok && pos_i < 20; pos_i += 3) {
+            bad[pos_i] = NAN;
+            ok = hsd_dist_canberra_f32(bad, b, 20, &r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_braycurtis_f32(b, bad, 20, &r) == HSD_ERR_INVALID_INPUT;
+            bad[pos_i] = (float)pos_i;
+        }
+        ok = ok && hsd_dist_canberra_f32(NULL, b, 4, &r) == HSD_ERR_NULL_PTR &&
+             hsd_dist_braycurtis_f32(a, NULL, 4, &r) == HSD_ERR_NULL_PTR &&
+             hsd_dist_canberra_f32(a, b, 4, NULL) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Invalid inputs", "hsd_canberra");
+    }
+
+    printf("======= Finished Canberra and Bray-Curtis Tests =======\n");
+}
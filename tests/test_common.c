@@ -10,6 +10,28 @@
 
 int g_test_failed = 0;
 
+void test_check(int ok, const char *test_name, const char *suite) {
+    if (ok) {
+        printf("PASS: %s [%s]\n", test_name, suite);
+    } else {
+        fprintf(stderr, "FAIL: %s [%s]\n", test_name, suite);
+        g_test_failed++;
+    }
+}
+
+uint64_t test_rand_u64(uint64_t *state) {
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return *state;
+}
+
+float test_rand_f32(uint64_t *state) {
+    return (float)(test_rand_u64(state) >> 40) / (float)(1ull << 24) * 2.0f - 1.0f;
+}
+
+double test_rand_f64(uint64_t *state) {
+    return (double)(test_rand_u64(state) >> 11) / (double)(1ull << 53) * 2.0 - 1.0;
+}
+
 #ifndef __has_builtin
 #define __has_builtin(x) 0
 #endif
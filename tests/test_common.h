@@ -35,6 +35,14 @@ void run_test_expect_failure_status_u16(hsd_func_u16_f32 func_to_test, const cha
                                         const char *test_name, const uint16_t *a, const uint16_t *b,
                                         size_t n);
 
+/* Prints PASS or FAIL for one check of a suite; a failure is counted in g_test_failed. */
+void test_check(int ok, const char *test_name, const char *suite);
+
+/* Deterministic LCG for test data; the float variants are uniform in [-1, 1). */
+uint64_t test_rand_u64(uint64_t *state);
+float test_rand_f32(uint64_t *state);
+double test_rand_f64(uint64_t *state);
+
 float simple_sqeuclidean_f32(const float *a, const float *b, const size_t n);
 float simple_cosine_sim_f32(const float *a, const float *b, const size_t n);
 float simple_dot_f32(const float *a, const float *b, const size_t n);
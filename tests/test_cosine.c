@@ -218,5 +218,69 @@ void run_cosine_sim_tests(void) {
     printf("-- Finished Large Vector Tests [%s] --\n", func_name);
     // --- End Large Vector Tests ---
 
+    // --- Precomputed Norms Tests ---
+    {
+        enum { ROWS = 37, DIM = 133 };
+        float *rows = (float *)malloc(ROWS * DIM * sizeof(float));
+        float norms[ROWS], batch[ROWS], r;
+        int ok = rows != NULL;
+        for (size_t i = 0; ok && i < ROWS * DIM; ++i)
+            rows[i] = (float)((i * 7) % 23) * 0.25f - 2.5f;
+        for (size_t j = 0; ok && j < DIM; ++j) rows[5 * DIM + j] = 0.0f;
+
+        ok = ok && hsd_norms_l2_f32(rows, ROWS, DIM, norms) == HSD_SUCCESS;
+        for (size_t i = 0; ok && i < ROWS; ++i) {
+            float want = sqrtf(simple_dot_f32(rows + i * DIM, rows + i * DIM, DIM));
+            ok = fabsf(norms[i] - want) <= 1e-5f * (1.0f + want);
+        }
+        for (size_t i = 0; ok && i < ROWS; ++i) {
+            float got, want;
+            ok = hsd_sim_cosine_normed_f32(rows, rows + i * DIM, DIM, norms[0], norms[i], &got) ==
+                     HSD_SUCCESS &&
+                 hsd_sim_cosine_f32(rows, rows + i * DIM, DIM, &want) == HSD_SUCCESS &&
+                 fabsf(got - want) <= 1e-5f;
+        }
+        test_check(ok, "Precomputed norms match cosine", "hsd_sim_cosine_normed_f32");
+
+        ok = rows != NULL &&
+             hsd_sim_cosine_normed_f32(rows + 5 * DIM, rows + 5 * DIM, DIM, 0.0f, 0.0f, &r) ==
+                 HSD_SUCCESS &&
+             r == 1.0f &&
+             hsd_sim_cosine_normed_f32(rows, rows + 5 * DIM, DIM, norms[0], 0.0f, &r) ==
+                 HSD_SUCCESS &&
+             r == 0.0f;
+        test_check(ok, "Zero norm", "hsd_sim_cosine_normed_f32");
+
+        ok = rows != NULL &&
+             hsd_sim_cosine_normed_f32(rows, rows, DIM, -1.0f, norms[0], &r) ==
+                 HSD_ERR_INVALID_INPUT &&
+             hsd_sim_cosine_normed_f32(rows, rows, DIM, NAN, norms[0], &r) ==
+                 HSD_ERR_INVALID_INPUT &&
+             hsd_sim_cosine_normed_f32(NULL, rows, DIM, 1.0f, 1.0f, &r) == HSD_ERR_NULL_PTR &&
+             hsd_norms_l2_f32(NULL, ROWS, DIM, norms) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Negative norm and invalid arguments", "hsd_sim_cosine_normed_f32");
+
+        ok = rows != NULL && hsd_sim_cosine_normed_batch_f32(rows + 3 * DIM, norms[3], rows, norms,
+                                                             ROWS, DIM, batch) == HSD_SUCCESS;
+        for (size_t i = 0; ok && i < ROWS; ++i) {
+            float want;
+            ok = hsd_sim_cosine_normed_f32(rows + 3 * DIM, rows + i * DIM, DIM, norms[3], norms[i],
+                                           &want) == HSD_SUCCESS &&
+                 batch[i] == want;
+        }
+        ok = ok && batch[5] == 0.0f;
+        /* A bad norm anywhere is rejected before any output is written. */
+        for (size_t i = 0; i < ROWS; ++i) batch[i] = -2.0f;
+        norms[7] = -1.0f;
+        ok = ok &&
+             hsd_sim_cosine_normed_batch_f32(rows, norms[0], rows, norms, ROWS, DIM, batch) ==
+                 HSD_ERR_INVALID_INPUT &&
+             batch[0] == -2.0f &&
+             hsd_sim_cosine_normed_batch_f32(rows, norms[0], rows, NULL, ROWS, DIM, batch) ==
+                 HSD_ERR_NULL_PTR;
+        test_check(ok, "Batch matches single calls", "hsd_sim_cosine_normed_batch_f32");
+        free(rows);
+    }
+
     printf("======= Finished Cosine Similarity Tests =======\n");
 }
@@ -0,0 +1,131 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define DIVERGENCE_TEST_MAX_N 1031
+
+/* Fills v with a probability vector; every seventh entry is zero when with_zeros is set. */
+static void make_distribution(float *v, size_t n, bool with_zeros, uint64_t *state) {
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = (with_zeros && i % 7 == 3) ? 0.0f : fabsf(test_rand_f32(state)) + 1e-3f;
+        total += v[i];
+    }
+    for (size_t i = 0; i < n; ++i) v[i] = (float)(v[i] / total);
+}
+
+static double simple_kl(const float *p, const float *q, size_t n, double eps) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double x = fmax(p[i], eps), y = fmax(q[i], eps);
+        if (x > 0.0) sum += x * log(x / y);
+    }
+    return sum;
+}
+
+static double simple_js(const float *p, const float *q, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double m = 0.5 * ((double)p[i] + (double)q[i]);
+        if (p[i] > 0.0f) sum += p[i] * log(p[i] / m);
+        if (q[i] > 0.0f) sum += q[i] * log(q[i] / m);
+    }
+    return 0.5 * sum;
+}
+
+static int divergence_close(float got, double want) {
+    return fabs((double)got - want) <= 1e-5 * fabs(want) + 1e-6;
+}
+
+void run_divergence_tests(void) {
+    printf("\n======= Running Divergence Tests =======\n");
+
+    uint64_t state = 17;
+    float *p = (float *)malloc(DIVERGENCE_TEST_MAX_N * sizeof(float));
+    float *q = (float *)malloc(DIVERGENCE_TEST_MAX_N * sizeof(float));
+    float *pz = (float *)malloc(DIVERGENCE_TEST_MAX_N * sizeof(float));
+    if (p == NULL || q == NULL || pz == NULL) {
+        test_check(0, "Allocation", "hsd_divergence");
+        free(p);
+        free(q);
+        free(pz);
+        return;
+    }
+
+    {
+        /* Lengths around every backend's vector width, with and without zero entries in p. */
+        const size_t lengths[] = {1, 3, 4, 7, 8, 15, 16, 17, 33, 100, DIVERGENCE_TEST_MAX_N};
+        int ok = 1;
+        for (size_t l = 0; ok && l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            size_t n = lengths[l];
+            make_distribution(p, n, false, &state);
+            make_distribution(q, n, false, &state);
+            make_distribution(pz, n, true, &state);
+            float kl, kl_zero, js, js_zero;
+            ok = hsd_dist_kl_f32(p, q, n, &kl) == HSD_SUCCESS &&
+                 hsd_dist_kl_f32(pz, q, n, &kl_zero) == HSD_SUCCESS &&
+                 hsd_dist_jensen_shannon_f32(p, q, n, &js) == HSD_SUCCESS &&
+                 hsd_dist_jensen_shannon_f32(pz, q, n, &js_zero) == HSD_SUCCESS;
+            ok = ok && divergence_close(kl, simple_kl(p, q, n, 0.0)) &&
+                 divergence_close(kl_zero, simple_kl(pz, q, n, 0.0)) &&
+                 divergence_close(js, simple_js(p, q, n)) &&
+                 divergence_close(js_zero, simple_js(pz, q, n)) && js >= -1e-6f &&
+                 js <= (float)log(2.0) + 1e-6f;
+        }
+        float self = -1.0f;
+        ok = ok && hsd_dist_kl_f32(p, p, DIVERGENCE_TEST_MAX_N, &self) == HSD_SUCCESS &&
+             fabsf(self) <= 1e-6f;
+        test_check(ok, "KL and Jensen-Shannon match reference", "hsd_divergence");
+    }
+
+    {
+        /* Zero entries of q make KL unbounded unless epsilon clamping is used. */
+        size_t n = 37;
+        make_distribution(p, n, false, &state);
+        make_distribution(q, n, true, &state);
+        q[0] = 1e-40f; /* A subnormal entry exercises the log rescaling. */
+        float r = 0.0f, js;
+        int ok = hsd_dist_kl_f32(p, q, n, &r) == HSD_ERR_INVALID_INPUT && isinf(r);
+        ok = ok && hsd_dist_kl_eps_f32(p, q, n, 1e-9f, &r) == HSD_SUCCESS &&
+             divergence_close(r, simple_kl(p, q, n, 1e-9f)) &&
+             hsd_dist_jensen_shannon_f32(p, q, n, &js) == HSD_SUCCESS &&
+             divergence_close(js, simple_js(p, q, n));
+        q[0] = 0.0f;
+        q[1] = 1e-40f;
+        p[1] = 0.5f;
+        ok = ok && hsd_dist_kl_eps_f32(p, q, 2, 1e-45f, &r) == HSD_SUCCESS &&
+             divergence_close(r, simple_kl(p, q, 2, 1e-45f));
+        test_check(ok, "Zero and subnormal entries with epsilon clamping", "hsd_divergence");
+    }
+
+    {
+        make_distribution(p, 20, false, &state);
+        make_distribution(q, 20, false, &state);
+        float r = 0.0f;
+        int ok = hsd_dist_kl_f32(p, q, 0, &r) == HSD_SUCCESS && r == 0.0f &&
+                 hsd_dist_kl_eps_f32(p, q, 20, 0.0f, &r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_kl_eps_f32(p, q, 20, NAN, &r) == HSD_ERR_INVALID_INPUT;
+        const float bad_values[] = {-0.25f, NAN, INFINITY};
+        for (size_t v = 0; ok && v < 3; ++v) {
+            for (size_t pos = 0; ok && pos < 20; pos += 9) {
+                float saved = p[pos];
+                p[pos] = bad_values[v];
+                ok = hsd_dist_kl_f32(p, q, 20, &r) == HSD_ERR_INVALID_INPUT &&
+                     hsd_dist_kl_f32(q, p, 20, &r) == HSD_ERR_INVALID_INPUT &&
+                     hsd_dist_jensen_shannon_f32(q, p, 20, &r) == HSD_ERR_INVALID_INPUT;
+                p[pos] = saved;
+            }
+        }
+        ok = ok && hsd_dist_kl_f32(NULL, q, 4, &r) == HSD_ERR_NULL_PTR &&
+             hsd_dist_jensen_shannon_f32(p, q, 4, NULL) == HSD_ERR_NULL_PTR &&
+             hsd_dist_kl_eps_f32(p, NULL, 4, 1e-6f, &r) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Invalid inputs", "hsd_divergence");
+    }
+
+    free(p);
+    free(q);
+    free(pz);
+    printf("======= Finished Divergence Tests =======\n");
+}
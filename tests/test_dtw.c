@@ -0,0 +1,142 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define DTW_TEST_MAX_N 300
+
+/*
+ * Row-by-row DP with the same per-cell float operations as the library, so the result must
+ * match bit for bit. The volatile keeps the compiler from fusing the multiply and the add.
+ */
+static float simple_dtw(const float *a, size_t na, const float *b, size_t nb, size_t band) {
+    size_t w = band > (na > nb ? na - nb : nb - na) ? band : (na > nb ? na - nb : nb - na);
+    float *d = (float *)malloc((na + 1) * (nb + 1) * sizeof(float));
+    for (size_t k = 0; k < (na + 1) * (nb + 1); ++k) d[k] = INFINITY;
+    d[0] = 0.0f;
+    for (size_t i = 1; i <= na; ++i) {
+        for (size_t j = 1; j <= nb; ++j) {
+            if ((i > j ? i - j : j - i) > w) continue;
+            float up = d[(i - 1) * (nb + 1) + j], left = d[i * (nb + 1) + j - 1];
+            float diag = d[(i - 1) * (nb + 1) + j - 1];
+            float m = up < left ? up : left;
+            m = m < diag ? m : diag;
+            float diff = a[i - 1] - b[j - 1];
+            volatile float sq = diff * diff;
+            d[i * (nb + 1) + j] = sq + m;
+        }
+    }
+    float r = d[na * (nb + 1) + nb];
+    free(d);
+    return r;
+}
+
+void run_dtw_tests(void) {
+    printf("\n======= Running DTW Tests =======\n");
+
+    uint64_t state = 44;
+    static float a[DTW_TEST_MAX_N], b[DTW_TEST_MAX_N];
+    for (size_t i = 0; i < DTW_TEST_MAX_N; ++i) {
+        a[i] = sinf(0.05f * (float)i) + 0.3f * test_rand_f32(&state);
+        b[i] = sinf(0.05f * (float)i + 0.4f) + 0.3f * test_rand_f32(&state);
+    }
+
+    {
+        /* Equal and unequal lengths, narrow and unconstrained bands. */
+        const size_t cases[][3] = {{1, 1, 0},     {5, 5, 0},    {17, 23, 3},    {23, 17, 3},
+                                   {64, 64, 5},   {100, 70, 0}, {33, 1, 0},     {200, 200, 10},
+                                   {97, 131, 40}, {DTW_TEST_MAX_N, DTW_TEST_MAX_N, SIZE_MAX}};
+        int ok = 1;
+        for (size_t c = 0; ok && c < sizeof(cases) / sizeof(cases[0]); ++c) {
+            size_t na = cases[c][0], nb = cases[c][1], band = cases[c][2];
+            float r = -1.0f;
+            ok = hsd_dist_dtw_f32(a, na, b, nb, band, &r) == HSD_SUCCESS &&
+                 r == simple_dtw(a, na, b, nb, band);
+        }
+        test_check(ok, "DTW matches row-by-row reference exactly", "hsd_dtw");
+    }
+
+    {
+        /* Band 0 on equal lengths is the squared Euclidean distance; DTW is symmetric. */
+        float r0, sq, r1, r2;
+        int ok = hsd_dist_dtw_f32(a, 77, b, 77, 0, &r0) == HSD_SUCCESS &&
+                 hsd_dist_sqeuclidean_f32(a, b, 77, &sq) == HSD_SUCCESS &&
+                 fabsf(r0 - sq) <= 1e-5f * sq &&
+                 hsd_dist_dtw_f32(a, 50, b, 80, 7, &r1) == HSD_SUCCESS &&
+                 hsd_dist_dtw_f32(b, 80, a, 50, 7, &r2) == HSD_SUCCESS && r1 == r2;
+        float shifted[60];
+        for (size_t i = 0; i < 60; ++i) shifted[i] = a[i < 3 ? 0 : i - 3];
+        float r3;
+        /* Repeating a[0] three times costs nothing once the band allows the length change. */
+        ok = ok && hsd_dist_dtw_f32(a, 57, shifted + 3, 57, 0, &r3) == HSD_SUCCESS && r3 == 0.0f &&
+             hsd_dist_dtw_f32(a, 57, shifted, 60, 0, &r3) == HSD_SUCCESS && r3 == 0.0f;
+        test_check(ok, "Band 0, symmetry and time shifts", "hsd_dtw");
+    }
+
+    {
+        /* Early abandoning returns +inf only when the distance exceeds the bound. */
+        float full, r;
+        int ok = hsd_dist_dtw_f32(a, 150, b, 140, 12, &full) == HSD_SUCCESS;
+        ok = ok && hsd_dist_dtw_bounded_f32(a, 150, b, 140, 12, full * 1.01f, &r) == HSD_SUCCESS &&
+             r == full;
+        ok = ok && hsd_dist_dtw_bounded_f32(a, 150, b, 140, 12, full * 0.99f, &r) == HSD_SUCCESS &&
+             isinf(r);
+        ok = ok && hsd_dist_dtw_bounded_f32(a, 150, b, 140, 12, 0.0f, &r) == HSD_SUCCESS &&
+             isinf(r);
+        test_check(ok, "Early abandoning against best-so-far", "hsd_dtw");
+    }
+
+    {
+        /* Envelope against a naive window scan; LB_Keogh never exceeds DTW. */
+        const size_t n = 128;
+        float upper[128], lower[128];
+        int ok = 1;
+        const size_t bands[] = {0, 1, 5, 16, 200};
+        for (size_t bi = 0; ok && bi < 5; ++bi) {
+            size_t w = bands[bi];
+            ok = hsd_dtw_envelope_f32(b, n, w, upper, lower) == HSD_SUCCESS;
+            for (size_t i = 0; ok && i < n; ++i) {
+                float hi = -INFINITY, lo = INFINITY;
+                for (size_t j = (i > w ? i - w : 0); j < n && j <= i + w; ++j) {
+                    hi = b[j] > hi ? b[j] : hi;
+                    lo = b[j] < lo ? b[j] : lo;
+                }
+                ok = upper[i] == hi && lower[i] == lo;
+            }
+            float lb, dtw;
+            double want = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                double e = a[i] > upper[i] ? a[i] - upper[i] : 0.0;
+                if (a[i] < lower[i]) e = lower[i] - a[i];
+                want += e * e;
+            }
+            ok = ok && hsd_dist_lb_keogh_f32(a, upper, lower, n, &lb) == HSD_SUCCESS &&
+                 hsd_dist_dtw_f32(a, n, b, n, w, &dtw) == HSD_SUCCESS &&
+                 fabs(lb - want) <= 1e-5 * (want + 1e-6) && lb <= dtw * (1.0f + 1e-5f);
+        }
+        test_check(ok, "Envelope and LB_Keogh lower bound", "hsd_dtw");
+    }
+
+    {
+        float bad[10], r = 0.0f;
+        for (size_t i = 0; i < 10; ++i) bad[i] = (float)i;
+        int ok = hsd_dist_dtw_f32(a, 0, b, 0, 0, &r) == HSD_SUCCESS && r == 0.0f &&
+                 hsd_dist_dtw_f32(a, 0, b, 5, 0, &r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_dtw_bounded_f32(a, 5, b, 5, 1, NAN, &r) == HSD_ERR_INVALID_INPUT;
+        bad[7] = NAN;
+        ok = ok && hsd_dist_dtw_f32(bad, 10, b, 12, 2, &r) == HSD_ERR_INVALID_INPUT;
+        bad[7] = INFINITY;
+        ok = ok && hsd_dist_dtw_f32(a, 12, bad, 10, 2, &r) == HSD_ERR_INVALID_INPUT;
+        float upper[10], lower[10];
+        ok = ok && hsd_dtw_envelope_f32(bad, 10, 2, upper, lower) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_dtw_f32(NULL, 4, b, 4, 1, &r) == HSD_ERR_NULL_PTR &&
+             hsd_dist_dtw_f32(a, 4, b, 4, 1, NULL) == HSD_ERR_NULL_PTR &&
+             hsd_dtw_envelope_f32(a, 4, 1, NULL, lower) == HSD_ERR_NULL_PTR &&
+             hsd_dist_lb_keogh_f32(a, NULL, lower, 4, &r) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Invalid inputs", "hsd_dtw");
+    }
+
+    printf("======= Finished DTW Tests =======\n");
+}
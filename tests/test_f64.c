@@ -0,0 +1,87 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define F64_TEST_MAX_N 1031
+
+static int f64_close(double got, long double want) {
+    return fabsl((long double)got - want) <= 1e-12L * (1.0L + fabsl(want));
+}
+
+void run_f64_tests(void) {
+    printf("\n======= Running F64 Kernel Tests =======\n");
+
+    uint64_t state = 7;
+    double a[F64_TEST_MAX_N], b[F64_TEST_MAX_N];
+    for (size_t i = 0; i < F64_TEST_MAX_N; ++i) {
+        a[i] = test_rand_f64(&state) * 10.0;
+        b[i] = test_rand_f64(&state) * 10.0;
+    }
+
+    {
+        /* Lengths around every backend's vector width, plus a tail for each. */
+        const size_t lengths[] = {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33, 100, F64_TEST_MAX_N};
+        int ok = 1;
+        for (size_t l = 0; ok && l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            size_t n = lengths[l];
+            long double sq = 0.0L, l1 = 0.0L, dot = 0.0L, na = 0.0L, nb = 0.0L;
+            for (size_t i = 0; i < n; ++i) {
+                long double x = a[i], y = b[i];
+                sq += (x - y) * (x - y);
+                l1 += fabsl(x - y);
+                dot += x * y;
+                na += x * x;
+                nb += y * y;
+            }
+            double r_sq, r_l1, r_dot, r_cos;
+            ok = hsd_dist_sqeuclidean_f64(a, b, n, &r_sq) == HSD_SUCCESS &&
+                 hsd_dist_manhattan_f64(a, b, n, &r_l1) == HSD_SUCCESS &&
+                 hsd_sim_dot_f64(a, b, n, &r_dot) == HSD_SUCCESS &&
+                 hsd_sim_cosine_f64(a, b, n, &r_cos) == HSD_SUCCESS && f64_close(r_sq, sq) &&
+                 f64_close(r_l1, l1) && f64_close(r_dot, dot) &&
+                 f64_close(r_cos, dot / sqrtl(na * nb));
+        }
+        test_check(ok, "All metrics match extended-precision reference", "hsd_f64");
+    }
+
+    {
+        /* Coordinates near 1e7 that differ by 1e-3: the differences vanish if rounded to f32. */
+        double p[9], q[9];
+        for (size_t i = 0; i < 9; ++i) {
+            p[i] = 6371000.0 + (double)i * 1000.0;
+            q[i] = p[i] + 0.001;
+        }
+        long double sq = 0.0L, l1 = 0.0L;
+        for (size_t i = 0; i < 9; ++i) {
+            long double d = (long double)q[i] - p[i];
+            sq += d * d;
+            l1 += fabsl(d);
+        }
+        double r_sq, r_l1;
+        int ok = hsd_dist_sqeuclidean_f64(p, q, 9, &r_sq) == HSD_SUCCESS &&
+                 hsd_dist_manhattan_f64(p, q, 9, &r_l1) == HSD_SUCCESS && f64_close(r_sq, sq) &&
+                 f64_close(r_l1, l1) && fabs(r_l1 - 9e-3) <= 1e-8;
+        test_check(ok, "Small differences between large coordinates", "hsd_f64");
+    }
+
+    {
+        const double bad[5] = {1.0, NAN, 2.0, 3.0, 4.0};
+        const double inf_vec[5] = {1.0, 2.0, 3.0, 4.0, INFINITY};
+        const double zero[5] = {0.0};
+        double r = -1.0;
+        int ok = hsd_dist_sqeuclidean_f64(a, b, 0, &r) == HSD_SUCCESS && r == 0.0 &&
+                 hsd_sim_cosine_f64(a, b, 0, &r) == HSD_SUCCESS && r == 1.0 &&
+                 hsd_sim_cosine_f64(zero, a, 5, &r) == HSD_SUCCESS && r == 0.0;
+        ok = ok && hsd_dist_sqeuclidean_f64(bad, b, 5, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_manhattan_f64(inf_vec, b, 5, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_sim_dot_f64(a, bad, 5, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_sim_cosine_f64(inf_vec, b, 5, &r) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_sim_dot_f64(NULL, b, 5, &r) == HSD_ERR_NULL_PTR &&
+             hsd_dist_manhattan_f64(a, b, 5, NULL) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Empty, zero, non-finite and null inputs", "hsd_f64");
+    }
+
+    printf("======= Finished F64 Kernel Tests =======\n");
+}
@@ -0,0 +1,143 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define HAVERSINE_TEST_MAX_N 1031
+
+/* Central angle in radians, computed in long double. */
+static long double simple_haversine(double lat, double lon, double qlat, double qlon) {
+    const long double half_deg = 3.14159265358979323846264338327950288L / 360.0L;
+    long double s_lat = sinl(((long double)lat - qlat) * half_deg);
+    long double s_lon = sinl(((long double)lon - qlon) * half_deg);
+    long double h = s_lat * s_lat + cosl(2.0L * lat * half_deg) * cosl(2.0L * qlat * half_deg) *
+                                        s_lon * s_lon;
+    return 2.0L * asinl(sqrtl(h > 1.0L ? 1.0L : h));
+}
+
+/* Haversine loses accuracy near antipodes: an error e in h moves d by about e / cos(d / 2). */
+static int haversine_close(long double got, long double want, long double tol, long double h_err) {
+    return fabsl(got - want) <= tol + h_err / cosl(want / 2.0L);
+}
+
+void run_haversine_tests(void) {
+    printf("\n======= Running Haversine Tests =======\n");
+
+    uint64_t state = 43;
+    static float lat[HAVERSINE_TEST_MAX_N], lon[HAVERSINE_TEST_MAX_N], out[HAVERSINE_TEST_MAX_N];
+    static double lat64[HAVERSINE_TEST_MAX_N], lon64[HAVERSINE_TEST_MAX_N];
+    static double out64[HAVERSINE_TEST_MAX_N];
+    for (size_t i = 0; i < HAVERSINE_TEST_MAX_N; ++i) {
+        lat64[i] = 90.0 * test_rand_f64(&state);
+        lon64[i] = 180.0 * test_rand_f64(&state);
+        lat[i] = (float)lat64[i];
+        lon[i] = (float)lon64[i];
+    }
+
+    {
+        /* Lengths around every backend's vector width, against several query points. */
+        const size_t lengths[] = {1, 2, 3, 4, 7, 8, 15, 16, 17, 33, 100, HAVERSINE_TEST_MAX_N};
+        const double queries[][2] = {{0.0, 0.0}, {51.5074, -0.1278}, {-89.9, 179.5}};
+        int ok = 1;
+        for (size_t q = 0; ok && q < 3; ++q) {
+            float qlat = (float)queries[q][0], qlon = (float)queries[q][1];
+            for (size_t l = 0; ok && l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+                size_t n = lengths[l];
+                ok = hsd_dist_haversine_batch_f32(lat, lon, n, qlat, qlon, out) == HSD_SUCCESS &&
+                     hsd_dist_haversine_batch_f64(lat64, lon64, n, queries[q][0], queries[q][1],
+                                                  out64) == HSD_SUCCESS;
+                for (size_t i = 0; ok && i < n; ++i) {
+                    long double want = simple_haversine(lat[i], lon[i], qlat, qlon);
+                    long double want64 =
+                        simple_haversine(lat64[i], lon64[i], queries[q][0], queries[q][1]);
+                    ok = haversine_close(out[i], want, 2e-6L, 2e-7L) &&
+                         haversine_close(out64[i], want64, 1e-14L, 1e-15L);
+                }
+            }
+        }
+        test_check(ok, "Haversine matches long double reference", "hsd_haversine");
+    }
+
+    {
+        /* Quarter circle, antipodes, poles, the date line and a short hop of about 11 m. */
+        float plat[6] = {0.0f, 0.0f, -90.0f, 10.0f, 45.0001f, 12.5f};
+        float plon[6] = {90.0f, 180.0f, 0.0f, -179.0f, 7.0f, 12.5f};
+        double plat64[6], plon64[6], r64[6];
+        float r[6];
+        for (size_t i = 0; i < 6; ++i) {
+            plat64[i] = plat[i];
+            plon64[i] = plon[i];
+        }
+        const float qlat[6] = {0.0f, 0.0f, 90.0f, 10.0f, 45.0f, 12.5f};
+        const float qlon[6] = {0.0f, 0.0f, 0.0f, 179.0f, 7.0f, 12.5f};
+        int ok = 1;
+        for (size_t i = 0; ok && i < 6; ++i) {
+            ok = hsd_dist_haversine_batch_f32(plat + i, plon + i, 1, qlat[i], qlon[i], r + i) ==
+                     HSD_SUCCESS &&
+                 hsd_dist_haversine_batch_f64(plat64 + i, plon64 + i, 1, qlat[i], qlon[i],
+                                              r64 + i) == HSD_SUCCESS;
+        }
+        const double pi = 3.14159265358979323846;
+        ok = ok && fabsf(r[0] - (float)(pi / 2)) <= 1e-6f && fabsf(r[1] - (float)pi) <= 1e-6f &&
+             fabsf(r[2] - (float)pi) <= 1e-6f && fabs(r64[0] - pi / 2) <= 1e-15 &&
+             fabs(r64[1] - pi) <= 1e-15 && fabs(r64[2] - pi) <= 1e-15;
+        long double wrap = simple_haversine(10.0, -179.0, 10.0, 179.0);
+        long double hop = simple_haversine(plat[4], 7.0, 45.0, 7.0);
+        ok = ok && fabsl(r[3] - wrap) <= 1e-6L && fabsl((r[4] - hop) / hop) <= 1e-5L &&
+             fabsl((r64[4] - hop) / hop) <= 1e-12L && r[5] == 0.0f && r64[5] == 0.0;
+        test_check(ok, "Known distances", "hsd_haversine");
+    }
+
+    {
+        /* The non-fast precision modes use libm in double on every backend. */
+        int ok = hsd_set_precision(HSD_PRECISION_F64) == HSD_SUCCESS &&
+                 hsd_dist_haversine_batch_f32(lat, lon, 100, 30.0f, 60.0f, out) == HSD_SUCCESS &&
+                 hsd_dist_haversine_batch_f64(lat64, lon64, 100, 30.0, 60.0, out64) ==
+                     HSD_SUCCESS;
+        for (size_t i = 0; ok && i < 100; ++i) {
+            ok = haversine_close(out[i], simple_haversine(lat[i], lon[i], 30.0, 60.0), 2e-7L,
+                                 1e-15L) &&
+                 haversine_close(out64[i], simple_haversine(lat64[i], lon64[i], 30.0, 60.0),
+                                 1e-15L, 1e-15L);
+        }
+        ok = hsd_set_precision(HSD_PRECISION_FAST) == HSD_SUCCESS && ok;
+        test_check(ok, "Precision mode uses the scalar kernel", "hsd_haversine");
+    }
+
+    {
+        float bad_lat[20], bad_lon[20], r[20];
+        double bad64[20], r64[20];
+        for (size_t i = 0; i < 20; ++i) {
+            bad_lat[i] = lat[i];
+            bad_lon[i] = lon[i];
+            bad64[i] = lat64[i];
+        }
+        int ok = hsd_dist_haversine_batch_f32(lat, lon, 0, 0.0f, 0.0f, r) == HSD_SUCCESS &&
+                 hsd_dist_haversine_batch_f32(lat, lon, 20, NAN, 0.0f, r) ==
+                     HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_haversine_batch_f64(lat64, lon64, 20, 0.0, INFINITY, r64) ==
+                     HSD_ERR_INVALID_INPUT;
+        for (size_t pos = 0; ok && pos < 20; pos += 3) {
+            bad_lat[pos] = NAN;
+            bad_lon[19 - pos] = INFINITY;
+            bad64[pos] = NAN;
+            ok = hsd_dist_haversine_batch_f32(bad_lat, lon, 20, 1.0f, 2.0f, r) ==
+                     HSD_ERR_INVALID_INPUT &&
+                 isnan(r[pos]) && !isnan(r[(pos + 1) % 20]) &&
+                 hsd_dist_haversine_batch_f32(lat, bad_lon, 20, 1.0f, 2.0f, r) ==
+                     HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_haversine_batch_f64(bad64, lon64, 20, 1.0, 2.0, r64) ==
+                     HSD_ERR_INVALID_INPUT;
+            bad_lat[pos] = lat[pos];
+            bad_lon[19 - pos] = lon[19 - pos];
+            bad64[pos] = lat64[pos];
+        }
+        ok = ok && hsd_dist_haversine_batch_f32(NULL, lon, 4, 0.0f, 0.0f, r) == HSD_ERR_NULL_PTR &&
+             hsd_dist_haversine_batch_f64(lat64, NULL, 4, 0.0, 0.0, r64) == HSD_ERR_NULL_PTR &&
+             hsd_dist_haversine_batch_f32(lat, lon, 4, 0.0f, 0.0f, NULL) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Invalid inputs", "hsd_haversine");
+    }
+
+    printf("======= Finished Haversine Tests =======\n");
+}
@@ -0,0 +1,185 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+
+static uint16_t f32_to_f16_simple(float f) {
+    /* Exact for the small integers used below. */
+    if (f == 0.0f) return 0;
+    uint16_t sign = f < 0 ? 0x8000 : 0;
+    f = fabsf(f);
+    int exp = 0;
+    while (f >= 2.0f) {
+        f /= 2.0f;
+        exp++;
+    }
+    while (f < 1.0f) {
+        f *= 2.0f;
+        exp--;
+    }
+    uint16_t mant = (uint16_t)((f - 1.0f) * 1024.0f);
+    return (uint16_t)(sign | ((exp + 15) << 10) | mant);
+}
+
+static float flat_reference_score(HSD_Metric metric, const float *a, const float *b, size_t n) {
+    switch (metric) {
+        case HSD_METRIC_SQEUCLIDEAN:
+            return simple_sqeuclidean_f32(a, b, n);
+        case HSD_METRIC_MANHATTAN:
+            return simple_manhattan_f32(a, b, n);
+        case HSD_METRIC_DOT:
+            return simple_dot_f32(a, b, n);
+        default:
+            return simple_cosine_sim_f32(a, b, n);
+    }
+}
+
+static void run_flat_bruteforce_check(HSD_Metric metric, const char *test_name) {
+    const size_t dim = 37, rows = 300, k = 5;
+    const bool similarity = (metric == HSD_METRIC_DOT || metric == HSD_METRIC_COSINE);
+    float *data = (float *)malloc(rows * dim * sizeof(float));
+    float query[37];
+    for (size_t i = 0; i < rows * dim; ++i) data[i] = (float)((i * 7919) % 101) / 50.0f - 1.0f;
+    for (size_t i = 0; i < dim; ++i) query[i] = (float)((i * 31) % 17) / 8.0f - 1.0f;
+
+    hsd_index_flat_t *index = NULL;
+    hsd_status_t status = hsd_index_flat_create(dim, HSD_DTYPE_F32, metric, &index);
+    uint64_t first_id = 99;
+    if (status == HSD_SUCCESS) status = hsd_index_flat_add(index, data, rows, &first_id);
+
+    uint64_t ids[5];
+    float scores[5];
+    size_t found = 0;
+    if (status == HSD_SUCCESS)
+        status = hsd_index_flat_search(index, query, k, ids, scores, &found);
+
+    int ok = (status == HSD_SUCCESS && first_id == 0 && found == k);
+    for (size_t i = 0; ok && i < found; ++i) {
+        float expected = flat_reference_score(metric, query, data + ids[i] * dim, dim);
+        if (fabsf(expected - scores[i]) > 1e-3f * (1.0f + fabsf(expected))) ok = 0;
+        if (i > 0 && (similarity ? scores[i] > scores[i - 1] : scores[i] < scores[i - 1])) ok = 0;
+    }
+    /* Only the returned rows may score strictly better than the worst returned one. */
+    size_t better = 0;
+    for (size_t r = 0; ok && r < rows; ++r) {
+        float s = flat_reference_score(metric, query, data + r * dim, dim);
+        float margin = 1e-3f * (1.0f + fabsf(s));
+        if (similarity ? s > scores[k - 1] + margin : s < scores[k - 1] - margin) better++;
+    }
+    ok = ok && better < k;
+    test_check(ok, test_name, "hsd_index_flat");
+    hsd_index_flat_free(index);
+    free(data);
+}
+
+void run_index_flat_tests(void) {
+    printf("\n======= Running Flat Index Tests =======\n");
+
+    run_flat_bruteforce_check(HSD_METRIC_SQEUCLIDEAN, "Top-k matches brute force (SqEuclidean)");
+    run_flat_bruteforce_check(HSD_METRIC_MANHATTAN, "Top-k matches brute force (Manhattan)");
+    run_flat_bruteforce_check(HSD_METRIC_DOT, "Top-k matches brute force (Dot)");
+    run_flat_bruteforce_check(HSD_METRIC_COSINE, "Top-k matches brute force (Cosine)");
+
+    /* Remove, tombstones and compaction */
+    {
+        const size_t dim = 3;
+        hsd_index_flat_t *index = NULL;
+        hsd_index_flat_create(dim, HSD_DTYPE_F32, HSD_METRIC_SQEUCLIDEAN, &index);
+        float rows[200 * 3];
+        for (size_t i = 0; i < 200; ++i) {
+            rows[i * 3 + 0] = (float)i;
+            rows[i * 3 + 1] = 0.0f;
+            rows[i * 3 + 2] = 0.0f;
+        }
+        hsd_index_flat_add(index, rows, 200, NULL);
+        const float query[3] = {10.2f, 0.0f, 0.0f};
+        uint64_t ids[3];
+        float scores[3];
+        size_t found = 0;
+
+        int ok = hsd_index_flat_remove(index, 10) == HSD_SUCCESS;
+        ok = ok && hsd_index_flat_remove(index, 10) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_flat_remove(index, 12345) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_flat_search(index, query, 3, ids, scores, &found) == HSD_SUCCESS;
+        ok = ok && found == 3 && ids[0] == 11 && ids[1] == 9 && ids[2] == 12;
+        test_check(ok, "Removed vector is not returned", "hsd_index_flat");
+
+        for (uint64_t id = 100; id < 200; ++id) hsd_index_flat_remove(index, id);
+        ok = hsd_index_flat_size(index) == 99;
+        uint64_t first_id = 0;
+        float extra[3] = {10.0f, 0.5f, 0.0f};
+        ok = ok && hsd_index_flat_add(index, extra, 1, &first_id) == HSD_SUCCESS;
+        ok = ok && first_id == 200;
+        ok = ok && hsd_index_flat_remove(index, 150) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_flat_search(index, query, 3, ids, scores, &found) == HSD_SUCCESS;
+        ok = ok && found == 3 && ids[0] == 200 && ids[1] == 11 && ids[2] == 9;
+        test_check(ok, "Ids survive compaction and new ids keep increasing", "hsd_index_flat");
+        hsd_index_flat_free(index);
+    }
+
+    /* f16 storage */
+    {
+        const float rows_f32[4][2] = {{1, 2}, {3, 4}, {-1, -2}, {8, 0}};
+        uint16_t rows_f16[8];
+        for (int i = 0; i < 8; ++i) rows_f16[i] = f32_to_f16_simple(rows_f32[i / 2][i % 2]);
+        uint16_t query[2] = {f32_to_f16_simple(3.0f), f32_to_f16_simple(3.0f)};
+        hsd_index_flat_t *index = NULL;
+        int ok = hsd_index_flat_create(2, HSD_DTYPE_F16, HSD_METRIC_SQEUCLIDEAN, &index) ==
+                 HSD_SUCCESS;
+        ok = ok && hsd_index_flat_add(index, rows_f16, 4, NULL) == HSD_SUCCESS;
+        uint64_t ids[2];
+        float scores[2];
+        size_t found = 0;
+        ok = ok && hsd_index_flat_search(index, query, 2, ids, scores, &found) == HSD_SUCCESS;
+        ok = ok && found == 2 && ids[0] == 1 && fabsf(scores[0] - 1.0f) < 1e-6f && ids[1] == 0 &&
+             fabsf(scores[1] - 5.0f) < 1e-6f;
+        test_check(ok, "F16 storage", "hsd_index_flat");
+        hsd_index_flat_free(index);
+    }
+
+    /* u8 bit vectors with Hamming */
+    {
+        const uint8_t rows[3][4] = {{0xFF, 0, 0, 0}, {0x0F, 0, 0, 0}, {0, 0, 0, 0x01}};
+        const uint8_t query[4] = {0x0E, 0, 0, 0};
+        hsd_index_flat_t *index = NULL;
+        int ok = hsd_index_flat_create(4, HSD_DTYPE_U8, HSD_METRIC_HAMMING, &index) == HSD_SUCCESS;
+        ok = ok && hsd_index_flat_add(index, rows, 3, NULL) == HSD_SUCCESS;
+        uint64_t ids[3];
+        float scores[3];
+        size_t found = 0;
+        ok = ok && hsd_index_flat_search(index, query, 10, ids, scores, &found) == HSD_SUCCESS;
+        ok = ok && found == 3 && ids[0] == 1 && scores[0] == 1.0f && ids[1] == 2 &&
+             scores[1] == 4.0f && ids[2] == 0 && scores[2] == 5.0f;
+        test_check(ok, "U8 storage with Hamming and k > size", "hsd_index_flat");
+        hsd_index_flat_free(index);
+    }
+
+    /* Invalid configurations and arguments */
+    {
+        hsd_index_flat_t *index = NULL;
+        int ok = hsd_index_flat_create(0, HSD_DTYPE_F32, HSD_METRIC_DOT, &index) ==
+                 HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_flat_create(8, HSD_DTYPE_U8, HSD_METRIC_COSINE, &index) ==
+                       HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_flat_create(8, HSD_DTYPE_F32, HSD_METRIC_HAMMING, &index) ==
+                       HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_flat_create(8, HSD_DTYPE_F32, HSD_METRIC_DOT, NULL) ==
+                       HSD_ERR_NULL_PTR;
+        ok = ok && hsd_index_flat_create(2, HSD_DTYPE_F32, HSD_METRIC_DOT, &index) == HSD_SUCCESS;
+        float bad[2] = {NAN, 1.0f};
+        float good[2] = {1.0f, 1.0f};
+        hsd_index_flat_add(index, good, 1, NULL);
+        size_t found = 7;
+        uint64_t id;
+        ok = ok && hsd_index_flat_search(index, NULL, 1, &id, NULL, &found) == HSD_ERR_NULL_PTR;
+        ok = ok && found == 0;
+        ok = ok && hsd_index_flat_search(index, bad, 1, &id, NULL, &found) != HSD_SUCCESS;
+        ok = ok && hsd_index_flat_search(index, good, 0, NULL, NULL, &found) == HSD_SUCCESS;
+        test_check(ok, "Invalid arguments", "hsd_index_flat");
+        hsd_index_flat_free(index);
+    }
+
+    printf("======= Finished Flat Index Tests =======\n");
+}
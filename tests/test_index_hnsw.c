@@ -0,0 +1,148 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define HNSW_TEST_DIM 16
+#define HNSW_TEST_ROWS 600
+#define HNSW_TEST_QUERIES 20
+#define HNSW_TEST_K 10
+#define HNSW_TEST_THREADS 4
+
+static double hnsw_recall(hsd_index_hnsw_t *hnsw, HSD_Metric metric, const float *data,
+                          const float *queries) {
+    hsd_index_flat_t *flat = NULL;
+    hsd_index_flat_create(HNSW_TEST_DIM, HSD_DTYPE_F32, metric, &flat);
+    hsd_index_flat_add(flat, data, HNSW_TEST_ROWS, NULL);
+
+    size_t hits = 0;
+    for (size_t q = 0; q < HNSW_TEST_QUERIES; ++q) {
+        uint64_t exact[HNSW_TEST_K], approx[HNSW_TEST_K];
+        size_t n_exact = 0, n_approx = 0;
+        hsd_index_flat_search(flat, queries + q * HNSW_TEST_DIM, HNSW_TEST_K, exact, NULL,
+                              &n_exact);
+        if (hsd_index_hnsw_search(hnsw, queries + q * HNSW_TEST_DIM, HNSW_TEST_K, approx, NULL,
+                                  &n_approx) != HSD_SUCCESS)
+            continue;
+        for (size_t i = 0; i < n_approx; ++i) {
+            for (size_t j = 0; j < n_exact; ++j) {
+                if (approx[i] == exact[j]) {
+                    hits++;
+                    break;
+                }
+            }
+        }
+    }
+    hsd_index_flat_free(flat);
+    return (double)hits / (double)(HNSW_TEST_QUERIES * HNSW_TEST_K);
+}
+
+typedef struct {
+    hsd_index_hnsw_t *index;
+    const float *data;
+    size_t begin;
+    size_t end;
+    uint64_t *ids;
+    hsd_status_t status;
+} hnsw_insert_job_t;
+
+static void *hnsw_insert_worker(void *arg) {
+    hnsw_insert_job_t *job = (hnsw_insert_job_t *)arg;
+    job->status = HSD_SUCCESS;
+    for (size_t i = job->begin; i < job->end && job->status == HSD_SUCCESS; ++i)
+        job->status = hsd_index_hnsw_add(job->index, job->data + i * HNSW_TEST_DIM, &job->ids[i]);
+    return NULL;
+}
+
+void run_index_hnsw_tests(void) {
+    printf("\n======= Running HNSW Index Tests =======\n");
+
+    float *data = (float *)malloc(HNSW_TEST_ROWS * HNSW_TEST_DIM * sizeof(float));
+    float *queries = (float *)malloc(HNSW_TEST_QUERIES * HNSW_TEST_DIM * sizeof(float));
+    uint64_t *ids = (uint64_t *)malloc(HNSW_TEST_ROWS * sizeof(uint64_t));
+    uint64_t state = 42;
+    for (size_t i = 0; i < HNSW_TEST_ROWS * HNSW_TEST_DIM; ++i) data[i] = test_rand_f32(&state);
+    for (size_t i = 0; i < HNSW_TEST_QUERIES * HNSW_TEST_DIM; ++i)
+        queries[i] = test_rand_f32(&state);
+
+    const HSD_Metric metrics[] = {HSD_METRIC_SQEUCLIDEAN, HSD_METRIC_DOT, HSD_METRIC_COSINE};
+    const char *names[] = {"Recall >= 0.9 (SqEuclidean)", "Recall >= 0.9 (Dot)",
+                           "Recall >= 0.9 (Cosine)"};
+    for (size_t m = 0; m < 3; ++m) {
+        hsd_hnsw_params_t params = {12, 64, 48, 7};
+        hsd_index_hnsw_t *index = NULL;
+        int ok = hsd_index_hnsw_create(HNSW_TEST_DIM, metrics[m], HNSW_TEST_ROWS, &params,
+                                       &index) == HSD_SUCCESS;
+        for (size_t i = 0; ok && i < HNSW_TEST_ROWS; ++i) {
+            ok = hsd_index_hnsw_add(index, data + i * HNSW_TEST_DIM, &ids[i]) == HSD_SUCCESS &&
+                 ids[i] == i;
+        }
+        double recall = ok ? hnsw_recall(index, metrics[m], data, queries) : 0.0;
+        printf("INFO: recall@%d = %.3f\n", HNSW_TEST_K, recall);
+        test_check(ok && recall >= 0.9, names[m], "hsd_index_hnsw");
+        hsd_index_hnsw_free(index);
+    }
+
+    /* Concurrent insertion from several threads */
+    {
+        hsd_hnsw_params_t params = {12, 64, 48, 11};
+        hsd_index_hnsw_t *index = NULL;
+        int ok = hsd_index_hnsw_create(HNSW_TEST_DIM, HSD_METRIC_SQEUCLIDEAN, HNSW_TEST_ROWS,
+                                       &params, &index) == HSD_SUCCESS;
+        pthread_t threads[HNSW_TEST_THREADS];
+        hnsw_insert_job_t jobs[HNSW_TEST_THREADS];
+        size_t per = HNSW_TEST_ROWS / HNSW_TEST_THREADS;
+        for (size_t t = 0; ok && t < HNSW_TEST_THREADS; ++t) {
+            jobs[t] = (hnsw_insert_job_t){index, data, t * per, (t + 1) * per, ids, HSD_SUCCESS};
+            pthread_create(&threads[t], NULL, hnsw_insert_worker, &jobs[t]);
+        }
+        for (size_t t = 0; ok && t < HNSW_TEST_THREADS; ++t) {
+            pthread_join(threads[t], NULL);
+            ok = ok && jobs[t].status == HSD_SUCCESS;
+        }
+        ok = ok && hsd_index_hnsw_size(index) == HNSW_TEST_ROWS;
+
+        /* Ids follow insertion order, so map them back to the source rows before comparing. */
+        float *by_id = (float *)malloc(HNSW_TEST_ROWS * HNSW_TEST_DIM * sizeof(float));
+        for (size_t i = 0; ok && i < HNSW_TEST_ROWS; ++i) {
+            for (size_t d = 0; d < HNSW_TEST_DIM; ++d)
+                by_id[ids[i] * HNSW_TEST_DIM + d] = data[i * HNSW_TEST_DIM + d];
+        }
+        double recall = ok ? hnsw_recall(index, HSD_METRIC_SQEUCLIDEAN, by_id, queries) : 0.0;
+        printf("INFO: recall@%d after concurrent insert = %.3f\n", HNSW_TEST_K, recall);
+        test_check(ok && recall >= 0.9, "Concurrent insertion", "hsd_index_hnsw");
+        free(by_id);
+        hsd_index_hnsw_free(index);
+    }
+
+    /* Exact match, capacity and invalid arguments */
+    {
+        hsd_index_hnsw_t *index = NULL;
+        int ok = hsd_index_hnsw_create(HNSW_TEST_DIM, HSD_METRIC_MANHATTAN, 10, NULL, &index) ==
+                 HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_hnsw_create(HNSW_TEST_DIM, HSD_METRIC_SQEUCLIDEAN, 3, NULL, &index) ==
+                       HSD_SUCCESS;
+        uint64_t id = 0;
+        size_t found = 9;
+        ok = ok && hsd_index_hnsw_search(index, data, 1, &id, NULL, &found) == HSD_SUCCESS &&
+             found == 0;
+        for (size_t i = 0; ok && i < 3; ++i)
+            ok = hsd_index_hnsw_add(index, data + i * HNSW_TEST_DIM, &id) == HSD_SUCCESS;
+        ok = ok && hsd_index_hnsw_add(index, data, &id) == HSD_ERR_INVALID_INPUT;
+        float score = -1.0f;
+        ok = ok && hsd_index_hnsw_search(index, data + HNSW_TEST_DIM, 1, &id, &score, &found) ==
+                       HSD_SUCCESS;
+        ok = ok && found == 1 && id == 1 && score == 0.0f;
+        ok = ok && hsd_index_hnsw_set_ef_search(index, 0) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_hnsw_search(index, NULL, 1, &id, NULL, &found) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Exact match, capacity and invalid arguments", "hsd_index_hnsw");
+        hsd_index_hnsw_free(index);
+    }
+
+    free(data);
+    free(queries);
+    free(ids);
+    printf("======= Finished HNSW Index Tests =======\n");
+}
@@ -0,0 +1,163 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define IVF_TEST_DIM 16
+#define IVF_TEST_ROWS 800
+#define IVF_TEST_QUERIES 20
+#define IVF_TEST_CLUSTERS 8
+#define IVF_TEST_K 10
+
+/* Gaussian-ish blobs around a few random centres, so that the coarse quantizer has structure. */
+static void ivf_make_data(float *out, size_t rows, uint64_t *state) {
+    float centres[IVF_TEST_CLUSTERS][IVF_TEST_DIM];
+    uint64_t centre_state = 1234;
+    for (size_t c = 0; c < IVF_TEST_CLUSTERS; ++c) {
+        for (size_t d = 0; d < IVF_TEST_DIM; ++d)
+            centres[c][d] = 4.0f * test_rand_f32(&centre_state);
+    }
+    for (size_t r = 0; r < rows; ++r) {
+        size_t c = r % IVF_TEST_CLUSTERS;
+        for (size_t d = 0; d < IVF_TEST_DIM; ++d)
+            out[r * IVF_TEST_DIM + d] = centres[c][d] + test_rand_f32(state) * 0.8f;
+    }
+}
+
+static size_t ivf_overlap(const uint64_t *a, size_t na, const uint64_t *b, size_t nb) {
+    size_t hits = 0;
+    for (size_t i = 0; i < na; ++i) {
+        for (size_t j = 0; j < nb; ++j) {
+            if (a[i] == b[j]) {
+                hits++;
+                break;
+            }
+        }
+    }
+    return hits;
+}
+
+/* Returns recall@k against the flat index, or a negative value on any API error. */
+static double ivf_recall(const hsd_index_ivf_t *ivf, const hsd_index_flat_t *flat,
+                         const float *queries) {
+    size_t hits = 0;
+    for (size_t q = 0; q < IVF_TEST_QUERIES; ++q) {
+        uint64_t exact[IVF_TEST_K], approx[IVF_TEST_K];
+        size_t n_exact = 0, n_approx = 0;
+        const float *query = queries + q * IVF_TEST_DIM;
+        if (hsd_index_flat_search(flat, query, IVF_TEST_K, exact, NULL, &n_exact) != HSD_SUCCESS ||
+            hsd_index_ivf_search(ivf, query, IVF_TEST_K, approx, NULL, &n_approx) != HSD_SUCCESS)
+            return -1.0;
+        hits += ivf_overlap(approx, n_approx, exact, n_exact);
+    }
+    return (double)hits / (double)(IVF_TEST_QUERIES * IVF_TEST_K);
+}
+
+static void run_ivf_recall_check(HSD_Metric metric, const float *data, const float *queries,
+                                 const char *test_name) {
+    hsd_index_ivf_t *ivf = NULL;
+    hsd_index_flat_t *flat = NULL;
+    int ok = hsd_index_ivf_create(IVF_TEST_DIM, metric, IVF_TEST_CLUSTERS, &ivf) == HSD_SUCCESS;
+    ok = ok && hsd_index_flat_create(IVF_TEST_DIM, HSD_DTYPE_F32, metric, &flat) == HSD_SUCCESS;
+    ok = ok && hsd_index_ivf_train(ivf, data, IVF_TEST_ROWS) == HSD_SUCCESS;
+    uint64_t first_id = 99;
+    ok = ok && hsd_index_ivf_add(ivf, data, IVF_TEST_ROWS, &first_id) == HSD_SUCCESS &&
+         first_id == 0 && hsd_index_ivf_size(ivf) == IVF_TEST_ROWS;
+    ok = ok && hsd_index_flat_add(flat, data, IVF_TEST_ROWS, NULL) == HSD_SUCCESS;
+
+    ok = ok && hsd_index_ivf_set_nprobe(ivf, 3) == HSD_SUCCESS;
+    double recall = ok ? ivf_recall(ivf, flat, queries) : -1.0;
+    printf("INFO: recall@%d with nprobe=3 = %.3f\n", IVF_TEST_K, recall);
+    ok = ok && recall >= 0.9;
+
+    /* Probing every list is an exhaustive scan, so the result must match the flat index. */
+    ok = ok && hsd_index_ivf_set_nprobe(ivf, 1000) == HSD_SUCCESS;
+    ok = ok && ivf_recall(ivf, flat, queries) == 1.0;
+    test_check(ok, test_name, "hsd_index_ivf");
+    hsd_index_ivf_free(ivf);
+    hsd_index_flat_free(flat);
+}
+
+void run_index_ivf_tests(void) {
+    printf("\n======= Running IVF Index Tests =======\n");
+
+    float *data = (float *)malloc(IVF_TEST_ROWS * IVF_TEST_DIM * sizeof(float));
+    float *queries = (float *)malloc(IVF_TEST_QUERIES * IVF_TEST_DIM * sizeof(float));
+    uint64_t state = 42;
+    ivf_make_data(data, IVF_TEST_ROWS, &state);
+    ivf_make_data(queries, IVF_TEST_QUERIES, &state);
+
+    run_ivf_recall_check(HSD_METRIC_SQEUCLIDEAN, data, queries, "Recall vs flat (SqEuclidean)");
+    run_ivf_recall_check(HSD_METRIC_DOT, data, queries, "Recall vs flat (Dot)");
+    run_ivf_recall_check(HSD_METRIC_COSINE, data, queries, "Recall vs flat (Cosine)");
+
+    /* Save and load round trip */
+    {
+        const char *path = "hsd_test_ivf_index.bin";
+        hsd_index_ivf_t *ivf = NULL, *loaded = NULL;
+        int ok = hsd_index_ivf_create(IVF_TEST_DIM, HSD_METRIC_SQEUCLIDEAN, IVF_TEST_CLUSTERS,
+                                      &ivf) == HSD_SUCCESS;
+        ok = ok && hsd_index_ivf_save(ivf, path) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_ivf_train(ivf, data, IVF_TEST_ROWS) == HSD_SUCCESS;
+        ok = ok && hsd_index_ivf_add(ivf, data, IVF_TEST_ROWS, NULL) == HSD_SUCCESS;
+        ok = ok && hsd_index_ivf_set_nprobe(ivf, 2) == HSD_SUCCESS;
+        ok = ok && hsd_index_ivf_save(ivf, path) == HSD_SUCCESS;
+        ok = ok && hsd_index_ivf_load(path, &loaded) == HSD_SUCCESS;
+        ok = ok && hsd_index_ivf_size(loaded) == IVF_TEST_ROWS;
+        for (size_t q = 0; ok && q < IVF_TEST_QUERIES; ++q) {
+            uint64_t a[IVF_TEST_K], b[IVF_TEST_K];
+            float sa[IVF_TEST_K], sb[IVF_TEST_K];
+            size_t na = 0, nb = 0;
+            const float *query = queries + q * IVF_TEST_DIM;
+            ok = hsd_index_ivf_search(ivf, query, IVF_TEST_K, a, sa, &na) == HSD_SUCCESS &&
+                 hsd_index_ivf_search(loaded, query, IVF_TEST_K, b, sb, &nb) == HSD_SUCCESS &&
+                 na == nb;
+            for (size_t i = 0; ok && i < na; ++i) ok = a[i] == b[i] && sa[i] == sb[i];
+        }
+        uint64_t first_id = 0;
+        ok = ok && hsd_index_ivf_add(loaded, data, 1, &first_id) == HSD_SUCCESS &&
+             first_id == IVF_TEST_ROWS;
+        test_check(ok, "Save and load round trip", "hsd_index_ivf");
+        hsd_index_ivf_free(ivf);
+        hsd_index_ivf_free(loaded);
+
+        FILE *f = fopen(path, "wb");
+        if (f != NULL) {
+            fputs("not an index", f);
+            fclose(f);
+        }
+        loaded = NULL;
+        ok = hsd_index_ivf_load(path, &loaded) == HSD_ERR_INVALID_INPUT && loaded == NULL;
+        test_check(ok, "Load rejects a corrupt file", "hsd_index_ivf");
+        remove(path);
+    }
+
+    /* Invalid configurations and arguments */
+    {
+        hsd_index_ivf_t *ivf = NULL;
+        int ok = hsd_index_ivf_create(IVF_TEST_DIM, HSD_METRIC_MANHATTAN, 4, &ivf) ==
+                 HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_ivf_create(IVF_TEST_DIM, HSD_METRIC_DOT, 0, &ivf) ==
+                       HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_ivf_create(IVF_TEST_DIM, HSD_METRIC_DOT, 4, NULL) == HSD_ERR_NULL_PTR;
+        ok = ok && hsd_index_ivf_create(IVF_TEST_DIM, HSD_METRIC_DOT, 4, &ivf) == HSD_SUCCESS;
+        ok = ok && hsd_index_ivf_add(ivf, data, 1, NULL) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_ivf_train(ivf, data, 3) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_ivf_set_nprobe(ivf, 0) == HSD_ERR_INVALID_INPUT;
+        size_t found = 5;
+        uint64_t id;
+        ok = ok && hsd_index_ivf_search(ivf, data, 1, &id, NULL, &found) == HSD_SUCCESS &&
+             found == 0;
+        ok = ok && hsd_index_ivf_search(ivf, NULL, 1, &id, NULL, &found) == HSD_ERR_NULL_PTR;
+        ok = ok && hsd_index_ivf_train(ivf, data, 100) == HSD_SUCCESS;
+        ok = ok && hsd_index_ivf_add(ivf, data, 100, NULL) == HSD_SUCCESS;
+        ok = ok && hsd_index_ivf_train(ivf, data, 100) == HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Invalid arguments", "hsd_index_ivf");
+        hsd_index_ivf_free(ivf);
+    }
+
+    free(data);
+    free(queries);
+    printf("======= Finished IVF Index Tests =======\n");
+}
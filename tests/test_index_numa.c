@@ -0,0 +1,125 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define NUMA_TEST_DIM 11
+#define NUMA_TEST_ROWS 9001
+#define NUMA_TEST_QUERIES 3
+#define NUMA_TEST_K 10
+
+/* Sharded search must return exactly what the exact flat index returns. */
+static int numa_matches_flat(hsd_index_numa_t *numa, HSD_Metric metric, const float *data,
+                             const float *queries) {
+    hsd_index_flat_t *flat = NULL;
+    int ok = hsd_index_flat_create(NUMA_TEST_DIM, HSD_DTYPE_F32, metric, &flat) == HSD_SUCCESS;
+    ok = ok && hsd_index_flat_add(flat, data, NUMA_TEST_ROWS, NULL) == HSD_SUCCESS;
+    for (size_t q = 0; ok && q < NUMA_TEST_QUERIES; ++q) {
+        const float *query = queries + q * NUMA_TEST_DIM;
+        uint64_t ids[NUMA_TEST_K], want_ids[NUMA_TEST_K];
+        float scores[NUMA_TEST_K], want_scores[NUMA_TEST_K];
+        size_t found = 0, want_found = 0;
+        ok = hsd_index_numa_search(numa, query, NUMA_TEST_K, ids, scores, &found) ==
+                 HSD_SUCCESS &&
+             hsd_index_flat_search(flat, query, NUMA_TEST_K, want_ids, want_scores,
+                                   &want_found) == HSD_SUCCESS &&
+             found == want_found;
+        for (size_t i = 0; ok && i < found; ++i) {
+            ok = ids[i] == want_ids[i] &&
+                 fabsf(scores[i] - want_scores[i]) <= 1e-4f * (1.0f + fabsf(want_scores[i]));
+        }
+    }
+    hsd_index_flat_free(flat);
+    return ok;
+}
+
+void run_index_numa_tests(void) {
+    printf("\n======= Running NUMA Index Tests =======\n");
+
+    uint64_t state = 31;
+    float *data = (float *)malloc(NUMA_TEST_ROWS * NUMA_TEST_DIM * sizeof(float));
+    float queries[NUMA_TEST_QUERIES * NUMA_TEST_DIM];
+    for (size_t i = 0; i < NUMA_TEST_ROWS * NUMA_TEST_DIM; ++i) data[i] = test_rand_f32(&state);
+    for (size_t i = 0; i < NUMA_TEST_QUERIES * NUMA_TEST_DIM; ++i)
+        queries[i] = test_rand_f32(&state);
+
+    /* Two nodes interleaved over four CPUs, plus an unused CPU; CPUs may not exist here. */
+    const int cpu_nodes[5] = {0, 1, 0, -1, 1};
+    hsd_numa_topology_t topology;
+    topology.cpu_count = 5;
+    topology.cpu_nodes = cpu_nodes;
+
+    const HSD_Metric metrics[] = {HSD_METRIC_SQEUCLIDEAN, HSD_METRIC_DOT, HSD_METRIC_COSINE};
+    for (size_t m = 0; m < 3; ++m) {
+        hsd_index_numa_t *index = NULL;
+        uint64_t first = 99, second = 99;
+        int ok = hsd_index_numa_create(NUMA_TEST_DIM, metrics[m], &topology, &index) ==
+                 HSD_SUCCESS;
+        ok = ok && hsd_index_numa_shard_count(index) == 2;
+        /* Two uneven batches exercise chunk boundaries and the rotating remainder. */
+        ok = ok && hsd_index_numa_add(index, data, 5001, &first) == HSD_SUCCESS;
+        ok = ok && hsd_index_numa_add(index, data + 5001 * NUMA_TEST_DIM, NUMA_TEST_ROWS - 5001,
+                                      &second) == HSD_SUCCESS;
+        ok = ok && first == 0 && second == 5001 && hsd_index_numa_size(index) == NUMA_TEST_ROWS;
+        ok = ok && numa_matches_flat(index, metrics[m], data, queries);
+        char name[64];
+        snprintf(name, sizeof(name), "Sharded search matches flat (metric %d)", (int)metrics[m]);
+        test_check(ok, name, "hsd_index_numa");
+
+        if (m == 0) {
+            int node0 = -1, node1 = -1;
+            size_t count0 = 0, count1 = 0;
+            ok = hsd_index_numa_shard_info(index, 0, &node0, &count0) == HSD_SUCCESS &&
+                 hsd_index_numa_shard_info(index, 1, &node1, &count1) == HSD_SUCCESS;
+            ok = ok && node0 == 0 && node1 == 1 && count0 + count1 == NUMA_TEST_ROWS;
+            ok = ok && (count0 > count1 ? count0 - count1 : count1 - count0) <= 1;
+            ok = ok && hsd_index_numa_shard_info(index, 2, NULL, NULL) == HSD_ERR_INVALID_INPUT;
+            test_check(ok, "Rows are balanced across nodes", "hsd_index_numa");
+        }
+        hsd_index_numa_free(index);
+    }
+
+    {
+        hsd_index_numa_t *index = NULL;
+        int ok = hsd_index_numa_create(NUMA_TEST_DIM, HSD_METRIC_SQEUCLIDEAN, NULL, &index) ==
+                 HSD_SUCCESS;
+        ok = ok && hsd_index_numa_shard_count(index) >= 1;
+        ok = ok && hsd_index_numa_add(index, data, 300, NULL) == HSD_SUCCESS;
+        uint64_t ids[1];
+        size_t found = 0;
+        ok = ok && hsd_index_numa_search(index, data + 7 * NUMA_TEST_DIM, 1, ids, NULL, &found) ==
+                       HSD_SUCCESS;
+        ok = ok && found == 1 && ids[0] == 7;
+        test_check(ok, "Detected topology", "hsd_index_numa");
+        hsd_index_numa_free(index);
+    }
+
+    {
+        const int unused[2] = {-1, -1};
+        hsd_numa_topology_t empty;
+        empty.cpu_count = 2;
+        empty.cpu_nodes = unused;
+        hsd_index_numa_t *index = NULL;
+        int ok = hsd_index_numa_create(NUMA_TEST_DIM, HSD_METRIC_DOT, &empty, &index) ==
+                 HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_numa_create(0, HSD_METRIC_DOT, &topology, &index) ==
+                       HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_numa_create(NUMA_TEST_DIM, HSD_METRIC_HAMMING, &topology, &index) ==
+                       HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_index_numa_create(NUMA_TEST_DIM, HSD_METRIC_DOT, &topology, NULL) ==
+                       HSD_ERR_NULL_PTR;
+        ok = ok && hsd_index_numa_create(NUMA_TEST_DIM, HSD_METRIC_DOT, &topology, &index) ==
+                       HSD_SUCCESS;
+        const float bad[NUMA_TEST_DIM] = {NAN};
+        ok = ok && hsd_index_numa_add(index, bad, 1, NULL) == HSD_ERR_INVALID_INPUT &&
+             hsd_index_numa_size(index) == 0;
+        size_t found = 1;
+        ok = ok && hsd_index_numa_search(index, bad, 1, NULL, NULL, &found) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Invalid arguments", "hsd_index_numa");
+        hsd_index_numa_free(index);
+    }
+
+    free(data);
+    printf("======= Finished NUMA Index Tests =======\n");
+}
@@ -0,0 +1,123 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define KMEANS_TEST_DIM 19
+#define KMEANS_TEST_K 7
+#define KMEANS_TEST_ROWS 701
+
+/* Well separated blobs: row r belongs to blob r % KMEANS_TEST_K. */
+static void kmeans_make_blobs(float *data, float *centres) {
+    uint64_t state = 99;
+    for (size_t c = 0; c < KMEANS_TEST_K; ++c) {
+        for (size_t d = 0; d < KMEANS_TEST_DIM; ++d)
+            centres[c * KMEANS_TEST_DIM + d] = 10.0f * test_rand_f32(&state);
+    }
+    for (size_t r = 0; r < KMEANS_TEST_ROWS; ++r) {
+        const float *centre = centres + (r % KMEANS_TEST_K) * KMEANS_TEST_DIM;
+        for (size_t d = 0; d < KMEANS_TEST_DIM; ++d)
+            data[r * KMEANS_TEST_DIM + d] = centre[d] + 0.5f * test_rand_f32(&state);
+    }
+}
+
+/* Every label must name the closest returned centroid, and the inertia must add up. */
+static int kmeans_labels_consistent(const float *data, const float *centroids,
+                                    const uint32_t *labels, float inertia) {
+    double total = 0.0;
+    for (size_t r = 0; r < KMEANS_TEST_ROWS; ++r) {
+        const float *x = data + r * KMEANS_TEST_DIM;
+        float own = simple_sqeuclidean_f32(x, centroids + labels[r] * KMEANS_TEST_DIM,
+                                           KMEANS_TEST_DIM);
+        for (size_t c = 0; c < KMEANS_TEST_K; ++c) {
+            float d = simple_sqeuclidean_f32(x, centroids + c * KMEANS_TEST_DIM, KMEANS_TEST_DIM);
+            if (d < own - 1e-3f * (1.0f + own)) return 0;
+        }
+        total += own;
+    }
+    return fabs(total - inertia) <= 1e-3 * (1.0 + total);
+}
+
+/* Each true blob centre must be matched by a distinct cluster with all its rows. */
+static int kmeans_recovers_blobs(const float *centres, const float *centroids,
+                                 const uint32_t *labels) {
+    for (size_t c = 0; c < KMEANS_TEST_K; ++c) {
+        uint32_t label = labels[c];
+        for (size_t r = c; r < KMEANS_TEST_ROWS; r += KMEANS_TEST_K) {
+            if (labels[r] != label) return 0;
+        }
+        for (size_t other = 0; other < c; ++other) {
+            if (labels[other] == label) return 0;
+        }
+        float d = simple_sqeuclidean_f32(centres + c * KMEANS_TEST_DIM,
+                                         centroids + label * KMEANS_TEST_DIM, KMEANS_TEST_DIM);
+        if (d > 0.1f) return 0;
+    }
+    return 1;
+}
+
+void run_kmeans_tests(void) {
+    printf("\n======= Running K-Means Tests =======\n");
+
+    float *data = (float *)malloc(KMEANS_TEST_ROWS * KMEANS_TEST_DIM * sizeof(float));
+    float centres[KMEANS_TEST_K * KMEANS_TEST_DIM];
+    float centroids[KMEANS_TEST_K * KMEANS_TEST_DIM];
+    float again[KMEANS_TEST_K * KMEANS_TEST_DIM];
+    uint32_t labels[KMEANS_TEST_ROWS];
+    kmeans_make_blobs(data, centres);
+
+    float lloyd_inertia = -1.0f;
+    {
+        hsd_kmeans_params_t params = {0, 0, 5};
+        int ok = hsd_kmeans_f32(data, KMEANS_TEST_ROWS, KMEANS_TEST_DIM, KMEANS_TEST_K, &params,
+                                centroids, labels, &lloyd_inertia) == HSD_SUCCESS;
+        ok = ok && kmeans_labels_consistent(data, centroids, labels, lloyd_inertia);
+        ok = ok && kmeans_recovers_blobs(centres, centroids, labels);
+        test_check(ok, "Lloyd recovers separated clusters", "hsd_kmeans_f32");
+
+        ok = hsd_kmeans_f32(data, KMEANS_TEST_ROWS, KMEANS_TEST_DIM, KMEANS_TEST_K, &params,
+                            again, NULL, NULL) == HSD_SUCCESS;
+        for (size_t i = 0; ok && i < KMEANS_TEST_K * KMEANS_TEST_DIM; ++i)
+            ok = again[i] == centroids[i];
+        test_check(ok, "Same seed gives the same centroids", "hsd_kmeans_f32");
+    }
+
+    {
+        hsd_kmeans_params_t params = {50, 64, 5};
+        float inertia = -1.0f;
+        int ok = hsd_kmeans_f32(data, KMEANS_TEST_ROWS, KMEANS_TEST_DIM, KMEANS_TEST_K, &params,
+                                centroids, labels, &inertia) == HSD_SUCCESS;
+        ok = ok && kmeans_labels_consistent(data, centroids, labels, inertia);
+        ok = ok && kmeans_recovers_blobs(centres, centroids, labels);
+        ok = ok && inertia <= 1.2f * lloyd_inertia;
+        test_check(ok, "Mini-batch recovers separated clusters", "hsd_kmeans_f32");
+    }
+
+    {
+        /* k == n: every point is its own cluster. */
+        const float points[3 * 2] = {0, 0, 5, 5, -3, 1};
+        float out[3 * 2];
+        uint32_t small_labels[3];
+        float inertia = -1.0f;
+        int ok = hsd_kmeans_f32(points, 3, 2, 3, NULL, out, small_labels, &inertia) ==
+                 HSD_SUCCESS;
+        ok = ok && inertia == 0.0f && small_labels[0] != small_labels[1] &&
+             small_labels[1] != small_labels[2] && small_labels[0] != small_labels[2];
+        test_check(ok, "One cluster per point", "hsd_kmeans_f32");
+    }
+
+    {
+        const float bad[4] = {1.0f, NAN, 2.0f, 3.0f};
+        float out[4];
+        int ok = hsd_kmeans_f32(NULL, 4, 1, 2, NULL, out, NULL, NULL) == HSD_ERR_NULL_PTR;
+        ok = ok && hsd_kmeans_f32(data, 4, 1, 5, NULL, out, NULL, NULL) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_kmeans_f32(data, 4, 0, 2, NULL, out, NULL, NULL) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_kmeans_f32(data, 4, 1, 0, NULL, out, NULL, NULL) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_kmeans_f32(bad, 4, 1, 2, NULL, out, NULL, NULL) == HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Invalid arguments", "hsd_kmeans_f32");
+    }
+
+    free(data);
+    printf("======= Finished K-Means Tests =======\n");
+}
@@ -0,0 +1,163 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+
+#define LEV_TEST_MAX_N 300
+#define LEV_TEST_BATCH 1100
+
+/* Wagner-Fischer DP with a single row. */
+static uint64_t simple_levenshtein(const uint8_t *a, size_t na, const uint8_t *b, size_t nb) {
+    size_t *row = (size_t *)malloc((nb + 1) * sizeof(size_t));
+    for (size_t j = 0; j <= nb; ++j) row[j] = j;
+    for (size_t i = 1; i <= na; ++i) {
+        size_t diag = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= nb; ++j) {
+            size_t up = row[j];
+            size_t best = diag + (a[i - 1] != b[j - 1]);
+            best = up + 1 < best ? up + 1 : best;
+            best = row[j - 1] + 1 < best ? row[j - 1] + 1 : best;
+            row[j] = best;
+            diag = up;
+        }
+    }
+    uint64_t r = row[nb];
+    free(row);
+    return r;
+}
+
+/* Random string over a small alphabet, so that matches are frequent. */
+static void lev_fill(uint8_t *s, size_t n, uint32_t alphabet, uint64_t *state) {
+    for (size_t i = 0; i < n; ++i) s[i] = (uint8_t)('a' + (test_rand_u64(state) >> 33) % alphabet);
+}
+
+/* Copy of src with a few random substitutions, insertions and deletions. */
+static size_t lev_mutate(const uint8_t *src, size_t n, uint8_t *dst, size_t edits,
+                         uint64_t *state) {
+    size_t len = n;
+    memcpy(dst, src, n);
+    for (size_t e = 0; e < edits && len > 0 && len < LEV_TEST_MAX_N; ++e) {
+        size_t pos = (test_rand_u64(state) >> 33) % len;
+        switch ((test_rand_u64(state) >> 33) % 3) {
+            case 0:
+                dst[pos] = (uint8_t)('a' + (test_rand_u64(state) >> 33) % 26);
+                break;
+            case 1:
+                memmove(dst + pos + 1, dst + pos, len - pos);
+                dst[pos] = (uint8_t)('a' + (test_rand_u64(state) >> 33) % 26);
+                ++len;
+                break;
+            default:
+                memmove(dst + pos, dst + pos + 1, len - pos - 1);
+                --len;
+                break;
+        }
+    }
+    return len;
+}
+
+void run_levenshtein_tests(void) {
+    printf("\n======= Running Levenshtein Tests =======\n");
+
+    uint64_t state = 47;
+
+    {
+        const char *pairs[][3] = {{"kitten", "sitting", "3"}, {"flaw", "lawn", "2"},
+                                  {"", "abc", "3"},          {"abc", "", "3"},
+                                  {"", "", "0"},             {"same", "same", "0"},
+                                  {"ab", "ba", "2"},         {"intention", "execution", "5"}};
+        int ok = 1;
+        for (size_t p = 0; ok && p < sizeof(pairs) / sizeof(pairs[0]); ++p) {
+            uint64_t r = UINT64_MAX;
+            ok = hsd_dist_levenshtein_u8((const uint8_t *)pairs[p][0], strlen(pairs[p][0]),
+                                         (const uint8_t *)pairs[p][1], strlen(pairs[p][1]),
+                                         &r) == HSD_SUCCESS &&
+                 r == (uint64_t)atoi(pairs[p][2]);
+        }
+        test_check(ok, "Known distances", "hsd_levenshtein");
+    }
+
+    {
+        /* Lengths around the 64-bit word boundary and multi-word patterns. */
+        static uint8_t a[LEV_TEST_MAX_N], b[LEV_TEST_MAX_N];
+        const size_t lengths[] = {1, 7, 63, 64, 65, 127, 128, 129, 200, 290};
+        int ok = 1;
+        for (size_t x = 0; ok && x < 10; ++x) {
+            for (size_t y = 0; ok && y < 10; ++y) {
+                size_t na = lengths[x], nb = lengths[y];
+                lev_fill(a, na, 4, &state);
+                lev_fill(b, nb, 4, &state);
+                uint64_t r1 = UINT64_MAX, r2 = UINT64_MAX;
+                uint64_t want = simple_levenshtein(a, na, b, nb);
+                ok = hsd_dist_levenshtein_u8(a, na, b, nb, &r1) == HSD_SUCCESS && r1 == want &&
+                     hsd_dist_levenshtein_u8(b, nb, a, na, &r2) == HSD_SUCCESS && r2 == want;
+            }
+        }
+        /* Small edits on long strings exercise the carries between blocks. */
+        for (size_t t = 0; ok && t < 40; ++t) {
+            size_t na = 60 + (test_rand_u64(&state) >> 33) % 200;
+            lev_fill(a, na, 26, &state);
+            size_t nb = lev_mutate(a, na, b, 1 + t % 9, &state);
+            uint64_t r = UINT64_MAX;
+            ok = hsd_dist_levenshtein_u8(a, na, b, nb, &r) == HSD_SUCCESS &&
+                 r == simple_levenshtein(a, na, b, nb);
+        }
+        test_check(ok, "Single and multi-word patterns match DP reference", "hsd_levenshtein");
+    }
+
+    {
+        /* Batches longer than one task, with empty and unequal texts. */
+        static uint8_t storage[LEV_TEST_BATCH][LEV_TEST_MAX_N];
+        static const uint8_t *texts[LEV_TEST_BATCH];
+        static size_t lens[LEV_TEST_BATCH];
+        static uint64_t results[LEV_TEST_BATCH];
+        uint8_t pattern[LEV_TEST_MAX_N];
+        const size_t pattern_lengths[] = {1, 5, 33, 64, 65, 150};
+        int ok = 1;
+        for (size_t p = 0; ok && p < 6; ++p) {
+            size_t m = pattern_lengths[p];
+            lev_fill(pattern, m, 26, &state);
+            for (size_t i = 0; i < LEV_TEST_BATCH; ++i) {
+                if (i % 97 == 5) {
+                    lens[i] = 0;
+                } else if (i % 3 == 0) {
+                    size_t edits = (test_rand_u64(&state) >> 33) % 8;
+                    lens[i] = lev_mutate(pattern, m, storage[i], edits, &state);
+                } else {
+                    lens[i] = (test_rand_u64(&state) >> 33) % 120;
+                    lev_fill(storage[i], lens[i], 26, &state);
+                }
+                texts[i] = lens[i] > 0 ? storage[i] : NULL;
+            }
+            size_t counts[] = {LEV_TEST_BATCH, 13};
+            for (size_t c = 0; ok && c < 2; ++c) {
+                ok = hsd_dist_levenshtein_batch_u8(pattern, m, texts, lens, counts[c], results) ==
+                     HSD_SUCCESS;
+                for (size_t i = 0; ok && i < counts[c]; ++i)
+                    ok = results[i] == simple_levenshtein(pattern, m, storage[i], lens[i]);
+            }
+        }
+        test_check(ok, "Batch matches DP reference", "hsd_levenshtein");
+    }
+
+    {
+        uint8_t s[4] = {'a', 'b', 'c', 'd'};
+        const uint8_t *texts[2] = {s, NULL};
+        size_t lens[2] = {4, 3};
+        uint64_t r = 0, results[2];
+        int ok = hsd_dist_levenshtein_u8(NULL, 0, s, 4, &r) == HSD_SUCCESS && r == 4 &&
+                 hsd_dist_levenshtein_u8(NULL, 2, s, 4, &r) == HSD_ERR_NULL_PTR &&
+                 r == UINT64_MAX && hsd_dist_levenshtein_u8(s, 4, s, 4, NULL) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_levenshtein_batch_u8(s, 4, texts, lens, 2, results) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_levenshtein_batch_u8(s, 4, NULL, lens, 2, results) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_levenshtein_batch_u8(NULL, 0, texts, lens, 1, results) == HSD_SUCCESS &&
+                 results[0] == 4 &&
+                 hsd_dist_levenshtein_batch_u8(s, 4, NULL, NULL, 0, NULL) == HSD_SUCCESS;
+        test_check(ok, "Invalid inputs", "hsd_levenshtein");
+    }
+
+    printf("======= Finished Levenshtein Tests =======\n");
+}
@@ -0,0 +1,196 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+
+#define MAHA_TEST_MAX_N 300
+#define MAHA_TEST_ROWS 700
+
+static double simple_weighted(const float *x, const float *y, const float *w, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += (double)w[i] * ((double)x[i] - y[i]) * (x[i] - y[i]);
+    return sum;
+}
+
+/* Symmetric positive definite C = A A^T / n + 0.1 I with a strongly correlated A. */
+static void maha_make_cov(float *cov, size_t n, uint64_t *state) {
+    float *a = (float *)malloc(n * n * sizeof(float));
+    for (size_t i = 0; i < n * n; ++i) a[i] = test_rand_f32(state) + (i % n == 0 ? 2.0f : 0.0f);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            double s = 0.0;
+            for (size_t k = 0; k < n; ++k) s += (double)a[i * n + k] * a[j * n + k];
+            cov[i * n + j] = cov[j * n + i] = (float)(s / (double)n + (i == j ? 0.1 : 0.0));
+        }
+    }
+    free(a);
+}
+
+/* sqrt(d^T C^-1 d) with C^-1 d from Gaussian elimination in double. */
+static double simple_mahalanobis(const float *x, const float *y, const float *cov, size_t n) {
+    double *m = (double *)malloc(n * (n + 1) * sizeof(double));
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) m[i * (n + 1) + j] = cov[i * n + j];
+        m[i * (n + 1) + n] = (double)x[i] - y[i];
+    }
+    for (size_t p = 0; p < n; ++p) {
+        for (size_t i = p + 1; i < n; ++i) {
+            double f = m[i * (n + 1) + p] / m[p * (n + 1) + p];
+            for (size_t j = p; j <= n; ++j) m[i * (n + 1) + j] -= f * m[p * (n + 1) + j];
+        }
+    }
+    double q = 0.0;
+    for (size_t i = n; i-- > 0;) {
+        double s = m[i * (n + 1) + n];
+        for (size_t j = i + 1; j < n; ++j) s -= m[i * (n + 1) + j] * m[j * (n + 1) + n];
+        m[i * (n + 1) + n] = s / m[i * (n + 1) + i];
+        q += ((double)x[i] - y[i]) * m[i * (n + 1) + n];
+    }
+    free(m);
+    return sqrt(q);
+}
+
+void run_mahalanobis_tests(void) {
+    printf("\n======= Running Weighted and Mahalanobis Distance Tests =======\n");
+
+    uint64_t state = 49;
+    static float a[MAHA_TEST_MAX_N * 4], b[MAHA_TEST_MAX_N * 4], w[MAHA_TEST_MAX_N * 4];
+    for (size_t i = 0; i < MAHA_TEST_MAX_N * 4; ++i) {
+        a[i] = 2.0f * test_rand_f32(&state);
+        b[i] = 2.0f * test_rand_f32(&state);
+        w[i] = 1.5f + test_rand_f32(&state);
+    }
+
+    {
+        /* Lengths around every vector width; unit weights give the plain squared distance. */
+        const size_t sizes[] = {1, 7, 8, 15, 16, 17, 31, 33, 100, 1200};
+        static float ones[MAHA_TEST_MAX_N * 4];
+        for (size_t i = 0; i < MAHA_TEST_MAX_N * 4; ++i) ones[i] = 1.0f;
+        int ok = 1;
+        for (size_t s = 0; ok && s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            size_t n = sizes[s];
+            double want = simple_weighted(a, b, w, n);
+            float r = -1.0f, r1 = -1.0f, plain = -1.0f;
+            ok = hsd_dist_weighted_sqeuclidean_f32(a, b, w, n, &r) == HSD_SUCCESS &&
+                 fabs(r - want) <= 1e-5 * want &&
+                 hsd_dist_weighted_sqeuclidean_f32(a, b, ones, n, &r1) == HSD_SUCCESS &&
+                 hsd_dist_sqeuclidean_f32(a, b, n, &plain) == HSD_SUCCESS &&
+                 fabsf(r1 - plain) <= 1e-5f * plain;
+        }
+        float r = -1.0f;
+        double want = simple_weighted(a, b, w, 1200);
+        ok = ok && hsd_set_precision(HSD_PRECISION_F64) == HSD_SUCCESS &&
+             hsd_dist_weighted_sqeuclidean_f32(a, b, w, 1200, &r) == HSD_SUCCESS &&
+             fabs(r - want) <= 1e-6 * want &&
+             hsd_set_precision(HSD_PRECISION_DETERMINISTIC) == HSD_SUCCESS &&
+             hsd_dist_weighted_sqeuclidean_f32(a, b, w, 1200, &r) == HSD_SUCCESS &&
+             r == (float)want;
+        ok = hsd_set_precision(HSD_PRECISION_FAST) == HSD_SUCCESS && ok;
+        test_check(ok, "Weighted squared distance matches reference", "hsd_mahalanobis");
+    }
+
+    static float cov[MAHA_TEST_MAX_N * MAHA_TEST_MAX_N];
+    static float factor[MAHA_TEST_MAX_N * MAHA_TEST_MAX_N];
+
+    {
+        /* W C W^T = I and W is lower triangular; n = 300 takes the heap path. */
+        const size_t sizes[] = {1, 3, 16, 45, MAHA_TEST_MAX_N};
+        int ok = 1;
+        for (size_t s = 0; ok && s < 5; ++s) {
+            size_t n = sizes[s];
+            maha_make_cov(cov, n, &state);
+            ok = hsd_mahalanobis_factor_f32(cov, n, factor) == HSD_SUCCESS;
+            for (size_t i = 0; ok && i < n; ++i) {
+                for (size_t j = i + 1; ok && j < n; ++j) ok = factor[i * n + j] == 0.0f;
+            }
+            for (size_t i = 0; ok && i < n; i += 1 + n / 10) {
+                for (size_t j = 0; ok && j < n; j += 1 + n / 13) {
+                    double e = 0.0;
+                    for (size_t k = 0; k <= i; ++k) {
+                        double cw = 0.0;
+                        for (size_t l = 0; l <= j; ++l)
+                            cw += (double)cov[k * n + l] * factor[j * n + l];
+                        e += (double)factor[i * n + k] * cw;
+                    }
+                    ok = fabs(e - (i == j ? 1.0 : 0.0)) <= 1e-3;
+                }
+            }
+            for (size_t t = 0; ok && t < 4; ++t) {
+                const float *x = a + t * 97, *y = b + t * 89;
+                double want = simple_mahalanobis(x, y, cov, n);
+                float r = -1.0f;
+                ok = hsd_dist_mahalanobis_f32(x, y, factor, n, &r) == HSD_SUCCESS &&
+                     fabs(r - want) <= 1e-3 * (want + 1.0);
+            }
+        }
+        test_check(ok, "Factor whitens the covariance and distances match reference",
+                   "hsd_mahalanobis");
+    }
+
+    {
+        /* A diagonal covariance reduces to the weighted distance with w = 1 / variance. */
+        const size_t n = 40;
+        float inv[40], r = -1.0f, rw = -1.0f;
+        memset(cov, 0, n * n * sizeof(float));
+        for (size_t i = 0; i < n; ++i) {
+            cov[i * n + i] = 0.25f * (float)(i + 1);
+            inv[i] = 1.0f / cov[i * n + i];
+        }
+        int ok = hsd_mahalanobis_factor_f32(cov, n, factor) == HSD_SUCCESS &&
+                 hsd_dist_mahalanobis_f32(a, b, factor, n, &r) == HSD_SUCCESS &&
+                 hsd_dist_weighted_sqeuclidean_f32(a, b, inv, n, &rw) == HSD_SUCCESS &&
+                 fabsf(r * r - rw) <= 1e-5f * rw;
+        test_check(ok, "Diagonal covariance matches weighted distance", "hsd_mahalanobis");
+    }
+
+    {
+        /* Batch against pre-whitened rows, spanning several cdist tiles. */
+        const size_t sizes[] = {5, 64, 260};
+        static float rows[MAHA_TEST_ROWS * 260], white[MAHA_TEST_ROWS * 260];
+        static float out[MAHA_TEST_ROWS];
+        int ok = 1;
+        for (size_t s = 0; ok && s < 3; ++s) {
+            size_t n = sizes[s];
+            maha_make_cov(cov, n, &state);
+            for (size_t i = 0; i < MAHA_TEST_ROWS * n; ++i) rows[i] = test_rand_f32(&state);
+            const float *query = rows + 123 * n;
+            ok = hsd_mahalanobis_factor_f32(cov, n, factor) == HSD_SUCCESS &&
+                 hsd_whiten_rows_f32(factor, n, rows, MAHA_TEST_ROWS, white) == HSD_SUCCESS &&
+                 hsd_dist_mahalanobis_batch_f32(query, white, MAHA_TEST_ROWS, factor, n, out) ==
+                     HSD_SUCCESS &&
+                 out[123] <= 1e-3f;
+            for (size_t i = 0; ok && i < MAHA_TEST_ROWS; i += 7) {
+                float r = -1.0f;
+                ok = hsd_dist_mahalanobis_f32(query, rows + i * n, factor, n, &r) == HSD_SUCCESS &&
+                     fabsf(out[i] - r) <= 1e-3f * (r + 1.0f);
+            }
+        }
+        test_check(ok, "Batch over whitened rows matches single distances", "hsd_mahalanobis");
+    }
+
+    {
+        float c[4] = {1.0f, 2.0f, 2.0f, 1.0f}, f[4], r = 0.0f, out[2];
+        float bad[4] = {1.0f, 0.0f, 0.0f, 1.0f};
+        int ok = hsd_mahalanobis_factor_f32(c, 2, f) == HSD_ERR_INVALID_INPUT &&
+                 hsd_mahalanobis_factor_f32(NULL, 2, f) == HSD_ERR_NULL_PTR &&
+                 hsd_mahalanobis_factor_f32(bad, 2, f) == HSD_SUCCESS &&
+                 hsd_dist_mahalanobis_f32(a, NULL, f, 2, &r) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_mahalanobis_f32(a, b, f, 2, NULL) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_mahalanobis_batch_f32(a, NULL, 2, f, 2, out) == HSD_ERR_NULL_PTR &&
+                 hsd_whiten_rows_f32(f, 2, a, 1, NULL) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_weighted_sqeuclidean_f32(a, b, NULL, 4, &r) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_weighted_sqeuclidean_f32(a, b, w, 0, &r) == HSD_SUCCESS && r == 0.0f;
+        bad[1] = NAN;
+        ok = ok && hsd_mahalanobis_factor_f32(bad, 2, f) == HSD_SUCCESS;
+        bad[2] = NAN;
+        ok = ok && hsd_mahalanobis_factor_f32(bad, 2, f) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_weighted_sqeuclidean_f32(a, bad, w, 4, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_mahalanobis_f32(a, bad, f, 2, &r) == HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Invalid inputs", "hsd_mahalanobis");
+    }
+
+    printf("======= Finished Weighted and Mahalanobis Distance Tests =======\n");
+}
@@ -0,0 +1,135 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define MINKOWSKI_TEST_MAX_N 1031
+
+/* Scaled by the largest difference so that large orders stay in range. */
+static double simple_minkowski(const float *a, const float *b, size_t n, double p) {
+    double m = 0.0, sum = 0.0;
+    for (size_t i = 0; i < n; ++i) m = fmax(m, fabs((double)a[i] - (double)b[i]));
+    if (m == 0.0) return 0.0;
+    for (size_t i = 0; i < n; ++i) sum += pow(fabs((double)a[i] - (double)b[i]) / m, p);
+    return m * pow(sum, 1.0 / p);
+}
+
+static float simple_chebyshev(const float *a, const float *b, size_t n) {
+    float m = 0.0f;
+    for (size_t i = 0; i < n; ++i) m = fmaxf(m, fabsf(a[i] - b[i]));
+    return m;
+}
+
+static int minkowski_close(float got, double want) {
+    return fabs((double)got - want) <= 1e-5 * (1.0 + fabs(want));
+}
+
+void run_minkowski_tests(void) {
+    printf("\n======= Running Chebyshev and Minkowski Tests =======\n");
+
+    uint64_t state = 31;
+    float a[MINKOWSKI_TEST_MAX_N], b[MINKOWSKI_TEST_MAX_N];
+    for (size_t i = 0; i < MINKOWSKI_TEST_MAX_N; ++i) {
+        a[i] = test_rand_f32(&state) * 4.0f;
+        b[i] = test_rand_f32(&state) * 4.0f;
+    }
+
+    {
+        /* Lengths around every backend's vector width and unroll factor. */
+        const size_t lengths[] = {1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 100, MINKOWSKI_TEST_MAX_N};
+        int ok = 1;
+        for (size_t l = 0; ok && l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            size_t n = lengths[l];
+            float inf_norm, p3, p1, p2, p_frac;
+            ok = hsd_dist_chebyshev_f32(a, b, n, &inf_norm) == HSD_SUCCESS &&
+                 hsd_dist_minkowski_f32(a, b, n, 3.0f, &p3) == HSD_SUCCESS &&
+                 hsd_dist_minkowski_f32(a, b, n, 1.0f, &p1) == HSD_SUCCESS &&
+                 hsd_dist_minkowski_f32(a, b, n, 2.0f, &p2) == HSD_SUCCESS &&
+                 hsd_dist_minkowski_f32(a, b, n, 2.5f, &p_frac) == HSD_SUCCESS;
+            ok = ok && inf_norm == simple_chebyshev(a, b, n) &&
+                 minkowski_close(p3, simple_minkowski(a, b, n, 3.0)) &&
+                 minkowski_close(p1, simple_minkowski(a, b, n, 1.0)) &&
+                 minkowski_close(p2, simple_minkowski(a, b, n, 2.0)) &&
+                 minkowski_close(p_frac, simple_minkowski(a, b, n, 2.5));
+        }
+        float r;
+        ok = ok && hsd_dist_minkowski_f32(a, b, 77, INFINITY, &r) == HSD_SUCCESS &&
+             r == simple_chebyshev(a, b, 77);
+        test_check(ok, "Chebyshev and Minkowski match reference", "hsd_minkowski");
+    }
+
+    {
+        /* |d|^p alone would overflow a double; fractional orders below 1 are allowed too. */
+        static float x[MINKOWSKI_TEST_MAX_N], y[MINKOWSKI_TEST_MAX_N];
+        for (size_t i = 0; i < MINKOWSKI_TEST_MAX_N; ++i) {
+            x[i] = a[i] * 1000.0f;
+            y[i] = b[i] * 1000.0f;
+        }
+        const float orders[] = {0.5f, 1.5f, 7.25f, 150.5f};
+        const size_t lengths[] = {5, 16, 37, MINKOWSKI_TEST_MAX_N};
+        int ok = 1;
+        for (size_t o = 0; ok && o < 4; ++o) {
+            for (size_t l = 0; ok && l < 4; ++l) {
+                float r = -1.0f;
+                ok = hsd_dist_minkowski_f32(x, y, lengths[l], orders[o], &r) == HSD_SUCCESS &&
+                     minkowski_close(r, simple_minkowski(x, y, lengths[l], orders[o]));
+            }
+        }
+        float r = -1.0f, z[8] = {0.0f};
+        ok = ok && hsd_dist_minkowski_f32(z, z, 8, 4.5f, &r) == HSD_SUCCESS && r == 0.0f;
+        /* The p = 3 kernel cubes without scaling, so these must take the scaled path. */
+        const float scales[] = {1e13f, 1e30f, 1e-15f};
+        for (size_t s = 0; ok && s < 3; ++s) {
+            float u[37], v[37];
+            for (size_t i = 0; i < 37; ++i) {
+                u[i] = a[i] * scales[s];
+                v[i] = b[i] * scales[s];
+            }
+            double want = simple_minkowski(u, v, 37, 3.0);
+            ok = hsd_dist_minkowski_f32(u, v, 37, 3.0f, &r) == HSD_SUCCESS &&
+                 fabs((double)r - want) <= 1e-5 * want;
+        }
+        ok = ok && hsd_set_precision(HSD_PRECISION_F64) == HSD_SUCCESS &&
+             hsd_dist_minkowski_f32(x, y, 100, 150.5f, &r) == HSD_SUCCESS &&
+             fabs(r - simple_minkowski(x, y, 100, 150.5)) <= 1e-6 * r;
+        ok = hsd_set_precision(HSD_PRECISION_FAST) == HSD_SUCCESS && ok;
+        test_check(ok, "General orders, including large p", "hsd_minkowski");
+    }
+
+    {
+        /* The largest difference sits in the last lane of a vector and in the scalar tail. */
+        float x[41] = {0.0f}, y[41] = {0.0f};
+        x[15] = -9.0f;
+        float r1, r2;
+        int ok = hsd_dist_chebyshev_f32(x, y, 41, &r1) == HSD_SUCCESS && r1 == 9.0f;
+        y[40] = 11.0f;
+        ok = ok && hsd_dist_chebyshev_f32(x, y, 41, &r2) == HSD_SUCCESS && r2 == 11.0f;
+        test_check(ok, "Chebyshev finds the maximum in any position", "hsd_minkowski");
+    }
+
+    {
+        float bad[20];
+        for (size_t i = 0; i < 20; ++i) bad[i] = (float)i;
+        float r = 0.0f;
+        int ok = hsd_dist_chebyshev_f32(a, b, 0, &r) == HSD_SUCCESS && r == 0.0f &&
+                 hsd_dist_minkowski_f32(a, b, 0, 3.0f, &r) == HSD_SUCCESS && r == 0.0f;
+        ok = ok && hsd_dist_minkowski_f32(a, b, 8, 0.0f, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_minkowski_f32(a, b, 8, -1.0f, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_minkowski_f32(a, b, 8, NAN, &r) == HSD_ERR_INVALID_INPUT;
+        for (size_t pos = 0; ok && pos < 20; pos += 3) {
+            bad[pos] = NAN;
+            ok = hsd_dist_chebyshev_f32(bad, b, 20, &r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_minkowski_f32(bad, b, 20, 3.0f, &r) == HSD_ERR_INVALID_INPUT;
+            bad[pos] = (float)pos;
+        }
+        bad[18] = INFINITY;
+        ok = ok && hsd_dist_chebyshev_f32(bad, b, 20, &r) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_dist_chebyshev_f32(NULL, b, 4, &r) == HSD_ERR_NULL_PTR &&
+             hsd_dist_minkowski_f32(a, NULL, 4, 3.0f, &r) == HSD_ERR_NULL_PTR &&
+             hsd_dist_minkowski_f32(a, b, 4, 3.0f, NULL) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Invalid inputs and orders", "hsd_minkowski");
+    }
+
+    printf("======= Finished Chebyshev and Minkowski Tests =======\n");
+}
@@ -0,0 +1,100 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define NORM_TEST_ROWS 2100
+#define NORM_TEST_DIM 37
+
+static float simple_l1_f32(const float *v, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += fabsf(v[i]);
+    return sum;
+}
+
+static int norm_close(float got, float want) {
+    return fabsf(got - want) <= 1e-5f * (1.0f + fabsf(want));
+}
+
+void run_norm_tests(void) {
+    printf("\n======= Running Norm Tests =======\n");
+
+    uint64_t state = 5;
+    {
+        /* Lengths around every backend's vector width and unroll factor. */
+        const size_t lengths[] = {1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 100, 1536};
+        float v[1536];
+        for (size_t i = 0; i < 1536; ++i) v[i] = test_rand_f32(&state) * 3.0f;
+        int ok = 1;
+        for (size_t l = 0; ok && l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            size_t n = lengths[l];
+            float l2 = -1.0f, l1 = -1.0f;
+            ok = hsd_norm_l2_f32(v, n, &l2) == HSD_SUCCESS &&
+                 hsd_norm_l1_f32(v, n, &l1) == HSD_SUCCESS &&
+                 norm_close(l2, sqrtf(simple_dot_f32(v, v, n))) &&
+                 norm_close(l1, simple_l1_f32(v, n));
+        }
+        float r = -1.0f;
+        ok = ok && hsd_norm_l2_f32(v, 0, &r) == HSD_SUCCESS && r == 0.0f;
+        test_check(ok, "L2 and L1 norms match reference", "hsd_norm");
+    }
+
+    {
+        float v[45];
+        for (size_t i = 0; i < 45; ++i) v[i] = test_rand_f32(&state) * 100.0f;
+        float zero[9] = {0.0f};
+        float norm = 0.0f;
+        int ok = hsd_normalize_f32(v, 45) == HSD_SUCCESS &&
+                 hsd_norm_l2_f32(v, 45, &norm) == HSD_SUCCESS && fabsf(norm - 1.0f) <= 1e-6f;
+        ok = ok && hsd_normalize_f32(zero, 9) == HSD_SUCCESS;
+        for (size_t i = 0; ok && i < 9; ++i) ok = zero[i] == 0.0f;
+        test_check(ok, "Normalize to unit length, zero vector unchanged", "hsd_norm");
+    }
+
+    {
+        float *data = (float *)malloc(NORM_TEST_ROWS * NORM_TEST_DIM * sizeof(float));
+        float *l2 = (float *)malloc(NORM_TEST_ROWS * sizeof(float));
+        float *l1 = (float *)malloc(NORM_TEST_ROWS * sizeof(float));
+        float *before = (float *)malloc(NORM_TEST_ROWS * sizeof(float));
+        int ok = data != NULL && l2 != NULL && l1 != NULL && before != NULL;
+        for (size_t i = 0; ok && i < NORM_TEST_ROWS * NORM_TEST_DIM; ++i)
+            data[i] = test_rand_f32(&state);
+        ok = ok && hsd_norms_l2_f32(data, NORM_TEST_ROWS, NORM_TEST_DIM, l2) == HSD_SUCCESS &&
+             hsd_norms_l1_f32(data, NORM_TEST_ROWS, NORM_TEST_DIM, l1) == HSD_SUCCESS;
+        for (size_t r = 0; ok && r < NORM_TEST_ROWS; ++r) {
+            const float *row = data + r * NORM_TEST_DIM;
+            ok = norm_close(l2[r], sqrtf(simple_dot_f32(row, row, NORM_TEST_DIM))) &&
+                 norm_close(l1[r], simple_l1_f32(row, NORM_TEST_DIM));
+        }
+        ok = ok &&
+             hsd_normalize_rows_f32(data, NORM_TEST_ROWS, NORM_TEST_DIM, before) == HSD_SUCCESS;
+        for (size_t r = 0; ok && r < NORM_TEST_ROWS; ++r) {
+            const float *row = data + r * NORM_TEST_DIM;
+            ok = before[r] == l2[r] &&
+                 fabsf(simple_dot_f32(row, row, NORM_TEST_DIM) - 1.0f) <= 1e-5f;
+        }
+        ok = ok && hsd_normalize_rows_f32(data, NORM_TEST_ROWS, NORM_TEST_DIM, NULL) == HSD_SUCCESS;
+        test_check(ok, "Batch norms and row normalization", "hsd_norm");
+        free(data);
+        free(l2);
+        free(l1);
+        free(before);
+    }
+
+    {
+        const float bad[5] = {1.0f, NAN, 2.0f, 3.0f, 4.0f};
+        float inf_rows[2 * 3] = {1.0f, 2.0f, 3.0f, INFINITY, 0.0f, 1.0f};
+        float r;
+        float norms[2];
+        int ok = hsd_norm_l2_f32(bad, 5, &r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_norm_l1_f32(bad, 5, &r) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_norms_l2_f32(inf_rows, 2, 3, norms) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_normalize_f32(NULL, 3) == HSD_ERR_NULL_PTR &&
+             hsd_norm_l2_f32(bad, 5, NULL) == HSD_ERR_NULL_PTR &&
+             hsd_norms_l1_f32(inf_rows, 2, 3, NULL) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Invalid inputs", "hsd_norm");
+    }
+
+    printf("======= Finished Norm Tests =======\n");
+}
@@ -0,0 +1,185 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+
+#define PARALLEL_TEST_DIM 13
+#define PARALLEL_TEST_A 37
+#define PARALLEL_TEST_B 300
+#define PARALLEL_TEST_ROWS 9000
+#define PARALLEL_TEST_K 8
+#define PARALLEL_TEST_CALLERS 4
+
+static float parallel_reference(const float *a, const float *b, HSD_Metric metric) {
+    switch (metric) {
+        case HSD_METRIC_SQEUCLIDEAN:
+            return simple_sqeuclidean_f32(a, b, PARALLEL_TEST_DIM);
+        case HSD_METRIC_MANHATTAN:
+            return simple_manhattan_f32(a, b, PARALLEL_TEST_DIM);
+        case HSD_METRIC_DOT:
+            return simple_dot_f32(a, b, PARALLEL_TEST_DIM);
+        default:
+            return simple_cosine_sim_f32(a, b, PARALLEL_TEST_DIM);
+    }
+}
+
+static int parallel_cdist_matches(const float *a, const float *b, HSD_Metric metric) {
+    float *out = (float *)malloc(PARALLEL_TEST_A * PARALLEL_TEST_B * sizeof(float));
+    int ok = out != NULL && hsd_cdist_f32(a, PARALLEL_TEST_A, b, PARALLEL_TEST_B,
+                                          PARALLEL_TEST_DIM, metric, out) == HSD_SUCCESS;
+    for (size_t i = 0; ok && i < PARALLEL_TEST_A; ++i) {
+        for (size_t j = 0; ok && j < PARALLEL_TEST_B; ++j) {
+            float want = parallel_reference(a + i * PARALLEL_TEST_DIM,
+                                            b + j * PARALLEL_TEST_DIM, metric);
+            ok = fabsf(out[i * PARALLEL_TEST_B + j] - want) <= 1e-4f * (1.0f + fabsf(want));
+        }
+    }
+    free(out);
+    return ok;
+}
+
+typedef struct {
+    const hsd_index_flat_t *index;
+    const float *queries;
+    const uint64_t *expected;
+    const float *a;
+    const float *b;
+    int ok;
+} parallel_caller_t;
+
+static int parallel_search_all(const hsd_index_flat_t *index, const float *queries,
+                               uint64_t *ids) {
+    for (size_t q = 0; q < 4; ++q) {
+        size_t found = 0;
+        if (hsd_index_flat_search(index, queries + q * PARALLEL_TEST_DIM, PARALLEL_TEST_K,
+                                  ids + q * PARALLEL_TEST_K, NULL, &found) != HSD_SUCCESS ||
+            found != PARALLEL_TEST_K)
+            return 0;
+    }
+    return 1;
+}
+
+static void *parallel_caller_main(void *arg) {
+    parallel_caller_t *caller = (parallel_caller_t *)arg;
+    uint64_t ids[4 * PARALLEL_TEST_K];
+    caller->ok = parallel_search_all(caller->index, caller->queries, ids) &&
+                 memcmp(ids, caller->expected, sizeof(ids)) == 0 &&
+                 parallel_cdist_matches(caller->a, caller->b, HSD_METRIC_COSINE);
+    return NULL;
+}
+
+void run_parallel_tests(void) {
+    printf("\n======= Running Thread Pool Tests =======\n");
+
+    uint64_t state = 2024;
+    float *a = (float *)malloc(PARALLEL_TEST_A * PARALLEL_TEST_DIM * sizeof(float));
+    float *b = (float *)malloc(PARALLEL_TEST_ROWS * PARALLEL_TEST_DIM * sizeof(float));
+    for (size_t i = 0; i < PARALLEL_TEST_A * PARALLEL_TEST_DIM; ++i)
+        a[i] = test_rand_f32(&state);
+    for (size_t i = 0; i < PARALLEL_TEST_ROWS * PARALLEL_TEST_DIM; ++i)
+        b[i] = test_rand_f32(&state);
+    /* Zero rows exercise the cosine conventions. */
+    memset(a, 0, PARALLEL_TEST_DIM * sizeof(float));
+    memset(b + 5 * PARALLEL_TEST_DIM, 0, PARALLEL_TEST_DIM * sizeof(float));
+
+    {
+        int ok = hsd_set_num_threads(3) == HSD_SUCCESS && hsd_get_num_threads() == 3;
+        ok = ok && hsd_set_num_threads(0) == HSD_SUCCESS && hsd_get_num_threads() >= 1;
+        test_check(ok, "Thread count round trip", "thread pool");
+    }
+
+    {
+        const size_t thread_counts[] = {1, 3, 8};
+        const HSD_Metric metrics[] = {HSD_METRIC_SQEUCLIDEAN, HSD_METRIC_MANHATTAN,
+                                      HSD_METRIC_DOT, HSD_METRIC_COSINE};
+        int ok = 1;
+        for (size_t t = 0; t < 3; ++t) {
+            ok = ok && hsd_set_num_threads(thread_counts[t]) == HSD_SUCCESS;
+            for (size_t m = 0; m < 4; ++m) ok = ok && parallel_cdist_matches(a, b, metrics[m]);
+        }
+        test_check(ok, "cdist matches reference for every thread count", "thread pool");
+    }
+
+    hsd_index_flat_t *index = NULL;
+    uint64_t expected[4 * PARALLEL_TEST_K];
+    {
+        int ok = hsd_index_flat_create(PARALLEL_TEST_DIM, HSD_DTYPE_F32, HSD_METRIC_SQEUCLIDEAN,
+                                       &index) == HSD_SUCCESS;
+        ok = ok && hsd_index_flat_add(index, b, PARALLEL_TEST_ROWS, NULL) == HSD_SUCCESS;
+        ok = ok && hsd_set_num_threads(1) == HSD_SUCCESS && parallel_search_all(index, a, expected);
+
+        /* Brute-force check of the single-threaded answer for the first query. */
+        float kth = ok ? simple_sqeuclidean_f32(
+                             a, b + expected[PARALLEL_TEST_K - 1] * PARALLEL_TEST_DIM,
+                             PARALLEL_TEST_DIM)
+                       : 0.0f;
+        for (size_t r = 0; ok && r < PARALLEL_TEST_ROWS; ++r) {
+            float d = simple_sqeuclidean_f32(a, b + r * PARALLEL_TEST_DIM, PARALLEL_TEST_DIM);
+            bool listed = false;
+            for (size_t i = 0; i < PARALLEL_TEST_K; ++i) listed = listed || expected[i] == r;
+            ok = listed || d >= kth;
+        }
+
+        const size_t thread_counts[] = {2, 4, 7};
+        for (size_t t = 0; ok && t < 3; ++t) {
+            uint64_t ids[4 * PARALLEL_TEST_K];
+            ok = hsd_set_num_threads(thread_counts[t]) == HSD_SUCCESS &&
+                 parallel_search_all(index, a, ids) && memcmp(ids, expected, sizeof(ids)) == 0;
+        }
+        test_check(ok, "Flat search is identical across thread counts", "thread pool");
+    }
+
+    {
+        hsd_set_num_threads(3);
+        pthread_t threads[PARALLEL_TEST_CALLERS];
+        parallel_caller_t callers[PARALLEL_TEST_CALLERS];
+        size_t started = 0;
+        for (size_t i = 0; i < PARALLEL_TEST_CALLERS; ++i) {
+            callers[i].index = index;
+            callers[i].queries = a;
+            callers[i].expected = expected;
+            callers[i].a = a;
+            callers[i].b = b;
+            callers[i].ok = 0;
+            if (pthread_create(&threads[i], NULL, parallel_caller_main, &callers[i]) != 0) break;
+            started++;
+        }
+        int ok = started == PARALLEL_TEST_CALLERS;
+        for (size_t i = 0; i < started; ++i) {
+            pthread_join(threads[i], NULL);
+            ok = ok && callers[i].ok;
+        }
+        test_check(ok, "Concurrent callers share the pool", "thread pool");
+    }
+
+    {
+        const int cpus[1] = {0};
+        hsd_status_t status = hsd_set_thread_affinity(cpus, 1);
+        int ok = status == HSD_SUCCESS || status == HSD_ERR_UNSUPPORTED;
+        ok = ok && parallel_cdist_matches(a, b, HSD_METRIC_DOT);
+        ok = ok && hsd_set_thread_affinity(NULL, 0) == HSD_SUCCESS;
+        ok = ok && hsd_set_thread_affinity(NULL, 2) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Pinned pool still computes correctly", "thread pool");
+    }
+
+    {
+        float out[4];
+        int ok = hsd_cdist_f32(NULL, 1, b, 1, PARALLEL_TEST_DIM, HSD_METRIC_DOT, out) ==
+                 HSD_ERR_NULL_PTR;
+        ok = ok && hsd_cdist_f32(a, 1, b, 1, PARALLEL_TEST_DIM, HSD_METRIC_HAMMING, out) ==
+                       HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_cdist_f32(a, 0, b, 1, PARALLEL_TEST_DIM, HSD_METRIC_DOT, out) ==
+                       HSD_SUCCESS;
+        ok = ok && hsd_set_num_threads(100000) == HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Invalid arguments", "thread pool");
+    }
+
+    hsd_set_num_threads(0);
+    hsd_index_flat_free(index);
+    free(a);
+    free(b);
+    printf("======= Finished Thread Pool Tests =======\n");
+}
@@ -0,0 +1,110 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define PEARSON_TEST_MAX_N 4099
+
+/* Two-pass reference in f64. */
+static double simple_pearson(const float *a, const float *b, size_t n) {
+    double ma = 0.0, mb = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        ma += a[i];
+        mb += b[i];
+    }
+    ma /= (double)n;
+    mb /= (double)n;
+    double cov = 0.0, va = 0.0, vb = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        cov += (a[i] - ma) * (b[i] - mb);
+        va += (a[i] - ma) * (a[i] - ma);
+        vb += (b[i] - mb) * (b[i] - mb);
+    }
+    return cov / sqrt(va * vb);
+}
+
+void run_pearson_tests(void) {
+    printf("\n======= Running Pearson Correlation Tests =======\n");
+
+    uint64_t state = 23;
+    static float a[PEARSON_TEST_MAX_N], b[PEARSON_TEST_MAX_N];
+    for (size_t i = 0; i < PEARSON_TEST_MAX_N; ++i) {
+        a[i] = test_rand_f32(&state) * 3.0f + 1.0f;
+        b[i] = 0.6f * a[i] + test_rand_f32(&state);
+    }
+
+    {
+        /* Lengths around every backend's vector width. */
+        const size_t lengths[] = {2, 3, 4, 7, 8, 15, 16, 17, 33, 100, PEARSON_TEST_MAX_N};
+        int ok = 1;
+        for (size_t l = 0; ok && l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            size_t n = lengths[l];
+            float r, rc;
+            double want = simple_pearson(a, b, n);
+            ok = hsd_sim_pearson_f32(a, b, n, &r) == HSD_SUCCESS &&
+                 hsd_sim_pearson_centered_f32(a, b, n, &rc) == HSD_SUCCESS &&
+                 fabs(r - want) <= 1e-5 && fabs(rc - want) <= 1e-5;
+        }
+        test_check(ok, "Pearson matches two-pass reference", "hsd_pearson");
+    }
+
+    {
+        /* Time series around 1e4 with unit spread: raw moments would cancel catastrophically. */
+        static float x[PEARSON_TEST_MAX_N], y[PEARSON_TEST_MAX_N];
+        for (size_t i = 0; i < PEARSON_TEST_MAX_N; ++i) {
+            x[i] = 10000.0f + test_rand_f32(&state);
+            y[i] = 10000.0f + 0.5f * (x[i] - 10000.0f) + 0.5f * test_rand_f32(&state);
+        }
+        double want = simple_pearson(x, y, PEARSON_TEST_MAX_N);
+        float r, rc;
+        int ok = hsd_sim_pearson_f32(x, y, PEARSON_TEST_MAX_N, &r) == HSD_SUCCESS &&
+                 hsd_sim_pearson_centered_f32(x, y, PEARSON_TEST_MAX_N, &rc) == HSD_SUCCESS &&
+                 fabs(r - want) <= 1e-3 && fabs(rc - want) <= 1e-5;
+        test_check(ok, "Large offsets stay accurate", "hsd_pearson");
+
+        /* The f64 and deterministic modes give the reference to float rounding. */
+        const HSD_Precision modes[] = {HSD_PRECISION_F64, HSD_PRECISION_DETERMINISTIC};
+        for (size_t m = 0; ok && m < 2; ++m) {
+            ok = hsd_set_precision(modes[m]) == HSD_SUCCESS &&
+                 hsd_sim_pearson_f32(x, y, PEARSON_TEST_MAX_N, &r) == HSD_SUCCESS &&
+                 hsd_sim_pearson_centered_f32(x, y, PEARSON_TEST_MAX_N, &rc) == HSD_SUCCESS &&
+                 fabs(r - want) <= 1e-6 && fabs(rc - want) <= 1e-6;
+        }
+        ok = hsd_set_precision(HSD_PRECISION_FAST) == HSD_SUCCESS && ok;
+        test_check(ok, "Precision modes match reference", "hsd_pearson");
+    }
+
+    {
+        float up[33], down[33], flat[33];
+        for (size_t i = 0; i < 33; ++i) {
+            up[i] = 2.0f * a[i] + 3.0f;
+            down[i] = -a[i];
+            flat[i] = 4.5f;
+        }
+        float r1, r2, r3, r4;
+        int ok = hsd_sim_pearson_f32(a, up, 33, &r1) == HSD_SUCCESS && fabsf(r1 - 1.0f) <= 1e-6f &&
+                 hsd_sim_pearson_centered_f32(a, down, 33, &r2) == HSD_SUCCESS &&
+                 fabsf(r2 + 1.0f) <= 1e-6f &&
+                 hsd_sim_pearson_f32(a, flat, 33, &r3) == HSD_SUCCESS && r3 == 0.0f &&
+                 hsd_sim_pearson_f32(a, b, 1, &r4) == HSD_SUCCESS && r4 == 0.0f;
+        test_check(ok, "Perfect, inverse and undefined correlation", "hsd_pearson");
+    }
+
+    {
+        float bad[20];
+        for (size_t i = 0; i < 20; ++i) bad[i] = (float)i;
+        bad[19] = NAN;
+        float r = 1.0f;
+        int ok = hsd_sim_pearson_f32(a, b, 0, &r) == HSD_SUCCESS && r == 0.0f &&
+                 hsd_sim_pearson_f32(bad, b, 20, &r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_sim_pearson_centered_f32(b, bad, 20, &r) == HSD_ERR_INVALID_INPUT;
+        bad[19] = INFINITY;
+        ok = ok && hsd_sim_pearson_f32(bad, b, 20, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_sim_pearson_f32(NULL, b, 20, &r) == HSD_ERR_NULL_PTR &&
+             hsd_sim_pearson_centered_f32(a, b, 20, NULL) == HSD_ERR_NULL_PTR;
+        test_check(ok, "Invalid inputs", "hsd_pearson");
+    }
+
+    printf("======= Finished Pearson Correlation Tests =======\n");
+}
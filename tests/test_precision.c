@@ -0,0 +1,142 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define PRECISION_TEST_N 200003
+
+/* In F64 mode the only error left is the final rounding to float (plus a little slack). */
+static int precision_close(float got, long double want) {
+    long double err = fabsl((long double)got - want);
+    return err <= 4e-7L * fabsl(want) + 1e-30L;
+}
+
+/*
+ * The deterministic mode's documented order: term i goes to lane i % 16, then lanes are folded
+ * pairwise at widths 8, 4, 2, 1. The volatile product keeps the compiler from fusing it.
+ */
+static float det_reference(const float *a, const float *b, size_t n, int op) {
+    float lanes[16] = {0.0f};
+    for (size_t i = 0; i < n; ++i) {
+        volatile float term;
+        if (op == 0) {
+            term = a[i] * b[i];
+        } else if (op == 1) {
+            float d = a[i] - b[i];
+            term = d * d;
+        } else {
+            term = fabsf(a[i] - b[i]);
+        }
+        lanes[i % 16] += term;
+    }
+    for (size_t w = 8; w > 0; w /= 2)
+        for (size_t j = 0; j < w; ++j) lanes[j] += lanes[j + w];
+    return lanes[0];
+}
+
+void run_precision_tests(void) {
+    printf("\n======= Running Precision Mode Tests =======\n");
+
+    uint64_t state = 99;
+    float *a = (float *)malloc(PRECISION_TEST_N * sizeof(float));
+    float *b = (float *)malloc(PRECISION_TEST_N * sizeof(float));
+    if (a == NULL || b == NULL) {
+        test_check(0, "Allocation", "hsd_precision");
+        free(a);
+        free(b);
+        return;
+    }
+    /* Large values next to small ones, so that f32 accumulation loses the small terms. */
+    for (size_t i = 0; i < PRECISION_TEST_N; ++i) {
+        float scale = (i % 97 == 0) ? 4096.0f : 1.0f;
+        a[i] = test_rand_f32(&state) * scale;
+        b[i] = test_rand_f32(&state) + 0.25f;
+    }
+
+    long double dot = 0.0L, sq = 0.0L, l1 = 0.0L, na = 0.0L, nb = 0.0L, abs_a = 0.0L;
+    for (size_t i = 0; i < PRECISION_TEST_N; ++i) {
+        long double x = a[i], y = b[i];
+        dot += x * y;
+        sq += (x - y) * (x - y);
+        l1 += fabsl(x - y);
+        na += x * x;
+        nb += y * y;
+        abs_a += fabsl(x);
+    }
+
+    int ok = hsd_get_precision() == HSD_PRECISION_FAST &&
+             hsd_set_precision(HSD_PRECISION_F64) == HSD_SUCCESS &&
+             hsd_get_precision() == HSD_PRECISION_F64;
+    test_check(ok, "Switch to F64 accumulation", "hsd_precision");
+
+    {
+        float r_dot, r_sq, r_l1, r_cos, r_norm, r_abs;
+        ok = hsd_sim_dot_f32(a, b, PRECISION_TEST_N, &r_dot) == HSD_SUCCESS &&
+             hsd_dist_sqeuclidean_f32(a, b, PRECISION_TEST_N, &r_sq) == HSD_SUCCESS &&
+             hsd_dist_manhattan_f32(a, b, PRECISION_TEST_N, &r_l1) == HSD_SUCCESS &&
+             hsd_sim_cosine_f32(a, b, PRECISION_TEST_N, &r_cos) == HSD_SUCCESS &&
+             hsd_norm_l2_f32(a, PRECISION_TEST_N, &r_norm) == HSD_SUCCESS &&
+             hsd_norm_l1_f32(a, PRECISION_TEST_N, &r_abs) == HSD_SUCCESS;
+        ok = ok && precision_close(r_dot, dot) && precision_close(r_sq, sq) &&
+             precision_close(r_l1, l1) && precision_close(r_cos, dot / sqrtl(na * nb)) &&
+             precision_close(r_norm, sqrtl(na)) && precision_close(r_abs, abs_a);
+        test_check(ok, "Long vectors match extended-precision reference", "hsd_precision");
+    }
+
+    {
+        /* Every length from 0 to 40 exercises each backend's vector tail. */
+        ok = 1;
+        for (size_t n = 0; ok && n <= 40; ++n) {
+            long double want = 0.0L;
+            for (size_t i = 0; i < n; ++i) want += (long double)a[i] * b[i];
+            float got;
+            ok = hsd_sim_dot_f32(a, b, n, &got) == HSD_SUCCESS && precision_close(got, want);
+        }
+        float cd[2 * 3], pair;
+        ok = ok && hsd_cdist_f32(a, 2, b, 3, 1000, HSD_METRIC_DOT, cd) == HSD_SUCCESS &&
+             hsd_sim_dot_f32(a + 1000, b + 2000, 1000, &pair) == HSD_SUCCESS && cd[5] == pair;
+        const float nan_vec[3] = {1.0f, NAN, 2.0f};
+        ok = ok && hsd_sim_dot_f32(nan_vec, b, 3, &pair) == HSD_ERR_INVALID_INPUT &&
+             hsd_sim_cosine_f32(nan_vec, b, 3, &pair) == HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Short vectors, cdist and invalid input", "hsd_precision");
+    }
+
+    {
+        /* Bit-exact against the reference order, so every backend returns the same bits. */
+        const size_t lengths[] = {0, 1, 5, 15, 16, 17, 31, 33, 64, 100, 1023, PRECISION_TEST_N};
+        ok = hsd_set_precision(HSD_PRECISION_DETERMINISTIC) == HSD_SUCCESS &&
+             hsd_get_precision() == HSD_PRECISION_DETERMINISTIC;
+        for (size_t l = 0; ok && l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            size_t n = lengths[l];
+            float r_dot, r_sq, r_l1;
+            ok = hsd_sim_dot_f32(a, b, n, &r_dot) == HSD_SUCCESS &&
+                 hsd_dist_sqeuclidean_f32(a, b, n, &r_sq) == HSD_SUCCESS &&
+                 hsd_dist_manhattan_f32(a, b, n, &r_l1) == HSD_SUCCESS &&
+                 r_dot == det_reference(a, b, n, 0) && r_sq == det_reference(a, b, n, 1) &&
+                 r_l1 == det_reference(a, b, n, 2);
+        }
+        float r_norm, r_cos;
+        ok = ok && hsd_norm_l2_f32(a, 1000, &r_norm) == HSD_SUCCESS &&
+             r_norm == (float)sqrt((double)det_reference(a, a, 1000, 0));
+        for (size_t n = 1000; ok && n <= 1003; n += 3) {
+            float den = sqrtf(det_reference(a, a, n, 0)) * sqrtf(det_reference(b, b, n, 0));
+            ok = hsd_sim_cosine_f32(a, b, n, &r_cos) == HSD_SUCCESS &&
+                 r_cos == det_reference(a, b, n, 0) / den;
+        }
+        float cd[2 * 3];
+        ok = ok && hsd_cdist_f32(a, 2, b, 3, 1000, HSD_METRIC_SQEUCLIDEAN, cd) == HSD_SUCCESS &&
+             cd[5] == det_reference(a + 1000, b + 2000, 1000, 1);
+        test_check(ok, "Deterministic mode matches fixed summation order", "hsd_precision");
+    }
+
+    ok = hsd_set_precision(HSD_PRECISION_FAST) == HSD_SUCCESS &&
+         hsd_get_precision() == HSD_PRECISION_FAST &&
+         hsd_set_precision((HSD_Precision)42) == HSD_ERR_INVALID_INPUT &&
+         hsd_get_precision() == HSD_PRECISION_FAST;
+    test_check(ok, "Restore fast mode and reject unknown modes", "hsd_precision");
+
+    free(a);
+    free(b);
+    printf("======= Finished Precision Mode Tests =======\n");
+}
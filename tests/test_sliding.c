@@ -0,0 +1,103 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define SLIDING_TEST_LEN 9000
+
+/*
+ * Compares every window against a double-precision reference. The tolerance is relative to
+ * the sum of |q[k] t[i + k]| (or of the squared terms), which bounds the rounding error of
+ * both the direct and the FFT path.
+ */
+static int sliding_matches(const float *q, size_t n, const float *t, size_t len, int sq,
+                           const float *out, double rel) {
+    for (size_t i = 0; i + n <= len; ++i) {
+        double want = 0.0, mag = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            double x = sq ? (double)t[i + k] - q[k] : (double)q[k] * t[i + k];
+            want += sq ? x * x : x;
+            mag += sq ? (double)q[k] * q[k] + (double)t[i + k] * t[i + k] : fabs(x);
+        }
+        if (!(fabs(out[i] - want) <= rel * mag + 1e-30)) return 0;
+    }
+    return 1;
+}
+
+void run_sliding_tests(void) {
+    printf("\n======= Running Sliding Window Tests =======\n");
+
+    uint64_t state = 48;
+    static float t[SLIDING_TEST_LEN], q[2048];
+    static float out[SLIDING_TEST_LEN];
+    for (size_t i = 0; i < SLIDING_TEST_LEN; ++i)
+        t[i] = 3.0f * sinf(0.01f * (float)i) + test_rand_f32(&state);
+    for (size_t k = 0; k < 2048; ++k) q[k] = test_rand_f32(&state);
+
+    {
+        /* Query lengths on both sides of the FFT threshold, signals shorter than one block. */
+        const size_t cases[][2] = {{1, 1},      {1, 50},     {5, 5},      {7, 200},
+                                   {31, 1000},  {319, 3000}, {320, 320},  {321, 500},
+                                   {400, 1401}, {513, 9000}, {2048, 9000}};
+        int ok = 1;
+        for (size_t c = 0; ok && c < sizeof(cases) / sizeof(cases[0]); ++c) {
+            size_t n = cases[c][0], len = cases[c][1];
+            ok = hsd_sim_dot_sliding_f32(q, n, t, len, out) == HSD_SUCCESS &&
+                 sliding_matches(q, n, t, len, 0, out, 1e-5) &&
+                 hsd_dist_sqeuclidean_sliding_f32(q, n, t, len, out) == HSD_SUCCESS &&
+                 sliding_matches(q, n, t, len, 1, out, 1e-5);
+        }
+        test_check(ok, "Sliding dot and distance match reference", "hsd_sliding");
+    }
+
+    {
+        /* A window equal to the query gives a distance of 0 on both paths. */
+        int ok = 1;
+        const size_t lengths[] = {40, 400};
+        for (size_t c = 0; ok && c < 2; ++c) {
+            size_t n = lengths[c], pos = 1234;
+            ok = hsd_dist_sqeuclidean_sliding_f32(t + pos, n, t, 4000, out) == HSD_SUCCESS &&
+                 out[pos] <= 1e-4f * (float)n;
+            float direct;
+            for (size_t i = 0; ok && i + n <= 4000; i += 397) {
+                ok = hsd_dist_sqeuclidean_f32(t + pos, t + i, n, &direct) == HSD_SUCCESS &&
+                     fabsf(out[i] - direct) <= 1e-4f * (direct + (float)n);
+            }
+        }
+        test_check(ok, "Exact match and agreement with hsd_dist_sqeuclidean_f32", "hsd_sliding");
+    }
+
+    {
+        /* The double-precision direct paths are used outside fast mode. */
+        const HSD_Precision modes[] = {HSD_PRECISION_F64, HSD_PRECISION_DETERMINISTIC};
+        int ok = 1;
+        for (size_t m = 0; ok && m < 2; ++m) {
+            ok = hsd_set_precision(modes[m]) == HSD_SUCCESS &&
+                 hsd_sim_dot_sliding_f32(q, 50, t, 2000, out) == HSD_SUCCESS &&
+                 sliding_matches(q, 50, t, 2000, 0, out, 1e-7) &&
+                 hsd_dist_sqeuclidean_sliding_f32(q, 50, t, 2000, out) == HSD_SUCCESS &&
+                 sliding_matches(q, 50, t, 2000, 1, out, 1e-7);
+        }
+        ok = hsd_set_precision(HSD_PRECISION_FAST) == HSD_SUCCESS && ok;
+        test_check(ok, "F64 and deterministic precision", "hsd_sliding");
+    }
+
+    {
+        float bad[20], r[20];
+        for (size_t i = 0; i < 20; ++i) bad[i] = (float)i;
+        int ok = hsd_sim_dot_sliding_f32(NULL, 4, bad, 20, r) == HSD_ERR_NULL_PTR &&
+                 hsd_sim_dot_sliding_f32(q, 4, NULL, 20, r) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_sqeuclidean_sliding_f32(q, 4, bad, 20, NULL) == HSD_ERR_NULL_PTR &&
+                 hsd_sim_dot_sliding_f32(q, 0, bad, 20, r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_sqeuclidean_sliding_f32(q, 21, bad, 20, r) == HSD_ERR_INVALID_INPUT;
+        bad[13] = NAN;
+        ok = ok && hsd_sim_dot_sliding_f32(q, 4, bad, 20, r) == HSD_ERR_INVALID_INPUT;
+        bad[13] = INFINITY;
+        ok = ok && hsd_dist_sqeuclidean_sliding_f32(q, 4, bad, 20, r) == HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Invalid inputs", "hsd_sliding");
+    }
+
+    printf("======= Finished Sliding Window Tests =======\n");
+}
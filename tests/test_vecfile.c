@@ -0,0 +1,177 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+
+#define VECFILE_TEST_DIM 21
+#define VECFILE_TEST_ROWS 5000
+#define VECFILE_TEST_K 7
+
+/* Mapped search must agree with the flat index built from the same rows. */
+static int vecfile_matches_flat(const hsd_vecfile_t *file, HSD_DType dtype, HSD_Metric metric,
+                                const void *data, const void *query) {
+    hsd_index_flat_t *flat = NULL;
+    uint64_t ids[VECFILE_TEST_K], want_ids[VECFILE_TEST_K];
+    float scores[VECFILE_TEST_K], want_scores[VECFILE_TEST_K];
+    size_t found = 0, want_found = 0;
+    int ok = hsd_index_flat_create(VECFILE_TEST_DIM, dtype, metric, &flat) == HSD_SUCCESS &&
+             hsd_index_flat_add(flat, data, VECFILE_TEST_ROWS, NULL) == HSD_SUCCESS &&
+             hsd_index_flat_search(flat, query, VECFILE_TEST_K, want_ids, want_scores,
+                                   &want_found) == HSD_SUCCESS &&
+             hsd_vecfile_search(file, query, metric, VECFILE_TEST_K, ids, scores, &found) ==
+                 HSD_SUCCESS &&
+             found == want_found;
+    for (size_t i = 0; ok && i < found; ++i) {
+        ok = ids[i] == want_ids[i] &&
+             fabsf(scores[i] - want_scores[i]) <= 1e-4f * (1.0f + fabsf(want_scores[i]));
+    }
+    hsd_index_flat_free(flat);
+    return ok;
+}
+
+/* Streaming the file through small buffers must reproduce the mapped search exactly. */
+static int vecfile_stream_matches(const char *path, const hsd_vecfile_t *file, HSD_Metric metric,
+                                  const void *query) {
+    hsd_stream_params_t params;
+    params.chunk_bytes = 64 * 1024;
+    params.depth = 3;
+    uint64_t ids[VECFILE_TEST_K], want_ids[VECFILE_TEST_K];
+    float scores[VECFILE_TEST_K], want_scores[VECFILE_TEST_K];
+    size_t found = 0, want_found = 0;
+    int ok = hsd_vecfile_search(file, query, metric, VECFILE_TEST_K, want_ids, want_scores,
+                                &want_found) == HSD_SUCCESS &&
+             hsd_vecfile_stream_search(path, query, metric, VECFILE_TEST_K, &params, ids, scores,
+                                       &found) == HSD_SUCCESS &&
+             found == want_found;
+    for (size_t i = 0; ok && i < found; ++i)
+        ok = ids[i] == want_ids[i] && scores[i] == want_scores[i];
+    return ok;
+}
+
+void run_vecfile_tests(void) {
+    printf("\n======= Running Vector File Tests =======\n");
+
+    const char *path = "hsd_test_vectors.bin";
+    uint64_t state = 17;
+    float *data = (float *)malloc(VECFILE_TEST_ROWS * VECFILE_TEST_DIM * sizeof(float));
+    for (size_t i = 0; i < VECFILE_TEST_ROWS * VECFILE_TEST_DIM; ++i)
+        data[i] = test_rand_f32(&state);
+    float query[VECFILE_TEST_DIM];
+    for (size_t i = 0; i < VECFILE_TEST_DIM; ++i) query[i] = test_rand_f32(&state);
+
+    {
+        hsd_vecfile_t *file = NULL;
+        int ok = hsd_vecfile_write(path, HSD_DTYPE_F32, VECFILE_TEST_DIM, data, VECFILE_TEST_ROWS,
+                                   true) == HSD_SUCCESS;
+        ok = ok && hsd_vecfile_open(path, &file) == HSD_SUCCESS;
+        ok = ok && hsd_vecfile_count(file) == VECFILE_TEST_ROWS &&
+             hsd_vecfile_dim(file) == VECFILE_TEST_DIM && hsd_vecfile_dtype(file) == HSD_DTYPE_F32;
+        ok = ok && hsd_vecfile_row_stride(file) % 64 == 0 && hsd_vecfile_norms(file) != NULL;
+        for (size_t r = 0; ok && r < VECFILE_TEST_ROWS; r += 997) {
+            const float *row = (const float *)hsd_vecfile_row(file, r);
+            ok = row != NULL && (uintptr_t)row % 64 == 0 &&
+                 memcmp(row, data + r * VECFILE_TEST_DIM, VECFILE_TEST_DIM * sizeof(float)) == 0 &&
+                 row[VECFILE_TEST_DIM] == 0.0f;
+            float norm = sqrtf(simple_dot_f32(row, row, VECFILE_TEST_DIM));
+            ok = ok && fabsf(hsd_vecfile_norms(file)[r] - norm) <= 1e-5f * (1.0f + norm);
+        }
+        ok = ok && hsd_vecfile_row(file, VECFILE_TEST_ROWS) == NULL;
+        test_check(ok, "Round trip exposes aligned rows and norms", "hsd_vecfile");
+
+        ok = hsd_vecfile_advise(file, HSD_ADVICE_SEQUENTIAL) == HSD_SUCCESS;
+        ok = ok && vecfile_matches_flat(file, HSD_DTYPE_F32, HSD_METRIC_SQEUCLIDEAN, data, query);
+        ok = ok && vecfile_matches_flat(file, HSD_DTYPE_F32, HSD_METRIC_MANHATTAN, data, query);
+        ok = ok && vecfile_matches_flat(file, HSD_DTYPE_F32, HSD_METRIC_DOT, data, query);
+        ok = ok && vecfile_matches_flat(file, HSD_DTYPE_F32, HSD_METRIC_COSINE, data, query);
+        ok = ok && hsd_vecfile_advise(file, HSD_ADVICE_NORMAL) == HSD_SUCCESS;
+        test_check(ok, "Zero-copy search matches flat index", "hsd_vecfile");
+
+        ok = vecfile_stream_matches(path, file, HSD_METRIC_SQEUCLIDEAN, query);
+        ok = ok && vecfile_stream_matches(path, file, HSD_METRIC_DOT, query);
+        ok = ok && vecfile_stream_matches(path, file, HSD_METRIC_COSINE, query);
+        test_check(ok, "Streaming search matches mapped search", "hsd_vecfile");
+        hsd_vecfile_close(file);
+    }
+
+    {
+        /* Cosine without a norms section falls back to computing row norms. */
+        hsd_vecfile_t *file = NULL;
+        int ok = hsd_vecfile_write(path, HSD_DTYPE_F32, VECFILE_TEST_DIM, data, VECFILE_TEST_ROWS,
+                                   false) == HSD_SUCCESS &&
+                 hsd_vecfile_open(path, &file) == HSD_SUCCESS && hsd_vecfile_norms(file) == NULL;
+        ok = ok && vecfile_matches_flat(file, HSD_DTYPE_F32, HSD_METRIC_COSINE, data, query);
+        test_check(ok, "Cosine without stored norms", "hsd_vecfile");
+        hsd_vecfile_close(file);
+    }
+
+    {
+        uint16_t *half =
+            (uint16_t *)malloc(VECFILE_TEST_ROWS * VECFILE_TEST_DIM * sizeof(uint16_t));
+        uint16_t half_query[VECFILE_TEST_DIM];
+        for (size_t i = 0; i < VECFILE_TEST_ROWS * VECFILE_TEST_DIM; ++i)
+            half[i] = (uint16_t)(0x3800 + (i * 2654435761u >> 20) % 0x0800);
+        for (size_t i = 0; i < VECFILE_TEST_DIM; ++i) half_query[i] = half[i * 31];
+        hsd_vecfile_t *file = NULL;
+        int ok = hsd_vecfile_write(path, HSD_DTYPE_F16, VECFILE_TEST_DIM, half, VECFILE_TEST_ROWS,
+                                   true) == HSD_SUCCESS &&
+                 hsd_vecfile_open(path, &file) == HSD_SUCCESS;
+        ok = ok && vecfile_matches_flat(file, HSD_DTYPE_F16, HSD_METRIC_SQEUCLIDEAN, half,
+                                        half_query);
+        ok = ok && vecfile_matches_flat(file, HSD_DTYPE_F16, HSD_METRIC_COSINE, half, half_query);
+        ok = ok && vecfile_stream_matches(path, file, HSD_METRIC_COSINE, half_query);
+        hsd_vecfile_close(file);
+
+        const uint8_t *bytes = (const uint8_t *)half;
+        file = NULL;
+        ok = ok && hsd_vecfile_write(path, HSD_DTYPE_U8, VECFILE_TEST_DIM, bytes,
+                                     VECFILE_TEST_ROWS, false) == HSD_SUCCESS &&
+             hsd_vecfile_open(path, &file) == HSD_SUCCESS;
+        ok = ok && vecfile_matches_flat(file, HSD_DTYPE_U8, HSD_METRIC_HAMMING, bytes, bytes + 40);
+        ok = ok && hsd_vecfile_write(path, HSD_DTYPE_U8, VECFILE_TEST_DIM, bytes, 4, true) ==
+                       HSD_ERR_INVALID_INPUT;
+        size_t found = 0;
+        uint64_t ids[1];
+        ok = ok && hsd_vecfile_search(file, bytes, HSD_METRIC_DOT, 1, ids, NULL, &found) ==
+                       HSD_ERR_INVALID_INPUT;
+        test_check(ok, "F16 and U8 files", "hsd_vecfile");
+        hsd_vecfile_close(file);
+        free(half);
+    }
+
+    {
+        hsd_vecfile_t *file = NULL;
+        int ok = hsd_vecfile_open("hsd_test_missing_vectors.bin", &file) == HSD_FAILURE;
+        ok = ok && hsd_vecfile_open(NULL, &file) == HSD_ERR_NULL_PTR;
+        size_t found = 0;
+        uint64_t ids[1];
+        ok = ok && hsd_vecfile_stream_search("hsd_test_missing_vectors.bin", data,
+                                             HSD_METRIC_DOT, 1, NULL, ids, NULL,
+                                             &found) == HSD_FAILURE;
+
+        /* A header promising more rows than the file holds is rejected. */
+        ok = ok && hsd_vecfile_write(path, HSD_DTYPE_F32, VECFILE_TEST_DIM, data, 10, false) ==
+                       HSD_SUCCESS;
+        FILE *f = fopen(path, "r+b");
+        uint64_t count = 11;
+        ok = ok && f != NULL && fseek(f, 24, SEEK_SET) == 0 &&
+             fwrite(&count, sizeof(count), 1, f) == 1;
+        if (f != NULL) fclose(f);
+        ok = ok && hsd_vecfile_open(path, &file) == HSD_ERR_INVALID_INPUT && file == NULL;
+        ok = ok && hsd_vecfile_stream_search(path, data, HSD_METRIC_DOT, 1, NULL, ids, NULL,
+                                             &found) == HSD_ERR_INVALID_INPUT;
+
+        f = fopen(path, "r+b");
+        ok = ok && f != NULL && fwrite("NOTAFILE", 8, 1, f) == 1;
+        if (f != NULL) fclose(f);
+        ok = ok && hsd_vecfile_open(path, &file) == HSD_ERR_INVALID_INPUT;
+        ok = ok && hsd_vecfile_write(path, HSD_DTYPE_F32, 0, data, 1, false) ==
+                       HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Invalid files and arguments", "hsd_vecfile");
+    }
+
+    remove(path);
+    free(data);
+    printf("======= Finished Vector File Tests =======\n");
+}
@@ -0,0 +1,147 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_common.h"
+
+#define WASS_TEST_MAX_N 1000
+
+static int wass_cmp(const void *p, const void *q) {
+    float x = *(const float *)p, y = *(const float *)q;
+    return (x > y) - (x < y);
+}
+
+/* Random histogram normalized to a total mass of 1. */
+static void wass_histogram(float *h, size_t n, uint64_t *state) {
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) total += h[i] = fabsf(test_rand_f32(state));
+    for (size_t i = 0; i < n; ++i) h[i] = (float)(h[i] / total);
+}
+
+static double simple_wasserstein_hist(const float *a, const float *b, size_t n) {
+    double cum = 0.0, sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        cum += (double)a[i] - b[i];
+        sum += fabs(cum);
+    }
+    return sum;
+}
+
+/*
+ * Integral of |Qx(u) - Qy(u)| over the quantile functions, the dual of the CDF form used by
+ * the library; between consecutive breakpoints k / nx and l / ny both quantiles are constant.
+ */
+static double simple_wasserstein_sorted(const float *x, size_t nx, const float *y, size_t ny) {
+    double sum = 0.0, u0 = 0.0;
+    size_t k = 1, l = 1;
+    while (k <= nx && l <= ny) {
+        double ux = (double)k / nx, uy = (double)l / ny, u1 = ux < uy ? ux : uy;
+        double mid = 0.5 * (u0 + u1);
+        sum += (u1 - u0) * fabs((double)x[(size_t)(mid * nx)] - y[(size_t)(mid * ny)]);
+        if (ux <= u1) ++k;
+        if (uy <= u1) ++l;
+        u0 = u1;
+    }
+    return sum;
+}
+
+void run_wasserstein_tests(void) {
+    printf("\n======= Running Wasserstein Distance Tests =======\n");
+
+    uint64_t state = 50;
+    static float a[WASS_TEST_MAX_N], b[WASS_TEST_MAX_N];
+
+    {
+        /* Lengths around every vector width, including the carry across blocks. */
+        const size_t sizes[] = {1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33, 100, WASS_TEST_MAX_N};
+        int ok = 1;
+        for (size_t s = 0; ok && s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            size_t n = sizes[s];
+            wass_histogram(a, n, &state);
+            wass_histogram(b, n, &state);
+            double want = simple_wasserstein_hist(a, b, n);
+            float r = -1.0f;
+            ok = hsd_dist_wasserstein1d_f32(a, b, n, &r) == HSD_SUCCESS &&
+                 fabs(r - want) <= 1e-4 * (want + 1e-3);
+        }
+        float r = -1.0f;
+        ok = ok && hsd_set_precision(HSD_PRECISION_F64) == HSD_SUCCESS &&
+             hsd_dist_wasserstein1d_f32(a, b, WASS_TEST_MAX_N, &r) == HSD_SUCCESS &&
+             r == (float)simple_wasserstein_hist(a, b, WASS_TEST_MAX_N);
+        ok = hsd_set_precision(HSD_PRECISION_FAST) == HSD_SUCCESS && ok;
+        test_check(ok, "Histogram distance matches reference", "hsd_wasserstein");
+    }
+
+    {
+        /* Moving all the mass by k bins costs k; identical histograms are at 0. */
+        int ok = 1;
+        for (size_t k = 0; ok && k < 40; k += 3) {
+            for (size_t i = 0; i < 64; ++i) a[i] = b[i] = 0.0f;
+            a[5] = 0.25f, a[20] = 0.75f;
+            b[5 + k] = 0.25f, b[20 + k] = 0.75f;
+            float r = -1.0f;
+            ok = hsd_dist_wasserstein1d_f32(a, b, 64, &r) == HSD_SUCCESS && r == (float)k &&
+                 hsd_dist_wasserstein1d_f32(b, a, 64, &r) == HSD_SUCCESS && r == (float)k;
+        }
+        test_check(ok, "Shifted histograms", "hsd_wasserstein");
+    }
+
+    {
+        /* Equal and unequal sample counts, with ties across the two arrays. */
+        const size_t cases[][2] = {{1, 1}, {1, 7}, {5, 3}, {40, 40}, {64, 100}, {999, 1000}};
+        int ok = 1;
+        for (size_t c = 0; ok && c < sizeof(cases) / sizeof(cases[0]); ++c) {
+            size_t nx = cases[c][0], ny = cases[c][1];
+            for (size_t i = 0; i < nx; ++i) a[i] = floorf(10.0f * (test_rand_f32(&state) + 1.0f));
+            for (size_t i = 0; i < ny; ++i) b[i] = 0.5f + 12.5f * (test_rand_f32(&state) + 1.0f);
+            qsort(a, nx, sizeof(float), wass_cmp);
+            qsort(b, ny, sizeof(float), wass_cmp);
+            double want = simple_wasserstein_sorted(a, nx, b, ny);
+            float r1 = -1.0f, r2 = -1.0f;
+            ok = hsd_dist_wasserstein1d_sorted_f32(a, nx, b, ny, &r1) == HSD_SUCCESS &&
+                 hsd_dist_wasserstein1d_sorted_f32(b, ny, a, nx, &r2) == HSD_SUCCESS &&
+                 fabs(r1 - want) <= 1e-5 * (want + 1.0) && fabs(r2 - want) <= 1e-5 * (want + 1.0);
+        }
+        const float x[3] = {0.0f, 1.0f, 3.0f}, y[3] = {5.0f, 6.0f, 8.0f}, z[2] = {0.0f, 2.0f};
+        float r = -1.0f;
+        ok = ok && hsd_dist_wasserstein1d_sorted_f32(x, 3, y, 3, &r) == HSD_SUCCESS &&
+             r == 5.0f && hsd_dist_wasserstein1d_sorted_f32(x, 1, z, 2, &r) == HSD_SUCCESS &&
+             r == 1.0f;
+        test_check(ok, "Sorted samples match quantile reference", "hsd_wasserstein");
+    }
+
+    {
+        /* A decreasing pair is rejected on both the equal-count and the merge path. */
+        float x[5] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f}, y[5] = {1.0f, 1.0f, 2.0f, 5.0f, 6.0f};
+        float r = -1.0f;
+        int ok = hsd_dist_wasserstein1d_sorted_f32(x, 5, y, 5, &r) == HSD_SUCCESS &&
+                 hsd_dist_wasserstein1d_sorted_f32(x, 5, y, 4, &r) == HSD_SUCCESS;
+        x[3] = 1.5f;
+        ok = ok && hsd_dist_wasserstein1d_sorted_f32(x, 5, y, 5, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_wasserstein1d_sorted_f32(x, 5, y, 4, &r) == HSD_ERR_INVALID_INPUT;
+        x[3] = 3.0f, y[4] = 4.0f;
+        ok = ok && hsd_dist_wasserstein1d_sorted_f32(x, 5, y, 5, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_wasserstein1d_sorted_f32(y, 5, x, 3, &r) == HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Unsorted samples", "hsd_wasserstein");
+    }
+
+    {
+        float bad[20], r = 0.0f;
+        for (size_t i = 0; i < 20; ++i) bad[i] = (float)i;
+        int ok = hsd_dist_wasserstein1d_f32(NULL, bad, 4, &r) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_wasserstein1d_f32(bad, bad, 4, NULL) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_wasserstein1d_f32(bad, bad, 0, &r) == HSD_SUCCESS && r == 0.0f &&
+                 hsd_dist_wasserstein1d_sorted_f32(bad, 0, bad, 3, &r) == HSD_ERR_INVALID_INPUT &&
+                 hsd_dist_wasserstein1d_sorted_f32(bad, 3, NULL, 3, &r) == HSD_ERR_NULL_PTR;
+        bad[13] = NAN;
+        ok = ok && hsd_dist_wasserstein1d_f32(a, bad, 20, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_wasserstein1d_sorted_f32(a, 5, bad, 20, &r) == HSD_ERR_INVALID_INPUT;
+        bad[13] = INFINITY;
+        ok = ok && hsd_dist_wasserstein1d_f32(bad, a, 20, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_dist_wasserstein1d_sorted_f32(bad, 20, a, 20, &r) == HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Invalid inputs", "hsd_wasserstein");
+    }
+
+    printf("======= Finished Wasserstein Distance Tests =======\n");
+}
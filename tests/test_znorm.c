@@ -0,0 +1,162 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_common.h"
+
+#define ZNORM_TEST_N 1500
+
+/* Z-normalizes both windows in double and sums the squared differences. */
+static double simple_znorm(const float *a, const float *b, size_t m) {
+    double ma = 0.0, mb = 0.0, va = 0.0, vb = 0.0;
+    for (size_t i = 0; i < m; ++i) ma += a[i], mb += b[i];
+    ma /= (double)m, mb /= (double)m;
+    for (size_t i = 0; i < m; ++i) {
+        va += (a[i] - ma) * (a[i] - ma);
+        vb += (b[i] - mb) * (b[i] - mb);
+    }
+    if (va == 0.0 && vb == 0.0) return 0.0;
+    if (va == 0.0 || vb == 0.0) return sqrt((double)m);
+    double sa = sqrt(va / (double)m), sb = sqrt(vb / (double)m), sum = 0.0;
+    for (size_t i = 0; i < m; ++i) {
+        double d = (a[i] - ma) / sa - (b[i] - mb) / sb;
+        sum += d * d;
+    }
+    return sqrt(sum);
+}
+
+/* Checks every profile entry against a brute-force scan of all non-excluded windows. */
+static int check_profile(const float *t, size_t n, size_t m, const float *profile,
+                         const size_t *index) {
+    size_t count = n - m + 1, excl = (m + 3) / 4;
+    for (size_t i = 0; i < count; ++i) {
+        double best = INFINITY;
+        for (size_t j = 0; j < count; ++j) {
+            if ((i > j ? i - j : j - i) <= excl) continue;
+            double d = simple_znorm(t + i, t + j, m);
+            best = d < best ? d : best;
+        }
+        if (isinf(best)) {
+            if (!isinf(profile[i]) || index[i] != SIZE_MAX) return 0;
+            continue;
+        }
+        double tol = 2e-3 * sqrt((double)m);
+        size_t j = index[i];
+        if (fabs(profile[i] - best) > tol || j >= count || (i > j ? i - j : j - i) <= excl ||
+            fabs(simple_znorm(t + i, t + j, m) - best) > tol)
+            return 0;
+    }
+    return 1;
+}
+
+void run_znorm_tests(void) {
+    printf("\n======= Running Z-Normalized Distance Tests =======\n");
+
+    uint64_t state = 46;
+    static float t[ZNORM_TEST_N];
+    for (size_t i = 0; i < ZNORM_TEST_N; ++i)
+        t[i] = 100.0f + sinf(0.07f * (float)i) + 0.4f * test_rand_f32(&state);
+
+    {
+        /*
+         * The distance follows the double reference, and offsets and scales cancel out. Near
+         * zero the square root magnifies the float rounding of the moments, hence the loose bound.
+         */
+        const size_t sizes[] = {2, 3, 16, 33, 100, 1024};
+        int ok = 1;
+        for (size_t s = 0; ok && s < 6; ++s) {
+            size_t n = sizes[s];
+            float r = -1.0f, scaled[1024];
+            for (size_t i = 0; i < n; ++i) scaled[i] = 3.0f * t[i] - 250.0f;
+            double want = simple_znorm(t, t + 200, n);
+            ok = hsd_dist_znorm_euclidean_f32(t, t + 200, n, &r) == HSD_SUCCESS &&
+                 fabs(r - want) <= 1e-4 * (want + 1.0) &&
+                 hsd_dist_znorm_euclidean_f32(t, scaled, n, &r) == HSD_SUCCESS &&
+                 r <= 1e-2f * sqrtf((float)n);
+        }
+        test_check(ok, "Z-normalized distance matches reference", "hsd_znorm");
+    }
+
+    {
+        /* Two constant vectors are at 0, one constant vector is at sqrt(n). */
+        float c1[40], c2[40], r0 = -1.0f, r1 = -1.0f, r2 = -1.0f;
+        for (size_t i = 0; i < 40; ++i) c1[i] = 5.0f, c2[i] = -2.5f;
+        int ok = hsd_dist_znorm_euclidean_f32(c1, c2, 40, &r0) == HSD_SUCCESS && r0 == 0.0f &&
+                 hsd_dist_znorm_euclidean_f32(c1, t, 40, &r1) == HSD_SUCCESS &&
+                 hsd_dist_znorm_euclidean_f32(t, c2, 40, &r2) == HSD_SUCCESS &&
+                 fabsf(r1 - sqrtf(40.0f)) <= 1e-5f && r1 == r2;
+        test_check(ok, "Constant vector conventions", "hsd_znorm");
+    }
+
+    {
+        /* Window lengths around the vector widths and the exclusion zone. */
+        const size_t cases[][2] = {{2, 2}, {10, 2}, {12, 4}, {40, 7}, {300, 16}, {700, 50}};
+        static float profile[ZNORM_TEST_N];
+        static size_t index[ZNORM_TEST_N];
+        int ok = 1;
+        for (size_t c = 0; ok && c < 6; ++c) {
+            size_t n = cases[c][0], m = cases[c][1];
+            ok = hsd_matrix_profile_f32(t, n, m, profile, index) == HSD_SUCCESS &&
+                 check_profile(t, n, m, profile, index);
+        }
+        test_check(ok, "Matrix profile matches brute force", "hsd_znorm");
+    }
+
+    {
+        /* Flat stretches make constant windows and exact ties between neighbours. */
+        static float flat[400], profile[400];
+        static size_t index[400];
+        memcpy(flat, t, sizeof(flat));
+        for (size_t i = 100; i < 160; ++i) flat[i] = 7.0f;
+        for (size_t i = 300; i < 340; ++i) flat[i] = -1.0f;
+        int ok = hsd_matrix_profile_f32(flat, 400, 12, profile, index) == HSD_SUCCESS &&
+                 check_profile(flat, 400, 12, profile, index);
+        /* Ties go to the smallest neighbour: the first constant window outside the zone. */
+        ok = ok && profile[100] == 0.0f && index[100] == 104 && profile[120] == 0.0f &&
+             index[120] == 100;
+        test_check(ok, "Constant windows and tie breaking", "hsd_znorm");
+    }
+
+    {
+        /* The profile and the indices do not depend on the thread count. */
+        static float p1[ZNORM_TEST_N], p2[ZNORM_TEST_N];
+        static size_t i1[ZNORM_TEST_N], i2[ZNORM_TEST_N];
+        const size_t m = 24, count = ZNORM_TEST_N - m + 1;
+        int ok = hsd_set_num_threads(1) == HSD_SUCCESS &&
+                 hsd_matrix_profile_f32(t, ZNORM_TEST_N, m, p1, i1) == HSD_SUCCESS;
+        const size_t threads[] = {2, 3, 8};
+        for (size_t k = 0; ok && k < 3; ++k) {
+            ok = hsd_set_num_threads(threads[k]) == HSD_SUCCESS &&
+                 hsd_matrix_profile_f32(t, ZNORM_TEST_N, m, p2, i2) == HSD_SUCCESS &&
+                 memcmp(p1, p2, count * sizeof(float)) == 0 &&
+                 memcmp(i1, i2, count * sizeof(size_t)) == 0;
+        }
+        hsd_set_num_threads(0);
+        ok = ok && hsd_matrix_profile_f32(t, ZNORM_TEST_N, m, p2, NULL) == HSD_SUCCESS &&
+             memcmp(p1, p2, count * sizeof(float)) == 0;
+        test_check(ok, "Matrix profile is independent of thread count", "hsd_znorm");
+    }
+
+    {
+        float bad[20], profile[20], r = 0.0f;
+        size_t index[20];
+        for (size_t i = 0; i < 20; ++i) bad[i] = (float)i;
+        int ok = hsd_dist_znorm_euclidean_f32(t, t, 0, &r) == HSD_SUCCESS && r == 0.0f &&
+                 hsd_dist_znorm_euclidean_f32(NULL, t, 4, &r) == HSD_ERR_NULL_PTR &&
+                 hsd_dist_znorm_euclidean_f32(t, t, 4, NULL) == HSD_ERR_NULL_PTR &&
+                 hsd_matrix_profile_f32(NULL, 20, 4, profile, index) == HSD_ERR_NULL_PTR &&
+                 hsd_matrix_profile_f32(bad, 20, 4, NULL, index) == HSD_ERR_NULL_PTR &&
+                 hsd_matrix_profile_f32(bad, 20, 1, profile, index) == HSD_ERR_INVALID_INPUT &&
+                 hsd_matrix_profile_f32(bad, 20, 21, profile, index) == HSD_ERR_INVALID_INPUT;
+        bad[9] = NAN;
+        ok = ok && hsd_dist_znorm_euclidean_f32(bad, t, 20, &r) == HSD_ERR_INVALID_INPUT &&
+             hsd_matrix_profile_f32(bad, 20, 4, profile, index) == HSD_ERR_INVALID_INPUT;
+        bad[9] = INFINITY;
+        ok = ok && hsd_matrix_profile_f32(bad, 20, 4, profile, index) == HSD_ERR_INVALID_INPUT;
+        test_check(ok, "Invalid inputs", "hsd_znorm");
+    }
+
+    printf("======= Finished Z-Normalized Distance Tests =======\n");
+}